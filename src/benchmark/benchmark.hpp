@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+// Self-registering benchmark cases, so the numbers behind performance changes can be measured again.
+// Usage: benchmark [case [arguments...]]. Without a case, every case runs with its defaults.
+// A case returns false when its results fail a check, which makes the run exit with 1.
+
+namespace benchmark
+{
+    using arguments = std::span<char* const>;
+    using function = bool (*)(arguments args);
+
+    class registration
+    {
+      public:
+        registration(const char* name, function run);
+    };
+
+    // Positive integer argument, or default_value if it is missing or invalid
+    size_t parse_argument(arguments args, size_t index, size_t default_value);
+
+    template <typename F>
+    double measure(F&& function)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Seconds per call, calling function in growing rounds until they take at least min_seconds
+    template <typename F>
+    double measure_per_call(F&& function, const double min_seconds = 0.2)
+    {
+        for (size_t iterations = 1;; iterations *= 2)
+        {
+            const auto seconds = measure([&] {
+                for (size_t i = 0; i < iterations; ++i)
+                {
+                    function();
+                }
+            });
+
+            if (seconds >= min_seconds)
+            {
+                return seconds / static_cast<double>(iterations);
+            }
+        }
+    }
+}
+
+#define BENCHMARK_CASE(name)                                                                      \
+    static bool benchmark_##name(benchmark::arguments args);                                      \
+    static const benchmark::registration benchmark_registration_##name(#name, &benchmark_##name); \
+    static bool benchmark_##name([[maybe_unused]] benchmark::arguments args)
@@ -0,0 +1,233 @@
+#include "benchmark.hpp"
+
+#include <utils/bit_buffer.hpp>
+#include <utils/byte_buffer.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// bit_writer/bit_reader against buffer_serializer/buffer_deserializer: encoding a batch of player records both ways,
+// then plain uint32 reads to show the per-field cost of the bit reader.
+// Arguments: [records per batch]
+
+namespace
+{
+    constexpr size_t DEFAULT_RECORD_COUNT = 1024;
+    constexpr size_t READ_COUNT = 1024 * 1024;
+
+    constexpr float WORLD_EXTENT = 8192.0f;
+    constexpr uint32_t POSITION_BITS = 20;
+    constexpr uint32_t YAW_BITS = 10;
+    constexpr float MAX_SPEED = 20.0f;
+    constexpr uint32_t SPEED_BITS = 12;
+    constexpr uint32_t MOVE_TYPE_BITS = 3;
+
+    struct player_record
+    {
+        uint64_t guid{};
+        std::array<float, 3> position{};
+        float yaw{};
+        float speed{};
+        int32_t move_type{};
+        bool in_combat{};
+    };
+
+    std::vector<player_record> generate_records(const size_t count, std::mt19937_64& random)
+    {
+        std::uniform_real_distribution<float> coordinate(-WORLD_EXTENT, WORLD_EXTENT);
+        std::uniform_real_distribution<float> yaw(-180.0f, 180.0f);
+        std::uniform_real_distribution<float> speed(0.0f, MAX_SPEED);
+
+        std::vector<player_record> records(count);
+        for (auto& record : records)
+        {
+            record.guid = random();
+            record.position = {coordinate(random), coordinate(random), coordinate(random)};
+            record.yaw = yaw(random);
+            record.speed = speed(random);
+            record.move_type = static_cast<int32_t>(random() % 5);
+            record.in_combat = random() % 2 != 0;
+        }
+
+        return records;
+    }
+
+    std::string write_bytes(const std::vector<player_record>& records)
+    {
+        utils::buffer_serializer buffer{};
+        for (const auto& record : records)
+        {
+            buffer.write(record.guid);
+            buffer.write(record.position);
+            buffer.write(record.yaw);
+            buffer.write(record.speed);
+            buffer.write(record.move_type);
+            buffer.write(record.in_combat);
+        }
+
+        return buffer.move_buffer();
+    }
+
+    void read_bytes(const std::string& data, std::vector<player_record>& records)
+    {
+        utils::buffer_deserializer buffer(data);
+        for (auto& record : records)
+        {
+            record.guid = buffer.read<uint64_t>();
+            record.position = buffer.read<std::array<float, 3>>();
+            record.yaw = buffer.read<float>();
+            record.speed = buffer.read<float>();
+            record.move_type = buffer.read<int32_t>();
+            record.in_combat = buffer.read<bool>();
+        }
+    }
+
+    std::string write_bits(const std::vector<player_record>& records)
+    {
+        utils::bit_writer writer{};
+        for (const auto& record : records)
+        {
+            writer.write_bits(record.guid, 64);
+
+            for (const auto coordinate : record.position)
+            {
+                writer.write_quantized(coordinate, -WORLD_EXTENT, WORLD_EXTENT, POSITION_BITS);
+            }
+
+            writer.write_quantized(record.yaw, -180.0f, 180.0f, YAW_BITS);
+            writer.write_quantized(record.speed, 0.0f, MAX_SPEED, SPEED_BITS);
+            writer.write_bits(static_cast<uint64_t>(record.move_type), MOVE_TYPE_BITS);
+            writer.write_bool(record.in_combat);
+        }
+
+        return writer.move_buffer();
+    }
+
+    void read_bits(const std::string& data, std::vector<player_record>& records)
+    {
+        utils::bit_reader reader(data);
+        for (auto& record : records)
+        {
+            record.guid = reader.read_bits(64);
+
+            for (auto& coordinate : record.position)
+            {
+                coordinate = reader.read_quantized(-WORLD_EXTENT, WORLD_EXTENT, POSITION_BITS);
+            }
+
+            record.yaw = reader.read_quantized(-180.0f, 180.0f, YAW_BITS);
+            record.speed = reader.read_quantized(0.0f, MAX_SPEED, SPEED_BITS);
+            record.move_type = static_cast<int32_t>(reader.read_bits(MOVE_TYPE_BITS));
+            record.in_combat = reader.read_bool();
+        }
+    }
+
+    bool is_close(const float a, const float b, const float min, const float max, const uint32_t bits)
+    {
+        return std::abs(a - b) <= (max - min) / static_cast<float>((uint64_t{1} << bits) - 1);
+    }
+
+    bool matches(const player_record& a, const player_record& b, const bool quantized)
+    {
+        if (a.guid != b.guid || a.move_type != b.move_type || a.in_combat != b.in_combat)
+        {
+            return false;
+        }
+
+        if (!quantized)
+        {
+            return a.position == b.position && a.yaw == b.yaw && a.speed == b.speed;
+        }
+
+        for (size_t i = 0; i < a.position.size(); ++i)
+        {
+            if (!is_close(a.position[i], b.position[i], -WORLD_EXTENT, WORLD_EXTENT, POSITION_BITS))
+            {
+                return false;
+            }
+        }
+
+        return is_close(a.yaw, b.yaw, -180.0f, 180.0f, YAW_BITS) && is_close(a.speed, b.speed, 0.0f, MAX_SPEED, SPEED_BITS);
+    }
+
+    bool all_match(const std::vector<player_record>& expected, const std::vector<player_record>& actual, const bool quantized)
+    {
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            if (!matches(expected[i], actual[i], quantized))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+BENCHMARK_CASE(bit_buffer)
+{
+    const auto record_count = benchmark::parse_argument(args, 0, DEFAULT_RECORD_COUNT);
+    const auto per_record = [&](const double seconds) { return seconds / static_cast<double>(record_count) * 1e9; };
+
+    std::mt19937_64 random(0x5733);
+    const auto records = generate_records(record_count, random);
+    std::vector<player_record> decoded(record_count);
+
+    const auto byte_data = write_bytes(records);
+    const auto bit_data = write_bits(records);
+
+    const auto byte_write = benchmark::measure_per_call([&] { (void)write_bytes(records); });
+    const auto byte_read = benchmark::measure_per_call([&] { read_bytes(byte_data, decoded); });
+    const auto bytes_match = all_match(records, decoded, false);
+
+    const auto bit_write = benchmark::measure_per_call([&] { (void)write_bits(records); });
+    const auto bit_read = benchmark::measure_per_call([&] { read_bits(bit_data, decoded); });
+    const auto bits_match = all_match(records, decoded, true);
+
+    printf("Player record, %zu per batch:\n", record_count);
+    printf("  byte serializer  %5.1f bytes  write %6.1f ns  read %6.1f ns\n",
+           static_cast<double>(byte_data.size()) / static_cast<double>(record_count), per_record(byte_write), per_record(byte_read));
+    printf("  bit writer       %5.1f bytes  write %6.1f ns  read %6.1f ns\n",
+           static_cast<double>(bit_data.size()) / static_cast<double>(record_count), per_record(bit_write), per_record(bit_read));
+
+    std::vector<uint32_t> values(READ_COUNT);
+    for (auto& value : values)
+    {
+        value = static_cast<uint32_t>(random());
+    }
+
+    const std::string value_data(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(uint32_t));
+
+    uint64_t byte_sum = 0;
+    const auto byte_reads = benchmark::measure_per_call([&] {
+        utils::buffer_deserializer buffer(value_data);
+        byte_sum = 0;
+
+        for (size_t i = 0; i < READ_COUNT; ++i)
+        {
+            byte_sum += buffer.read<uint32_t>();
+        }
+    });
+
+    uint64_t bit_sum = 0;
+    const auto bit_reads = benchmark::measure_per_call([&] {
+        utils::bit_reader reader(value_data);
+        bit_sum = 0;
+
+        for (size_t i = 0; i < READ_COUNT; ++i)
+        {
+            bit_sum += reader.read_bits(32);
+        }
+    });
+
+    const auto per_read = [](const double seconds) { return seconds / static_cast<double>(READ_COUNT) * 1e9; };
+
+    printf("uint32 reads:\n");
+    printf("  byte deserializer  %5.2f ns\n", per_read(byte_reads));
+    printf("  bit reader         %5.2f ns\n", per_read(bit_reads));
+
+    return bytes_match && bits_match && byte_sum == bit_sum;
+}
@@ -0,0 +1,177 @@
+#include "benchmark.hpp"
+
+#include <server/client_map.hpp>
+
+#include <game/structs.hpp>
+#include <utils/byte_buffer.hpp>
+#include <utils/string.hpp>
+
+#include <cstdio>
+#include <random>
+#include <ranges>
+#include <unordered_map>
+
+// Server tick over the client table: the expiry sweep, gathering the states packet and walking the recipients.
+// Compares client_map with the node based table of heap owning records it replaced. Sending itself is left out,
+// those are syscalls either way.
+// Arguments: [player count]
+
+namespace
+{
+    constexpr size_t DEFAULT_PLAYER_COUNT = 64;
+
+    using clock = client_map::clock;
+
+    // The record as it was before the hot/cold split
+    struct legacy_client
+    {
+        clock::time_point last_packet{};
+        uint64_t guid{};
+        std::string name{};
+        game::player_state current_state{};
+        std::string authentication_nonce{};
+        std::optional<utils::cryptography::ecc::key> public_key{};
+        uint64_t state_id{0};
+        bool has_printed_failure{false};
+
+        bool is_authenticated() const
+        {
+            return this->public_key.has_value();
+        }
+    };
+
+    using legacy_client_map = std::unordered_map<network::address, legacy_client>;
+
+    network::address get_player_address(const size_t player)
+    {
+        return network::address("127.0.0.1:" + std::to_string(30000 + player));
+    }
+
+    size_t run_legacy_tick(legacy_client_map& clients, const clock::time_point now)
+    {
+        for (auto i = clients.begin(); i != clients.end();)
+        {
+            if (now - i->second.last_packet > std::chrono::seconds(20))
+            {
+                i = clients.erase(i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        std::vector<game::player> states{};
+        states.reserve(clients.size());
+
+        for (const auto& client : clients | std::views::values)
+        {
+            if (!client.is_authenticated())
+            {
+                continue;
+            }
+
+            game::player player{};
+            player.guid = client.guid;
+            player.state = client.current_state;
+            player.state.state_id = client.state_id;
+            utils::string::copy(player.name, client.name.data());
+
+            states.emplace_back(std::move(player));
+        }
+
+        utils::buffer_serializer buffer{};
+        buffer.write(game::PROTOCOL);
+        buffer.write_vector(states);
+
+        size_t recipients = 0;
+        for (const auto& client : clients)
+        {
+            if (client.second.is_authenticated())
+            {
+                recipients += client.first.get_port() != 0;
+            }
+        }
+
+        return buffer.get_buffer().size() * recipients;
+    }
+
+    size_t run_tick(client_map& clients, std::string& storage, const clock::time_point now)
+    {
+        clients.expire(now - std::chrono::seconds(20));
+
+        utils::buffer_serializer buffer(storage);
+        buffer.reserve(sizeof(game::PROTOCOL) + sizeof(uint32_t) + clients.size() * sizeof(game::player));
+        buffer.write(game::PROTOCOL);
+
+        const auto count_offset = buffer.size();
+        buffer.write(uint32_t{});
+
+        uint32_t count = 0;
+        clients.for_each_authenticated([&](const client_map::index i) {
+            buffer.write(clients.get_player(i));
+            ++count;
+        });
+
+        buffer.write_at(count_offset, count);
+
+        size_t recipients = 0;
+        clients.for_each_authenticated([&](const client_map::index i) { recipients += clients.get_address(i).get_port() != 0; });
+
+        return buffer.size() * recipients;
+    }
+}
+
+BENCHMARK_CASE(client_table)
+{
+    const auto player_count = benchmark::parse_argument(args, 0, DEFAULT_PLAYER_COUNT);
+    const auto now = clock::now();
+
+    std::mt19937_64 random(0x5733);
+
+    legacy_client_map legacy_clients{};
+    client_map clients{};
+
+    // Clients join over time between other allocations, so the old records end up scattered over the heap
+    std::vector<std::string> other_allocations{};
+
+    for (size_t i = 0; i < player_count; ++i)
+    {
+        const auto address = get_player_address(i);
+        const auto name = "Player with a long name " + std::to_string(i);
+
+        game::player player{};
+        player.guid = random();
+        utils::string::copy(player.name, name.data());
+
+        auto& legacy_client = legacy_clients[address];
+        legacy_client.last_packet = now;
+        legacy_client.guid = player.guid;
+        legacy_client.name = name;
+        legacy_client.authentication_nonce = std::string(32, 'n');
+        legacy_client.public_key.emplace();
+
+        const auto index = clients.get_or_create(address);
+        clients.update_state(index, player, now);
+        clients.authenticate(index, {}, now);
+
+        for (size_t j = 0; j < 8; ++j)
+        {
+            other_allocations.emplace_back(64 + random() % 4096, 'x');
+        }
+    }
+
+    size_t legacy_bytes = 0;
+    const auto legacy_seconds = benchmark::measure_per_call([&] { legacy_bytes = run_legacy_tick(legacy_clients, now); });
+
+    std::string storage{};
+    size_t bytes = 0;
+    const auto seconds = benchmark::measure_per_call([&] { bytes = run_tick(clients, storage, now); });
+
+    printf("%zu players, per tick:\n", player_count);
+    printf("  node table + records  %8.3f us\n", legacy_seconds * 1e6);
+    printf("  client_map columns    %8.3f us\n", seconds * 1e6);
+
+    // Same packet for the same recipients
+    return legacy_bytes == bytes && clients.size() == player_count;
+}
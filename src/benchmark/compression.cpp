@@ -0,0 +1,195 @@
+#include "benchmark.hpp"
+
+#include <utils/compression.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+
+// The reused zlib contexts at each level against the one-shot compress2 and chunk-grown inflate they replaced,
+// at datagram, packet batch and snapshot sizes. Decompression goes through decompress_into with the size as hint.
+// Arguments: [largest size in KiB]
+
+namespace
+{
+    constexpr size_t DEFAULT_MAX_KIB = 4 * 1024;
+    constexpr size_t LEGACY_CHUNK = 16384;
+
+    // Snapshot-like content: fact names with small values, the names repeating across quests
+    std::string generate_payload(const size_t size)
+    {
+        std::mt19937_64 random(0x5733);
+
+        std::string payload{};
+        payload.reserve(size + 64);
+
+        while (payload.size() < size)
+        {
+            payload += "q" + std::to_string(100 + random() % 300) + "_fact_" + std::to_string(random() % 2000);
+            payload.push_back(static_cast<char>(random() % 16));
+            payload.push_back(static_cast<char>(random() % 4));
+        }
+
+        payload.resize(size);
+        return payload;
+    }
+
+    std::string legacy_compress(const std::string_view data)
+    {
+        std::string result{};
+        auto length = compressBound(static_cast<uLong>(data.size()));
+        result.resize(length);
+
+        if (compress2(reinterpret_cast<Bytef*>(result.data()), &length, reinterpret_cast<const Bytef*>(data.data()),
+                      static_cast<uLong>(data.size()), Z_BEST_COMPRESSION) != Z_OK)
+        {
+            return {};
+        }
+
+        result.resize(length);
+        return result;
+    }
+
+    std::string legacy_decompress(const std::string_view data)
+    {
+        z_stream stream{};
+        if (inflateInit(&stream) != Z_OK)
+        {
+            return {};
+        }
+
+        std::string buffer{};
+        uint8_t dest[LEGACY_CHUNK];
+
+        stream.avail_in = static_cast<uInt>(data.size());
+        stream.next_in = reinterpret_cast<const Bytef*>(data.data());
+
+        int ret{};
+        do
+        {
+            stream.avail_out = sizeof(dest);
+            stream.next_out = dest;
+
+            ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END)
+            {
+                buffer.clear();
+                break;
+            }
+
+            buffer.insert(buffer.end(), dest, dest + sizeof(dest) - stream.avail_out);
+        } while (ret != Z_STREAM_END);
+
+        inflateEnd(&stream);
+        return buffer;
+    }
+
+    struct codec_result
+    {
+        size_t compressed_size{};
+        double compress_seconds{};
+        double decompress_seconds{};
+        bool matches{};
+    };
+
+    // Short rounds for the large sizes, which take milliseconds per call at the higher levels
+    double measure_call(const size_t size, const auto& function)
+    {
+        return benchmark::measure_per_call(function, size >= 1024 * 1024 ? 0.5 : 0.1);
+    }
+
+    codec_result measure_legacy(const std::string& payload)
+    {
+        codec_result result{};
+
+        std::string compressed{};
+        result.compress_seconds = measure_call(payload.size(), [&] { compressed = legacy_compress(payload); });
+
+        std::string decompressed{};
+        result.decompress_seconds = measure_call(payload.size(), [&] { decompressed = legacy_decompress(compressed); });
+
+        result.compressed_size = compressed.size();
+        result.matches = decompressed == payload;
+
+        return result;
+    }
+
+    codec_result measure_level(const std::string& payload, const int level)
+    {
+        codec_result result{};
+
+        std::string compressed{};
+        result.compress_seconds = measure_call(payload.size(), [&] {
+            result.matches = utils::compression::zlib::compress_into(compressed, payload, level); //
+        });
+
+        std::string decompressed{};
+        result.decompress_seconds = measure_call(payload.size(), [&] {
+            result.matches &= utils::compression::zlib::decompress_into(decompressed, compressed, payload.size());
+        });
+
+        result.compressed_size = compressed.size();
+        result.matches &= decompressed == payload;
+
+        return result;
+    }
+
+    bool print_result(const char* name, const size_t size, const codec_result& result)
+    {
+        const auto megabytes = static_cast<double>(size) / 1e6;
+
+        printf("    %-10s %9zu B %6.2fx   compress %8.1f MB/s   decompress %8.1f MB/s%s\n", name, result.compressed_size,
+               static_cast<double>(size) / static_cast<double>(std::max(result.compressed_size, size_t{1})),
+               megabytes / result.compress_seconds, megabytes / result.decompress_seconds, result.matches ? "" : "  MISMATCH");
+
+        return result.matches;
+    }
+
+    std::string format_size(const size_t size)
+    {
+        if (size >= 1024 * 1024)
+        {
+            return std::to_string(size / (1024 * 1024)) + " MiB";
+        }
+
+        if (size >= 1024)
+        {
+            return std::to_string(size / 1024) + " KiB";
+        }
+
+        return std::to_string(size) + " B";
+    }
+}
+
+BENCHMARK_CASE(compression)
+{
+    const auto max_size = benchmark::parse_argument(args, 0, DEFAULT_MAX_KIB) * 1024;
+
+    auto matches = true;
+
+    for (const size_t size : {size_t{64}, size_t{512}, size_t{16 * 1024}, size_t{256 * 1024}, size_t{4 * 1024 * 1024}})
+    {
+        if (size > max_size)
+        {
+            break;
+        }
+
+        const auto payload = generate_payload(size);
+        printf("%s:\n", format_size(size).c_str());
+
+        matches &= print_result("legacy 9", size, measure_legacy(payload));
+
+        for (const auto level : {utils::compression::zlib::fastest_level, utils::compression::zlib::default_level,
+                                 utils::compression::zlib::best_level})
+        {
+            const auto name = "level " + std::to_string(level);
+            matches &= print_result(name.c_str(), size, measure_level(payload, level));
+        }
+    }
+
+    return matches;
+}
@@ -0,0 +1,250 @@
+#include "benchmark.hpp"
+
+#include <client/module/quest_sync.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Replays AddFact traffic through the fact registration path, without its logging: the flat LRU fact_cache against
+// the unordered_map with a sort-based prune it replaced. Both keep the Merkle world state up to date.
+// Arguments: [distinct facts] [calls]
+
+namespace
+{
+    constexpr size_t DEFAULT_FACT_COUNT = 4000;
+    constexpr size_t DEFAULT_CALL_COUNT = 60000;
+    constexpr size_t ROUND_COUNT = 5;
+
+    // Most calls set one of the facts touched just before
+    constexpr size_t RECENT_WINDOW = 32;
+
+    using clock = std::chrono::steady_clock;
+
+    struct fact_call
+    {
+        std::string name{};
+        int32_t value{};
+    };
+
+    std::vector<fact_call> generate_calls(const size_t fact_count, const size_t call_count)
+    {
+        std::mt19937_64 random(0x5733);
+
+        std::vector<std::string> names{};
+        std::vector<fact_call> calls{};
+        calls.reserve(call_count);
+
+        for (size_t i = 0; i < call_count; ++i)
+        {
+            const auto introduce = names.size() < fact_count && (names.empty() || random() % 16 == 0);
+            if (introduce)
+            {
+                names.emplace_back("q" + std::to_string(100 + names.size() % 300) + "_fact_" + std::to_string(names.size()));
+            }
+
+            size_t index = names.size() - 1;
+            if (!introduce)
+            {
+                const auto recent = std::min(names.size(), RECENT_WINDOW);
+                index = random() % 8 ? names.size() - 1 - random() % recent : random() % names.size();
+            }
+
+            calls.push_back({names[index], static_cast<int32_t>(random() % 16)});
+        }
+
+        return calls;
+    }
+
+    uint64_t to_state_value(const int32_t value)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+    uint64_t get_timestamp()
+    {
+        return std::chrono::high_resolution_clock::now().time_since_epoch().count();
+    }
+
+    // The fact cache as it was before the flat LRU
+    class legacy_fact_cache
+    {
+      public:
+        void register_fact(const std::string& fact_name, const int32_t value, const uint64_t player_guid)
+        {
+            const auto fact_hash = quest_sync::quest_fact_manager::compute_fact_hash(fact_name);
+
+            legacy_fact fact{};
+            fact.fact_name = fact_name;
+            fact.value = value;
+            fact.timestamp = get_timestamp();
+            fact.player_guid = player_guid;
+            fact.fact_hash = fact_hash;
+
+            const auto [it, inserted] = this->facts_.try_emplace(fact_hash, fact);
+            if (inserted)
+            {
+                this->world_state_.insert(fact_hash, to_state_value(value));
+            }
+            else
+            {
+                this->world_state_.update(fact_hash, to_state_value(it->second.value), to_state_value(value));
+                it->second = std::move(fact);
+            }
+
+            if (this->facts_.size() > quest_sync::FACT_CACHE_SIZE_LIMIT)
+            {
+                this->prune_oldest_facts();
+            }
+        }
+
+        uint64_t get_world_state_hash() const
+        {
+            return this->world_state_.get_root();
+        }
+
+      private:
+        struct legacy_fact
+        {
+            std::string fact_name{};
+            int32_t value{0};
+            uint64_t timestamp{0};
+            uint64_t player_guid{0};
+            uint32_t fact_hash{0};
+        };
+
+        std::unordered_map<uint32_t, legacy_fact> facts_{};
+        utils::merkle_tree world_state_{};
+
+        void prune_oldest_facts()
+        {
+            constexpr auto keep = static_cast<size_t>(quest_sync::FACT_CACHE_SIZE_LIMIT * 0.75);
+
+            std::vector<std::pair<uint32_t, uint64_t>> fact_ages{};
+            fact_ages.reserve(this->facts_.size());
+
+            for (const auto& [hash, fact] : this->facts_)
+            {
+                fact_ages.emplace_back(hash, fact.timestamp);
+            }
+
+            std::ranges::sort(fact_ages, [](const auto& a, const auto& b) { return a.second < b.second; });
+
+            const auto prune_count = this->facts_.size() - keep;
+            for (size_t i = 0; i < prune_count; ++i)
+            {
+                const auto it = this->facts_.find(fact_ages[i].first);
+                this->world_state_.erase(it->first, to_state_value(it->second.value));
+                this->facts_.erase(it);
+            }
+        }
+    };
+
+    // quest_fact_manager::register_fact without the lock and the log line
+    class flat_fact_cache
+    {
+      public:
+        void register_fact(const std::string& fact_name, const int32_t value, const uint64_t player_guid)
+        {
+            const auto fact_hash = quest_sync::quest_fact_manager::compute_fact_hash(fact_name);
+            const auto [fact, inserted] = this->facts_.emplace(fact_hash, [this](const quest_sync::quest_fact& evicted) {
+                this->world_state_.erase(evicted.fact_hash, to_state_value(evicted.value));
+            });
+
+            if (inserted)
+            {
+                network::protocol::copy_string(fact->fact_name, fact_name);
+                this->world_state_.insert(fact_hash, to_state_value(value));
+            }
+            else
+            {
+                this->world_state_.update(fact_hash, to_state_value(fact->value), to_state_value(value));
+            }
+
+            fact->value = value;
+            fact->timestamp = get_timestamp();
+            fact->player_guid = player_guid;
+        }
+
+        uint64_t get_world_state_hash() const
+        {
+            return this->world_state_.get_root();
+        }
+
+        // The Merkle tree rebuilt from what the cache holds, to check that evictions kept it in sync
+        uint64_t rebuild_world_state_hash() const
+        {
+            utils::merkle_tree world_state{};
+            this->facts_.for_each(
+                [&](const quest_sync::quest_fact& fact) { world_state.insert(fact.fact_hash, to_state_value(fact.value)); });
+
+            return world_state.get_root();
+        }
+
+      private:
+        quest_sync::fact_cache facts_{};
+        utils::merkle_tree world_state_{};
+    };
+
+    struct replay_result
+    {
+        double mean_seconds{};
+        double worst_seconds{};
+    };
+
+    // Fastest of a few rounds, each on a fresh cache
+    template <typename Cache>
+    replay_result replay(const std::vector<fact_call>& calls, Cache& last_cache)
+    {
+        replay_result best{};
+
+        for (size_t round = 0; round < ROUND_COUNT; ++round)
+        {
+            Cache cache{};
+            auto worst = clock::duration::zero();
+
+            const auto seconds = benchmark::measure([&] {
+                for (const auto& call : calls)
+                {
+                    const auto start = clock::now();
+                    cache.register_fact(call.name, call.value, 1);
+                    worst = std::max(worst, clock::now() - start);
+                }
+            });
+
+            const auto mean_seconds = seconds / static_cast<double>(calls.size());
+            if (round == 0 || mean_seconds < best.mean_seconds)
+            {
+                best.mean_seconds = mean_seconds;
+                best.worst_seconds = std::chrono::duration<double>(worst).count();
+            }
+
+            last_cache = std::move(cache);
+        }
+
+        return best;
+    }
+}
+
+BENCHMARK_CASE(fact_cache)
+{
+    const auto fact_count = benchmark::parse_argument(args, 0, DEFAULT_FACT_COUNT);
+    const auto call_count = benchmark::parse_argument(args, 1, DEFAULT_CALL_COUNT);
+
+    const auto calls = generate_calls(fact_count, call_count);
+
+    legacy_fact_cache legacy_cache{};
+    const auto legacy = replay(calls, legacy_cache);
+
+    flat_fact_cache cache{};
+    const auto flat = replay(calls, cache);
+
+    printf("%zu facts, %zu calls, limit %zu, per call (timer included):\n", fact_count, call_count, quest_sync::FACT_CACHE_SIZE_LIMIT);
+    printf("  unordered_map + sort prune  %7.1f ns   worst %8.2f us\n", legacy.mean_seconds * 1e9, legacy.worst_seconds * 1e6);
+    printf("  flat LRU fact_cache         %7.1f ns   worst %8.2f us\n", flat.mean_seconds * 1e9, flat.worst_seconds * 1e6);
+
+    return cache.get_world_state_hash() == cache.rebuild_world_state_hash();
+}
@@ -0,0 +1,127 @@
+#include "benchmark.hpp"
+
+#include <utils/cryptography.hpp>
+#include <utils/io.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+
+// compute_file streaming a large file through the hasher in slices, against reading the whole file into memory and
+// hashing it in one call as the updater used to. Both run on the warm page cache, so this compares CPU and memory
+// traffic, not the disk. The old path also holds the whole file in memory at once.
+// Arguments: [file size in MiB]
+
+namespace
+{
+    constexpr size_t DEFAULT_SIZE_MIB = 512;
+    constexpr size_t WRITE_CHUNK_SIZE = 1024 * 1024;
+
+    class temporary_file
+    {
+      public:
+        explicit temporary_file(const size_t size)
+            : path_(std::filesystem::temp_directory_path() / "w3m_file_hash_benchmark.bin")
+        {
+            std::mt19937_64 random(0x5733);
+            std::string chunk(WRITE_CHUNK_SIZE, '\0');
+
+            std::ofstream stream(this->path_, std::ios::binary | std::ios::trunc);
+            for (size_t written = 0; written < size; written += chunk.size())
+            {
+                for (auto& c : chunk)
+                {
+                    c = static_cast<char>(random());
+                }
+
+                stream.write(chunk.data(), static_cast<std::streamsize>(std::min(chunk.size(), size - written)));
+            }
+
+            this->valid_ = static_cast<bool>(stream);
+        }
+
+        ~temporary_file()
+        {
+            std::error_code error{};
+            std::filesystem::remove(this->path_, error);
+        }
+
+        temporary_file(temporary_file&&) = delete;
+        temporary_file(const temporary_file&) = delete;
+        temporary_file& operator=(temporary_file&&) = delete;
+        temporary_file& operator=(const temporary_file&) = delete;
+
+        const std::filesystem::path& get_path() const
+        {
+            return this->path_;
+        }
+
+        bool is_valid() const
+        {
+            return this->valid_;
+        }
+
+      private:
+        std::filesystem::path path_{};
+        bool valid_{};
+    };
+
+    template <typename Digest, typename Stream, typename Legacy>
+    bool compare(const char* name, const std::filesystem::path& file, const size_t size, Stream&& stream, Legacy&& legacy)
+    {
+        std::optional<Digest> streamed{};
+        const auto stream_seconds = benchmark::measure([&] { streamed = stream(file); });
+
+        std::string whole{};
+        const auto legacy_seconds = benchmark::measure([&] {
+            std::string data{};
+            if (utils::io::read_file(file, &data))
+            {
+                whole = legacy(data);
+            }
+        });
+
+        const auto mib = static_cast<double>(size) / (1024.0 * 1024.0);
+        printf("  %-8s %10.0f %10.0f\n", name, mib / stream_seconds, mib / legacy_seconds);
+
+        return streamed && whole == std::string(reinterpret_cast<const char*>(streamed->data()), streamed->size());
+    }
+}
+
+BENCHMARK_CASE(file_hash)
+{
+    const auto size = benchmark::parse_argument(args, 0, DEFAULT_SIZE_MIB) * 1024 * 1024;
+
+    const temporary_file file(size);
+    if (!file.is_valid())
+    {
+        printf("Failed to write %s\n", file.get_path().string().data());
+        return false;
+    }
+
+    printf("Hashing a %zu MiB file, MiB/s\n", size / (1024 * 1024));
+    printf("  %-8s %10s %10s\n", "", "streamed", "whole");
+
+    auto matches = compare<utils::cryptography::sha1::digest>(
+        "sha1", file.get_path(), size, [](const auto& path) { return utils::cryptography::sha1::compute_file(path); },
+        [](const std::string& data) { return utils::cryptography::sha1::compute(data); });
+
+    matches &= compare<utils::cryptography::sha256::digest>(
+        "sha256", file.get_path(), size, [](const auto& path) { return utils::cryptography::sha256::compute_file(path); },
+        [](const std::string& data) { return utils::cryptography::sha256::compute(data); });
+
+    matches &= compare<utils::cryptography::sha512::digest>(
+        "sha512", file.get_path(), size, [](const auto& path) { return utils::cryptography::sha512::compute_file(path); },
+        [](const std::string& data) { return utils::cryptography::sha512::compute(data); });
+
+    if (!matches)
+    {
+        printf("Streamed and whole-file digests differ\n");
+    }
+
+    return matches;
+}
@@ -0,0 +1,83 @@
+#include "benchmark.hpp"
+
+#include <utils/cryptography.hpp>
+#include <utils/hash.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+
+// utils::hash against std::hash and the jenkins one-at-a-time hash, at a fact name, a short packet and a block size,
+// then the block size with each block loop the CPU supports.
+
+namespace
+{
+    template <typename Hash>
+    double measure_throughput(const std::string_view input, const size_t size, Hash&& hash)
+    {
+        uint64_t sink = 0;
+        const auto seconds = benchmark::measure_per_call([&] {
+            // Chained through the input offset so calls can't be hoisted or overlapped
+            sink += hash(input.substr(static_cast<size_t>(sink & 1), size));
+        });
+
+        // Keeps the chain alive
+        if (sink == 0x5733)
+        {
+            printf(" ");
+        }
+
+        return static_cast<double>(size) / seconds / 1e9;
+    }
+}
+
+BENCHMARK_CASE(hash)
+{
+    std::mt19937_64 random(0x5733);
+
+    std::string input(64 * 1024 + 1, '\0');
+    for (auto& c : input)
+    {
+        c = static_cast<char>(random());
+    }
+
+    printf("Throughput in GB/s, xxh3 block loop: %s\n", std::string(utils::hash::get_name(utils::hash::get_best_instruction_set())).c_str());
+    printf("  %-8s %9s %10s %9s\n", "size", "xxh3", "std::hash", "jenkins");
+
+    for (const size_t size : {size_t{24}, size_t{200}, size_t{64 * 1024}})
+    {
+        const auto xxh3 = measure_throughput(input, size, [](const std::string_view value) { return utils::hash::compute(value); });
+        const auto standard =
+            measure_throughput(input, size, [](const std::string_view value) { return std::hash<std::string_view>{}(value); });
+        const auto jenkins = measure_throughput(input, size, [](const std::string_view value) {
+            return utils::cryptography::jenkins_one_at_a_time::compute(value.data(), value.size());
+        });
+
+        printf("  %-8zu %9.2f %10.2f %9.2f\n", size, xxh3, standard, jenkins);
+    }
+
+    const auto block = std::string_view(input).substr(0, 64 * 1024);
+    const auto expected = utils::hash::compute(block);
+    bool matches = true;
+
+    printf("\n  %-8s %9s\n", "loop", "65536");
+
+    for (const auto instructions : {utils::hash::instruction_set::generic, utils::hash::instruction_set::sse2, utils::hash::instruction_set::avx2})
+    {
+        if (!utils::hash::is_supported(instructions))
+        {
+            continue;
+        }
+
+        const auto throughput = measure_throughput(
+            input, block.size(), [instructions](const std::string_view value) { return utils::hash::compute(value, instructions); });
+
+        printf("  %-8s %9.2f\n", std::string(utils::hash::get_name(instructions)).c_str(), throughput);
+        matches &= utils::hash::compute(block, instructions) == expected;
+    }
+
+    // Reference value from XXH3_64bits
+    return matches && utils::hash::compute("") == 0x2D06800538D394C2;
+}
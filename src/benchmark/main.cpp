@@ -0,0 +1,108 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+extern "C"
+{
+    int s_read_arc4random(void*, size_t)
+    {
+        return -1;
+    }
+
+    int s_read_getrandom(void*, size_t)
+    {
+        return -1;
+    }
+
+    int s_read_urandom(void*, size_t)
+    {
+        return -1;
+    }
+
+    int s_read_ltm_rng(void*, size_t)
+    {
+        return -1;
+    }
+}
+
+namespace benchmark
+{
+    namespace
+    {
+        struct benchmark_case
+        {
+            const char* name{};
+            function run{};
+        };
+
+        std::vector<benchmark_case>& get_cases()
+        {
+            static std::vector<benchmark_case> cases{};
+            return cases;
+        }
+    }
+
+    registration::registration(const char* name, const function run)
+    {
+        get_cases().push_back({name, run});
+    }
+
+    size_t parse_argument(const arguments args, const size_t index, const size_t default_value)
+    {
+        if (args.size() <= index)
+        {
+            return default_value;
+        }
+
+        const auto value = strtoull(args[index], nullptr, 10);
+        return value ? static_cast<size_t>(value) : default_value;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    const std::string_view selected = argc > 1 ? argv[1] : "";
+    const benchmark::arguments args(argv + std::min(argc, 2), argv + argc);
+
+    auto found = false;
+    auto failed = false;
+
+    for (const auto& benchmark_case : benchmark::get_cases())
+    {
+        if (!selected.empty() && selected != benchmark_case.name)
+        {
+            continue;
+        }
+
+        found = true;
+        printf("=== %s ===\n", benchmark_case.name);
+        (void)fflush(stdout);
+
+        if (!benchmark_case.run(args))
+        {
+            printf("%s: results failed their checks\n", benchmark_case.name);
+            failed = true;
+        }
+
+        printf("\n");
+        (void)fflush(stdout);
+    }
+
+    if (!found)
+    {
+        printf("Unknown benchmark: %s\nAvailable:", selected.data());
+        for (const auto& benchmark_case : benchmark::get_cases())
+        {
+            printf(" %s", benchmark_case.name);
+        }
+
+        printf("\n");
+        return 1;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include "benchmark.hpp"
+
+#include <network/packet_codec.hpp>
+
+#include <cstdio>
+
+// Schema codec against the raw struct copies it replaced, encode plus decode through reused storage.
+// String fields are measured in the steady state, with their dictionary ids already acknowledged.
+
+namespace
+{
+    using namespace network::protocol;
+
+    struct codec_result
+    {
+        size_t raw_size{};
+        size_t schema_size{};
+        double raw_seconds{};
+        double schema_seconds{};
+        bool matches{};
+    };
+
+    template <typename Packet>
+    std::string encode(const Packet& packet)
+    {
+        network::string_encoder strings{};
+        utils::buffer_serializer buffer{};
+        write(buffer, strings, packet);
+
+        return buffer.move_buffer();
+    }
+
+    // Every schema lists all members, so packets with the same encoding are equal
+    template <typename Packet>
+    bool is_same_packet(const Packet& a, const Packet& b)
+    {
+        return encode(a) == encode(b);
+    }
+
+    template <typename Packet>
+    codec_result measure_codec(const Packet& packet)
+    {
+        codec_result result{};
+
+        std::string storage{};
+        Packet decoded{};
+
+        network::string_dictionary dictionary{};
+
+        // First send defines the strings, after the acknowledgement only ids travel
+        {
+            utils::buffer_serializer buffer(storage);
+            write(buffer, dictionary.outgoing, packet);
+
+            utils::buffer_deserializer reader(buffer.get_view());
+            read(reader, dictionary.incoming, decoded);
+
+            for (const auto id : dictionary.incoming.take_acknowledgements())
+            {
+                dictionary.outgoing.acknowledge(id);
+            }
+        }
+
+        result.raw_seconds = benchmark::measure_per_call([&] {
+            utils::buffer_serializer buffer(storage);
+            buffer.write(packet);
+
+            utils::buffer_deserializer reader(buffer.get_view());
+            decoded = reader.read<Packet>();
+        });
+
+        result.raw_size = storage.size();
+        result.matches = is_same_packet(packet, decoded);
+        decoded = {};
+
+        result.schema_seconds = benchmark::measure_per_call([&] {
+            utils::buffer_serializer buffer(storage);
+            write(buffer, dictionary.outgoing, packet);
+
+            utils::buffer_deserializer reader(buffer.get_view());
+            read(reader, dictionary.incoming, decoded);
+        });
+
+        result.schema_size = storage.size();
+        result.matches &= is_same_packet(packet, decoded);
+
+        return result;
+    }
+
+    template <typename Packet>
+    bool print_codec(const char* name, const Packet& packet)
+    {
+        const auto result = measure_codec(packet);
+
+        printf("  %-13s %4zu B -> %4zu B   raw %6.1f ns   schema %6.1f ns%s\n", name, result.raw_size, result.schema_size,
+               result.raw_seconds * 1e9, result.schema_seconds * 1e9, result.matches ? "" : "  MISMATCH");
+
+        return result.matches;
+    }
+}
+
+BENCHMARK_CASE(packet_codec)
+{
+    player_state_packet player_state{};
+    player_state.player_guid = 0x1122334455667788;
+    player_state.position = {1024.5, -377.25, 12.0, 1.0};
+    player_state.angles = {0.0, 92.5, 0.0};
+    player_state.velocity = {3.5, -1.25, 0.0, 0.0};
+    player_state.move_type = 2;
+    player_state.speed = 4.5f;
+    for (size_t i = 0; i < player_state.binary_state.size(); ++i)
+    {
+        player_state.binary_state[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    heartbeat_packet heartbeat{};
+    heartbeat.player_guid = 0x1122334455667788;
+    heartbeat.total_crowns = 15420;
+    heartbeat.world_fact_hash = 0xDEADBEEF;
+    heartbeat.script_version = 3;
+    heartbeat.game_time = 86400 * 12 + 3600;
+    heartbeat.weather_id = 4;
+    heartbeat.timestamp = 1234567890123;
+
+    quest_lock_packet quest_lock{};
+    quest_lock.is_locked = true;
+    quest_lock.scene_id = 4711;
+    quest_lock.player_guid = 0x1122334455667788;
+    quest_lock.timestamp = 123456;
+
+    fact_packet fact{};
+    copy_string(fact.fact_name, "q104_ciri_found_in_crookback_bog");
+    fact.value = 3;
+    fact.timestamp = 1234567890123;
+
+    attack_packet attack{};
+    attack.attacker_guid = 0x1122334455667788;
+    copy_string(attack.target_tag, "drowner_001");
+    attack.damage_amount = 125.5f;
+    attack.type = attack_type::heavy;
+    attack.timestamp = 1234567890123;
+
+    printf("Encode + decode per packet:\n");
+
+    auto matches = print_codec("player_state", player_state);
+    matches &= print_codec("heartbeat", heartbeat);
+    matches &= print_codec("quest_lock", quest_lock);
+    matches &= print_codec("fact", fact);
+    matches &= print_codec("attack", attack);
+
+    return matches;
+}
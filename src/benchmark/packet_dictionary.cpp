@@ -0,0 +1,376 @@
+#include "benchmark.hpp"
+
+#include <game/structs.hpp>
+#include <network/packet_codec.hpp>
+#include <network/packet_dictionary.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Trains the datagram dictionary on session traffic written by the packet codecs and compares it with plain zlib and
+// the embedded dictionary on traffic from another seed. With a path, the trained dictionary is written there as the
+// source of network/packet_dictionary.cpp, retrain it this way whenever game::PROTOCOL changes the wire layout.
+// Arguments: [packet_dictionary.cpp to write]
+
+namespace
+{
+    using namespace network::protocol;
+
+    constexpr uint32_t TRAINING_SEED = 1;
+    constexpr uint32_t EVALUATION_SEED = 2;
+    constexpr size_t TRAINING_DATAGRAMS = 20000;
+    constexpr size_t EVALUATION_DATAGRAMS = 5000;
+
+    constexpr int LEVEL = utils::compression::zlib::default_level;
+
+    constexpr const char* PLAYER_NAMES[] = {"Geralt", "Ciri", "Yennefer", "Lambert"};
+    constexpr const char* FACT_NAMES[] = {
+        "q001_nightmare_ended", "q002_yen_arrives",      "mq1001_done",         "sq101_keira_met",
+        "q103_baron_talked",    "tutorial_combat_done",  "witcher_sense_used",  "q105_wild_hunt_seen",
+        "sq106_killed_monster", "mq3035_philippa_found", "kill_count_drowner",  "q201_ship_arrived",
+        "q301_dreamer_found",   "sq302_roche_joined",    "q310_ciri_saved",     "discovered_place_of_power_01",
+        "geralt_has_horse",     "crafting_tutorial_done",
+    };
+    constexpr const char* NPC_TAGS[] = {"drowner_001", "drowner_002",   "ghoul_alpha",  "griffin_boss",
+                                        "nekker_03",   "bandit_leader", "wolf_pack_01", "wraith_14"};
+    constexpr const char* ITEM_NAMES[] = {"Crowns", "Relic Sword", "Griffin Trophy", "Witcher Silver Sword", "Swallow Potion"};
+
+    template <typename T, size_t N>
+    const T& pick(std::mt19937& random, const T (&values)[N])
+    {
+        return values[random() % N];
+    }
+
+    // Datagram payloads as manager::send compresses them: command, separator, data. The mix follows a four player
+    // session: mostly player states, then combat, fact batches, heartbeats and loot.
+    class session_traffic
+    {
+      public:
+        explicit session_traffic(const uint32_t seed)
+            : random_(seed)
+        {
+            for (size_t i = 0; i < this->players_.size(); ++i)
+            {
+                auto& player = this->players_[i];
+                player.guid = this->random_() | (static_cast<uint64_t>(this->random_()) << 32);
+                copy_string(player.name, PLAYER_NAMES[i]);
+                player.state.position = {this->uniform(-2000, 2000), this->uniform(-2000, 2000), this->uniform(0, 80), 1.0};
+            }
+        }
+
+        std::vector<std::string> generate(const size_t count)
+        {
+            std::vector<std::string> datagrams{};
+            datagrams.reserve(count);
+
+            while (datagrams.size() < count)
+            {
+                datagrams.push_back(this->next());
+            }
+
+            return datagrams;
+        }
+
+      private:
+        std::mt19937 random_;
+        std::array<game::player, 4> players_{};
+
+        // Client to server and server to client dictionaries
+        std::array<network::string_encoder, 2> strings_{};
+
+        double uniform(const double min, const double max)
+        {
+            return std::uniform_real_distribution<double>(min, max)(this->random_);
+        }
+
+        uint64_t get_timestamp()
+        {
+            return 1700000000000ull + this->random_();
+        }
+
+        uint64_t get_guid()
+        {
+            return this->players_[this->random_() % this->players_.size()].guid;
+        }
+
+        void move(game::player& player)
+        {
+            auto& state = player.state;
+            for (size_t i = 0; i < 2; ++i)
+            {
+                state.velocity[i] = this->uniform(-5, 5);
+                state.position[i] += state.velocity[i] * 0.03;
+            }
+
+            state.angles[1] = this->uniform(-180, 180);
+            state.speed = static_cast<float>(this->uniform(0, 6));
+            state.move_type = static_cast<int32_t>(this->random_() % 4);
+            ++state.state_id;
+        }
+
+        std::string next()
+        {
+            utils::buffer_serializer buffer{};
+            buffer.write(game::PROTOCOL);
+
+            auto& strings = this->strings_[this->random_() % this->strings_.size()];
+            const auto roll = this->random_() % 100;
+
+            const char* command{};
+
+            if (roll < 40)
+            {
+                command = "states";
+                buffer.write(static_cast<uint32_t>(this->players_.size()));
+
+                for (auto& player : this->players_)
+                {
+                    this->move(player);
+                    buffer.write(player);
+                }
+            }
+            else if (roll < 80)
+            {
+                command = "state";
+                auto& player = this->players_[this->random_() % this->players_.size()];
+                this->move(player);
+                buffer.write(player);
+            }
+            else if (roll < 86)
+            {
+                command = "attack";
+                attack_packet attack{};
+                attack.attacker_guid = this->get_guid();
+                copy_string(attack.target_tag, pick(this->random_, NPC_TAGS));
+                attack.damage_amount = static_cast<float>(this->uniform(10, 400));
+                attack.type = static_cast<attack_type>(this->random_() % 3);
+                attack.timestamp = this->get_timestamp();
+                write(buffer, strings, attack);
+            }
+            else if (roll < 92)
+            {
+                command = "npc_update";
+                npc_update_packet update{};
+                copy_string(update.target_tag, pick(this->random_, NPC_TAGS));
+                update.damage_amount = static_cast<float>(this->uniform(10, 900));
+                update.hit_count = static_cast<uint16_t>(this->random_() % 5 + 1);
+                update.killed = this->random_() % 6 == 0;
+                update.killer_guid = update.killed ? this->get_guid() : 0;
+                update.timestamp = this->get_timestamp();
+                write(buffer, strings, update);
+            }
+            else if (roll < 96)
+            {
+                command = "fact_batch";
+                fact_batch_packet batch{};
+                batch.facts.resize(this->random_() % 6 + 1);
+
+                for (auto& fact : batch.facts)
+                {
+                    copy_string(fact.fact_name, pick(this->random_, FACT_NAMES));
+                    fact.value = static_cast<int32_t>(this->random_() % 3);
+                    fact.update = this->random_() % 4 == 0 ? fact_update::add : fact_update::set;
+                    fact.timestamp = this->get_timestamp();
+                }
+
+                write(buffer, strings, batch);
+            }
+            else if (roll < 98)
+            {
+                command = "heartbeat";
+                heartbeat_packet heartbeat{};
+                heartbeat.player_guid = this->get_guid();
+                heartbeat.total_crowns = this->random_() % 20000;
+                heartbeat.world_fact_hash = this->random_();
+                heartbeat.script_version = 3;
+                heartbeat.game_time = this->random_() % 86400;
+                heartbeat.weather_id = static_cast<uint16_t>(this->random_() % 12);
+                heartbeat.timestamp = this->get_timestamp();
+                write(buffer, strings, heartbeat);
+            }
+            else
+            {
+                command = "loot";
+                loot_packet loot{};
+                copy_string(loot.item_name, pick(this->random_, ITEM_NAMES));
+                loot.quantity = this->random_() % 500 + 1;
+                loot.player_guid = this->get_guid();
+                loot.timestamp = this->random_();
+                write(buffer, strings, loot);
+            }
+
+            std::string datagram = command;
+            datagram.push_back(' ');
+            datagram.append(buffer.get_view());
+
+            return datagram;
+        }
+    };
+
+    struct evaluation
+    {
+        size_t raw_size{};
+        size_t sent_size{};
+        double compress_seconds{};
+        double decompress_seconds{};
+        bool matches{true};
+    };
+
+    // Datagrams that don't get smaller are sent as they are, like manager::send does
+    template <typename Compressor, typename Decompressor>
+    evaluation evaluate(const std::vector<std::string>& datagrams, Compressor& compressor, Decompressor& decompressor)
+    {
+        evaluation result{};
+
+        std::vector<std::string> compressed(datagrams.size());
+        result.compress_seconds = benchmark::measure([&] {
+            for (size_t i = 0; i < datagrams.size(); ++i)
+            {
+                result.matches &= compressor.compress(compressed[i], datagrams[i], LEVEL);
+            }
+        });
+
+        std::string decompressed{};
+        result.decompress_seconds = benchmark::measure([&] {
+            for (size_t i = 0; i < datagrams.size(); ++i)
+            {
+                result.matches &= decompressor.decompress(decompressed, compressed[i]) && decompressed == datagrams[i];
+            }
+        });
+
+        for (size_t i = 0; i < datagrams.size(); ++i)
+        {
+            result.raw_size += datagrams[i].size();
+            result.sent_size += std::min(datagrams[i].size(), compressed[i].size());
+        }
+
+        const auto count = static_cast<double>(datagrams.size());
+        result.compress_seconds /= count;
+        result.decompress_seconds /= count;
+
+        return result;
+    }
+
+    evaluation evaluate(const std::vector<std::string>& datagrams)
+    {
+        utils::compression::zlib::compressor compressor{};
+        utils::compression::zlib::decompressor decompressor{};
+
+        return evaluate(datagrams, compressor, decompressor);
+    }
+
+    evaluation evaluate(const std::vector<std::string>& datagrams, const utils::compression::zlib::dictionary& dictionary)
+    {
+        utils::compression::zlib::compressor compressor(dictionary);
+        utils::compression::zlib::decompressor decompressor(dictionary);
+
+        return evaluate(datagrams, compressor, decompressor);
+    }
+
+    bool print_evaluation(const char* name, const evaluation& result)
+    {
+        printf("  %-22s %.3f   compress %5.1f us   decompress %5.1f us%s\n", name,
+               static_cast<double>(result.sent_size) / static_cast<double>(result.raw_size), result.compress_seconds * 1e6,
+               result.decompress_seconds * 1e6, result.matches ? "" : "  MISMATCH");
+
+        return result.matches;
+    }
+
+    std::string generate_source(const std::string_view dictionary)
+    {
+        std::string source = "#include \"packet_dictionary.hpp\"\n"
+                             "\n"
+                             "#include \"../game/structs.hpp\"\n"
+                             "\n"
+                             "// Generated by the packet_dictionary benchmark case, see src/benchmark/packet_dictionary.cpp\n"
+                             "\n"
+                             "namespace network\n"
+                             "{\n"
+                             "    namespace\n"
+                             "    {\n";
+
+        source += "        constexpr uint32_t TRAINED_PROTOCOL = " + std::to_string(game::PROTOCOL) + ";\n";
+        source += "        static_assert(TRAINED_PROTOCOL == game::PROTOCOL, \"Retrain the packet dictionary for the new game::PROTOCOL\");\n\n";
+        source += "        // Command texts, interned names and padded player records of a typical session, most common last\n"
+                  "        constexpr unsigned char dictionary_data[] = {\n";
+
+        char byte[8]{};
+        for (size_t i = 0; i < dictionary.size(); ++i)
+        {
+            if (i % 16 == 0)
+            {
+                source += "            ";
+            }
+
+            (void)snprintf(byte, sizeof(byte), "0x%02X,", static_cast<uint8_t>(dictionary[i]));
+            source += byte;
+            source += (i % 16 == 15 || i + 1 == dictionary.size()) ? "\n" : " ";
+        }
+
+        source += "        };\n"
+                  "    }\n"
+                  "\n"
+                  "    const utils::compression::zlib::dictionary& get_packet_dictionary()\n"
+                  "    {\n"
+                  "        static const utils::compression::zlib::dictionary dictionary(\n"
+                  "            std::string(reinterpret_cast<const char*>(dictionary_data), sizeof(dictionary_data)));\n"
+                  "        return dictionary;\n"
+                  "    }\n"
+                  "\n"
+                  "    uint32_t get_packet_dictionary_protocol()\n"
+                  "    {\n"
+                  "        return TRAINED_PROTOCOL;\n"
+                  "    }\n"
+                  "}\n";
+
+        return source;
+    }
+}
+
+BENCHMARK_CASE(packet_dictionary)
+{
+    const auto training = session_traffic(TRAINING_SEED).generate(TRAINING_DATAGRAMS);
+    const auto held_out = session_traffic(EVALUATION_SEED).generate(EVALUATION_DATAGRAMS);
+
+    std::string trained_data{};
+    const auto training_seconds = benchmark::measure([&] { trained_data = utils::compression::zlib::train_dictionary(training); });
+    const utils::compression::zlib::dictionary trained(trained_data);
+
+    const auto& embedded = network::get_packet_dictionary();
+
+    printf("Trained %zu bytes on %zu datagrams in %.2f s\n", trained_data.size(), training.size(), training_seconds);
+    printf("Sent/raw bytes on %zu held-out datagrams at level %d, per datagram:\n", held_out.size(), LEVEL);
+
+    auto matches = print_evaluation("zlib", evaluate(held_out));
+    matches &= print_evaluation("embedded dictionary", evaluate(held_out, embedded));
+    matches &= print_evaluation("trained dictionary", evaluate(held_out, trained));
+
+    // The protocol itself is pinned by a static_assert in the generated source, this catches trainer changes
+    const auto stale = embedded.get_id() != trained.get_id();
+    if (stale)
+    {
+        printf("The embedded dictionary (protocol %u) differs from the trained one (protocol %u)\n",
+               network::get_packet_dictionary_protocol(), game::PROTOCOL);
+    }
+
+    if (args.empty())
+    {
+        return matches && !stale;
+    }
+
+    std::ofstream output(args[0], std::ios::binary | std::ios::trunc);
+    output << generate_source(trained_data);
+    output.close();
+
+    if (!output)
+    {
+        printf("Failed to write %s\n", args[0]);
+        return false;
+    }
+
+    printf("Wrote %s\n", args[0]);
+    return matches;
+}
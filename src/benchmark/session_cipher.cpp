@@ -0,0 +1,123 @@
+#include "benchmark.hpp"
+
+#include <security/session_cipher.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ChaCha20-Poly1305 session sealing per packet, from a bare header to the 8 KiB packet budget: seal alone, then seal
+// plus open on the peer's cipher. Cycles are time stamp counter ticks, which run at the nominal clock.
+
+namespace
+{
+    constexpr size_t HEADER_SIZE = sizeof(int32_t);
+
+    double get_counter_frequency()
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        uint64_t start_ticks{};
+        const auto seconds = benchmark::measure([&] {
+            start_ticks = __rdtsc();
+            const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+            while (std::chrono::steady_clock::now() < end)
+            {
+            }
+        });
+
+        return static_cast<double>(__rdtsc() - start_ticks) / seconds;
+#else
+        return 0.0;
+#endif
+    }
+
+    security::session_keys make_keys(const uint8_t send, const uint8_t receive)
+    {
+        security::session_keys keys{};
+        keys.send.fill(send);
+        keys.receive.fill(receive);
+
+        return keys;
+    }
+
+    struct cipher_result
+    {
+        double seal_seconds{};
+        double cycle_seconds{};
+        bool matches{};
+    };
+
+    cipher_result measure_cipher(const size_t size)
+    {
+        security::session_cipher sender(make_keys(1, 2));
+        security::session_cipher receiver(make_keys(2, 1));
+
+        std::string plaintext(size, '\0');
+        for (size_t i = 0; i < size; ++i)
+        {
+            plaintext[i] = static_cast<char>(i * 31);
+        }
+
+        std::string packet{};
+        packet.reserve(HEADER_SIZE + security::SEAL_OVERHEAD + size);
+
+        const auto prepare = [&] {
+            packet.assign(HEADER_SIZE + security::SEQUENCE_SIZE, '\0');
+            packet.append(plaintext);
+        };
+
+        cipher_result result{};
+        result.matches = true;
+
+        result.seal_seconds = benchmark::measure_per_call([&] {
+            prepare();
+            result.matches &= sender.seal(packet, HEADER_SIZE);
+        });
+
+        result.cycle_seconds = benchmark::measure_per_call([&] {
+            prepare();
+            result.matches &= sender.seal(packet, HEADER_SIZE) && receiver.open(packet, HEADER_SIZE);
+        });
+
+        result.matches &= packet.size() == HEADER_SIZE + security::SEQUENCE_SIZE + size &&
+                          memcmp(packet.data() + HEADER_SIZE + security::SEQUENCE_SIZE, plaintext.data(), size) == 0;
+
+        // Replays must fail
+        prepare();
+        result.matches &= sender.seal(packet, HEADER_SIZE);
+
+        auto replay = packet;
+        result.matches &= receiver.open(packet, HEADER_SIZE) && !receiver.open(replay, HEADER_SIZE);
+
+        return result;
+    }
+}
+
+BENCHMARK_CASE(session_cipher)
+{
+    const auto frequency = get_counter_frequency();
+
+    printf("Per packet, cycles per payload byte in brackets (counter at %.2f GHz):\n", frequency / 1e9);
+    printf("  %-8s %22s %22s\n", "payload", "seal", "seal + open");
+
+    auto matches = true;
+
+    for (const size_t size : {size_t{16}, size_t{64}, size_t{200}, size_t{1200}, size_t{8 * 1024 - 64}})
+    {
+        const auto result = measure_cipher(size);
+        const auto bytes = static_cast<double>(size);
+
+        printf("  %-8zu %9.1f ns (%6.2f) %9.1f ns (%6.2f)%s\n", size, result.seal_seconds * 1e9, result.seal_seconds * frequency / bytes,
+               result.cycle_seconds * 1e9, result.cycle_seconds * frequency / bytes, result.matches ? "" : "  MISMATCH");
+
+        matches &= result.matches;
+    }
+
+    return matches;
+}
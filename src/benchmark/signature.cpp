@@ -0,0 +1,210 @@
+#include "benchmark.hpp"
+
+#include <utils/pattern_scanner.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Measures utils::pattern_scanner on a synthetic image, so scanner changes can be compared without the game.
+// Arguments: [image size in MiB] [pattern count]
+
+namespace
+{
+    constexpr size_t DEFAULT_IMAGE_SIZE = 100;
+    constexpr size_t DEFAULT_PATTERN_COUNT = 500;
+
+    // Stand-in for x86-64 code: common instruction encodings with random operands, padding between functions.
+    // The byte distribution is as skewed as in a real module, which is what anchor selection depends on.
+    struct instruction_template
+    {
+        std::vector<uint8_t> opcode{};
+        size_t operand_size{};
+    };
+
+    const std::vector<instruction_template>& get_instruction_templates()
+    {
+        static const std::vector<instruction_template> templates{
+            {{0x48, 0x8B, 0x05}, 4}, // mov rax, [rip + disp32]
+            {{0x48, 0x8D, 0x0D}, 4}, // lea rcx, [rip + disp32]
+            {{0x48, 0x89, 0x5C, 0x24}, 1}, // mov [rsp + disp8], rbx
+            {{0x48, 0x8B, 0x4C, 0x24}, 1}, // mov rcx, [rsp + disp8]
+            {{0x48, 0x83, 0xEC}, 1}, // sub rsp, imm8
+            {{0x48, 0x83, 0xC4}, 1}, // add rsp, imm8
+            {{0x48, 0x8B, 0xC8}, 0}, // mov rcx, rax
+            {{0x48, 0x85, 0xC0}, 0}, // test rax, rax
+            {{0x33, 0xC0}, 0}, // xor eax, eax
+            {{0x0F, 0x84}, 4}, // jz rel32
+            {{0x74}, 1}, // jz rel8
+            {{0x75}, 1}, // jnz rel8
+            {{0xE8}, 4}, // call rel32
+            {{0xE9}, 4}, // jmp rel32
+            {{0xFF, 0x15}, 4}, // call [rip + disp32]
+            {{0xBA}, 4}, // mov edx, imm32
+            {{0x40, 0x53}, 0}, // push rbx
+            {{0x5B}, 0}, // pop rbx
+            {{0xC3}, 0}, // ret
+        };
+
+        return templates;
+    }
+
+    std::vector<uint8_t> generate_image(const size_t size, std::mt19937_64& random)
+    {
+        const auto& templates = get_instruction_templates();
+
+        std::vector<uint8_t> image{};
+        image.reserve(size + 64);
+
+        while (image.size() < size)
+        {
+            const auto value = random();
+            if (value % 64 == 0)
+            {
+                // Padding between functions
+                image.insert(image.end(), 1 + (value >> 8) % 15, (value & 0x100) ? 0xCC : 0x00);
+                continue;
+            }
+
+            const auto& instruction = templates[(value >> 8) % templates.size()];
+            image.insert(image.end(), instruction.opcode.begin(), instruction.opcode.end());
+
+            // Operands are mostly small displacements, positive or negative
+            auto operand = (value >> 16) % 4 == 0 ? random() : ((value >> 18) % 0x400) - ((value & 0x200) ? 0x400 : 0);
+            for (size_t i = 0; i < instruction.operand_size; ++i)
+            {
+                image.push_back(static_cast<uint8_t>(operand));
+                operand >>= 8;
+            }
+        }
+
+        image.resize(size);
+        return image;
+    }
+
+    // Cuts patterns out of the image like hand written signatures: 12 to 40 bytes, about a quarter of them
+    // wildcards, first and last byte fixed. Each pattern matches at least once.
+    std::vector<std::string> generate_patterns(const std::vector<uint8_t>& image, const size_t count, std::mt19937_64& random)
+    {
+        std::vector<std::string> patterns{};
+        patterns.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto length = 12 + random() % 29;
+            const auto offset = random() % (image.size() - length);
+
+            std::string pattern{};
+            for (size_t j = 0; j < length; ++j)
+            {
+                const auto is_wildcard = j > 0 && j + 1 < length && random() % 4 == 0;
+
+                char byte[4]{};
+                snprintf(byte, sizeof(byte), "%02X ", image[offset + j]);
+
+                pattern += is_wildcard ? "? " : byte;
+            }
+
+            patterns.emplace_back(std::move(pattern));
+        }
+
+        return patterns;
+    }
+
+    size_t count_matches(const std::vector<std::vector<size_t>>& matches)
+    {
+        size_t count = 0;
+        for (const auto& pattern_matches : matches)
+        {
+            count += pattern_matches.size();
+        }
+
+        return count;
+    }
+}
+
+BENCHMARK_CASE(signature)
+{
+    using namespace utils::pattern_scanner;
+    using benchmark::measure;
+
+    const auto image_size = benchmark::parse_argument(args, 0, DEFAULT_IMAGE_SIZE) * 1024 * 1024;
+    const auto pattern_count = benchmark::parse_argument(args, 1, DEFAULT_PATTERN_COUNT);
+
+    std::mt19937_64 random(0x5733);
+    const auto image = generate_image(image_size, random);
+    const auto pattern_texts = generate_patterns(image, pattern_count, random);
+
+    std::vector<pattern> patterns{};
+    patterns.reserve(pattern_texts.size());
+    for (const auto& text : pattern_texts)
+    {
+        patterns.emplace_back(text);
+    }
+
+    const auto image_mib = static_cast<double>(image.size()) / (1024 * 1024);
+    printf("Image: %.0f MiB, %zu patterns, best instruction set: %s\n\n", image_mib, patterns.size(),
+           get_name(get_best_instruction_set()).data());
+
+    std::vector<std::vector<size_t>> reference{};
+    auto failed = false;
+
+    for (const auto instructions : {instruction_set::generic, instruction_set::sse42, instruction_set::avx2})
+    {
+        if (!is_supported(instructions))
+        {
+            printf("%-8s not supported\n", get_name(instructions).data());
+            continue;
+        }
+
+        for (const size_t thread_count : {size_t{1}, size_t{0}})
+        {
+            scan_options options{};
+            options.thread_count = thread_count;
+            options.instructions = instructions;
+
+            std::vector<std::vector<size_t>> matches{};
+            const auto seconds = measure([&] { matches = find(image, patterns, options); });
+
+            if (reference.empty())
+            {
+                reference = matches;
+            }
+            else if (matches != reference)
+            {
+                failed = true;
+            }
+
+            printf("%-8s %-9s %8.3f s %10.1f MiB/s %9zu matches%s\n", get_name(instructions).data(),
+                   thread_count == 1 ? "1 thread" : "default", seconds, image_mib / seconds, count_matches(matches),
+                   matches == reference ? "" : "  MISMATCH");
+        }
+    }
+
+    // One pass per pattern, as with separate signatures
+    constexpr size_t SEPARATE_PATTERNS = 20;
+    const auto separate_count = std::min(SEPARATE_PATTERNS, patterns.size());
+
+    const auto separate_seconds = measure([&] {
+        for (size_t i = 0; i < separate_count; ++i)
+        {
+            const auto matches = find(image, {patterns[i]});
+            if (matches.front() != reference[i])
+            {
+                failed = true;
+            }
+        }
+    });
+
+    printf("\nSeparate passes: %.3f s for %zu patterns, %.3f s extrapolated to all\n", separate_seconds, separate_count,
+           separate_seconds / static_cast<double>(separate_count) * static_cast<double>(patterns.size()));
+
+    if (failed)
+    {
+        printf("Results differ between implementations\n");
+    }
+
+    return !failed;
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <network/protocol.hpp>
+
+namespace quest_sync
+{
+    constexpr size_t MAX_FACT_NAME_LENGTH = 128;
+    constexpr size_t FACT_CACHE_SIZE_LIMIT = 1024; // Default maximum of cached facts, see set_fact_limit
+
+    // ---------------------------------------------------------------------------
+    // QUEST FACT STRUCTURE
+    // ---------------------------------------------------------------------------
+    // Represents a synchronized world fact for quest progression
+
+    using network::protocol::fact_update;
+
+    struct quest_fact
+    {
+        std::array<char, MAX_FACT_NAME_LENGTH> fact_name{}; // Inline, truncated like fact_packet
+        int32_t value{0};
+        uint64_t timestamp{0};
+        uint64_t player_guid{0};              // Player who triggered this fact
+        uint32_t fact_hash{0};                // Hash for fast comparison
+        fact_update update{fact_update::set}; // Pending updates only: an add carries a delta
+    };
+
+    // ---------------------------------------------------------------------------
+    // FACT CACHE
+    // ---------------------------------------------------------------------------
+    // Flat open-addressing table keyed by fact hash with an intrusive LRU list
+    // Entries sit in one preallocated array with their names inline, so registering
+    // a fact doesn't allocate and evicting the least recently registered one is O(1)
+
+    class fact_cache
+    {
+      public:
+        explicit fact_cache(size_t limit = FACT_CACHE_SIZE_LIMIT)
+        {
+            set_limit(limit);
+        }
+
+        quest_fact* find(uint32_t fact_hash)
+        {
+            const auto slot = find_slot(fact_hash);
+            return slot == NONE ? nullptr : &m_entries[m_slots[slot]].fact;
+        }
+
+        const quest_fact* find(uint32_t fact_hash) const
+        {
+            const auto slot = find_slot(fact_hash);
+            return slot == NONE ? nullptr : &m_entries[m_slots[slot]].fact;
+        }
+
+        // Returns the fact's entry, now the most recent one, and whether it was just created
+        // A full cache first evicts its least recent fact and hands it to on_evict
+        template <typename OnEvict>
+        std::pair<quest_fact*, bool> emplace(uint32_t fact_hash, OnEvict&& on_evict)
+        {
+            auto slot = home_slot(fact_hash);
+
+            while (m_slots[slot] != NONE)
+            {
+                const auto index = m_slots[slot];
+                if (m_entries[index].fact.fact_hash == fact_hash)
+                {
+                    unlink(index);
+                    link_front(index);
+                    return {&m_entries[index].fact, false};
+                }
+
+                slot = (slot + 1) & m_mask;
+            }
+
+            uint32_t index = NONE;
+
+            if (m_size == m_limit)
+            {
+                index = m_tail;
+                on_evict(static_cast<const quest_fact&>(m_entries[index].fact));
+
+                unlink(index);
+                remove_slot(find_slot(m_entries[index].fact.fact_hash));
+                --m_size;
+
+                // Backward shifting may have moved an entry into the slot we found
+                slot = home_slot(fact_hash);
+                while (m_slots[slot] != NONE)
+                {
+                    slot = (slot + 1) & m_mask;
+                }
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_size);
+            }
+
+            m_entries[index].fact = quest_fact{};
+            m_entries[index].fact.fact_hash = fact_hash;
+            m_slots[slot] = index;
+            link_front(index);
+            ++m_size;
+
+            return {&m_entries[index].fact, true};
+        }
+
+        void erase(uint32_t fact_hash)
+        {
+            const auto slot = find_slot(fact_hash);
+            if (slot == NONE)
+            {
+                return;
+            }
+
+            const auto index = m_slots[slot];
+            unlink(index);
+            remove_slot(slot);
+
+            // Keep live entries dense in [0, size) by moving the last one into the hole
+            const auto last = static_cast<uint32_t>(m_size - 1);
+            if (index != last)
+            {
+                m_slots[find_slot(m_entries[last].fact.fact_hash)] = index;
+                relink(last, index);
+                m_entries[index] = m_entries[last];
+            }
+
+            --m_size;
+        }
+
+        void clear()
+        {
+            std::fill(m_slots.begin(), m_slots.end(), NONE);
+            m_head = NONE;
+            m_tail = NONE;
+            m_size = 0;
+        }
+
+        // Shrinking evicts the least recent facts through on_evict
+        template <typename OnEvict>
+        void set_limit(size_t limit, OnEvict&& on_evict)
+        {
+            limit = std::max<size_t>(limit, 1);
+
+            while (m_size > limit)
+            {
+                const auto& fact = m_entries[m_tail].fact;
+                on_evict(fact);
+                erase(fact.fact_hash);
+            }
+
+            std::vector<quest_fact> facts{};
+            facts.reserve(m_size);
+            for_each([&](const quest_fact& fact) { facts.push_back(fact); });
+
+            // At most half full keeps linear probe chains short
+            size_t slot_count = 1;
+            while (slot_count < limit * 2)
+            {
+                slot_count <<= 1;
+            }
+
+            m_limit = limit;
+            m_mask = slot_count - 1;
+            m_entries.assign(limit, entry{});
+            m_slots.assign(slot_count, NONE);
+            clear();
+
+            for (auto it = facts.rbegin(); it != facts.rend(); ++it)
+            {
+                *emplace(it->fact_hash, [](const quest_fact&) {}).first = *it;
+            }
+        }
+
+        void set_limit(size_t limit)
+        {
+            set_limit(limit, [](const quest_fact&) {});
+        }
+
+        // Most recent first
+        template <typename F>
+        void for_each(F&& callback) const
+        {
+            for (auto index = m_head; index != NONE; index = m_entries[index].next)
+            {
+                callback(m_entries[index].fact);
+            }
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        size_t get_limit() const
+        {
+            return m_limit;
+        }
+
+      private:
+        static constexpr uint32_t NONE = ~0u;
+
+        struct entry
+        {
+            quest_fact fact{};
+            uint32_t prev{NONE};
+            uint32_t next{NONE};
+        };
+
+        size_t home_slot(uint32_t fact_hash) const
+        {
+            // Fibonacci hashing spreads keys that only differ in their high bits
+            return static_cast<size_t>((fact_hash * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+        }
+
+        size_t find_slot(uint32_t fact_hash) const
+        {
+            for (auto slot = home_slot(fact_hash); m_slots[slot] != NONE; slot = (slot + 1) & m_mask)
+            {
+                if (m_entries[m_slots[slot]].fact.fact_hash == fact_hash)
+                {
+                    return slot;
+                }
+            }
+
+            return NONE;
+        }
+
+        // Backward-shift deletion, later members of the probe chain move up so no tombstones are needed
+        void remove_slot(size_t slot)
+        {
+            auto next = (slot + 1) & m_mask;
+
+            while (m_slots[next] != NONE)
+            {
+                const auto home = home_slot(m_entries[m_slots[next]].fact.fact_hash);
+                if (((next - home) & m_mask) >= ((next - slot) & m_mask))
+                {
+                    m_slots[slot] = m_slots[next];
+                    slot = next;
+                }
+
+                next = (next + 1) & m_mask;
+            }
+
+            m_slots[slot] = NONE;
+        }
+
+        void link_front(uint32_t index)
+        {
+            auto& e = m_entries[index];
+            e.prev = NONE;
+            e.next = m_head;
+
+            if (m_head != NONE)
+            {
+                m_entries[m_head].prev = index;
+            }
+
+            m_head = index;
+
+            if (m_tail == NONE)
+            {
+                m_tail = index;
+            }
+        }
+
+        void unlink(uint32_t index)
+        {
+            const auto& e = m_entries[index];
+
+            (e.prev != NONE ? m_entries[e.prev].next : m_head) = e.next;
+            (e.next != NONE ? m_entries[e.next].prev : m_tail) = e.prev;
+        }
+
+        // Points the neighbours of from at to, the entry itself is copied by the caller
+        void relink(uint32_t from, uint32_t to)
+        {
+            const auto& e = m_entries[from];
+
+            (e.prev != NONE ? m_entries[e.prev].next : m_head) = to;
+            (e.next != NONE ? m_entries[e.next].prev : m_tail) = to;
+        }
+
+        std::vector<entry> m_entries;
+        std::vector<uint32_t> m_slots;
+        size_t m_mask{0};
+        size_t m_size{0};
+        size_t m_limit{0};
+        uint32_t m_head{NONE};
+        uint32_t m_tail{NONE};
+    };
+}
@@ -2,19 +2,74 @@
 
 #include "../loader/component_loader.hpp"
 
+#include <game/structs.hpp>
 #include <network/manager.hpp>
+#include <security/session_cipher.hpp>
+#include <utils/byte_buffer.hpp>
 
 #include "network.hpp"
+#include "scheduler.hpp"
+#include "../utils/identity.hpp"
 
 namespace network
 {
     namespace
     {
+        constexpr auto SESSION_TIMEOUT = 5s;
+
         manager& get_network_manager()
         {
             static manager m{};
             return m;
         }
+
+        void send_dictionary_updates()
+        {
+            const auto [acknowledgements, reset_requested] =
+                get_master_dictionary().access<std::pair<std::vector<uint32_t>, bool>>([](string_dictionary& dictionary) {
+                    return std::make_pair(dictionary.incoming.take_acknowledgements(), dictionary.incoming.take_reset_request());
+                });
+
+            for (const auto& payload : serialize_acknowledgements(acknowledgements))
+            {
+                send(get_master_server(), "dict_ack", payload);
+            }
+
+            if (reset_requested)
+            {
+                utils::buffer_serializer buffer{};
+                buffer.write(game::PROTOCOL);
+
+                send(get_master_server(), "dict_reset", buffer.get_buffer());
+            }
+        }
+
+        void handle_authentication_request(const address& source, const std::string_view& data)
+        {
+            utils::buffer_deserializer buffer(data);
+            if (buffer.read<uint32_t>() != game::PROTOCOL)
+            {
+                return;
+            }
+
+            const auto nonce = buffer.read_string();
+
+            utils::cryptography::ecc::key server_key{};
+            server_key.deserialize(buffer.read_string_view());
+
+            const auto& key = utils::identity::get_key();
+            const auto keys = security::derive_session_keys(key, server_key, nonce, security::session_role::client);
+
+            utils::buffer_serializer response{};
+            response.write(game::PROTOCOL);
+            response.write_string(key.serialize(PK_PUBLIC));
+            response.write_string(utils::cryptography::ecc::sign_message(key, nonce));
+
+            // Nothing is sealed before the server's first sealed packet confirms the keys, so a repeated request
+            // can safely replace them
+            get_network_manager().set_session(source, std::make_shared<security::session_cipher>(keys), false);
+            send(source, "authResponse", response.get_buffer());
+        }
     }
 
     void on(const std::string& command, callback callback)
@@ -22,7 +77,7 @@ namespace network
         get_network_manager().on(command, std::move(callback));
     }
 
-    bool send(const address& address, const std::string& command, const std::string& data, const char separator)
+    bool send(const address& address, const std::string& command, const std::string_view data, const char separator)
     {
         return get_network_manager().send(address, command, data, separator);
     }
@@ -43,6 +98,12 @@ namespace network
         return master;
     }
 
+    utils::concurrency::container<string_dictionary>& get_master_dictionary()
+    {
+        static utils::concurrency::container<string_dictionary> dictionary{};
+        return dictionary;
+    }
+
     bool connect(const std::string& address_string)
     {
         try
@@ -78,6 +139,9 @@ namespace network
     {
         printf("[W3MP NETWORK] Connecting to %s:%d\n", target_address.to_string().c_str(), target_address.get_port());
 
+        // Keys from an earlier connection would seal packets the server can't open, it starts a new handshake
+        get_network_manager().clear_session(target_address);
+
         return true;
     }
 
@@ -85,7 +149,32 @@ namespace network
     {
         void post_load() override
         {
-            get_network_manager();
+            // The server sends states every tick, silence means it restarted or dropped us and lost the session keys
+            get_network_manager().set_session_timeout(SESSION_TIMEOUT);
+
+            on("dict_ack", [](const address& source, const std::string_view& data) {
+                if (source == get_master_server())
+                {
+                    get_master_dictionary().access(
+                        [&](string_dictionary& dictionary) { apply_acknowledgements(dictionary.outgoing, data); });
+                }
+            });
+
+            on("authRequest", [](const address& source, const std::string_view& data) {
+                if (source == get_master_server())
+                {
+                    handle_authentication_request(source, data);
+                }
+            });
+
+            on("dict_reset", [](const address& source, const std::string_view&) {
+                if (source == get_master_server())
+                {
+                    get_master_dictionary().access([](string_dictionary& dictionary) { dictionary.outgoing.reset(); });
+                }
+            });
+
+            scheduler::loop(send_dictionary_updates, scheduler::pipeline::async, 100ms);
         }
 
         void pre_destroy() override
@@ -1,19 +1,24 @@
 #pragma once
 
 #include <network/address.hpp>
+#include <network/string_dictionary.hpp>
+#include <utils/concurrency.hpp>
 
 namespace network
 {
     using callback = std::function<void(const address&, const std::string_view&)>;
 
     void on(const std::string& command, callback callback);
-    bool send(const address& address, const std::string& command, const std::string& data = {}, char separator = ' ');
+    bool send(const address& address, const std::string& command, std::string_view data = {}, char separator = ' ');
 
     bool send_data(const address& address, const void* data, size_t length);
     bool send_data(const address& address, const std::string& data);
 
     const address& get_master_server();
 
+    // Interned names for packets exchanged with the master server
+    utils::concurrency::container<string_dictionary>& get_master_dictionary();
+
     bool connect(const std::string& address_string);
     bool connect(const address& target_address);
 }
@@ -14,7 +14,8 @@
 #include "network.hpp"
 
 #include <game/structs.hpp>
-#include <network/protocol.hpp>
+#include <network/packet_codec.hpp>
+#include <network/world_snapshot.hpp>
 #include <utils/byte_buffer.hpp>
 
 #include "../utils/identity.hpp"
@@ -37,26 +38,29 @@ namespace quest_sync
         // Atomic flag for global sync state
         std::atomic<bool> g_W3mGlobalSyncInProgress{false};
 
-        // Pending facts queue for atomic processing
-        std::vector<quest_fact> g_W3mPendingFacts;
+        // Pending facts queue for atomic processing, one entry per fact name
+        fact_coalescer g_W3mPendingFacts;
         std::mutex g_pending_facts_mutex;
 
+        // Outgoing facts are held for a short window and sent as one batch
+        // Scripts set dozens of facts per frame and bump counters repeatedly
+        constexpr std::chrono::milliseconds DEFAULT_FACT_COALESCE_WINDOW{50};
+        constexpr std::chrono::milliseconds FACT_FLUSH_INTERVAL{10};
+
+        fact_coalescer g_outgoing_facts;
+        std::chrono::steady_clock::time_point g_outgoing_window_start{};
+        std::chrono::milliseconds g_fact_coalesce_window{DEFAULT_FACT_COALESCE_WINDOW};
+        std::mutex g_outgoing_facts_mutex;
+
         // ===================================================================
         // ATOMIC FACT SYNCHRONIZATION
         // ===================================================================
 
-        void queue_fact_during_sync(const std::string& fact_name, int32_t value, uint64_t player_guid)
+        void queue_fact_during_sync(const std::string& fact_name, int32_t value, fact_update update, uint64_t player_guid)
         {
             std::lock_guard<std::mutex> lock(g_pending_facts_mutex);
 
-            quest_fact fact{};
-            fact.fact_name = fact_name;
-            fact.value = value;
-            fact.timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            fact.player_guid = player_guid;
-            fact.fact_hash = quest_fact_manager::compute_fact_hash(fact_name);
-
-            g_W3mPendingFacts.push_back(fact);
+            g_W3mPendingFacts.push(fact_name, value, update, player_guid);
 
             printf("[W3MP ATOMIC] Fact queued during sync: %s = %d\n", fact_name.c_str(), value);
         }
@@ -70,44 +74,116 @@ namespace quest_sync
                 return;
             }
 
-            for (const auto& fact : g_W3mPendingFacts)
+            const auto pending_facts = g_W3mPendingFacts.take();
+
+            for (const auto& fact : pending_facts)
             {
-                g_fact_manager.register_fact(fact.fact_name, fact.value, fact.player_guid);
+                g_fact_manager.register_fact(network::protocol::view_string(fact.fact_name), fact.value, fact.player_guid, fact.update);
             }
 
-            printf("[W3MP ATOMIC] Global sync completed, %zu pending facts applied\n", g_W3mPendingFacts.size());
-
-            g_W3mPendingFacts.clear();
+            printf("[W3MP ATOMIC] Global sync completed, %zu pending facts applied\n", pending_facts.size());
         }
 
         // ===================================================================
         // FACT BROADCASTING
         // ===================================================================
 
-        void broadcast_quest_fact(const std::string& fact_name, int32_t value)
+        void send_fact_batches(const std::vector<quest_fact>& facts)
+        {
+            for (size_t offset = 0; offset < facts.size(); offset += network::protocol::MAX_FACT_BATCH_SIZE)
+            {
+                const auto count = std::min(facts.size() - offset, network::protocol::MAX_FACT_BATCH_SIZE);
+
+                network::protocol::W3mFactBatchPacket batch{};
+                batch.facts.resize(count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const auto& fact = facts[offset + i];
+                    auto& packet = batch.facts[i];
+
+                    packet.fact_name = fact.fact_name;
+                    packet.value = fact.value;
+                    packet.timestamp = fact.timestamp;
+                    packet.update = fact.update;
+                }
+
+                utils::buffer_serializer buffer{};
+                buffer.write(game::PROTOCOL);
+
+                network::get_master_dictionary().access(
+                    [&](network::string_dictionary& dictionary) { network::protocol::write(buffer, dictionary.outgoing, batch); });
+
+                network::send(network::get_master_server(), "fact_batch", buffer.get_buffer());
+            }
+
+            printf("[W3MP NARRATIVE] Broadcasting %zu coalesced facts\n", facts.size());
+        }
+
+        // Sends the pending batch once its window has elapsed, or right away when forced
+        void flush_outgoing_facts(const bool force)
+        {
+            std::vector<quest_fact> facts{};
+
+            {
+                std::lock_guard<std::mutex> lock(g_outgoing_facts_mutex);
+
+                if (g_outgoing_facts.empty())
+                {
+                    return;
+                }
+
+                if (!force && std::chrono::steady_clock::now() - g_outgoing_window_start < g_fact_coalesce_window)
+                {
+                    return;
+                }
+
+                facts = g_outgoing_facts.take();
+            }
+
+            send_fact_batches(facts);
+        }
+
+        void broadcast_quest_fact(const std::string& fact_name, int32_t value, fact_update update)
         {
             const auto player_guid = utils::identity::get_guid();
 
             if (g_W3mGlobalSyncInProgress.load())
             {
-                queue_fact_during_sync(fact_name, value, player_guid);
+                queue_fact_during_sync(fact_name, value, update, player_guid);
                 return;
             }
 
-            g_fact_manager.register_fact(fact_name, value, player_guid);
+            g_fact_manager.register_fact(fact_name, value, player_guid, update);
 
-            network::protocol::W3mFactPacket packet{};
-            network::protocol::copy_string(packet.fact_name, fact_name);
-            packet.value = value;
-            packet.timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+            bool send_now = false;
 
-            utils::buffer_serializer buffer{};
-            buffer.write(game::PROTOCOL);
-            buffer.write(packet);
+            {
+                std::lock_guard<std::mutex> lock(g_outgoing_facts_mutex);
+
+                if (g_outgoing_facts.empty())
+                {
+                    g_outgoing_window_start = std::chrono::steady_clock::now();
+                }
+
+                g_outgoing_facts.push(fact_name, value, update, player_guid);
+                send_now = g_fact_coalesce_window.count() == 0;
+            }
 
-            network::send(network::get_master_server(), "fact", buffer.get_buffer());
+            if (send_now)
+            {
+                flush_outgoing_facts(true);
+            }
+        }
 
-            printf("[W3MP NARRATIVE] Broadcasting fact: %s = %d\n", fact_name.c_str(), value);
+        void set_fact_coalesce_window(const std::chrono::milliseconds window)
+        {
+            {
+                std::lock_guard<std::mutex> lock(g_outgoing_facts_mutex);
+                g_fact_coalesce_window = std::max(window, std::chrono::milliseconds(0));
+            }
+
+            printf("[W3MP NARRATIVE] Fact coalescing window set to %lld ms\n", static_cast<long long>(window.count()));
         }
 
         // ===================================================================
@@ -140,17 +216,11 @@ namespace quest_sync
 
             utils::buffer_serializer buffer{};
             buffer.write(game::PROTOCOL);
-            buffer.write(packet);
 
-            g_telemetry.increment_sent();
-            if (g_loopback_enabled)
-            {
-                receive_session_state_safe(network::get_master_server(), buffer.get_buffer());
-            }
-            else
-            {
-                network::send(network::get_master_server(), forced ? "story_lock_release_forced" : "quest_lock", buffer.get_buffer());
-            }
+            network::get_master_dictionary().access(
+                [&](network::string_dictionary& dictionary) { network::protocol::write(buffer, dictionary.outgoing, packet); });
+
+            network::send(network::get_master_server(), forced ? "story_lock_release_forced" : "quest_lock", buffer.get_buffer());
 
             if (forced)
             {
@@ -187,20 +257,22 @@ namespace quest_sync
 
         void W3mBroadcastFact(const scripting::string& fact_name, int32_t value)
         {
-            broadcast_quest_fact(fact_name.to_string(), value);
+            broadcast_quest_fact(fact_name.to_string(), value, fact_update::set);
         }
 
         void W3mAtomicAddFact(const scripting::string& fact_name, int32_t value)
         {
-            const auto fact_str = fact_name.to_string();
+            broadcast_quest_fact(fact_name.to_string(), value, fact_update::add);
+        }
 
-            if (g_W3mGlobalSyncInProgress.load())
-            {
-                queue_fact_during_sync(fact_str, value, utils::identity::get_guid());
-                return;
-            }
+        void W3mAtomicSetFact(const scripting::string& fact_name, int32_t value)
+        {
+            broadcast_quest_fact(fact_name.to_string(), value, fact_update::set);
+        }
 
-            W3mBroadcastFact(fact_name, value);
+        void W3mSetFactCoalesceWindow(int32_t milliseconds)
+        {
+            set_fact_coalesce_window(std::chrono::milliseconds(milliseconds));
         }
 
         void W3mAcquireStoryLock(uint64_t initiator_guid, int32_t scene_id)
@@ -252,7 +324,7 @@ namespace quest_sync
 
         int32_t W3mComputeWorldStateHash()
         {
-            return static_cast<int32_t>(g_fact_manager.compute_world_state_hash());
+            return static_cast<int32_t>(g_fact_manager.get_world_state_hash());
         }
 
         void W3mCheckDialogueProximity(uint64_t initiator_guid, const scripting::game::Vector& initiator_position)
@@ -291,16 +363,284 @@ namespace quest_sync
             }
         }
 
+        // ===================================================================
+        // WORLD SNAPSHOT
+        // ===================================================================
+        // Late joiners pull the session's world state from the server once
+        // A full window requests the next one right away, the timer only
+        // resends the request when chunks got lost or the server didn't answer
+
+        constexpr std::chrono::milliseconds SNAPSHOT_RETRY_INTERVAL{500};
+
+        network::snapshot_receiver g_snapshot_receiver;
+        uint32_t g_snapshot_requested_until = 0;
+        std::atomic_bool g_snapshot_applied{false};
+        std::mutex g_snapshot_mutex;
+
+        void send_snapshot_request(uint64_t snapshot_id, uint32_t first_chunk)
+        {
+            utils::buffer_serializer buffer{};
+            buffer.write(game::PROTOCOL);
+            buffer.write(snapshot_id);
+            buffer.write(first_chunk);
+
+            network::send(network::get_master_server(), "snapshot_request", buffer.get_buffer());
+        }
+
+        void request_next_snapshot_window()
+        {
+            g_snapshot_requested_until = g_snapshot_receiver.get_next_chunk() + static_cast<uint32_t>(network::SNAPSHOT_WINDOW);
+            send_snapshot_request(g_snapshot_receiver.get_snapshot_id(), g_snapshot_receiver.get_next_chunk());
+        }
+
+        void request_world_snapshot()
+        {
+            if (g_snapshot_applied.load())
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(g_snapshot_mutex);
+            request_next_snapshot_window();
+        }
+
+        void apply_world_snapshot(const network::world_snapshot& snapshot)
+        {
+            const auto applied = g_fact_manager.apply_snapshot_facts(snapshot.facts, 0);
+
+            printf("[W3MP SNAPSHOT] World snapshot applied: %zu of %zu facts, %u crowns, time=%u, weather=%u\n", applied,
+                   snapshot.facts.size(), snapshot.total_crowns, snapshot.game_time, snapshot.weather_id);
+        }
+
+        void receive_snapshot_chunk(const network::address& address, const std::string_view& data)
+        {
+            if (address != network::get_master_server() || g_snapshot_applied.load())
+            {
+                return;
+            }
+
+            utils::buffer_deserializer buffer(data);
+            if (buffer.read<uint32_t>() != game::PROTOCOL)
+            {
+                return;
+            }
+
+            const auto chunk = network::read_snapshot_chunk(buffer);
+            std::optional<network::world_snapshot> snapshot{};
+
+            {
+                std::lock_guard<std::mutex> lock(g_snapshot_mutex);
+
+                const auto previous_id = g_snapshot_receiver.get_snapshot_id();
+                g_snapshot_receiver.add_chunk(chunk);
+
+                // A new snapshot always starts at the first window
+                if (g_snapshot_receiver.get_snapshot_id() != previous_id)
+                {
+                    g_snapshot_requested_until = static_cast<uint32_t>(network::SNAPSHOT_WINDOW);
+                }
+
+                if (!g_snapshot_receiver.is_complete())
+                {
+                    if (g_snapshot_receiver.get_next_chunk() >= g_snapshot_requested_until)
+                    {
+                        request_next_snapshot_window();
+                    }
+
+                    return;
+                }
+
+                try
+                {
+                    snapshot = g_snapshot_receiver.get_snapshot();
+                }
+                catch (const std::exception& e)
+                {
+                    printf("[W3MP SNAPSHOT] Discarding world snapshot: %s\n", e.what());
+                    g_snapshot_receiver.reset();
+                    return;
+                }
+
+                // Asking past the last chunk releases the server's copy
+                send_snapshot_request(g_snapshot_receiver.get_snapshot_id(), g_snapshot_receiver.get_chunk_count());
+                g_snapshot_receiver.reset();
+                g_snapshot_applied = true;
+            }
+
+            apply_world_snapshot(*snapshot);
+        }
+
+        // ===================================================================
+        // WORLD STATE RECONCILIATION
+        // ===================================================================
+        // The server answers a heartbeat whose root differs from its own with
+        // the children of the root. Differing nodes are drilled into, differing
+        // buckets are pulled page by page and only their facts are resynced.
+        // A lost packet just ends the drill-down, the next heartbeat restarts it.
+
+        // Fact hashes the server listed so far, per bucket being resynced
+        std::unordered_map<uint16_t, std::vector<uint32_t>> g_resync_buckets;
+        std::mutex g_resync_mutex;
+
+        template <typename Packet>
+        void send_to_server(const std::string& command, const Packet& packet)
+        {
+            utils::buffer_serializer buffer{};
+            buffer.write(game::PROTOCOL);
+
+            network::get_master_dictionary().access(
+                [&](network::string_dictionary& dictionary) { network::protocol::write(buffer, dictionary.outgoing, packet); });
+
+            network::send(network::get_master_server(), command, buffer.get_buffer());
+        }
+
+        template <typename Packet>
+        std::optional<Packet> read_from_server(const network::address& address, const std::string_view& data)
+        {
+            if (address != network::get_master_server())
+            {
+                return std::nullopt;
+            }
+
+            utils::buffer_deserializer buffer(data);
+            if (buffer.read<uint32_t>() != game::PROTOCOL)
+            {
+                return std::nullopt;
+            }
+
+            return network::get_master_dictionary().access<Packet>(
+                [&](network::string_dictionary& dictionary) { return network::protocol::read<Packet>(buffer, dictionary.incoming); });
+        }
+
+        // Facts queued during a story lock aren't in the tree yet, and a full cache can't hold the server's world
+        bool can_reconcile()
+        {
+            return !g_W3mGlobalSyncInProgress.load() && !g_fact_manager.is_fact_cache_full();
+        }
+
+        // Local updates the server hasn't received yet, the server's value for them is outdated
+        bool is_fact_outgoing(const uint32_t fact_hash)
+        {
+            std::lock_guard<std::mutex> lock(g_outgoing_facts_mutex);
+            return g_outgoing_facts.contains(fact_hash);
+        }
+
+        void request_bucket_page(const size_t bucket, const uint32_t offset)
+        {
+            network::protocol::world_state_bucket_request_packet request{};
+            request.bucket = static_cast<uint16_t>(bucket);
+            request.offset = offset;
+
+            send_to_server("world_state_bucket_request", request);
+        }
+
+        void receive_world_state_nodes(const network::address& address, const std::string_view& data)
+        {
+            const auto packet = read_from_server<network::protocol::world_state_nodes_packet>(address, data);
+            if (!packet || packet->node >= utils::merkle_tree::FIRST_BUCKET_NODE || !can_reconcile())
+            {
+                return;
+            }
+
+            for (const auto node : g_fact_manager.find_divergent_world_state_nodes(packet->node, packet->children))
+            {
+                if (utils::merkle_tree::is_bucket_node(node))
+                {
+                    request_bucket_page(utils::merkle_tree::get_bucket_of_node(node), 0);
+                    continue;
+                }
+
+                network::protocol::world_state_nodes_request_packet request{};
+                request.node = static_cast<uint16_t>(node);
+
+                send_to_server("world_state_nodes_request", request);
+            }
+        }
+
+        void receive_world_state_bucket(const network::address& address, const std::string_view& data)
+        {
+            const auto packet = read_from_server<network::protocol::world_state_bucket_packet>(address, data);
+            if (!packet || packet->bucket >= utils::merkle_tree::BUCKET_COUNT || !can_reconcile())
+            {
+                return;
+            }
+
+            std::vector<uint32_t> server_hashes{};
+
+            {
+                std::lock_guard<std::mutex> lock(g_resync_mutex);
+
+                auto& listed = g_resync_buckets[packet->bucket];
+                if (packet->offset == 0)
+                {
+                    listed.clear();
+                }
+
+                // A page got lost or arrived twice
+                if (packet->offset != listed.size())
+                {
+                    g_resync_buckets.erase(packet->bucket);
+                    return;
+                }
+
+                for (const auto& fact : packet->facts)
+                {
+                    listed.push_back(network::protocol::get_fact_hash(network::protocol::view_string(fact.fact_name)));
+                }
+
+                const auto next_offset = static_cast<uint32_t>(listed.size());
+                if (!packet->facts.empty() && next_offset < packet->fact_count)
+                {
+                    request_bucket_page(packet->bucket, next_offset);
+                }
+                else
+                {
+                    server_hashes = std::move(listed);
+                    g_resync_buckets.erase(packet->bucket);
+                }
+            }
+
+            const auto applied = g_fact_manager.apply_resynced_facts(packet->facts, 0, &is_fact_outgoing);
+
+            if (applied != 0)
+            {
+                printf("[W3MP NARRATIVE] Resynced %zu facts of bucket %u\n", applied, packet->bucket);
+            }
+
+            if (packet->offset + packet->facts.size() < packet->fact_count)
+            {
+                return;
+            }
+
+            // The whole bucket is listed, facts the server never received are sent again
+            std::ranges::sort(server_hashes);
+
+            std::vector<quest_fact> missing{};
+            for (auto& fact : g_fact_manager.get_bucket_facts(packet->bucket))
+            {
+                if (!std::ranges::binary_search(server_hashes, fact.fact_hash) && !is_fact_outgoing(fact.fact_hash))
+                {
+                    fact.update = fact_update::set;
+                    missing.push_back(fact);
+                }
+            }
+
+            if (!missing.empty())
+            {
+                send_fact_batches(missing);
+            }
+        }
+
         // ===================================================================
         // NARRATIVE HEARTBEAT
         // ===================================================================
 
         void broadcast_narrative_heartbeat()
         {
-            const auto world_state_hash = g_fact_manager.compute_world_state_hash();
+            const auto world_state_hash = g_fact_manager.get_world_state_hash();
             const auto fact_count = g_fact_manager.get_fact_count();
 
-            printf("[W3MP NARRATIVE] Heartbeat: %zu facts, world_state_hash=%u\n", fact_count, world_state_hash);
+            printf("[W3MP NARRATIVE] Heartbeat: %zu facts, world_state_hash=%016llx\n", fact_count, world_state_hash);
 
             check_story_lock_timeout();
         }
@@ -318,6 +658,8 @@ namespace quest_sync
 
                 scripting::register_function<W3mBroadcastFact>(L"W3mBroadcastFact");
                 scripting::register_function<W3mAtomicAddFact>(L"W3mAtomicAddFact");
+                scripting::register_function<W3mAtomicSetFact>(L"W3mAtomicSetFact");
+                scripting::register_function<W3mSetFactCoalesceWindow>(L"W3mSetFactCoalesceWindow");
                 scripting::register_function<W3mAcquireStoryLock>(L"W3mAcquireStoryLock");
                 scripting::register_function<W3mReleaseStoryLock>(L"W3mReleaseStoryLock");
                 scripting::register_function<W3mIsStoryLocked>(L"W3mIsStoryLocked");
@@ -329,9 +671,15 @@ namespace quest_sync
                 scripting::register_function<W3mComputeWorldStateHash>(L"W3mComputeWorldStateHash");
                 scripting::register_function<W3mCheckDialogueProximity>(L"W3mCheckDialogueProximity");
 
-                W3mLog("Registered 12 narrative synchronization functions");
+                W3mLog("Registered 14 narrative synchronization functions");
 
                 scheduler::loop([] { broadcast_narrative_heartbeat(); }, scheduler::pipeline::async, std::chrono::milliseconds(5000));
+                scheduler::loop([] { flush_outgoing_facts(false); }, scheduler::pipeline::async, FACT_FLUSH_INTERVAL);
+
+                network::on("snapshot_chunk", &receive_snapshot_chunk);
+                network::on("world_state_nodes", &receive_world_state_nodes);
+                network::on("world_state_bucket", &receive_world_state_bucket);
+                scheduler::loop([] { request_world_snapshot(); }, scheduler::pipeline::async, SNAPSHOT_RETRY_INTERVAL);
 
                 printf("[W3MP NARRATIVE] Narrative synchronization system initialized\n");
             }
@@ -346,6 +694,30 @@ namespace quest_sync
     {
         return g_W3mGlobalSyncInProgress.load();
     }
+
+    uint64_t get_world_state_root()
+    {
+        return g_fact_manager.get_world_state_hash();
+    }
+
+    void apply_remote_facts(const std::span<const network::protocol::fact_packet> facts)
+    {
+        for (const auto& fact : facts)
+        {
+            g_fact_manager.register_fact(network::protocol::view_string(fact.fact_name), fact.value, 0, fact.update);
+        }
+    }
+
+    void restart_world_snapshot()
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_snapshot_mutex);
+            g_snapshot_receiver.reset();
+            g_snapshot_requested_until = 0;
+        }
+
+        g_snapshot_applied = false;
+    }
 }
 
 REGISTER_COMPONENT(quest_sync::component)
@@ -1,12 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <optional>
 #include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <network/protocol.hpp>
+#include <utils/hash.hpp>
+#include <utils/merkle_tree.hpp>
+
+#include "fact_cache.hpp"
 
 namespace quest_sync
 {
@@ -19,22 +32,6 @@ namespace quest_sync
     // ===========================================================================
 
     constexpr uint32_t NARRATIVE_PROXIMITY_RADIUS = 30; // Meters for dialogue teleportation
-    constexpr size_t MAX_FACT_NAME_LENGTH = 128;
-    constexpr size_t FACT_CACHE_SIZE_LIMIT = 1024; // Maximum cached facts to prevent bloat
-
-    // ---------------------------------------------------------------------------
-    // QUEST FACT STRUCTURE
-    // ---------------------------------------------------------------------------
-    // Represents a synchronized world fact for quest progression
-
-    struct quest_fact
-    {
-        std::string fact_name{};
-        int32_t value{0};
-        uint64_t timestamp{0};
-        uint64_t player_guid{0}; // Player who triggered this fact
-        uint32_t fact_hash{0};   // Hash for fast comparison
-    };
 
     // ---------------------------------------------------------------------------
     // NARRATIVE EVENT TYPES
@@ -77,7 +74,8 @@ namespace quest_sync
             m_scene_id.store(scene_id);
             m_lock_timestamp.store(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
-            printf("[W3MP NARRATIVE] Story lock ACQUIRED: Initiator=%llu, Scene=%u\n", initiator_guid, scene_id);
+            printf("[W3MP NARRATIVE] Story lock ACQUIRED: Initiator=%llu, Scene=%u\n", static_cast<unsigned long long>(initiator_guid),
+                   scene_id);
         }
 
         void release_lock()
@@ -94,7 +92,7 @@ namespace quest_sync
             m_initiator_guid.store(0);
             m_scene_id.store(0);
 
-            printf("[W3MP NARRATIVE] Story lock RELEASED: Initiator=%llu, Scene=%u\n", initiator, scene);
+            printf("[W3MP NARRATIVE] Story lock RELEASED: Initiator=%llu, Scene=%u\n", static_cast<unsigned long long>(initiator), scene);
         }
 
         bool is_locked() const
@@ -139,58 +137,129 @@ namespace quest_sync
         // FACT REGISTRATION
         // -----------------------------------------------------------------------
 
-        void register_fact(const std::string& fact_name, int32_t value, uint64_t player_guid)
+        // An add is a delta on the current value, an unknown fact starts at 0
+        void register_fact(const std::string_view fact_name, int32_t value, uint64_t player_guid,
+                           fact_update update = fact_update::set)
         {
             std::lock_guard<std::mutex> lock(m_fact_mutex);
 
             const auto fact_hash = compute_fact_hash(fact_name);
+            const auto [fact, inserted] = m_fact_cache.emplace(fact_hash, [this](const quest_fact& evicted) { forget_fact(evicted); });
 
-            quest_fact fact{};
-            fact.fact_name = fact_name;
-            fact.value = value;
-            fact.timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-            fact.player_guid = player_guid;
-            fact.fact_hash = fact_hash;
-
-            m_fact_cache[fact_hash] = fact;
+            value = network::protocol::apply_fact_update(inserted ? 0 : fact->value, value, update);
 
-            if (m_fact_cache.size() > FACT_CACHE_SIZE_LIMIT)
+            if (inserted)
+            {
+                network::protocol::copy_string(fact->fact_name, fact_name);
+                m_world_state.insert(fact_hash, to_state_value(value));
+            }
+            else
             {
-                prune_oldest_facts();
+                m_world_state.update(fact_hash, to_state_value(fact->value), to_state_value(value));
             }
 
-            printf("[W3MP NARRATIVE] Fact registered: %s = %d (hash: %u, player: %llu)\n", fact_name.c_str(), value, fact_hash,
-                   player_guid);
+            fact->value = value;
+            fact->timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+            fact->player_guid = player_guid;
+
+            printf("[W3MP NARRATIVE] Fact registered: %.*s = %d (hash: %u, player: %llu)\n", static_cast<int>(fact_name.size()),
+                   fact_name.data(), value, fact_hash, static_cast<unsigned long long>(player_guid));
         }
 
-        // -----------------------------------------------------------------------
-        // FACT RETRIEVAL
-        // -----------------------------------------------------------------------
+        // Facts from a late-join world snapshot, registered under one lock without per-fact logging
+        // Facts already known locally are at least as recent as the snapshot and are kept
+        size_t apply_snapshot_facts(const std::vector<std::pair<std::string, int32_t>>& facts, uint64_t player_guid)
+        {
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
+
+            const auto timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+            size_t applied = 0;
+
+            for (const auto& [fact_name, value] : facts)
+            {
+                const auto fact_hash = compute_fact_hash(fact_name);
+                const auto [fact, inserted] = m_fact_cache.emplace(fact_hash, [this](const quest_fact& evicted) { forget_fact(evicted); });
+
+                if (!inserted)
+                {
+                    continue;
+                }
+
+                network::protocol::copy_string(fact->fact_name, fact_name);
+                fact->value = value;
+                fact->timestamp = timestamp;
+                fact->player_guid = player_guid;
+
+                m_world_state.insert(fact_hash, to_state_value(value));
+                ++applied;
+            }
 
-        std::optional<quest_fact> get_fact(const std::string& fact_name) const
+            return applied;
+        }
+
+        // Server values of the facts in a divergent bucket, the server's state wins
+        // Facts skip returns true for, e.g. local updates the server hasn't seen yet, are kept
+        template <typename Skip>
+        size_t apply_resynced_facts(const std::span<const network::protocol::fact_packet> facts, uint64_t player_guid, Skip&& skip)
         {
             std::lock_guard<std::mutex> lock(m_fact_mutex);
 
-            const auto fact_hash = compute_fact_hash(fact_name);
-            const auto it = m_fact_cache.find(fact_hash);
+            const auto timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+            size_t applied = 0;
 
-            if (it != m_fact_cache.end())
+            for (const auto& packet : facts)
             {
-                return it->second;
+                const auto fact_name = network::protocol::view_string(packet.fact_name);
+                const auto fact_hash = compute_fact_hash(fact_name);
+
+                if (skip(fact_hash))
+                {
+                    continue;
+                }
+
+                const auto* known = m_fact_cache.find(fact_hash);
+                if (known && known->value == packet.value)
+                {
+                    continue;
+                }
+
+                const auto [fact, inserted] = m_fact_cache.emplace(fact_hash, [this](const quest_fact& evicted) { forget_fact(evicted); });
+
+                if (inserted)
+                {
+                    network::protocol::copy_string(fact->fact_name, fact_name);
+                    m_world_state.insert(fact_hash, to_state_value(packet.value));
+                }
+                else
+                {
+                    m_world_state.update(fact_hash, to_state_value(fact->value), to_state_value(packet.value));
+                }
+
+                fact->value = packet.value;
+                fact->timestamp = timestamp;
+                fact->player_guid = player_guid;
+                ++applied;
             }
 
-            return std::nullopt;
+            return applied;
+        }
+
+        // -----------------------------------------------------------------------
+        // FACT RETRIEVAL
+        // -----------------------------------------------------------------------
+
+        std::optional<quest_fact> get_fact(const std::string_view fact_name) const
+        {
+            return get_fact(compute_fact_hash(fact_name));
         }
 
         std::optional<quest_fact> get_fact(uint32_t fact_hash) const
         {
             std::lock_guard<std::mutex> lock(m_fact_mutex);
 
-            const auto it = m_fact_cache.find(fact_hash);
-
-            if (it != m_fact_cache.end())
+            if (const auto* fact = m_fact_cache.find(fact_hash))
             {
-                return it->second;
+                return *fact;
             }
 
             return std::nullopt;
@@ -200,45 +269,73 @@ namespace quest_sync
         // FACT EXISTENCE CHECK
         // -----------------------------------------------------------------------
 
-        bool has_fact(const std::string& fact_name) const
+        bool has_fact(const std::string_view fact_name) const
         {
-            return get_fact(fact_name).has_value();
+            return has_fact(compute_fact_hash(fact_name));
         }
 
         bool has_fact(uint32_t fact_hash) const
         {
-            return get_fact(fact_hash).has_value();
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
+            return m_fact_cache.find(fact_hash) != nullptr;
         }
 
         // -----------------------------------------------------------------------
         // FACT HASH COMPUTATION
         // -----------------------------------------------------------------------
-        // Uses std::hash for consistent fact identification
+        // utils::hash is stable across compilers and platforms, so every peer derives the same id
         // Keeps packet sizes minimal (4 bytes instead of 128 bytes)
 
-        static uint32_t compute_fact_hash(const std::string& fact_name)
+        static uint32_t compute_fact_hash(const std::string_view fact_name)
         {
-            return static_cast<uint32_t>(std::hash<std::string>{}(fact_name));
+            return network::protocol::get_fact_hash(fact_name);
         }
 
         // -----------------------------------------------------------------------
         // WORLD STATE CONSISTENCY
         // -----------------------------------------------------------------------
-        // Generates a hash of all critical facts for verification
+        // Merkle tree over (fact hash, value), updated as facts change
+        // Peers compare roots, then drill into differing nodes to find the buckets to resync
+        // See WORLD STATE RECONCILIATION in protocol.hpp for the exchange with the server
 
-        uint32_t compute_world_state_hash() const
+        uint64_t get_world_state_hash() const
         {
             std::lock_guard<std::mutex> lock(m_fact_mutex);
+            return m_world_state.get_root();
+        }
 
-            uint32_t combined_hash = 0;
+        std::array<uint64_t, utils::merkle_tree::FANOUT> get_world_state_children(size_t node) const
+        {
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
 
-            for (const auto& [fact_hash, fact] : m_fact_cache)
-            {
-                combined_hash ^= fact_hash;
-                combined_hash ^= static_cast<uint32_t>(fact.value);
-            }
+            std::array<uint64_t, utils::merkle_tree::FANOUT> children{};
+            const auto local_children = m_world_state.get_children(node);
+            std::copy(local_children.begin(), local_children.end(), children.begin());
+
+            return children;
+        }
+
+        std::vector<size_t> find_divergent_world_state_nodes(size_t node,
+                                                             std::span<const uint64_t, utils::merkle_tree::FANOUT> remote_children) const
+        {
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
+            return m_world_state.find_divergent_children(node, remote_children);
+        }
+
+        // Facts a peer needs to repair a divergent bucket
+        std::vector<quest_fact> get_bucket_facts(size_t bucket) const
+        {
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
+
+            std::vector<quest_fact> facts{};
+            m_fact_cache.for_each([&](const quest_fact& fact) {
+                if (utils::merkle_tree::get_bucket(fact.fact_hash) == bucket)
+                {
+                    facts.push_back(fact);
+                }
+            });
 
-            return combined_hash;
+            return facts;
         }
 
         // -----------------------------------------------------------------------
@@ -249,6 +346,7 @@ namespace quest_sync
         {
             std::lock_guard<std::mutex> lock(m_fact_mutex);
             m_fact_cache.clear();
+            m_world_state.clear();
 
             printf("[W3MP NARRATIVE] Fact cache cleared\n");
         }
@@ -259,41 +357,106 @@ namespace quest_sync
             return m_fact_cache.size();
         }
 
+        // Shrinking evicts the least recently registered facts
+        void set_fact_limit(size_t limit)
+        {
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
+            m_fact_cache.set_limit(limit, [this](const quest_fact& evicted) { forget_fact(evicted); });
+        }
+
+        size_t get_fact_limit() const
+        {
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
+            return m_fact_cache.get_limit();
+        }
+
+        // A full cache may have evicted facts, its tree then only covers part of the world
+        bool is_fact_cache_full() const
+        {
+            std::lock_guard<std::mutex> lock(m_fact_mutex);
+            return m_fact_cache.size() >= m_fact_cache.get_limit();
+        }
+
       private:
-        // -----------------------------------------------------------------------
-        // CACHE PRUNING
-        // -----------------------------------------------------------------------
-        // Removes oldest facts when cache exceeds size limit
+        void forget_fact(const quest_fact& fact)
+        {
+            m_world_state.erase(fact.fact_hash, to_state_value(fact.value));
+        }
 
-        void prune_oldest_facts()
+        static uint64_t to_state_value(const int32_t value)
         {
-            if (m_fact_cache.size() <= FACT_CACHE_SIZE_LIMIT * 0.75)
-            {
-                return;
-            }
+            return network::protocol::get_fact_state(value);
+        }
+
+        mutable std::mutex m_fact_mutex;
+        fact_cache m_fact_cache;
+        utils::merkle_tree m_world_state;
+    };
+
+    // ---------------------------------------------------------------------------
+    // FACT COALESCER
+    // ---------------------------------------------------------------------------
+    // Collects fact updates by name until they are flushed as one batch
+    // A set replaces the pending value, an add is summed into it
+    // Only adds stay a delta, anything after a set is folded into an absolute value
+    // Facts keep the position of their first update, so flushes are deterministic
 
-            std::vector<std::pair<uint32_t, uint64_t>> fact_ages;
-            fact_ages.reserve(m_fact_cache.size());
+    class fact_coalescer
+    {
+      public:
+        void push(const std::string_view fact_name, int32_t value, fact_update update, uint64_t player_guid)
+        {
+            const auto fact_hash = quest_fact_manager::compute_fact_hash(fact_name);
+            const auto [it, inserted] = m_index.try_emplace(fact_hash, m_facts.size());
 
-            for (const auto& [hash, fact] : m_fact_cache)
+            if (inserted)
             {
-                fact_ages.emplace_back(hash, fact.timestamp);
+                auto& fact = m_facts.emplace_back();
+                network::protocol::copy_string(fact.fact_name, fact_name);
+                fact.fact_hash = fact_hash;
+                fact.value = value;
+                fact.update = update;
             }
+            else
+            {
+                auto& fact = m_facts[it->second];
+                fact.value = network::protocol::apply_fact_update(fact.value, value, update);
 
-            std::sort(fact_ages.begin(), fact_ages.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+                if (update == fact_update::set)
+                {
+                    fact.update = fact_update::set;
+                }
+            }
 
-            const size_t prune_count = m_fact_cache.size() - static_cast<size_t>(FACT_CACHE_SIZE_LIMIT * 0.75);
+            auto& fact = m_facts[it->second];
+            fact.timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+            fact.player_guid = player_guid;
+        }
 
-            for (size_t i = 0; i < prune_count && i < fact_ages.size(); ++i)
-            {
-                m_fact_cache.erase(fact_ages[i].first);
-            }
+        std::vector<quest_fact> take()
+        {
+            m_index.clear();
+            return std::exchange(m_facts, {});
+        }
 
-            printf("[W3MP NARRATIVE] Pruned %zu old facts from cache\n", prune_count);
+        bool contains(uint32_t fact_hash) const
+        {
+            return m_index.contains(fact_hash);
         }
 
-        mutable std::mutex m_fact_mutex;
-        std::unordered_map<uint32_t, quest_fact> m_fact_cache;
+        bool empty() const
+        {
+            return m_facts.empty();
+        }
+
+        size_t size() const
+        {
+            return m_facts.size();
+        }
+
+      private:
+        std::vector<quest_fact> m_facts;
+        std::unordered_map<uint32_t, size_t> m_index;
     };
 
     // ---------------------------------------------------------------------------
@@ -344,8 +507,8 @@ namespace quest_sync
 
             m_pending_teleports[player_guid] = request;
 
-            printf("[W3MP NARRATIVE] Teleport requested for player %llu to (%.2f, %.2f, %.2f)\n", player_guid, target_position[0],
-                   target_position[1], target_position[2]);
+            printf("[W3MP NARRATIVE] Teleport requested for player %llu to (%.2f, %.2f, %.2f)\n",
+                   static_cast<unsigned long long>(player_guid), target_position[0], target_position[1], target_position[2]);
         }
 
         bool has_pending_teleport(uint64_t player_guid) const
@@ -377,4 +540,13 @@ namespace quest_sync
     // ---------------------------------------------------------------------------
 
     bool is_global_sync_active();
+
+    // Sent in the heartbeat, the server starts a drill-down when it differs from its own
+    uint64_t get_world_state_root();
+
+    // Facts relayed from other players, so the local tree keeps matching the server's
+    void apply_remote_facts(std::span<const network::protocol::fact_packet> facts);
+
+    // Joining a session pulls that server's world snapshot, even if one was applied before
+    void restart_world_snapshot();
 }
@@ -11,15 +11,17 @@
 #include "../w3m_logger.h"
 
 #include <game/structs.hpp>
-#include <network/protocol.hpp>
+#include <network/packet_codec.hpp>
 #include <utils/nt.hpp>
 #include <utils/hook.hpp>
 #include <utils/string.hpp>
 #include <utils/byte_buffer.hpp>
 #include <utils/concurrency.hpp>
+#include <utils/hash.hpp>
 
 #include "../utils/identity.hpp"
 #include "network.hpp"
+#include "quest_sync.hpp"
 #include "renderer.hpp"
 #include "scheduler.hpp"
 #include "scripting.hpp"
@@ -106,6 +108,39 @@ namespace scripting_experiments
         W3mTelemetry g_telemetry;
         std::atomic<bool> g_loopback_enabled{false};
 
+        // ===================================================================
+        // INTERNED PACKET ENCODING - MASTER SERVER DICTIONARY
+        // ===================================================================
+
+        // Upper bound of an interned message, for stack buffers
+        template <typename Packet>
+        constexpr size_t max_message_size = sizeof(game::PROTOCOL) + network::protocol::max_packet_size<Packet>;
+
+        template <typename Packet>
+        void serialize_interned(utils::buffer_serializer& buffer, const Packet& packet)
+        {
+            buffer.write(game::PROTOCOL);
+
+            network::get_master_dictionary().access(
+                [&](network::string_dictionary& dictionary) { network::protocol::write(buffer, dictionary.outgoing, packet); });
+        }
+
+        template <typename Packet>
+        std::string serialize_interned(const Packet& packet)
+        {
+            utils::buffer_serializer buffer{};
+            serialize_interned(buffer, packet);
+
+            return buffer.move_buffer();
+        }
+
+        template <typename Packet>
+        Packet deserialize_interned(utils::buffer_deserializer& buffer)
+        {
+            return network::get_master_dictionary().access<Packet>(
+                [&](network::string_dictionary& dictionary) { return network::protocol::read<Packet>(buffer, dictionary.incoming); });
+        }
+
         // ===================================================================
         // FORWARD DECLARATIONS - PACKET HANDLERS
         // ===================================================================
@@ -115,8 +150,8 @@ namespace scripting_experiments
         void receive_session_state_safe(const network::address& address, const std::string_view& data);
         void receive_achievement_safe(const network::address& address, const std::string_view& data);
         void receive_heartbeat_safe(const network::address& address, const std::string_view& data);
-        void receive_attack_safe(const network::address& address, const std::string_view& data);
         void receive_fact_safe(const network::address& address, const std::string_view& data);
+        void receive_fact_batch_safe(const network::address& address, const std::string_view& data);
 
         // ===================================================================
         // NATIVE UI CLASS - CDPR HEX CODES
@@ -169,6 +204,7 @@ namespace scripting_experiments
           private:
             std::queue<network::protocol::W3mLootPacket> m_outgoing_queue;
             std::mutex m_queue_mutex;
+            std::string m_send_buffer; // Reused by process_queue, guarded by m_queue_mutex
             std::set<std::string> m_processed_items;
 
           public:
@@ -204,36 +240,37 @@ namespace scripting_experiments
             void process_queue()
             {
                 std::lock_guard<std::mutex> lock(m_queue_mutex);
+                utils::buffer_serializer buffer(m_send_buffer);
 
                 while (!m_outgoing_queue.empty())
                 {
                     const auto packet = m_outgoing_queue.front();
                     m_outgoing_queue.pop();
 
-                    utils::buffer_serializer buffer{};
-                    buffer.write(game::PROTOCOL);
-                    buffer.write(packet);
+                    buffer.reset();
+                    serialize_interned(buffer, packet);
 
                     g_telemetry.increment_sent();
 
                     if (g_loopback_enabled)
                     {
-                        receive_inventory_safe(network::get_master_server(), buffer.get_buffer());
+                        receive_inventory_safe(network::get_master_server(), buffer.get_view());
                     }
                     else
                     {
-                        network::send(network::get_master_server(), "loot", buffer.get_buffer());
+                        network::send(network::get_master_server(), "loot", buffer.get_view());
                     }
                 }
             }
 
             void receive_item(const network::protocol::W3mLootPacket& packet, const std::string& player_name)
             {
-                const auto item_name = network::protocol::extract_string(packet.item_name);
+                const auto item_name = network::protocol::view_string(packet.item_name);
 
                 // Note: WitcherScript integration requires event-based system
                 // Items are received via the inventory bridge system
-                printf("[W3MP INVENTORY] Received: %s x%d (from %s)\n", item_name.c_str(), packet.quantity, player_name.c_str());
+                printf("[W3MP INVENTORY] Received: %.*s x%d (from %s)\n", static_cast<int>(item_name.size()), item_name.data(),
+                       packet.quantity, player_name.c_str());
             }
         };
 
@@ -285,7 +322,7 @@ namespace scripting_experiments
         // ===================================================================
 
         constexpr uint32_t SCRIPT_VERSION = 1;
-        std::set<std::string> m_unlocked_achievements;
+        std::set<std::string, std::less<>> m_unlocked_achievements;
 
         // ===================================================================
         // HANDSHAKE PROTOCOL - SESSION SECURITY
@@ -300,13 +337,13 @@ namespace scripting_experiments
             return g_handshake_complete.load();
         }
 
-        void set_handshake_complete(uint64_t session_id, const std::string& player_name)
+        void set_handshake_complete(uint64_t session_id, const std::string_view player_name)
         {
             g_session_id.store(session_id);
             g_handshake_player_name = player_name;
             g_handshake_complete.store(true);
 
-            printf("[W3MP HANDSHAKE] Session established: ID=%llu, Player=%s\n", session_id, player_name.c_str());
+            printf("[W3MP HANDSHAKE] Session established: ID=%llu, Player=%s\n", session_id, g_handshake_player_name.c_str());
         }
 
         // ===================================================================
@@ -415,7 +452,7 @@ namespace scripting_experiments
                 utils::buffer_deserializer buffer(data);
                 buffer.read<uint32_t>(); // Skip protocol (already validated)
 
-                const auto packet = buffer.read<network::protocol::W3mLootPacket>();
+                const auto packet = deserialize_interned<network::protocol::W3mLootPacket>(buffer);
                 const auto player_name = get_player_name(packet.player_guid);
 
                 g_inventory_bridge.receive_item(packet, player_name);
@@ -431,8 +468,8 @@ namespace scripting_experiments
                     utils::buffer_deserializer buffer(data);
                     buffer.read<uint32_t>(); // Skip protocol (already validated)
 
-                    const auto packet = buffer.read<network::protocol::W3mHandshakePacket>();
-                    const auto player_name = std::string(packet.player_name, strnlen(packet.player_name, sizeof(packet.player_name)));
+                    const auto packet = deserialize_interned<network::protocol::W3mHandshakePacket>(buffer);
+                    const auto player_name = std::string_view(packet.player_name, strnlen(packet.player_name, sizeof(packet.player_name)));
 
                     // Validate session ID and establish connection
                     if (packet.session_id != 0)
@@ -440,12 +477,12 @@ namespace scripting_experiments
                         set_handshake_complete(packet.session_id, player_name);
 
                         // Handshake complete - connection established
-                        printf("[W3MP HANDSHAKE] Received: ID=%llu, Player=%s, GUID=%u\n", packet.session_id, player_name.c_str(),
-                               packet.player_guid);
+                        printf("[W3MP HANDSHAKE] Received: ID=%llu, Player=%.*s, GUID=%u\n", packet.session_id,
+                               static_cast<int>(player_name.size()), player_name.data(), packet.player_guid);
                     }
                     else
                     {
-                        printf("[W3MP HANDSHAKE] Invalid session ID from %s\n", player_name.c_str());
+                        printf("[W3MP HANDSHAKE] Invalid session ID from %.*s\n", static_cast<int>(player_name.size()), player_name.data());
                     }
                 },
                 false); // Handshake packets don't require handshake (obviously)
@@ -458,7 +495,7 @@ namespace scripting_experiments
                 utils::buffer_deserializer buffer(data);
                 buffer.read<uint32_t>(); // Skip protocol
 
-                const auto packet = buffer.read<network::protocol::W3mQuestLockPacket>();
+                const auto packet = deserialize_interned<network::protocol::W3mQuestLockPacket>(buffer);
                 const auto player_name = get_player_name(packet.player_guid);
 
                 game::vec4_t initiator_position{};
@@ -491,21 +528,23 @@ namespace scripting_experiments
                 utils::buffer_deserializer buffer(data);
                 buffer.read<uint32_t>(); // Skip protocol
 
-                const auto packet = buffer.read<network::protocol::W3mAchievementPacket>();
-                const auto achievement_id = network::protocol::extract_string(packet.achievement_id);
+                const auto packet = deserialize_interned<network::protocol::W3mAchievementPacket>(buffer);
+                const auto achievement_id = network::protocol::view_string(packet.achievement_id);
 
                 if (m_unlocked_achievements.contains(achievement_id))
                 {
-                    printf("[W3MP ACHIEVEMENT] Already unlocked, skipping: %s\n", achievement_id.c_str());
+                    printf("[W3MP ACHIEVEMENT] Already unlocked, skipping: %.*s\n", static_cast<int>(achievement_id.size()),
+                           achievement_id.data());
                     return;
                 }
 
-                m_unlocked_achievements.insert(achievement_id);
+                m_unlocked_achievements.emplace(achievement_id);
                 const auto player_name = get_player_name(packet.player_guid);
 
                 // Achievement unlocked - logged for tracking
 
-                printf("[W3MP ACHIEVEMENT] Unlocked: %s (from %s)\n", achievement_id.c_str(), player_name.c_str());
+                printf("[W3MP ACHIEVEMENT] Unlocked: %.*s (from %s)\n", static_cast<int>(achievement_id.size()), achievement_id.data(),
+                       player_name.c_str());
             });
         }
 
@@ -516,7 +555,7 @@ namespace scripting_experiments
                 utils::buffer_deserializer buffer(data);
                 buffer.read<uint32_t>(); // Skip protocol
 
-                const auto packet = buffer.read<network::protocol::W3mHeartbeatPacket>();
+                const auto packet = deserialize_interned<network::protocol::W3mHeartbeatPacket>(buffer);
 
                 if (packet.script_version != SCRIPT_VERSION)
                 {
@@ -541,7 +580,7 @@ namespace scripting_experiments
                 utils::buffer_deserializer buffer(data);
                 buffer.read<uint32_t>(); // Skip protocol
 
-                const auto packet = buffer.read<network::protocol::W3mPlayerStatePacket>();
+                const auto packet = deserialize_interned<network::protocol::W3mPlayerStatePacket>(buffer);
 
                 if (packet.player_guid == utils::identity::get_guid())
                 {
@@ -560,22 +599,35 @@ namespace scripting_experiments
             });
         }
 
-        void receive_attack_safe(const network::address& address, const std::string_view& data)
+        void receive_npc_update_safe(const network::address& address, const std::string_view& data)
         {
             g_telemetry.increment_received();
-            receive_packet_safe("ATTACK", address, data, [](const network::address& /* addr */, const std::string_view& data) {
+            receive_packet_safe("NPC_UPDATE", address, data, [](const network::address& /* addr */, const std::string_view& data) {
                 utils::buffer_deserializer buffer(data);
                 buffer.read<uint32_t>(); // Skip protocol
 
-                const auto packet = buffer.read<network::protocol::W3mAttackPacket>();
-                const auto target_tag = network::protocol::extract_string(packet.target_tag);
-                const auto player_name = get_player_name(packet.attacker_guid);
+                const auto packet = deserialize_interned<network::protocol::W3mNpcUpdatePacket>(buffer);
+                const auto target_tag = network::protocol::view_string(packet.target_tag);
 
-                printf("[W3MP COMBAT] Received attack: %s -> %s (%.1f dmg, type %d)\n", player_name.c_str(), target_tag.c_str(),
-                       packet.damage_amount, static_cast<int32_t>(packet.type));
+                if (packet.killed)
+                {
+                    const auto killer_name = get_player_name(packet.killer_guid);
+                    printf("[W3MP COMBAT] NPC killed: %.*s (%.1f dmg over %u hits, killing blow by %s)\n",
+                           static_cast<int>(target_tag.size()), target_tag.data(), packet.damage_amount, packet.hit_count,
+                           killer_name.c_str());
+                    return;
+                }
+
+                printf("[W3MP COMBAT] NPC update: %.*s (%.1f dmg over %u hits)\n", static_cast<int>(target_tag.size()), target_tag.data(),
+                       packet.damage_amount, packet.hit_count);
             });
         }
 
+        const char* get_update_operator(const network::protocol::fact_update update)
+        {
+            return update == network::protocol::fact_update::add ? "+=" : "=";
+        }
+
         void receive_fact_safe(const network::address& address, const std::string_view& data)
         {
             g_telemetry.increment_received();
@@ -583,10 +635,32 @@ namespace scripting_experiments
                 utils::buffer_deserializer buffer(data);
                 buffer.read<uint32_t>(); // Skip protocol
 
-                const auto packet = buffer.read<network::protocol::W3mFactPacket>();
-                const auto fact_name = network::protocol::extract_string(packet.fact_name);
+                const auto packet = deserialize_interned<network::protocol::W3mFactPacket>(buffer);
+                const auto fact_name = network::protocol::view_string(packet.fact_name);
 
-                printf("[W3MP NARRATIVE] Received fact: %s = %d (timestamp: %llu)\n", fact_name.c_str(), packet.value, packet.timestamp);
+                quest_sync::apply_remote_facts({&packet, 1});
+
+                printf("[W3MP NARRATIVE] Received fact: %.*s %s %d (timestamp: %llu)\n", static_cast<int>(fact_name.size()),
+                       fact_name.data(), get_update_operator(packet.update), packet.value, packet.timestamp);
+            });
+        }
+
+        void receive_fact_batch_safe(const network::address& address, const std::string_view& data)
+        {
+            g_telemetry.increment_received();
+            receive_packet_safe("FACT_BATCH", address, data, [](const network::address& /* addr */, const std::string_view& data) {
+                utils::buffer_deserializer buffer(data);
+                buffer.read<uint32_t>(); // Skip protocol
+
+                const auto batch = deserialize_interned<network::protocol::W3mFactBatchPacket>(buffer);
+                quest_sync::apply_remote_facts(batch.facts);
+
+                for (const auto& packet : batch.facts)
+                {
+                    const auto fact_name = network::protocol::view_string(packet.fact_name);
+                    printf("[W3MP NARRATIVE] Received fact: %.*s %s %d (timestamp: %llu)\n", static_cast<int>(fact_name.size()),
+                           fact_name.data(), get_update_operator(packet.update), packet.value, packet.timestamp);
+                }
             });
         }
 
@@ -607,19 +681,17 @@ namespace scripting_experiments
             packet.player_guid = utils::identity::get_guid();
             packet.timestamp = static_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
-            utils::buffer_serializer buffer{};
-            buffer.write(game::PROTOCOL);
-            buffer.write(packet);
+            const auto buffer = serialize_interned(packet);
 
             g_telemetry.increment_sent();
 
             if (g_loopback_enabled)
             {
-                receive_session_state_safe(network::get_master_server(), buffer.get_buffer());
+                receive_session_state_safe(network::get_master_server(), buffer);
             }
             else
             {
-                network::send(network::get_master_server(), "quest_lock", buffer.get_buffer());
+                network::send(network::get_master_server(), "quest_lock", buffer);
             }
 
             printf("[W3MP SESSION] Broadcasting state: %s (scene %d)\n", packet.is_locked ? "SPECTATOR" : "FREE_ROAM", scene_id);
@@ -628,8 +700,8 @@ namespace scripting_experiments
         void W3mInitiateHandshake(const scripting::string& session_id_str)
         {
             const auto session_id_std = session_id_str.to_string();
-            // Hash string to uint64_t for packet compatibility
-            uint64_t session_id = std::hash<std::string>{}(session_id_std);
+            // Hash string to uint64_t for packet compatibility, every peer has to derive the same id
+            const uint64_t session_id = utils::hash::compute(session_id_std);
 
             network::protocol::W3mHandshakePacket packet{};
             packet.session_id = session_id;
@@ -641,19 +713,17 @@ namespace scripting_experiments
             const auto local_name = get_player_name(utils::identity::get_guid());
             strncpy_s(packet.player_name, sizeof(packet.player_name), local_name.c_str(), _TRUNCATE);
 
-            utils::buffer_serializer buffer{};
-            buffer.write(game::PROTOCOL);
-            buffer.write(packet);
+            const auto buffer = serialize_interned(packet);
 
             g_telemetry.increment_sent();
 
             if (g_loopback_enabled)
             {
-                receive_handshake_safe(network::get_master_server(), buffer.get_buffer());
+                receive_handshake_safe(network::get_master_server(), buffer);
             }
             else
             {
-                network::send(network::get_master_server(), "handshake", buffer.get_buffer());
+                network::send(network::get_master_server(), "handshake", buffer);
             }
 
             printf("[W3MP HANDSHAKE] Broadcasting: ID=%llu (hash of %s), Player=%s\n", session_id, session_id_std.c_str(),
@@ -677,19 +747,17 @@ namespace scripting_experiments
             packet.player_guid = utils::identity::get_guid();
             packet.timestamp = static_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
-            utils::buffer_serializer buffer{};
-            buffer.write(game::PROTOCOL);
-            buffer.write(packet);
+            const auto buffer = serialize_interned(packet);
 
             g_telemetry.increment_sent();
 
             if (g_loopback_enabled)
             {
-                receive_achievement_safe(network::get_master_server(), buffer.get_buffer());
+                receive_achievement_safe(network::get_master_server(), buffer);
             }
             else
             {
-                network::send(network::get_master_server(), "achievement", buffer.get_buffer());
+                network::send(network::get_master_server(), "achievement", buffer);
             }
 
             printf("[W3MP ACHIEVEMENT] Broadcasting unlock: %s\n", achievement_str.c_str());
@@ -763,6 +831,7 @@ namespace scripting_experiments
 
             network::address server_addr(ip.c_str(), port);
             network::connect(server_addr);
+            quest_sync::restart_world_snapshot();
 
             W3mInitiateHandshake(session_id_str);
 
@@ -789,19 +858,19 @@ namespace scripting_experiments
             packet.move_type = move_type;
             packet.speed = speed;
 
-            utils::buffer_serializer buffer{};
-            buffer.write(game::PROTOCOL);
-            buffer.write(packet);
+            std::array<char, max_message_size<network::protocol::W3mPlayerStatePacket>> storage;
+            utils::buffer_serializer buffer(storage);
+            serialize_interned(buffer, packet);
 
             g_telemetry.increment_sent();
 
             if (g_loopback_enabled)
             {
-                receive_player_state_safe(network::get_master_server(), buffer.get_buffer());
+                receive_player_state_safe(network::get_master_server(), buffer.get_view());
             }
             else
             {
-                network::send(network::get_master_server(), "player_state", buffer.get_buffer());
+                network::send(network::get_master_server(), "player_state", buffer.get_view());
             }
         }
 
@@ -855,12 +924,6 @@ namespace scripting_experiments
             W3mLog("W3mSetSpeed called: %.2f", abs_speed);
         }
 
-        void W3mBroadcastFact(const scripting::string& fact_name, const int32_t value)
-        {
-            // Stub: Fact broadcasting
-            W3mLog("W3mBroadcastFact called: %s = %d", fact_name.to_string().c_str(), value);
-        }
-
         void W3mBroadcastAttack(const uint64_t attacker_guid, const scripting::string& target_tag, const float damage_amount,
                                 const int32_t attack_type)
         {
@@ -874,20 +937,14 @@ namespace scripting_experiments
             packet.force_kill = false;
             packet.timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 
-            utils::buffer_serializer buffer{};
-            buffer.write(game::PROTOCOL);
-            buffer.write(packet);
-
-            g_telemetry.increment_sent();
+            auto buffer = serialize_interned(packet);
 
-            if (g_loopback_enabled)
+            // Only the server's damage ledger consumes attacks, peers get its npc_update instead.
+            // Without a server in loopback mode, nothing would come back.
+            if (!g_loopback_enabled)
             {
-                scheduler::once([buffer = buffer.get_buffer()] { receive_attack_safe(network::get_master_server(), buffer); },
-                                scheduler::pipeline::async);
-            }
-            else
-            {
-                network::send(network::get_master_server(), "attack", buffer.get_buffer());
+                g_telemetry.increment_sent();
+                network::send(network::get_master_server(), "attack", buffer);
             }
 
             printf("[W3MP COMBAT] Broadcasting attack: %s -> %s (%.1f dmg, type %d)\n", std::to_string(attacker_guid).c_str(),
@@ -1030,25 +1087,25 @@ namespace scripting_experiments
             network::protocol::W3mHeartbeatPacket packet{};
             packet.player_guid = utils::identity::get_guid();
             packet.total_crowns = g_cached_crowns.load();
-            packet.world_fact_hash = 0;
+            packet.world_fact_hash = quest_sync::get_world_state_root();
             packet.script_version = SCRIPT_VERSION;
             packet.game_time = g_cached_game_time.load();
             packet.weather_id = g_cached_weather_id.load();
             packet.timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 
-            utils::buffer_serializer buffer{};
-            buffer.write(game::PROTOCOL);
-            buffer.write(packet);
+            std::array<char, max_message_size<network::protocol::W3mHeartbeatPacket>> storage;
+            utils::buffer_serializer buffer(storage);
+            serialize_interned(buffer, packet);
 
             g_telemetry.increment_sent();
 
             if (g_loopback_enabled)
             {
-                receive_heartbeat_safe(network::get_master_server(), buffer.get_buffer());
+                receive_heartbeat_safe(network::get_master_server(), buffer.get_view());
             }
             else
             {
-                network::send(network::get_master_server(), "heartbeat", buffer.get_buffer());
+                network::send(network::get_master_server(), "heartbeat", buffer.get_view());
             }
 
             printf("[W3MP HEARTBEAT] Sent: %u crowns, time=%u, weather=%u (v%u)\n", packet.total_crowns, packet.game_time,
@@ -1085,7 +1142,6 @@ namespace scripting_experiments
                 scripting::register_function<W3mUpdatePlayerName>(L"W3mUpdatePlayerName");
                 scripting::register_function<W3mGetMoveType>(L"W3mGetMoveType");
                 scripting::register_function<W3mSetSpeed>(L"W3mSetSpeed");
-                scripting::register_function<W3mBroadcastFact>(L"W3mBroadcastFact");
                 scripting::register_function<W3mBroadcastAttack>(L"W3mBroadcastAttack");
                 scripting::register_function<W3mBroadcastCutscene>(L"W3mBroadcastCutscene");
                 scripting::register_function<W3mBroadcastAnimation>(L"W3mBroadcastAnimation");
@@ -1113,8 +1169,9 @@ namespace scripting_experiments
                 network::on("heartbeat", &receive_heartbeat_safe);
                 network::on("handshake", &receive_handshake_safe);
                 network::on("player_state", &receive_player_state_safe);
-                network::on("attack", &receive_attack_safe);
+                network::on("npc_update", &receive_npc_update_safe);
                 network::on("fact", &receive_fact_safe);
+                network::on("fact_batch", &receive_fact_batch_safe);
 
                 // 5-second Reconciliation Heartbeat
                 scheduler::loop([] { broadcast_heartbeat(); }, scheduler::pipeline::async, std::chrono::milliseconds(5000));
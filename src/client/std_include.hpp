@@ -24,6 +24,9 @@
 #pragma warning(disable : 26812)
 #pragma warning(disable : 28020)
 
+// The updater's platform independent parts also build into the tests
+#ifdef _WIN32
+
 #define WIN32_LEAN_AND_MEAN
 
 #include <Windows.h>
@@ -41,6 +44,8 @@
 #undef min
 #endif
 
+#endif
+
 #include <map>
 #include <set>
 #include <span>
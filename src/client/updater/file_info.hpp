@@ -1,13 +1,22 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace updater
 {
+    // Delta from a previous version of the file, see utils::binary_patch
+    struct file_patch
+    {
+        std::string base_hash;
+        std::size_t size;
+    };
+
     struct file_info
     {
         std::string name;
         std::size_t size;
         std::string hash;
+        std::vector<file_patch> patches;
     };
 }
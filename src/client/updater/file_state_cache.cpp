@@ -0,0 +1,227 @@
+#include "../std_include.hpp"
+
+#include "file_state_cache.hpp"
+
+#include <utils/byte_buffer.hpp>
+#include <utils/hash.hpp>
+#include <utils/io.hpp>
+
+namespace updater
+{
+    namespace
+    {
+        constexpr uint32_t CACHE_MAGIC = 0x43534657; // "WFSC"
+        constexpr uint32_t CACHE_VERSION = 1;
+
+        // Files written this recently may still change within the same timestamp, so their hash is not cached.
+        // Otherwise an edit right after hashing could keep size and time and go unnoticed.
+        constexpr auto RACY_INTERVAL = 2s;
+
+        struct file_metadata
+        {
+            uint64_t size{};
+            std::filesystem::file_time_type modification_time{};
+        };
+
+        std::optional<file_metadata> get_metadata(const std::filesystem::path& path)
+        {
+            std::error_code ec{};
+            const auto status = std::filesystem::status(path, ec);
+            if (ec || !std::filesystem::is_regular_file(status))
+            {
+                return std::nullopt;
+            }
+
+            file_metadata metadata{};
+            metadata.size = std::filesystem::file_size(path, ec);
+            if (ec)
+            {
+                return std::nullopt;
+            }
+
+            metadata.modification_time = std::filesystem::last_write_time(path, ec);
+            if (ec)
+            {
+                return std::nullopt;
+            }
+
+            return metadata;
+        }
+
+        int64_t get_ticks(const std::filesystem::file_time_type time)
+        {
+            return static_cast<int64_t>(time.time_since_epoch().count());
+        }
+
+        bool is_racy(const file_metadata& metadata)
+        {
+            return metadata.modification_time + RACY_INTERVAL > std::filesystem::file_time_type::clock::now();
+        }
+    }
+
+    file_state_cache::file_state_cache(std::filesystem::path file)
+        : file_(std::move(file))
+    {
+        std::string data{};
+        if (!utils::io::read_file(this->file_, &data))
+        {
+            return;
+        }
+
+        try
+        {
+            utils::buffer_deserializer buffer(data);
+            if (buffer.read<uint32_t>() != CACHE_MAGIC || buffer.read<uint32_t>() != CACHE_VERSION)
+            {
+                return;
+            }
+
+            const auto checksum = buffer.read<uint64_t>();
+            const auto body = buffer.get_remaining_view();
+            if (utils::hash::compute(body) != checksum)
+            {
+                return;
+            }
+
+            utils::buffer_deserializer body_buffer(body);
+            const auto count = body_buffer.read<uint32_t>();
+
+            std::unordered_map<std::string, entry> entries{};
+            entries.reserve(count);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                auto name = body_buffer.read_string();
+
+                entry e{};
+                e.size = body_buffer.read<uint64_t>();
+                e.modification_time = body_buffer.read<int64_t>();
+                body_buffer.read(e.hash.data(), e.hash.size());
+
+                entries[std::move(name)] = e;
+            }
+
+            this->state_.access([&](state& s) { s.entries = std::move(entries); });
+        }
+        catch (const std::exception&)
+        {
+            // Rehashing everything once is the worst a broken cache can cause
+        }
+    }
+
+    std::optional<utils::cryptography::sha1::digest> file_state_cache::find(const std::string& name,
+                                                                            const std::filesystem::path& path) const
+    {
+        const auto metadata = get_metadata(path);
+        if (!metadata)
+        {
+            return std::nullopt;
+        }
+
+        return this->state_.access<std::optional<utils::cryptography::sha1::digest>>(
+            [&](const state& s) -> std::optional<utils::cryptography::sha1::digest> {
+                const auto entry = s.entries.find(name);
+                if (entry == s.entries.end() || entry->second.size != metadata->size ||
+                    entry->second.modification_time != get_ticks(metadata->modification_time))
+                {
+                    return std::nullopt;
+                }
+
+                return entry->second.hash;
+            });
+    }
+
+    std::optional<utils::cryptography::sha1::digest> file_state_cache::get_hash(const std::string& name,
+                                                                                const std::filesystem::path& path)
+    {
+        auto hash = this->find(name, path);
+        if (hash)
+        {
+            return hash;
+        }
+
+        hash = utils::cryptography::sha1::compute_file(path);
+        if (hash)
+        {
+            this->store(name, path, *hash);
+        }
+
+        return hash;
+    }
+
+    void file_state_cache::store(const std::string& name, const std::filesystem::path& path,
+                                 const utils::cryptography::sha1::digest& hash)
+    {
+        // The metadata is read after hashing, a change in between is caught on the next launch
+        const auto metadata = get_metadata(path);
+
+        this->state_.access([&](state& s) {
+            if (!metadata || is_racy(*metadata))
+            {
+                s.dirty |= s.entries.erase(name) != 0;
+                return;
+            }
+
+            entry e{};
+            e.size = metadata->size;
+            e.modification_time = get_ticks(metadata->modification_time);
+            e.hash = hash;
+
+            s.entries[name] = e;
+            s.dirty = true;
+        });
+    }
+
+    void file_state_cache::save()
+    {
+        utils::buffer_serializer body{};
+
+        const auto dirty = this->state_.access<bool>([&](state& s) {
+            if (!s.dirty)
+            {
+                return false;
+            }
+
+            body.write(static_cast<uint32_t>(s.entries.size()));
+
+            for (const auto& [name, e] : s.entries)
+            {
+                body.write_string(name);
+                body.write(e.size);
+                body.write(e.modification_time);
+                body.write(e.hash.data(), e.hash.size());
+            }
+
+            s.dirty = false;
+            return true;
+        });
+
+        if (!dirty)
+        {
+            return;
+        }
+
+        utils::buffer_serializer buffer{};
+        buffer.reserve(body.size() + 16);
+        buffer.write(CACHE_MAGIC);
+        buffer.write(CACHE_VERSION);
+        buffer.write(utils::hash::compute(body.get_view()));
+        buffer.write(body);
+
+        // Replace the cache atomically, a torn write would only cost a full rehash but there is no reason to risk it
+        auto temporary_file = this->file_;
+        temporary_file += ".tmp";
+
+        std::error_code ec{};
+        if (!utils::io::write_file(temporary_file, buffer.get_buffer()))
+        {
+            return;
+        }
+
+        std::filesystem::rename(temporary_file, this->file_, ec);
+        if (ec)
+        {
+            utils::io::remove_file(temporary_file);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <utils/concurrency.hpp>
+#include <utils/cryptography.hpp>
+
+namespace updater
+{
+    // Remembers the hash of every installed file together with its size and modification time, so a launch only
+    // rehashes files whose metadata changed since they were last verified. Persisted next to the install.
+    class file_state_cache
+    {
+      public:
+        static constexpr auto FILE_NAME = "w3m-files.cache";
+
+        // A missing or corrupt cache file just starts empty
+        explicit file_state_cache(std::filesystem::path file);
+
+        // Cached hash of a file if its size and modification time are unchanged
+        std::optional<utils::cryptography::sha1::digest> find(const std::string& name, const std::filesystem::path& path) const;
+
+        // Hashes the file, served from the cache if it is unchanged. Nothing if it can't be read.
+        std::optional<utils::cryptography::sha1::digest> get_hash(const std::string& name, const std::filesystem::path& path);
+
+        void store(const std::string& name, const std::filesystem::path& path, const utils::cryptography::sha1::digest& hash);
+
+        // Writes the cache if it changed
+        void save();
+
+      private:
+        struct entry
+        {
+            uint64_t size{};
+            int64_t modification_time{};
+            utils::cryptography::sha1::digest hash{};
+        };
+
+        struct state
+        {
+            std::unordered_map<std::string, entry> entries{};
+            bool dirty{};
+        };
+
+        std::filesystem::path file_{};
+        utils::concurrency::container<state> state_{};
+    };
+}
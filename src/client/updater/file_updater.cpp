@@ -3,15 +3,23 @@
 #include "updater.hpp"
 #include "updater_ui.hpp"
 #include "file_updater.hpp"
+#include "verified_file_sink.hpp"
+
+#include <fstream>
 
 #include <rapidjson/document.h>
 
 #include "../utils/http.hpp"
 
+#include <utils/binary_patch.hpp>
 #include <utils/cryptography.hpp>
+#include <utils/finally.hpp>
 #include <utils/io.hpp>
 
+// Can be overridden to test against a local server
+#ifndef UPDATE_SERVER
 #define UPDATE_SERVER      "https://data.momo5502.com/"
+#endif
 
 #define UPDATE_FILE_MAIN   UPDATE_SERVER "w3.json"
 #define UPDATE_FOLDER_MAIN UPDATE_SERVER "w3/"
@@ -22,6 +30,9 @@ namespace updater
 {
     namespace
     {
+        // Files this large are fetched in parallel ranges and hashed once complete
+        constexpr uint64_t RANGED_DOWNLOAD_SIZE = 16 * 1024 * 1024;
+
         std::string get_update_file()
         {
             return UPDATE_FILE_MAIN;
@@ -58,6 +69,24 @@ namespace updater
                 info.size = array[1].GetInt64();
                 info.hash.assign(array[2].GetString(), array[2].GetStringLength());
 
+                // Optional list of [base hash, patch size] deltas from previous versions
+                if (array.Size() > 3 && array[3].IsArray())
+                {
+                    for (const auto& patch : array[3].GetArray())
+                    {
+                        if (!patch.IsArray() || patch.Size() < 2 || !patch[0].IsString() || !patch[1].IsInt64())
+                        {
+                            continue;
+                        }
+
+                        file_patch patch_info{};
+                        patch_info.base_hash.assign(patch[0].GetString(), patch[0].GetStringLength());
+                        patch_info.size = patch[1].GetInt64();
+
+                        info.patches.emplace_back(std::move(patch_info));
+                    }
+                }
+
                 files.emplace_back(std::move(info));
             }
 
@@ -82,9 +111,23 @@ namespace updater
             return parse_file_infos(*json);
         }
 
-        std::string get_hash(const std::string& data)
+        // Patches live next to the file, named after the version they apply to
+        std::string get_patch_url(const file_info& file, const file_patch& patch)
+        {
+            return get_update_folder() + file.name + "." + patch.base_hash + ".patch?" + file.hash;
+        }
+
+        const file_patch* find_patch(const file_info& file, const utils::cryptography::sha1::digest& base_hash)
         {
-            return utils::cryptography::sha1::compute(data, true);
+            for (const auto& patch : file.patches)
+            {
+                if (utils::cryptography::matches_hex(base_hash, patch.base_hash))
+                {
+                    return &patch;
+                }
+            }
+
+            return nullptr;
         }
 
         const file_info* find_host_file_info(const std::vector<file_info>& outdated_files)
@@ -107,6 +150,13 @@ namespace updater
             return std::max(1ull, std::min(cores, file_count));
         }
 
+        size_t get_optimal_concurrent_check_count(const size_t file_count)
+        {
+            // Cold checks are bound by disk reads, a few more threads than cores keep the queue full
+            const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+            return std::max(1ull, std::min(threads * 2, file_count));
+        }
+
         bool is_inside_folder(const std::filesystem::path& file, const std::filesystem::path& folder)
         {
             const auto relative = std::filesystem::relative(file, folder);
@@ -119,7 +169,8 @@ namespace updater
         : listener_(listener),
           base_(std::move(base)),
           process_file_(std::move(process_file)),
-          dead_process_file_(process_file_)
+          dead_process_file_(process_file_),
+          state_cache_(base_ / file_state_cache::FILE_NAME)
     {
         this->dead_process_file_.replace_extension(".exe.old");
         this->delete_old_process_file();
@@ -134,44 +185,164 @@ namespace updater
         }
 
         const auto outdated_files = this->get_outdated_files(files);
+        this->state_cache_.save();
+
         if (outdated_files.empty())
         {
             return;
         }
 
+        // The host binary relaunches the process, which rehashes the files it got but keeps everything else cached
         this->update_host_binary(outdated_files);
+
+        auto save_cache = utils::finally([&] { this->state_cache_.save(); });
         this->update_files(outdated_files);
 
         std::this_thread::sleep_for(1s);
     }
 
     void file_updater::update_file(const file_info& file) const
+    {
+        const auto out_file = this->get_drive_filename(file);
+        if (out_file.has_parent_path())
+        {
+            utils::io::create_directory(out_file.parent_path());
+        }
+
+        // Only a verified download replaces the file, a crash or failure leaves the old one in place
+        auto temporary_file = out_file;
+        temporary_file += ".download";
+
+        auto remove_temporary_file = utils::finally([&] { utils::io::remove_file(temporary_file); });
+
+        // A patch against the installed version is usually a fraction of the full file
+        auto digest = this->patch_file(file, out_file, temporary_file);
+        if (!digest)
+        {
+            digest = this->download_file(file, temporary_file);
+        }
+
+        std::error_code ec{};
+        std::filesystem::rename(temporary_file, out_file, ec);
+        if (ec)
+        {
+            throw std::runtime_error("Failed to write: " + file.name);
+        }
+
+        this->state_cache_.store(file.name, out_file, *digest);
+    }
+
+    utils::cryptography::sha1::digest file_updater::download_file(const file_info& file, const std::filesystem::path& output_file) const
     {
         const auto url = get_update_folder() + file.name + "?" + file.hash;
+        const auto progress = [&](const size_t progress) { this->listener_.file_progress(file, progress); };
+
+        if (file.size >= RANGED_DOWNLOAD_SIZE)
+        {
+            // Ranges arrive out of order, so the file is hashed after the download instead of while streaming
+            const auto hash = utils::http::download_file(url, output_file, file.size, progress)
+                                  ? utils::cryptography::sha1::compute_file(output_file)
+                                  : std::nullopt;
 
-        const auto data = utils::http::get_data(url, {}, [&](const size_t progress) { this->listener_.file_progress(file, progress); });
+            if (!hash || !utils::cryptography::matches_hex(*hash, file.hash))
+            {
+                throw std::runtime_error("Failed to download: " + url);
+            }
+
+            return *hash;
+        }
 
-        if (!data || (data->size() != file.size || get_hash(*data) != file.hash))
+        verified_file_sink sink(output_file, file);
+        if (!utils::http::get_data(url, sink, {}, progress) || !sink.finish())
         {
             throw std::runtime_error("Failed to download: " + url);
         }
 
-        const auto out_file = this->get_drive_filename(file);
-        if (!utils::io::write_file(out_file, *data, false))
+        return sink.get_digest();
+    }
+
+    std::optional<utils::cryptography::sha1::digest> file_updater::patch_file(const file_info& file, const std::filesystem::path& base_file,
+                                                                              const std::filesystem::path& output_file) const
+    {
+        if (file.patches.empty())
         {
-            throw std::runtime_error("Failed to write: " + file.name);
+            return std::nullopt;
+        }
+
+        // Usually cached from the outdated check
+        const auto base_hash = this->state_cache_.get_hash(file.name, base_file);
+        if (!base_hash)
+        {
+            return std::nullopt;
+        }
+
+        const auto* patch = find_patch(file, *base_hash);
+        if (!patch)
+        {
+            return std::nullopt;
+        }
+
+        const auto patch_data = utils::http::get_data(get_patch_url(file, *patch), {},
+                                                      [&](const size_t progress) { this->listener_.file_progress(file, progress); });
+
+        if (!patch_data || patch_data->size() != patch->size)
+        {
+            return std::nullopt;
+        }
+
+        std::ifstream base(base_file, std::ios::binary);
+        if (!base)
+        {
+            return std::nullopt;
+        }
+
+        // The base is read as the patch needs it and the result is hashed on the way to disk
+        verified_file_sink sink(output_file, file);
+        sink.begin();
+
+        const auto write = [&](const std::string_view data) { return sink.write(data); };
+        if (!utils::binary_patch::apply_patch(base, *patch_data, write) || !sink.finish())
+        {
+            return std::nullopt;
         }
+
+        return sink.get_digest();
     }
 
     std::vector<file_info> file_updater::get_outdated_files(const std::vector<file_info>& files) const
     {
+        std::vector<char> outdated(files.size(), 0);
+        std::atomic<size_t> current_index{0};
+
+        // Warm checks only stat the files, cold ones hash them, both spread over all cores
+        const auto thread_count = get_optimal_concurrent_check_count(files.size());
+
+        std::vector<std::thread> threads{};
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([&]() {
+                for (auto index = current_index++; index < files.size(); index = current_index++)
+                {
+                    outdated[index] = this->is_outdated_file(files[index]) ? 1 : 0;
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+
         std::vector<file_info> outdated_files{};
 
-        for (const auto& info : files)
+        for (size_t i = 0; i < files.size(); ++i)
         {
-            if (this->is_outdated_file(info))
+            if (outdated[i])
             {
-                outdated_files.emplace_back(info);
+                outdated_files.emplace_back(files[i]);
             }
         }
 
@@ -271,20 +442,16 @@ namespace updater
         }
 #endif
 
-        std::string data{};
         const auto drive_name = this->get_drive_filename(file);
-        if (!utils::io::read_file(drive_name, &data))
-        {
-            return true;
-        }
 
-        if (data.size() != file.size)
+        std::error_code ec{};
+        if (std::filesystem::file_size(drive_name, ec) != file.size || ec)
         {
             return true;
         }
 
-        const auto hash = get_hash(data);
-        return hash != file.hash;
+        const auto hash = this->state_cache_.get_hash(file.name, drive_name);
+        return !hash || !utils::cryptography::matches_hex(*hash, file.hash);
     }
 
     std::filesystem::path file_updater::get_drive_filename(const file_info& file) const
@@ -344,6 +511,11 @@ namespace updater
                 continue;
             }
 
+            if (entry.string() == file_state_cache::FILE_NAME)
+            {
+                continue;
+            }
+
             bool found = false;
             for (const auto& wantedFile : files)
             {
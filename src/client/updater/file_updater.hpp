@@ -1,5 +1,6 @@
 #pragma once
 
+#include "file_state_cache.hpp"
 #include "progress_listener.hpp"
 
 namespace updater
@@ -24,8 +25,16 @@ namespace updater
         std::filesystem::path process_file_;
         std::filesystem::path dead_process_file_;
 
+        mutable file_state_cache state_cache_;
+
         void update_file(const file_info& file) const;
 
+        // Both write the new version to output_file and return its hash. Patching returns nothing if no patch
+        // applies to the installed version or it fails, downloading throws.
+        utils::cryptography::sha1::digest download_file(const file_info& file, const std::filesystem::path& output_file) const;
+        std::optional<utils::cryptography::sha1::digest> patch_file(const file_info& file, const std::filesystem::path& base_file,
+                                                                    const std::filesystem::path& output_file) const;
+
         [[nodiscard]] bool is_outdated_file(const file_info& file) const;
         [[nodiscard]] std::filesystem::path get_drive_filename(const file_info& file) const;
 
@@ -0,0 +1,45 @@
+#include "../std_include.hpp"
+
+#include "verified_file_sink.hpp"
+
+namespace updater
+{
+    verified_file_sink::verified_file_sink(std::filesystem::path path, const file_info& file)
+        : path_(std::move(path)),
+          file_(file)
+    {
+    }
+
+    void verified_file_sink::begin()
+    {
+        this->stream_.close();
+        this->stream_.clear();
+        this->stream_.open(this->path_, std::ios::binary | std::ios::trunc);
+
+        this->hasher_.reset();
+        this->size_ = 0;
+    }
+
+    bool verified_file_sink::write(const std::string_view data)
+    {
+        this->size_ += data.size();
+        if (this->size_ > this->file_.size)
+        {
+            return false;
+        }
+
+        this->hasher_.update(data);
+        this->stream_.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+        return this->stream_.good();
+    }
+
+    bool verified_file_sink::finish()
+    {
+        this->stream_.close();
+        this->digest_ = this->hasher_.finalize();
+
+        return !this->stream_.fail() && this->size_ == this->file_.size &&
+               utils::cryptography::matches_hex(this->digest_, this->file_.hash);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+
+#include <utils/cryptography.hpp>
+
+#include "file_info.hpp"
+#include "../utils/http.hpp"
+
+namespace updater
+{
+    // Writes a download to a temporary file and hashes it on the way, so nothing is held in memory
+    class verified_file_sink final : public utils::http::download_sink
+    {
+      public:
+        verified_file_sink(std::filesystem::path path, const file_info& file);
+
+        void begin() override;
+
+        // Anything beyond the expected size is rejected before it fills the disk
+        bool write(std::string_view data) override;
+
+        // Closes the file, true if it is complete and matches the expected hash
+        bool finish();
+
+        const utils::cryptography::sha1::digest& get_digest() const
+        {
+            return this->digest_;
+        }
+
+      private:
+        std::filesystem::path path_{};
+        const file_info& file_;
+
+        std::ofstream stream_{};
+        utils::cryptography::sha1::hasher hasher_{};
+        utils::cryptography::sha1::digest digest_{};
+        size_t size_{};
+    };
+}
@@ -2,7 +2,14 @@
 #include <curl/curl.h>
 #include <utils/finally.hpp>
 
+#include <array>
+#include <deque>
+#include <fstream>
+#include <mutex>
+
+#ifdef _MSC_VER
 #pragma comment(lib, "ws2_32.lib")
+#endif
 
 namespace utils::http
 {
@@ -11,9 +18,140 @@ namespace utils::http
         struct progress_helper
         {
             const std::function<void(size_t)>* callback{};
+            download_sink* sink{};
             std::exception_ptr exception{};
         };
 
+        class string_sink final : public download_sink
+        {
+          public:
+            void begin() override
+            {
+                this->data.clear();
+            }
+
+            bool write(const std::string_view data) override
+            {
+                this->data.append(data);
+                return true;
+            }
+
+            std::string data{};
+        };
+
+        class file_sink final : public download_sink
+        {
+          public:
+            explicit file_sink(std::filesystem::path file)
+                : file_(std::move(file))
+            {
+            }
+
+            void begin() override
+            {
+                this->stream_.close();
+                this->stream_.clear();
+                this->stream_.open(this->file_, std::ios::binary | std::ios::trunc);
+                this->size_ = 0;
+            }
+
+            bool write(const std::string_view data) override
+            {
+                this->stream_.write(data.data(), static_cast<std::streamsize>(data.size()));
+                this->size_ += data.size();
+                return this->stream_.good();
+            }
+
+            // Closes the file, true if nothing failed and it holds size bytes
+            bool finish(const uint64_t size)
+            {
+                this->stream_.close();
+                return !this->stream_.fail() && this->size_ == size;
+            }
+
+          private:
+            std::filesystem::path file_{};
+            std::ofstream stream_{};
+            uint64_t size_{};
+        };
+
+        // Connections, DNS results and TLS sessions are shared by all requests, so requests to a host that was
+        // contacted before reuse an idle connection instead of paying for a new TCP and TLS handshake
+        class connection_pool
+        {
+          public:
+            connection_pool()
+            {
+                curl_global_init(CURL_GLOBAL_DEFAULT);
+
+                this->share_ = curl_share_init();
+                if (!this->share_)
+                {
+                    return;
+                }
+
+                curl_share_setopt(this->share_, CURLSHOPT_LOCKFUNC, lock_callback);
+                curl_share_setopt(this->share_, CURLSHOPT_UNLOCKFUNC, unlock_callback);
+                curl_share_setopt(this->share_, CURLSHOPT_USERDATA, this);
+                curl_share_setopt(this->share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+                curl_share_setopt(this->share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+                curl_share_setopt(this->share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            }
+
+            ~connection_pool()
+            {
+                if (this->share_)
+                {
+                    curl_share_cleanup(this->share_);
+                }
+            }
+
+            connection_pool(connection_pool&&) = delete;
+            connection_pool(const connection_pool&) = delete;
+            connection_pool& operator=(connection_pool&&) = delete;
+            connection_pool& operator=(const connection_pool&) = delete;
+
+            CURLSH* get() const
+            {
+                return this->share_;
+            }
+
+          private:
+            CURLSH* share_{};
+            std::array<std::mutex, CURL_LOCK_DATA_LAST> locks_{};
+
+            static void lock_callback(CURL* /*handle*/, const curl_lock_data data, curl_lock_access /*access*/, void* userptr)
+            {
+                static_cast<connection_pool*>(userptr)->locks_[data].lock();
+            }
+
+            static void unlock_callback(CURL* /*handle*/, const curl_lock_data data, void* userptr)
+            {
+                static_cast<connection_pool*>(userptr)->locks_[data].unlock();
+            }
+        };
+
+        CURLSH* get_connection_pool()
+        {
+            static connection_pool pool{};
+            return pool.get();
+        }
+
+        void configure_handle(CURL* curl)
+        {
+            curl_easy_setopt(curl, CURLOPT_SHARE, get_connection_pool());
+            curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+            // Falls back to HTTP/1.1 if either side lacks HTTP/2
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+
+            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+            curl_easy_setopt(curl, CURLOPT_USERAGENT, "w3m-client/1.0");
+            curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+        }
+
         int progress_callback(void* clientp, const curl_off_t /*dltotal*/, const curl_off_t dlnow, const curl_off_t /*ultotal*/,
                               const curl_off_t /*ulnow*/)
         {
@@ -37,21 +175,29 @@ namespace utils::http
 
         size_t write_callback(void* contents, const size_t size, const size_t nmemb, void* userp)
         {
-            auto* buffer = static_cast<std::string*>(userp);
-
+            auto* helper = static_cast<progress_helper*>(userp);
             const auto total_size = size * nmemb;
-            buffer->append(static_cast<char*>(contents), total_size);
-            return total_size;
+
+            try
+            {
+                // Anything but total_size makes curl abort with CURLE_WRITE_ERROR
+                return helper->sink->write(std::string_view(static_cast<char*>(contents), total_size)) ? total_size : 0;
+            }
+            catch (...)
+            {
+                helper->exception = std::current_exception();
+                return 0;
+            }
         }
 
-        std::optional<std::string> perform_request(const std::string& url, const std::string* post_body, const headers& headers,
-                                                   const std::function<void(size_t)>& callback, const uint32_t retries)
+        bool perform_request(const std::string& url, const std::string* post_body, download_sink& sink, const headers& headers,
+                             const std::function<void(size_t)>& callback, const uint32_t retries)
         {
             curl_slist* header_list = nullptr;
             auto* curl = curl_easy_init();
             if (!curl)
             {
-                return {};
+                return false;
             }
 
             auto _ = utils::finally([&]() {
@@ -65,22 +211,18 @@ namespace utils::http
                 header_list = curl_slist_append(header_list, data.data());
             }
 
-            std::string buffer{};
             progress_helper helper{};
             helper.callback = &callback;
+            helper.sink = &sink;
 
+            configure_handle(curl);
             curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
             curl_easy_setopt(curl, CURLOPT_URL, url.data());
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &helper);
             curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progress_callback);
             curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &helper);
             curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-            curl_easy_setopt(curl, CURLOPT_USERAGENT, "w3m-client/1.0");
-            curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-            curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
 
             if (post_body)
             {
@@ -90,6 +232,8 @@ namespace utils::http
 
             for (auto i = 0u; i < retries + 1; ++i)
             {
+                sink.begin();
+
                 // Due to CURLOPT_FAILONERROR, CURLE_OK will not be met when the server returns 400 or 500
                 if (curl_easy_perform(curl) == CURLE_OK)
                 {
@@ -98,7 +242,7 @@ namespace utils::http
 
                     if (http_code >= 200)
                     {
-                        return {std::move(buffer)};
+                        return true;
                     }
 
                     throw std::runtime_error("Bad status code " + std::to_string(http_code) + " met while trying to download file " + url);
@@ -118,7 +262,271 @@ namespace utils::http
                 }
             }
 
-            return {};
+            return false;
+        }
+
+        std::optional<std::string> perform_request(const std::string& url, const std::string* post_body, const headers& headers,
+                                                   const std::function<void(size_t)>& callback, const uint32_t retries)
+        {
+            string_sink sink{};
+            if (!perform_request(url, post_body, sink, headers, callback, retries))
+            {
+                return {};
+            }
+
+            return {std::move(sink.data)};
+        }
+
+        // ===========================================================================
+        // RANGED DOWNLOADS
+        // ===========================================================================
+        // A file is split into ranges that run as concurrent transfers on one multi
+        // handle. With HTTP/2 they share one connection, otherwise each transfer gets
+        // its own pooled connection. A transfer that finishes a range picks up the
+        // next one, a failed range goes back to the front of the queue and resumes
+        // at the first byte that did not arrive.
+        // ===========================================================================
+
+        struct byte_range
+        {
+            uint64_t offset{};
+            uint64_t end{};
+            uint32_t failures{};
+        };
+
+        struct ranged_download
+        {
+            std::ofstream stream{};
+            std::vector<byte_range> ranges{};
+            uint64_t received{};
+            const std::function<void(size_t)>* callback{};
+            bool ranges_ignored{};
+            std::exception_ptr exception{};
+        };
+
+        struct range_transfer
+        {
+            ranged_download* download{};
+            CURL* curl{};
+            size_t range{};
+            bool active{};
+            bool status_checked{};
+        };
+
+        enum class ranged_result
+        {
+            complete,
+            failed,
+            unsupported,
+        };
+
+        size_t range_write_callback(void* contents, const size_t size, const size_t nmemb, void* userp)
+        {
+            auto* transfer = static_cast<range_transfer*>(userp);
+            auto& download = *transfer->download;
+            auto& range = download.ranges[transfer->range];
+            const auto total_size = size * nmemb;
+
+            try
+            {
+                if (!transfer->status_checked)
+                {
+                    // A full response instead of a partial one means the server ignores ranges
+                    long http_code = 0;
+                    curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &http_code);
+                    if (http_code != 206)
+                    {
+                        download.ranges_ignored = true;
+                        return 0;
+                    }
+
+                    transfer->status_checked = true;
+                }
+
+                if (total_size > range.end - range.offset)
+                {
+                    return 0;
+                }
+
+                download.stream.seekp(static_cast<std::streamoff>(range.offset));
+                download.stream.write(static_cast<char*>(contents), static_cast<std::streamsize>(total_size));
+                if (!download.stream.good())
+                {
+                    return 0;
+                }
+
+                range.offset += total_size;
+                download.received += total_size;
+
+                if (*download.callback)
+                {
+                    (*download.callback)(static_cast<size_t>(download.received));
+                }
+
+                return total_size;
+            }
+            catch (...)
+            {
+                download.exception = std::current_exception();
+                return 0;
+            }
+        }
+
+        ranged_result perform_ranged_download(const std::string& url, const std::filesystem::path& file, const uint64_t size,
+                                              const std::function<void(size_t)>& callback, const range_options& options)
+        {
+            ranged_download download{};
+            download.callback = &callback;
+
+            for (uint64_t offset = 0; offset < size; offset += options.chunk_size)
+            {
+                download.ranges.push_back({offset, std::min(size, offset + options.chunk_size)});
+            }
+
+            download.stream.open(file, std::ios::binary | std::ios::trunc);
+            if (!download.stream)
+            {
+                return ranged_result::failed;
+            }
+
+            auto* multi = curl_multi_init();
+            if (!multi)
+            {
+                return ranged_result::failed;
+            }
+
+            std::vector<range_transfer> transfers(std::min(options.connections, download.ranges.size()));
+
+            auto _ = utils::finally([&]() {
+                for (const auto& transfer : transfers)
+                {
+                    if (transfer.active)
+                    {
+                        curl_multi_remove_handle(multi, transfer.curl);
+                    }
+
+                    curl_easy_cleanup(transfer.curl);
+                }
+
+                curl_multi_cleanup(multi);
+            });
+
+            curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+            curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(transfers.size()));
+
+            std::deque<size_t> pending_ranges{};
+            for (size_t i = 0; i < download.ranges.size(); ++i)
+            {
+                pending_ranges.push_back(i);
+            }
+
+            size_t active_transfers = 0;
+            const auto start_transfer = [&](range_transfer& transfer) {
+                if (pending_ranges.empty())
+                {
+                    return true;
+                }
+
+                transfer.range = pending_ranges.front();
+                pending_ranges.pop_front();
+
+                const auto& range = download.ranges[transfer.range];
+                const auto range_value = std::to_string(range.offset) + "-" + std::to_string(range.end - 1);
+
+                transfer.status_checked = false;
+                curl_easy_setopt(transfer.curl, CURLOPT_RANGE, range_value.data());
+
+                transfer.active = curl_multi_add_handle(multi, transfer.curl) == CURLM_OK;
+                active_transfers += transfer.active ? 1 : 0;
+                return transfer.active;
+            };
+
+            for (auto& transfer : transfers)
+            {
+                transfer.download = &download;
+                transfer.curl = curl_easy_init();
+                if (!transfer.curl)
+                {
+                    return ranged_result::failed;
+                }
+
+                configure_handle(transfer.curl);
+                curl_easy_setopt(transfer.curl, CURLOPT_URL, url.data());
+                curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, range_write_callback);
+                curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer);
+                curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+
+                // Wait for a connection that can multiplex rather than opening another one
+                curl_easy_setopt(transfer.curl, CURLOPT_PIPEWAIT, 1L);
+
+                if (!start_transfer(transfer))
+                {
+                    return ranged_result::failed;
+                }
+            }
+
+            while (active_transfers > 0)
+            {
+                int running = 0;
+                if (curl_multi_perform(multi, &running) != CURLM_OK)
+                {
+                    return ranged_result::failed;
+                }
+
+                int queued = 0;
+                while (const auto* message = curl_multi_info_read(multi, &queued))
+                {
+                    if (message->msg != CURLMSG_DONE)
+                    {
+                        continue;
+                    }
+
+                    range_transfer* transfer{};
+                    curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &transfer);
+
+                    curl_multi_remove_handle(multi, transfer->curl);
+                    transfer->active = false;
+                    --active_transfers;
+
+                    if (download.exception)
+                    {
+                        std::rethrow_exception(download.exception);
+                    }
+
+                    if (download.ranges_ignored)
+                    {
+                        return ranged_result::unsupported;
+                    }
+
+                    auto& range = download.ranges[transfer->range];
+                    if (range.offset < range.end)
+                    {
+                        // Error responses won't change on a retry, broken connections might
+                        long http_code = 0;
+                        curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+                        if (http_code >= 400 || ++range.failures > options.retries)
+                        {
+                            return ranged_result::failed;
+                        }
+
+                        pending_ranges.push_front(transfer->range);
+                    }
+
+                    if (!start_transfer(*transfer))
+                    {
+                        return ranged_result::failed;
+                    }
+                }
+
+                if (active_transfers > 0 && curl_multi_poll(multi, nullptr, 0, 1000, nullptr) != CURLM_OK)
+                {
+                    return ranged_result::failed;
+                }
+            }
+
+            download.stream.close();
+            return !download.stream.fail() && download.received == size ? ranged_result::complete : ranged_result::failed;
         }
     }
 
@@ -143,4 +551,26 @@ namespace utils::http
     {
         return std::async(std::launch::async, [url, headers] { return get_data(url, headers); });
     }
-}
+
+    bool get_data(const std::string& url, download_sink& sink, const headers& headers, const std::function<void(size_t)>& callback,
+                  const uint32_t retries)
+    {
+        return perform_request(url, {}, sink, headers, callback, retries);
+    }
+
+    bool download_file(const std::string& url, const std::filesystem::path& file, const uint64_t size,
+                       const std::function<void(size_t)>& callback, const range_options& options)
+    {
+        if (options.connections > 1 && options.chunk_size > 0 && size >= options.chunk_size * 2)
+        {
+            const auto result = perform_ranged_download(url, file, size, callback, options);
+            if (result != ranged_result::unsupported)
+            {
+                return result == ranged_result::complete;
+            }
+        }
+
+        file_sink sink(file);
+        return perform_request(url, {}, sink, {}, callback, options.retries) && sink.finish(size);
+    }
+}
\ No newline at end of file
@@ -1,13 +1,31 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <future>
+#include <unordered_map>
 
 namespace utils::http
 {
     using headers = std::unordered_map<std::string, std::string>;
 
+    // Receives a response body piece by piece instead of buffering it
+    class download_sink
+    {
+      public:
+        virtual ~download_sink() = default;
+
+        // Called before every attempt, a retry starts the body over
+        virtual void begin() = 0;
+
+        // Returning false aborts the transfer
+        virtual bool write(std::string_view data) = 0;
+    };
+
     std::optional<std::string> post_data(const std::string& url, const std::string& post_body, const headers& headers = {},
                                          const std::function<void(size_t)>& callback = {}, uint32_t retries = 2);
     std::future<std::optional<std::string>> post_data_async(const std::string& url, const std::string& post_body,
@@ -16,4 +34,23 @@ namespace utils::http
     std::optional<std::string> get_data(const std::string& url, const headers& headers = {},
                                         const std::function<void(size_t)>& callback = {}, uint32_t retries = 2);
     std::future<std::optional<std::string>> get_data_async(const std::string& url, const headers& headers = {});
+
+    // Streams the body into sink, returns whether the transfer completed
+    bool get_data(const std::string& url, download_sink& sink, const headers& headers = {},
+                  const std::function<void(size_t)>& callback = {}, uint32_t retries = 2);
+
+    struct range_options
+    {
+        // Files smaller than two chunks are fetched in one request
+        uint64_t chunk_size = 4 * 1024 * 1024;
+        size_t connections = 4;
+
+        // Per range, a failed range resumes at the first byte it is missing
+        uint32_t retries = 2;
+    };
+
+    // Downloads size bytes into file as parallel Range requests, multiplexed over one connection where HTTP/2 is
+    // available. Servers that ignore ranges get a single request instead. The callback receives the total so far.
+    bool download_file(const std::string& url, const std::filesystem::path& file, uint64_t size,
+                       const std::function<void(size_t)>& callback = {}, const range_options& options = {});
 }
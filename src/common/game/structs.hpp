@@ -5,7 +5,7 @@
 
 namespace game
 {
-    constexpr uint32_t PROTOCOL = 6;
+    constexpr uint32_t PROTOCOL = 13;
 
     using vec3_t = std::array<double, 3>;
     using vec4_t = std::array<double, 4>;
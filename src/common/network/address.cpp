@@ -1,8 +1,11 @@
 #include "address.hpp"
 
+#include <array>
+#include <cstring>
 #include <stdexcept>
 
 #include "../utils/finally.hpp"
+#include "../utils/hash.hpp"
 
 #ifdef _WIN32
 #pragma comment(lib, "ws2_32.lib")
@@ -355,21 +358,30 @@ namespace network
 
 std::size_t std::hash<network::address>::operator()(const network::address& a) const noexcept
 {
-    const uint32_t family = a.get_addr().sa_family;
-    const uint32_t port = a.get_port();
+    // family, port and address packed without padding, so equal addresses always hash the same
+    std::array<uint8_t, sizeof(uint16_t) * 2 + sizeof(in6_addr)> key{};
+    size_t length = 0;
+
+    const auto append = [&](const void* data, const size_t size) {
+        memcpy(key.data() + length, data, size);
+        length += size;
+    };
+
+    const auto family = static_cast<uint16_t>(a.get_addr().sa_family);
+    const auto port = a.get_port();
+
+    append(&family, sizeof(family));
+    append(&port, sizeof(port));
 
-    std::size_t hash = std::hash<uint32_t>{}(family);
-    hash ^= std::hash<uint32_t>{}(port);
     switch (a.get_addr().sa_family)
     {
     case AF_INET:
-        hash ^= std::hash<decltype(a.get_in_addr().sin_addr.s_addr)>{}(a.get_in_addr().sin_addr.s_addr);
+        append(&a.get_in_addr().sin_addr, sizeof(a.get_in_addr().sin_addr));
         break;
     case AF_INET6:
-        hash ^= std::hash<std::string_view>{}(std::string_view{reinterpret_cast<const char*>(a.get_in6_addr().sin6_addr.s6_addr),
-                                                               sizeof(a.get_in6_addr().sin6_addr.s6_addr)});
+        append(&a.get_in6_addr().sin6_addr, sizeof(a.get_in6_addr().sin6_addr));
         break;
     }
 
-    return hash;
+    return static_cast<std::size_t>(utils::hash::compute(key.data(), length));
 }
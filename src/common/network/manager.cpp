@@ -1,6 +1,9 @@
 #include "manager.hpp"
 
 #include "socket.hpp"
+#include "packet_dictionary.hpp"
+
+#include "../security/session_cipher.hpp"
 
 #include "../utils/thread.hpp"
 #include "../utils/string.hpp"
@@ -68,12 +71,75 @@ namespace network
 
         constexpr size_t MAX_PACKET_BYTES = 8 * 1024; // Hardened security budget
 
-        void handle_data(const utils::concurrency::container<manager::callback_map>& callbacks, const address& source,
-                         const std::string& packet)
+        constexpr int32_t PLAIN_MAGIC = -1;
+        constexpr int32_t COMPRESSED_MAGIC = -2;
+        constexpr int32_t SEALED_MAGIC = -3;
+        constexpr auto MAGIC_SIZE = sizeof(int32_t);
+
+        // Sealed packets: magic, sequence, then a plain or compressed frame and the tag
+        constexpr auto SEALED_HEADER_SIZE = MAGIC_SIZE + security::SEQUENCE_SIZE;
+
+        void handle_payload(const utils::concurrency::container<manager::callback_map>& callbacks, const address& source,
+                            const std::string_view buffer)
         {
-            constexpr int32_t magic = -1;
-            constexpr auto magic_size = sizeof(magic);
+            const auto divider = buffer.find_first_of(" \n");
+            if (divider == std::string_view::npos)
+            {
+                return;
+            }
+
+            const std::string_view command(buffer.data(), divider);
+            if (command.empty())
+            {
+                return;
+            }
+
+            const auto data_start = divider + 1;
+            const std::string_view data(buffer.data() + data_start, buffer.size() - data_start);
+
+            dispatch_command(callbacks, source, command, data);
+        }
+
+        // Plain or compressed frame, sealed packets carry one of these
+        void handle_frame(const utils::concurrency::container<manager::callback_map>& callbacks, const address& source,
+                          const std::string_view frame)
+        {
+            if (frame.size() < (MAGIC_SIZE + 1))
+            {
+                return;
+            }
+
+            const auto buffer = frame.substr(MAGIC_SIZE);
+
+            if (memcmp(frame.data(), &PLAIN_MAGIC, MAGIC_SIZE) == 0)
+            {
+                handle_payload(callbacks, source, buffer);
+                return;
+            }
+
+            if (memcmp(frame.data(), &COMPRESSED_MAGIC, MAGIC_SIZE) != 0)
+            {
+                return;
+            }
+
+            // Only the dispatcher thread receives, the buffer keeps its capacity across packets
+            thread_local utils::compression::zlib::decompressor decompressor(get_packet_dictionary());
+            thread_local std::string payload{};
 
+            if (!decompressor.decompress(payload, buffer, 0, MAX_PACKET_BYTES - MAGIC_SIZE))
+            {
+                printf("Dropping corrupt compressed packet (%zu bytes)\n", frame.size());
+                (void)fflush(stdout);
+                return;
+            }
+
+            handle_payload(callbacks, source, payload);
+        }
+
+        void handle_data(const utils::concurrency::container<manager::callback_map>& callbacks,
+                         utils::concurrency::container<manager::session_map>& sessions, const std::chrono::milliseconds session_timeout,
+                         const address& source, std::string& packet)
+        {
             if (packet.size() > MAX_PACKET_BYTES)
             {
                 printf("Security: Dropping packet larger than %zu bytes (received %zu bytes)\n", MAX_PACKET_BYTES, packet.size());
@@ -81,31 +147,53 @@ namespace network
                 return;
             }
 
-            if (packet.size() < (magic_size + 1) || memcmp(packet.data(), &magic, magic_size) != 0)
+            if (packet.size() < (MAGIC_SIZE + 1))
             {
                 return;
             }
 
-            const std::string_view buffer(packet.data() + magic_size, packet.size() - magic_size);
-            const auto divider = buffer.find_first_of(" \n");
-            if (divider == std::string_view::npos)
+            const auto session = sessions.access<manager::session>([&](const manager::session_map& map) {
+                const auto entry = map.find(source);
+                return entry == map.end() ? manager::session{} : entry->second;
+            });
+
+            const auto now = std::chrono::steady_clock::now();
+
+            if (memcmp(packet.data(), &SEALED_MAGIC, MAGIC_SIZE) != 0)
             {
+                // Once both ends hold the keys, anything unsealed is spoofed or stale. A session that went quiet
+                // lets the peer's new handshake through instead, the peer might have lost its keys.
+                if (!session.is_sealing(now, session_timeout))
+                {
+                    handle_frame(callbacks, source, packet);
+                }
+
                 return;
             }
 
-            const std::string_view command(buffer.data(), divider);
-            if (command.empty())
+            if (!session.cipher || !session.cipher->open(packet, MAGIC_SIZE))
             {
                 return;
             }
 
-            const auto data_start = divider + 1;
-            const std::string_view data(buffer.data() + data_start, buffer.size() - data_start);
+            if (!session.confirmed || session_timeout.count() != 0)
+            {
+                sessions.access([&](manager::session_map& map) {
+                    const auto entry = map.find(source);
+                    if (entry != map.end() && entry->second.cipher == session.cipher)
+                    {
+                        entry->second.confirmed = true;
+                        entry->second.last_received = now;
+                    }
+                });
+            }
 
-            dispatch_command(callbacks, source, command, data);
+            handle_frame(callbacks, source, std::string_view(packet).substr(SEALED_HEADER_SIZE));
         }
 
-        bool receive_socket_data(const utils::concurrency::container<manager::callback_map>& callbacks, const socket& s)
+        bool receive_socket_data(const utils::concurrency::container<manager::callback_map>& callbacks,
+                                 utils::concurrency::container<manager::session_map>& sessions,
+                                 const std::chrono::milliseconds session_timeout, const socket& s)
         {
             address source{};
             std::string data{};
@@ -115,7 +203,7 @@ namespace network
                 return false;
             }
 
-            handle_data(callbacks, source, data);
+            handle_data(callbacks, sessions, session_timeout, source, data);
             return true;
         }
 
@@ -145,8 +233,9 @@ namespace network
     {
         while (!stop_token.stop_requested())
         {
-            const auto v4_handled = receive_socket_data(this->callbacks_, this->socket_v4_);
-            const auto v6_handled = receive_socket_data(this->callbacks_, this->socket_v6_);
+            const auto session_timeout = this->session_timeout_.load();
+            const auto v4_handled = receive_socket_data(this->callbacks_, this->sessions_, session_timeout, this->socket_v4_);
+            const auto v6_handled = receive_socket_data(this->callbacks_, this->sessions_, session_timeout, this->socket_v6_);
 
             if (!v4_handled && !v6_handled)
             {
@@ -162,14 +251,88 @@ namespace network
         this->callbacks_.access([&](callback_map& callbacks) { callbacks[utils::string::to_lower(command)] = std::move(callback); });
     }
 
-    bool manager::send(const address& address, const std::string& command, const std::string& data, const char separator) const
+    bool manager::send(const address& address, const std::string& command, const std::string_view data, const char separator) const
     {
-        std::string packet = "\xFF\xFF\xFF\xFF";
+        // Reused per thread, sending doesn't allocate once it has grown to the largest packet.
+        // The frame starts after room for the sealed header, so sealing happens in place.
+        thread_local std::string packet{};
+
+        packet.assign(SEALED_HEADER_SIZE, '\0');
+        packet.append(reinterpret_cast<const char*>(&PLAIN_MAGIC), MAGIC_SIZE);
         packet.append(command);
         packet.push_back(separator);
         packet.append(data);
 
-        return this->send_data(address, packet);
+        if (this->compression_)
+        {
+            thread_local utils::compression::zlib::compressor compressor(get_packet_dictionary());
+            thread_local std::string compressed{};
+
+            const auto payload = std::string_view(packet).substr(SEALED_HEADER_SIZE + MAGIC_SIZE);
+
+            // Tiny packets can still come out larger, those go out as they are
+            if (compressor.compress(compressed, payload, utils::compression::zlib::default_level) && compressed.size() < payload.size())
+            {
+                packet.resize(SEALED_HEADER_SIZE);
+                packet.append(reinterpret_cast<const char*>(&COMPRESSED_MAGIC), MAGIC_SIZE);
+                packet.append(compressed);
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto session_timeout = this->session_timeout_.load();
+
+        const auto cipher = this->sessions_.access<std::shared_ptr<security::session_cipher>>([&](const session_map& map) {
+            const auto entry = map.find(address);
+            return entry != map.end() && entry->second.is_sealing(now, session_timeout) ? entry->second.cipher : nullptr;
+        });
+
+        if (!cipher)
+        {
+            return this->send_data(address, packet.data() + SEALED_HEADER_SIZE, packet.size() - SEALED_HEADER_SIZE);
+        }
+
+        memcpy(packet.data(), &SEALED_MAGIC, MAGIC_SIZE);
+        packet.reserve(packet.size() + security::TAG_SIZE);
+
+        return cipher->seal(packet, MAGIC_SIZE) && this->send_data(address, packet);
+    }
+
+    void manager::set_compression(const bool enabled)
+    {
+        this->compression_ = enabled;
+    }
+
+    void manager::set_session(const address& address, std::shared_ptr<security::session_cipher> cipher, const bool confirmed)
+    {
+        this->sessions_.access(
+            [&](session_map& map) { map[address] = session{std::move(cipher), confirmed, std::chrono::steady_clock::now()}; });
+    }
+
+    void manager::set_session_timeout(const std::chrono::milliseconds timeout)
+    {
+        this->session_timeout_ = timeout;
+    }
+
+    bool manager::session::is_sealing(const std::chrono::steady_clock::time_point now, const std::chrono::milliseconds timeout) const
+    {
+        return this->confirmed && (timeout.count() == 0 || now - this->last_received <= timeout);
+    }
+
+    void manager::clear_session(const address& address)
+    {
+        this->sessions_.access([&](session_map& map) { map.erase(address); });
+    }
+
+    bool manager::is_sealing(const address& address) const
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto session_timeout = this->session_timeout_.load();
+
+        return this->sessions_.access<bool>([&](const session_map& map) {
+            const auto entry = map.find(address);
+            return entry != map.end() && entry->second.is_sealing(now, session_timeout);
+        });
     }
 
     bool manager::send_data(const address& address, const void* data, const size_t length) const
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <thread>
 #include <optional>
 #include <functional>
@@ -9,6 +12,11 @@
 
 #include "../utils/concurrency.hpp"
 
+namespace security
+{
+    class session_cipher;
+}
+
 namespace network
 {
     class manager
@@ -24,12 +32,44 @@ namespace network
         using callback = std::function<void(const address&, const std::string_view&)>;
         using callback_map = std::unordered_map<std::string, callback>;
 
+        struct session
+        {
+            std::shared_ptr<security::session_cipher> cipher{};
+
+            // Whether the peer is known to hold the keys, until then nothing is sealed and plain packets are accepted
+            bool confirmed{};
+
+            // Set up or last opened a sealed packet
+            std::chrono::steady_clock::time_point last_received{};
+
+            // A confirmed session that went quiet for longer than timeout is treated as unconfirmed
+            bool is_sealing(std::chrono::steady_clock::time_point now, std::chrono::milliseconds timeout) const;
+        };
+
+        using session_map = std::unordered_map<address, session>;
+
         void on(const std::string& command, callback callback);
-        bool send(const address& address, const std::string& command, const std::string& data = {}, char separator = ' ') const;
+        bool send(const address& address, const std::string& command, std::string_view data = {}, char separator = ' ') const;
 
         bool send_data(const address& address, const void* data, size_t length) const;
         bool send_data(const address& address, const std::string& data) const;
 
+        // Compresses outgoing packets against the trained packet dictionary when that makes them smaller.
+        // Compressed packets are always accepted, so only enable this once every peer speaks the current protocol.
+        void set_compression(bool enabled);
+
+        // Seals all packets to address once the session is confirmed, which happens with the first sealed packet
+        // received from it. A confirmed session drops everything from address that isn't sealed with its keys.
+        void set_session(const address& address, std::shared_ptr<security::session_cipher> cipher, bool confirmed);
+        void clear_session(const address& address);
+
+        // Whether packets to address are sealed, and so whether anything unsealed from it is dropped
+        bool is_sealing(const address& address) const;
+
+        // Without a sealed packet from the peer for this long, a confirmed session stops sealing and accepts plain
+        // packets again, so a new handshake can replace it, e.g. after the peer restarted. 0, the default, never does.
+        void set_session_timeout(std::chrono::milliseconds timeout);
+
         void stop();
 
         const socket& get_ipv4_socket() const;
@@ -39,7 +79,11 @@ namespace network
         socket socket_v4_{};
         socket socket_v6_{};
 
+        std::atomic_bool compression_{false};
+        std::atomic<std::chrono::milliseconds> session_timeout_{};
+
         utils::concurrency::container<callback_map> callbacks_{};
+        utils::concurrency::container<session_map> sessions_{};
 
         std::jthread thread_{};
 
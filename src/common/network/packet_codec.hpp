@@ -0,0 +1,170 @@
+#pragma once
+
+#include "protocol.hpp"
+#include "packet_schema.hpp"
+
+namespace network::protocol
+{
+    // ===========================================================================
+    // PACKET SCHEMAS
+    // ===========================================================================
+    // Wire layout of every packet in protocol.hpp. The structs stay the
+    // in-memory representation on both ends; only the fields listed here
+    // travel. New fields go at the end of a list with the next version number.
+    // ===========================================================================
+
+    template <>
+    struct schema<fact_packet>
+    {
+        using type = fields<field<&fact_packet::fact_name>,
+                            field<&fact_packet::value>,
+                            field<&fact_packet::timestamp>,
+                            field<&fact_packet::update, 2>>;
+    };
+
+    template <>
+    struct schema<fact_batch_packet>
+    {
+        using type = fields<list_field<&fact_batch_packet::facts, MAX_FACT_BATCH_SIZE>>;
+    };
+
+    template <>
+    struct schema<attack_packet>
+    {
+        using type = fields<field<&attack_packet::attacker_guid>,
+                            field<&attack_packet::target_tag>,
+                            field<&attack_packet::damage_amount>,
+                            field<&attack_packet::type>,
+                            field<&attack_packet::force_kill>,
+                            field<&attack_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<npc_update_packet>
+    {
+        using type = fields<field<&npc_update_packet::target_tag>,
+                            field<&npc_update_packet::damage_amount>,
+                            field<&npc_update_packet::hit_count>,
+                            field<&npc_update_packet::killed>,
+                            field<&npc_update_packet::killer_guid>,
+                            field<&npc_update_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<cutscene_packet>
+    {
+        using type = fields<field<&cutscene_packet::cutscene_path>,
+                            field<&cutscene_packet::position>,
+                            field<&cutscene_packet::rotation>,
+                            field<&cutscene_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<anim_packet>
+    {
+        using type = fields<field<&anim_packet::player_guid>,
+                            field<&anim_packet::anim_name>,
+                            field<&anim_packet::exploration_action>,
+                            field<&anim_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<vehicle_packet>
+    {
+        using type = fields<field<&vehicle_packet::player_guid>,
+                            field<&vehicle_packet::vehicle_template>,
+                            field<&vehicle_packet::is_mounting>,
+                            field<&vehicle_packet::vehicle_position>,
+                            field<&vehicle_packet::vehicle_rotation>,
+                            field<&vehicle_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<quest_lock_packet>
+    {
+        using type = fields<field<&quest_lock_packet::is_locked>,
+                            field<&quest_lock_packet::scene_id>,
+                            field<&quest_lock_packet::player_guid>,
+                            field<&quest_lock_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<loot_packet>
+    {
+        using type = fields<field<&loot_packet::item_name>,
+                            field<&loot_packet::quantity>,
+                            field<&loot_packet::player_guid>,
+                            field<&loot_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<achievement_packet>
+    {
+        using type = fields<field<&achievement_packet::achievement_id>,
+                            field<&achievement_packet::player_guid>,
+                            field<&achievement_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<handshake_packet>
+    {
+        using type = fields<field<&handshake_packet::session_id>,
+                            field<&handshake_packet::player_guid>,
+                            field<&handshake_packet::protocol_version>,
+                            field<&handshake_packet::player_name>,
+                            field<&handshake_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<heartbeat_packet>
+    {
+        using type = fields<field<&heartbeat_packet::player_guid>,
+                            field<&heartbeat_packet::total_crowns>,
+                            field<&heartbeat_packet::world_fact_hash>,
+                            field<&heartbeat_packet::script_version>,
+                            field<&heartbeat_packet::game_time>,
+                            field<&heartbeat_packet::weather_id>,
+                            field<&heartbeat_packet::timestamp>>;
+    };
+
+    template <>
+    struct schema<world_state_nodes_request_packet>
+    {
+        using type = fields<field<&world_state_nodes_request_packet::node>>;
+    };
+
+    template <>
+    struct schema<world_state_nodes_packet>
+    {
+        using type = fields<field<&world_state_nodes_packet::node>,
+                            field<&world_state_nodes_packet::children>>;
+    };
+
+    template <>
+    struct schema<world_state_bucket_request_packet>
+    {
+        using type = fields<field<&world_state_bucket_request_packet::bucket>,
+                            field<&world_state_bucket_request_packet::offset>>;
+    };
+
+    template <>
+    struct schema<world_state_bucket_packet>
+    {
+        using type = fields<field<&world_state_bucket_packet::bucket>,
+                            field<&world_state_bucket_packet::offset>,
+                            field<&world_state_bucket_packet::fact_count>,
+                            list_field<&world_state_bucket_packet::facts, MAX_BUCKET_PAGE_SIZE>>;
+    };
+
+    template <>
+    struct schema<player_state_packet>
+    {
+        using type = fields<field<&player_state_packet::player_guid>,
+                            field<&player_state_packet::position>,
+                            field<&player_state_packet::angles>,
+                            field<&player_state_packet::velocity>,
+                            field<&player_state_packet::move_type>,
+                            field<&player_state_packet::speed>,
+                            field<&player_state_packet::binary_state>>;
+    };
+}
@@ -0,0 +1,270 @@
+#include "packet_dictionary.hpp"
+
+#include "../game/structs.hpp"
+
+// Generated by the packet_dictionary benchmark case, see src/benchmark/packet_dictionary.cpp
+
+namespace network
+{
+    namespace
+    {
+        constexpr uint32_t TRAINED_PROTOCOL = 13;
+        static_assert(TRAINED_PROTOCOL == game::PROTOCOL, "Retrain the packet dictionary for the new game::PROTOCOL");
+
+        // Command texts, interned names and padded player records of a typical session, most common last
+        constexpr unsigned char dictionary_data[] = {
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA4, 0xD2, 0x3B, 0xEA, 0xAC, 0x6A, 0x5A, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA4, 0xCD, 0x41, 0xA2, 0xEB, 0x12, 0x9B, 0x40, 0x0E,
+            0x56, 0xCB, 0x68, 0x66, 0x42, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0x5A, 0x01, 0x9E, 0xAE, 0xCC, 0x5D, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x13, 0xA4, 0x1C, 0x99, 0xA3, 0x95, 0x40, 0x2F,
+            0xB7, 0x35, 0xBA, 0x2C, 0x72, 0x87, 0xC0, 0xA5, 0x68, 0x3B, 0x3F, 0x7A, 0x11, 0x8B, 0x52, 0x40,
+            0x64, 0xF8, 0xBF, 0x2B, 0x2E, 0x3F, 0xD2, 0x42, 0xD8, 0x0A, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x92, 0xF1, 0x54, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xBD, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x90,
+            0x47, 0xC3, 0xF2, 0x29, 0xA8, 0xEA, 0xBF, 0x18, 0xD3, 0x6B, 0xE7, 0xF6, 0xB9, 0x09, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5C,
+            0xAF, 0x3B, 0x40, 0x00, 0x00, 0x00, 0x00, 0xE8, 0x15, 0x00, 0x3F, 0xDC, 0x0C, 0x3D, 0xB0, 0x3D,
+            0xEA, 0x03, 0x40, 0x64, 0xB3, 0x86, 0x37, 0x91, 0x87, 0x04, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x61, 0xFF, 0x01, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x2B, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5F, 0x68, 0x75, 0x6E, 0x74, 0x5F,
+            0x73, 0x65, 0x65, 0x6E, 0x01, 0x00, 0x00, 0x00, 0x3A, 0x79, 0x93, 0xF5, 0x8B, 0x01, 0x00, 0x00,
+            0x00, 0x02, 0x1F, 0x00, 0x1B, 0x10, 0x71, 0x30, 0x30, 0x32, 0x5F, 0x79, 0x65, 0x6E, 0x5F, 0x61,
+            0x72, 0x72, 0x69, 0x76, 0x65, 0x73, 0x02, 0x00, 0x00, 0x00, 0x18, 0xFE, 0xAB, 0x82, 0x53, 0xC0,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3C, 0x94, 0x6C, 0x45, 0x3F, 0x23, 0x9B, 0x40,
+            0x5D, 0x12, 0xC7, 0x1A, 0x38, 0x60, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x62, 0x16, 0xFB, 0x53, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x30, 0xF9, 0x3F, 0xA0, 0x80, 0x88, 0xEF, 0xE1,
+            0xA7, 0xEA, 0xBF, 0xDA, 0xDE, 0xA6, 0x94, 0x30, 0x6C, 0x01, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0x31, 0x66, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xCA, 0x1A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x94, 0xCA, 0x42, 0x40, 0x79, 0x01, 0x66, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0x26, 0xDF, 0xE0, 0x5C, 0x1C, 0x9B, 0x40, 0xCE,
+            0xBB, 0xC2, 0x2F, 0xE8, 0x34, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x3F, 0x00, 0x5D, 0x55, 0x0E, 0x26,
+            0x54, 0xA6, 0xBF, 0x32, 0xA3, 0x2F, 0xD2, 0x01, 0x76, 0x0C, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0xA7, 0x06, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x50, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB8, 0x0C, 0x4F, 0x93, 0x57, 0xA4, 0x5E, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0xB0, 0xA5, 0xA4, 0x67, 0x10, 0x9B, 0x40, 0xB5,
+            0x99, 0x42, 0xCA, 0xE5, 0x33, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x2C, 0xF4, 0x12, 0x5F, 0xE7, 0x19, 0x50, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x68, 0x60, 0x5F, 0xA8, 0x84, 0x8F, 0x95, 0x40, 0xEE,
+            0x06, 0x00, 0xA1, 0xDF, 0x78, 0x87, 0xC0, 0xA5, 0x68, 0x3B, 0x3F, 0x79, 0x4A, 0x67, 0x15, 0xC1,
+            0xCB, 0x13, 0xC0, 0x70, 0x6F, 0x9E, 0x82, 0x49, 0x22, 0x04, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46, 0x19, 0x05, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x7D, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0xF8, 0x21, 0xF1, 0x8D, 0x0C,
+            0x2E, 0xF3, 0xBF, 0x5B, 0x9A, 0x86, 0xC8, 0x3F, 0x10, 0x08, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE6, 0xAB, 0x00, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xF7, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x10,
+            0xED, 0x27, 0xB7, 0x85, 0xBC, 0x13, 0x40, 0x23, 0xB7, 0xF4, 0x80, 0x00, 0xFF, 0x07, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44,
+            0x14, 0xF1, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x12, 0x22, 0x00, 0x3F, 0xF8, 0x4F, 0x31, 0x90, 0xD2,
+            0xF3, 0xFC, 0x3F, 0x30, 0x91, 0xB7, 0x2A, 0x8C, 0x72, 0x0D, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4E, 0xE0, 0x09, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xCD, 0x17, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xDC, 0xDD, 0x1C, 0x9A, 0x3D, 0x19, 0x57, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD4, 0x80, 0x9C, 0x83, 0xEF, 0x1D, 0x9B, 0x40, 0x8A,
+            0x82, 0x3F, 0xA7, 0x2F, 0x3B, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x8C, 0xE5, 0xBC, 0x2D, 0xF4, 0x55, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7C, 0xA7, 0xAD, 0x36, 0xBE, 0x9A, 0x95, 0x40, 0x66,
+            0xC8, 0xCD, 0xB2, 0xE2, 0x70, 0x87, 0xC0, 0xA5, 0x68, 0x3B, 0x3F, 0xC6, 0x7D, 0xF3, 0x4E, 0x14,
+            0xE7, 0x11, 0xC0, 0xE9, 0x45, 0x07, 0x76, 0xAC, 0xD3, 0x05, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x34, 0x5B, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xF2, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9C, 0xF1, 0xDB, 0xFE, 0x62, 0xC8, 0x58, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF4, 0xA0, 0xD8, 0xF7, 0xD6, 0x0D, 0x9B, 0x40, 0x07,
+            0xB0, 0xB3, 0xDF, 0x8B, 0x35, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x84, 0x76, 0x30, 0xDA, 0xEB, 0x94, 0x54, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x74, 0xD7, 0xF5, 0xA7, 0x06, 0x15, 0x9B, 0x40, 0x28,
+            0xC9, 0x71, 0x2A, 0xE6, 0x3A, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x3F, 0x58, 0x77, 0xB8, 0x7D, 0xEF,
+            0xF4, 0x09, 0xC0, 0xA8, 0x05, 0xE2, 0xA1, 0x61, 0xE5, 0x0A, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x34, 0x92, 0x03, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xC1, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x85, 0x5D, 0x32, 0x3F, 0x77,
+            0x70, 0x10, 0xC0, 0x88, 0xB4, 0xB8, 0x37, 0x81, 0x42, 0x02, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1C, 0xB0, 0x07, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x19, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0xE0, 0x58, 0xD8, 0xE8, 0xBC,
+            0x10, 0x13, 0x40, 0x0B, 0x83, 0xC7, 0x69, 0x9C, 0x7D, 0x06, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0xB7, 0x5A, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xB0,
+            0xAA, 0xA0, 0xE2, 0x59, 0x55, 0x05, 0x40, 0x44, 0x7E, 0x42, 0xE5, 0xE4, 0x95, 0x0C, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C,
+            0x02, 0x08, 0x40, 0x00, 0x00, 0x00, 0x00, 0x49, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8C, 0x9E, 0x5E, 0x0B, 0x47, 0x2E, 0x51, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0x5E, 0xB9, 0x13, 0x32, 0x22, 0x9B, 0x40, 0x4F,
+            0x18, 0x20, 0x17, 0x6A, 0x38, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x98, 0x10, 0x9D, 0x33, 0x50, 0x59, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x78, 0x10, 0x8D, 0x1B, 0xA5, 0x19, 0x9B, 0x40, 0x95,
+            0xFA, 0x60, 0x1C, 0x18, 0x3C, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xF0,
+            0x05, 0x63, 0xFC, 0x8A, 0x93, 0xD1, 0xBF, 0xD0, 0x2D, 0xA0, 0x7D, 0x76, 0x5F, 0x03, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE8,
+            0xF1, 0x56, 0x40, 0x00, 0x00, 0x00, 0x00, 0xCB, 0x24, 0x00, 0x02, 0x23, 0x00, 0x37, 0x14, 0x73,
+            0x71, 0x31, 0x30, 0x36, 0x5F, 0x6B, 0x69, 0x6C, 0x6C, 0x65, 0x64, 0x5F, 0x6D, 0x6F, 0x6E, 0x73,
+            0x74, 0x65, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0xED, 0x9B, 0xEB, 0x8B, 0x01, 0x00, 0x00, 0x00,
+            0x02, 0x21, 0x00, 0x0B, 0x12, 0x71, 0x33, 0x30, 0x31, 0x5F, 0x3F, 0x94, 0xD1, 0x64, 0x15, 0xCB,
+            0xD4, 0xF0, 0xBF, 0x3C, 0x97, 0xA8, 0x73, 0x36, 0x28, 0x0B, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x7A, 0x0D, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xB2, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xA0,
+            0xA9, 0x06, 0x35, 0x72, 0x28, 0x00, 0x40, 0x5C, 0xE1, 0xA8, 0xE9, 0x4C, 0x9A, 0x02, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE4,
+            0x46, 0x5C, 0x40, 0x00, 0x00, 0x00, 0x00, 0x4F, 0x0C, 0x00, 0xAB, 0xE0, 0x63, 0x74, 0x64, 0xC0,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD0, 0x82, 0x5F, 0x45, 0x41, 0x1E, 0x9B, 0x40,
+            0x97, 0x22, 0x9F, 0x37, 0xD3, 0x3F, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x62, 0x16, 0xFB, 0x53, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xE0, 0xEF, 0xCE, 0xF8, 0xE0, 0x03, 0x62, 0xC0,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0xCB, 0x94, 0xEE, 0x1C, 0x1E, 0x9B, 0x40,
+            0x12, 0x02, 0xE6, 0xF1, 0x27, 0x5F, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x62, 0x16, 0xFB, 0x53, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xC0, 0xA3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB4, 0x1D, 0x78, 0x05, 0xE6, 0x52, 0x60, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA8, 0x4F, 0x7C, 0xA4, 0x8D, 0x1C, 0x9B, 0x40, 0xCA,
+            0x6B, 0x5A, 0x30, 0x54, 0x37, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x03, 0xE2, 0x03, 0x9C, 0xAE, 0x61, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC8, 0xA6, 0xF6, 0xAE, 0xA7, 0x0F, 0x9B, 0x40, 0x03,
+            0x79, 0x2C, 0x9B, 0x95, 0x36, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x6C, 0x6F, 0x6F, 0x74, 0x20, 0x0D,
+            0x00, 0x00, 0x00, 0x01, 0x26, 0x00, 0x3F, 0x14, 0x57, 0x69, 0x74, 0x63, 0x68, 0x65, 0x72, 0x20,
+            0x53, 0x69, 0x6C, 0x76, 0x65, 0x72, 0x20, 0x53, 0x77, 0x6F, 0x72, 0x64, 0x5C, 0x01, 0x00, 0x00,
+            0x8B, 0xFB, 0x56, 0x34, 0xFC, 0x20, 0x86, 0x71, 0x93, 0x93, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x98, 0x32, 0x73, 0x02, 0xB0, 0x6A, 0x61, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x55, 0x39, 0xFC, 0x68, 0x1F, 0x9B, 0x40, 0x6C,
+            0x61, 0x31, 0xA4, 0x0C, 0x39, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x3F, 0xB4, 0xC3, 0xA2, 0xDE, 0x51,
+            0xC3, 0x12, 0x40, 0x5F, 0x07, 0xDF, 0x4F, 0xBF, 0x0A, 0x12, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0xAB, 0x0E, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x2B, 0x0D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65,
+            0x20, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x22, 0x00, 0x07, 0x09, 0x77, 0x72, 0x61, 0x69, 0x74, 0x68,
+            0x5F, 0x31, 0x34, 0x14, 0x09, 0x4A, 0x44, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x10, 0x32, 0x23, 0xAB, 0x8C, 0x01, 0x00, 0x00, 0x3F, 0x4D, 0xEB, 0x71, 0x3D, 0x55,
+            0xD7, 0x04, 0xC0, 0x7E, 0x8A, 0x00, 0x54, 0xC9, 0x5E, 0x13, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xCC, 0xF4, 0x64, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x6B, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0x14, 0x99, 0xA8, 0x2F, 0x5B,
+            0xBB, 0xF1, 0xBF, 0x2E, 0x56, 0xE9, 0x2F, 0x01, 0x83, 0x11, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB0, 0x2B, 0x62, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0xD7, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x40,
+            0x69, 0xB0, 0xF1, 0x4A, 0x1E, 0xD3, 0x3F, 0x84, 0xA1, 0x61, 0xB2, 0x5C, 0x5C, 0x10, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD8,
+            0x49, 0x0F, 0x40, 0x00, 0x00, 0x00, 0x00, 0xA3, 0x13, 0x00, 0x3F, 0x18, 0xE2, 0x94, 0x49, 0x2F,
+            0x6B, 0xFC, 0x3F, 0xF5, 0x12, 0xE9, 0xB4, 0xC7, 0xF6, 0x13, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB9, 0xB9, 0x10, 0x40, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xD0,
+            0xD0, 0xBE, 0xE0, 0x16, 0xEF, 0xF3, 0x3F, 0xD8, 0xDF, 0xD9, 0xE1, 0xEC, 0x0B, 0x11, 0xC0, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0,
+            0x39, 0x63, 0x40, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x23, 0x00, 0x39, 0xE4, 0xBB, 0xDF, 0x65, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x34, 0x7E, 0x5B, 0xFF, 0x02, 0x91, 0xC0,
+            0x93, 0x94, 0xB4, 0xD8, 0x61, 0x36, 0x5F, 0x40, 0xCB, 0x68, 0x5D, 0x4D, 0x7C, 0x47, 0x52, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x20, 0xE5, 0x6B, 0x69, 0x6C, 0x6C, 0x65, 0x64,
+            0x5F, 0x6D, 0x6F, 0x6E, 0x73, 0x74, 0x65, 0x72, 0x01, 0x00, 0x00, 0x00, 0x43, 0xE9, 0x01, 0x87,
+            0x8C, 0x01, 0x00, 0x00, 0x00, 0x02, 0x21, 0x00, 0x3B, 0x12, 0x6B, 0x69, 0x6C, 0x6C, 0x5F, 0x63,
+            0x6F, 0x75, 0x6E, 0x74, 0x5F, 0x64, 0x72, 0x6F, 0x77, 0x6E, 0x73, 0x74, 0x61, 0x74, 0x65, 0x20,
+            0x0D, 0x00, 0x00, 0x00, 0x25, 0xF4, 0xC1, 0x6A, 0xEB, 0x80, 0x47, 0xFF, 0x47, 0x65, 0x72, 0x61,
+            0x6C, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x67, 0x65, 0x72, 0x61, 0x6C,
+            0x74, 0x5F, 0x68, 0x61, 0x73, 0x5F, 0x68, 0x6F, 0x72, 0x73, 0x65, 0x00, 0x00, 0x00, 0x00, 0x3F,
+            0xEA, 0x23, 0xF7, 0x8B, 0x01, 0x00, 0x00, 0x01, 0x02, 0x1F, 0x00, 0x09, 0x10, 0x67, 0x65, 0x72,
+            0x61, 0x6C, 0x74, 0x5F, 0x68, 0x61, 0x73, 0x5F, 0x68, 0x6F, 0x73, 0x74, 0x61, 0x74, 0x65, 0x20,
+            0x0D, 0x00, 0x00, 0x00, 0x8B, 0xFB, 0x56, 0x34, 0xFC, 0x20, 0x86, 0x71, 0x4C, 0x61, 0x6D, 0x62,
+            0x65, 0x72, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x15, 0x6D, 0x71, 0x33, 0x30, 0x33,
+            0x35, 0x5F, 0x70, 0x68, 0x69, 0x6C, 0x69, 0x70, 0x70, 0x61, 0x5F, 0x66, 0x6F, 0x75, 0x6E, 0x64,
+            0x00, 0x00, 0x00, 0x00, 0xBA, 0x6B, 0x0C, 0x88, 0x8C, 0x01, 0x00, 0x00, 0x00, 0x02, 0x24, 0x00,
+            0x21, 0x15, 0x6D, 0x71, 0x33, 0x30, 0x33, 0x35, 0x5F, 0x70, 0x73, 0x74, 0x61, 0x74, 0x65, 0x20,
+            0x0D, 0x00, 0x00, 0x00, 0x4F, 0xCB, 0x91, 0x25, 0xC0, 0x53, 0x70, 0x3C, 0x43, 0x69, 0x72, 0x69,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x71, 0x33, 0x31, 0x30, 0x5F,
+            0x63, 0x69, 0x72, 0x69, 0x5F, 0x73, 0x61, 0x76, 0x65, 0x64, 0x01, 0x00, 0x00, 0x00, 0xB7, 0xC9,
+            0xFD, 0x4F, 0x8C, 0x01, 0x00, 0x00, 0x00, 0x02, 0x22, 0x00, 0x17, 0x13, 0x71, 0x31, 0x30, 0x35,
+            0x5F, 0x77, 0x69, 0x6C, 0x64, 0x5F, 0x68, 0x75, 0x6E, 0x74, 0x11, 0x71, 0x31, 0x30, 0x33, 0x5F,
+            0x62, 0x61, 0x72, 0x6F, 0x6E, 0x5F, 0x74, 0x61, 0x6C, 0x6B, 0x65, 0x64, 0x02, 0x00, 0x00, 0x00,
+            0x7A, 0x87, 0xF4, 0x43, 0x8C, 0x01, 0x00, 0x00, 0x00, 0x02, 0x1F, 0x00, 0x33, 0x10, 0x71, 0x30,
+            0x30, 0x32, 0x5F, 0x79, 0x65, 0x6E, 0x5F, 0x61, 0x72, 0x72, 0x75, 0x70, 0x64, 0x61, 0x74, 0x65,
+            0x20, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x22, 0x00, 0x03, 0x09, 0x6E, 0x65, 0x6B, 0x6B, 0x65, 0x72,
+            0x5F, 0x30, 0x33, 0xA9, 0x8D, 0x0E, 0x42, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x90, 0x46, 0xB1, 0x78, 0x8C, 0x01, 0x00, 0x00, 0x69, 0x61, 0x6C, 0x5F, 0x63, 0x6F,
+            0x6D, 0x62, 0x61, 0x74, 0x5F, 0x64, 0x6F, 0x6E, 0x65, 0x02, 0x00, 0x00, 0x00, 0x70, 0x14, 0x4D,
+            0xB4, 0x8C, 0x01, 0x00, 0x00, 0x00, 0x02, 0x1E, 0x00, 0x19, 0x0F, 0x73, 0x71, 0x31, 0x30, 0x31,
+            0x5F, 0x6B, 0x65, 0x69, 0x72, 0x61, 0x5F, 0x6D, 0x65, 0x74, 0x61, 0x74, 0x65, 0x20, 0x0D, 0x00,
+            0x00, 0x00, 0x01, 0x25, 0x00, 0x29, 0x0C, 0x67, 0x72, 0x69, 0x66, 0x66, 0x69, 0x6E, 0x5F, 0x62,
+            0x6F, 0x73, 0x73, 0x2C, 0x3F, 0x0E, 0x43, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x30, 0x99, 0xBB, 0x53, 0x8C, 0x01, 0x00, 0x00, 0x0B, 0x6D, 0x71, 0x31, 0x30, 0x30,
+            0x31, 0x5F, 0x64, 0x6F, 0x6E, 0x65, 0x01, 0x00, 0x00, 0x00, 0x30, 0x76, 0x5B, 0x29, 0x8C, 0x01,
+            0x00, 0x00, 0x01, 0x02, 0x21, 0x00, 0x1B, 0x12, 0x77, 0x69, 0x74, 0x63, 0x68, 0x65, 0x72, 0x5F,
+            0x73, 0x65, 0x6E, 0x73, 0x65, 0x5F, 0x75, 0x73, 0x65, 0x64, 0x71, 0x33, 0x30, 0x31, 0x5F, 0x64,
+            0x72, 0x65, 0x61, 0x6D, 0x65, 0x72, 0x5F, 0x66, 0x6F, 0x75, 0x6E, 0x64, 0x01, 0x00, 0x00, 0x00,
+            0x36, 0xFF, 0x50, 0x21, 0x8C, 0x01, 0x00, 0x00, 0x00, 0x02, 0x20, 0x00, 0x15, 0x11, 0x71, 0x32,
+            0x30, 0x31, 0x5F, 0x73, 0x68, 0x69, 0x70, 0x5F, 0x61, 0x72, 0x61, 0x74, 0x65, 0x20, 0x0D, 0x00,
+            0x00, 0x00, 0x01, 0x25, 0x00, 0x2F, 0x0C, 0x77, 0x6F, 0x6C, 0x66, 0x5F, 0x70, 0x61, 0x63, 0x6B,
+            0x5F, 0x30, 0x31, 0xEB, 0xD8, 0xE1, 0x43, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0xC0, 0x57, 0xF7, 0xD0, 0x8B, 0x01, 0x00, 0x00, 0x74, 0x65, 0x20, 0x0D, 0x00, 0x00,
+            0x00, 0x01, 0x26, 0x00, 0x33, 0x0D, 0x62, 0x61, 0x6E, 0x64, 0x69, 0x74, 0x5F, 0x6C, 0x65, 0x61,
+            0x64, 0x65, 0x72, 0xFD, 0x9B, 0x03, 0x44, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x20, 0x2E, 0xC6, 0xC5, 0x8C, 0x01, 0x00, 0x00, 0x65, 0x64, 0x01, 0x00, 0x00, 0x00,
+            0x3E, 0x80, 0xB5, 0x4C, 0x8C, 0x01, 0x00, 0x00, 0x01, 0x02, 0x2B, 0x00, 0x27, 0x1C, 0x64, 0x69,
+            0x73, 0x63, 0x6F, 0x76, 0x65, 0x72, 0x65, 0x64, 0x5F, 0x70, 0x6C, 0x61, 0x63, 0x65, 0x5F, 0x6F,
+            0x66, 0x5F, 0x70, 0x6F, 0x77, 0x65, 0x72, 0x5F, 0x30, 0x31, 0x69, 0x70, 0x5F, 0x61, 0x72, 0x72,
+            0x69, 0x76, 0x65, 0x64, 0x00, 0x00, 0x00, 0x00, 0x9B, 0x04, 0xE1, 0xDE, 0x8B, 0x01, 0x00, 0x00,
+            0x00, 0x02, 0x23, 0x00, 0x25, 0x14, 0x71, 0x30, 0x30, 0x31, 0x5F, 0x6E, 0x69, 0x67, 0x68, 0x74,
+            0x6D, 0x61, 0x72, 0x65, 0x5F, 0x65, 0x6E, 0x64, 0x65, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x41, 0x9E, 0xCF, 0xE6, 0x4C, 0x63, 0xC0, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x1A, 0xD8, 0xA8, 0x08, 0xF5, 0x90, 0xC0, 0xEF, 0x90,
+            0xFD, 0xB3, 0xA8, 0x28, 0x61, 0x40, 0xCB, 0x68, 0x5D, 0x4D, 0x03, 0xF5, 0xFE, 0x17, 0x65, 0xC0,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xA0, 0x83, 0x96, 0x1D, 0xFD, 0xEC, 0x79, 0xC0,
+            0x27, 0x42, 0xF5, 0x3A, 0x59, 0xDC, 0x7B, 0xC0, 0x8A, 0xD2, 0x6D, 0x0F, 0x33, 0xCA, 0x4A, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x80, 0x1B, 0x8C, 0x01, 0x00, 0x00, 0x00, 0x02,
+            0x25, 0x00, 0x31, 0x16, 0x63, 0x72, 0x61, 0x66, 0x74, 0x69, 0x6E, 0x67, 0x5F, 0x74, 0x75, 0x74,
+            0x6F, 0x72, 0x69, 0x61, 0x6C, 0x5F, 0x64, 0x6F, 0x6E, 0x65, 0x00, 0x00, 0x00, 0x00, 0x4B, 0xD9,
+            0x94, 0xB7, 0x8C, 0x01, 0x00, 0x00, 0x00, 0x02, 0x21, 0x00, 0x68, 0x65, 0x61, 0x72, 0x74, 0x62,
+            0x65, 0x61, 0x74, 0x20, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x26, 0x00, 0x4F, 0xCB, 0x91, 0x25, 0xC0,
+            0x53, 0x70, 0x3C, 0x67, 0x1E, 0x00, 0x00, 0xFE, 0x26, 0xC5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+            0x00, 0x00, 0x00, 0xDA, 0x21, 0x00, 0x00, 0x00, 0x00, 0x53, 0x61, 0x74, 0x74, 0x61, 0x63, 0x6B,
+            0x20, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x23, 0x00, 0x25, 0xF4, 0xC1, 0x6A, 0xEB, 0x80, 0x47, 0xFF,
+            0x11, 0x0B, 0x67, 0x68, 0x6F, 0x75, 0x6C, 0x5F, 0x61, 0x6C, 0x70, 0x68, 0x61, 0xB6, 0x50, 0x83,
+            0x43, 0x00, 0x00, 0xCD, 0x67, 0xEC, 0xFD, 0x8B, 0x01, 0x00, 0x66, 0x61, 0x63, 0x74, 0x5F, 0x62,
+            0x61, 0x74, 0x63, 0x68, 0x20, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x25, 0x00, 0x01, 0x02, 0x21, 0x00,
+            0x0B, 0x12, 0x73, 0x71, 0x33, 0x30, 0x32, 0x5F, 0x72, 0x6F, 0x63, 0x68, 0x65, 0x5F, 0x6A, 0x6F,
+            0x69, 0x6E, 0x65, 0x64, 0x02, 0x00, 0x00, 0x00, 0x6F, 0x65, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x72, 0xF3, 0xB6, 0x72, 0xD1, 0xF4, 0xBF, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xAC, 0x91, 0xA4, 0x0D, 0xED, 0x16, 0x91, 0xC0, 0x6B, 0x16,
+            0xFB, 0x83, 0xA0, 0x80, 0x60, 0x40, 0xCB, 0x68, 0x5D, 0x4D, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x00,
+            0x5E, 0xD0, 0x80, 0x80, 0x01, 0xC1, 0xBF, 0x20, 0x75, 0x02, 0xE2, 0x45, 0x20, 0xE8, 0x3F, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x19,
+            0x1B, 0x5E, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x00, 0x6E, 0x70, 0x63, 0x5F, 0x75, 0x70,
+            0x64, 0x61, 0x74, 0x65, 0x20, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x24, 0x00, 0x2B, 0x0B, 0x64, 0x72,
+            0x6F, 0x77, 0x6E, 0x65, 0x72, 0x5F, 0x30, 0x30, 0x32, 0x4B, 0x49, 0x27, 0x43, 0x01, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0xB7, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB3,
+            0xE7, 0x76, 0x40, 0x78, 0x32, 0x60, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x86,
+            0x8D, 0x5E, 0xD9, 0x29, 0x92, 0x95, 0x40, 0xEC, 0xDC, 0xFB, 0x0A, 0x5D, 0x8E, 0x87, 0xC0, 0xA5,
+            0x68, 0x3B, 0x89, 0x5F, 0xFB, 0x44, 0x40, 0x00, 0x00, 0x00, 0xAC, 0xC9, 0x04, 0x47, 0x52, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6E, 0x15, 0xBB, 0xE5, 0x7A, 0xFE, 0x90, 0xC0,
+            0x4C, 0x8E, 0x07, 0x94, 0x8B, 0xEE, 0x5E, 0x40, 0xCB, 0x68, 0x5D, 0x4D, 0x7C, 0x47, 0x52, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xA4, 0xA7, 0x9B, 0xC8, 0x98, 0x83, 0xCA, 0x4A,
+            0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE1, 0x6E, 0x3B, 0x88, 0x35, 0xCE, 0x78,
+            0xC0, 0xD2, 0x84, 0x5B, 0x8D, 0x8D, 0x5E, 0x7C, 0xC0, 0x8A, 0xD2, 0x6D, 0x0F, 0x33, 0xCA, 0x4A,
+            0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0xE1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x31, 0xA1, 0x95, 0x40, 0x03, 0x00, 0x00,
+            0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4F, 0xCB, 0x91, 0x25, 0xC0, 0x53, 0x70,
+            0x3C, 0x43, 0x69, 0x72, 0x69, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3B, 0x75, 0x92, 0xDA, 0x12, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x8A, 0x89, 0xB6, 0x17, 0x9B, 0x40,
+            0x99, 0x0E, 0xB5, 0x86, 0x94, 0x43, 0x97, 0xC0, 0xF1, 0x0B, 0x6A, 0x62, 0x16, 0xFB, 0x53, 0x40,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, 0x60, 0xD1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8B, 0x20, 0x44, 0x40, 0x00, 0x00, 0x00, 0x00, 0x7B,
+            0x1F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8B, 0xFB, 0x56, 0x34, 0xFC, 0x20, 0x86, 0x71, 0x4C,
+            0x61, 0x6D, 0x62, 0x65, 0x72, 0x74, 0x00, 0x00, 0x00, 0x00, 0x73, 0x74, 0x61, 0x74, 0x65, 0x20,
+            0x0D, 0x00, 0x00, 0x00, 0x86, 0x8D, 0x92, 0x65, 0x19, 0x7D, 0x7F, 0xEF, 0x59, 0x65, 0x6E, 0x6E,
+            0x65, 0x66, 0x65, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x73, 0x74, 0x61, 0x74, 0x65, 0x73,
+            0x20, 0x0D, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x25, 0xF4, 0xC1, 0x6A, 0xEB, 0x80, 0x47,
+            0xFF, 0x47, 0x65, 0x72, 0x61, 0x6C, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        };
+    }
+
+    const utils::compression::zlib::dictionary& get_packet_dictionary()
+    {
+        static const utils::compression::zlib::dictionary dictionary(
+            std::string(reinterpret_cast<const char*>(dictionary_data), sizeof(dictionary_data)));
+        return dictionary;
+    }
+
+    uint32_t get_packet_dictionary_protocol()
+    {
+        return TRAINED_PROTOCOL;
+    }
+}
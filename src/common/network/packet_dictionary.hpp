@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../utils/compression.hpp"
+
+namespace network
+{
+    // Preset dictionary for compressed datagrams, see manager::set_compression
+    // Trained with utils::compression::zlib::train_dictionary on datagrams written by the packet codecs. Both ends
+    // have to use the same one, so it is pinned to game::PROTOCOL and a bump fails the build until it is retrained:
+    // benchmark packet_dictionary src/common/network/packet_dictionary.cpp
+    const utils::compression::zlib::dictionary& get_packet_dictionary();
+
+    // game::PROTOCOL at training time
+    uint32_t get_packet_dictionary_protocol();
+}
@@ -0,0 +1,489 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../utils/byte_buffer.hpp"
+#include "string_dictionary.hpp"
+
+namespace network::protocol
+{
+    // ===========================================================================
+    // SCHEMA-DRIVEN PACKET SERIALIZATION
+    // ===========================================================================
+    // Each packet struct lists its wire fields once:
+    //
+    //   template <>
+    //   struct schema<fact_packet>
+    //   {
+    //       using type = fields<field<&fact_packet::fact_name>, field<&fact_packet::value>, ...>;
+    //   };
+    //
+    // and write()/read() are generated from that list. Scalars and arrays of
+    // scalars are written little-endian without padding, char arrays go through
+    // the link's string dictionary.
+    //
+    // Wire format: uint8 version, uint16 payload length, fields in order.
+    // A field is only appended to the end of the list and tagged with the
+    // version that introduced it. Readers leave fields newer than the sender's
+    // version at their default and skip trailing bytes they don't know about,
+    // so both older and newer peers can parse the packet.
+    //
+    // Variable-length members, e.g. a batch of nested packets, are declared with
+    // list_field and written as a varint count followed by the elements.
+    //
+    // Packets without lists are assembled in a stack block and appended at once.
+    // Schemas without strings have a fixed layout at compile-time offsets, which
+    // a reader of the same version loads after a single bounds check. Other
+    // reads go field by field, newer fields simply aren't present.
+    // ===========================================================================
+
+    template <uint32_t... Versions>
+    constexpr bool is_version_ordered()
+    {
+        uint32_t last = 0;
+        return ((Versions >= last ? (last = Versions, true) : false) && ...);
+    }
+
+    template <auto Member, uint32_t Version = 1>
+    struct field
+    {
+        static_assert(Version > 0 && Version <= 0xFF, "Field version must fit the version byte");
+
+        static constexpr auto member = Member;
+        static constexpr uint32_t version = Version;
+    };
+
+    // std::vector member holding at most MaxCount packets that have a schema themselves
+    template <auto Member, size_t MaxCount, uint32_t Version = 1>
+    struct list_field : field<Member, Version>
+    {
+        static constexpr size_t max_count = MaxCount;
+    };
+
+    template <typename... Fields>
+    struct fields
+    {
+        static_assert(sizeof...(Fields) > 0, "Schema must have at least one field");
+        static_assert(is_version_ordered<Fields::version...>(), "Fields must be appended in version order");
+
+        static constexpr uint32_t version = std::max({Fields::version...});
+    };
+
+    template <typename T>
+    struct schema;
+
+    template <typename T>
+    concept has_schema = requires { typename schema<T>::type; };
+
+    namespace schema_detail
+    {
+        template <typename T>
+        concept scalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+        // Fixed-size codecs expose size/store/load, string codecs expose max_size/write/read and a store that
+        // returns the end of what it wrote
+        template <typename T>
+        struct codec;
+
+        template <typename Codec>
+        concept fixed_codec = requires { Codec::size; };
+
+        template <scalar T>
+        struct codec<T>
+        {
+            static constexpr size_t size = std::is_same_v<T, bool> ? 1 : sizeof(T);
+
+            static void store(uint8_t* out, const T& value)
+            {
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    out[0] = value ? 1 : 0;
+                }
+                else
+                {
+                    std::memcpy(out, &value, size);
+
+                    if constexpr (std::endian::native != std::endian::little)
+                    {
+                        std::reverse(out, out + size);
+                    }
+                }
+            }
+
+            static void load(const uint8_t* in, T& value)
+            {
+                if constexpr (std::is_same_v<T, bool>)
+                {
+                    value = in[0] != 0;
+                }
+                else if constexpr (std::endian::native == std::endian::little)
+                {
+                    std::memcpy(&value, in, size);
+                }
+                else
+                {
+                    std::array<uint8_t, size> bytes{};
+                    std::reverse_copy(in, in + size, bytes.begin());
+                    std::memcpy(&value, bytes.data(), size);
+                }
+            }
+        };
+
+        template <scalar T, size_t N>
+        struct codec<std::array<T, N>>
+        {
+            static constexpr size_t size = codec<T>::size * N;
+            static constexpr bool is_raw = std::endian::native == std::endian::little && !std::is_same_v<T, bool>;
+
+            static void store(uint8_t* out, const std::array<T, N>& value)
+            {
+                if constexpr (is_raw)
+                {
+                    std::memcpy(out, value.data(), size);
+                }
+                else
+                {
+                    for (size_t i = 0; i < N; ++i)
+                    {
+                        codec<T>::store(out + i * codec<T>::size, value[i]);
+                    }
+                }
+            }
+
+            static void load(const uint8_t* in, std::array<T, N>& value)
+            {
+                if constexpr (is_raw)
+                {
+                    std::memcpy(value.data(), in, size);
+                }
+                else
+                {
+                    for (size_t i = 0; i < N; ++i)
+                    {
+                        codec<T>::load(in + i * codec<T>::size, value[i]);
+                    }
+                }
+            }
+        };
+
+        template <size_t N>
+        constexpr size_t max_string_size = string_encoder::max_encoded_size(std::min(N, MAX_INTERNED_LENGTH));
+
+        template <size_t N>
+        struct codec<std::array<char, N>>
+        {
+            static constexpr size_t max_size = max_string_size<N>;
+
+            static void write(utils::buffer_serializer& buffer, string_encoder& strings, const std::array<char, N>& value)
+            {
+                strings.write(buffer, value);
+            }
+
+            static uint8_t* store(uint8_t* out, string_encoder& strings, const std::array<char, N>& value)
+            {
+                return strings.store(out, value);
+            }
+
+            static void read(utils::buffer_deserializer& buffer, string_decoder& strings, std::array<char, N>& value)
+            {
+                strings.read(buffer, value);
+            }
+        };
+
+        template <size_t N>
+        struct codec<char[N]>
+        {
+            static constexpr size_t max_size = max_string_size<N>;
+
+            static void write(utils::buffer_serializer& buffer, string_encoder& strings, const char (&value)[N])
+            {
+                strings.write(buffer, value);
+            }
+
+            static uint8_t* store(uint8_t* out, string_encoder& strings, const char (&value)[N])
+            {
+                return strings.store(out, value);
+            }
+
+            static void read(utils::buffer_deserializer& buffer, string_decoder& strings, char (&value)[N])
+            {
+                strings.read(buffer, value);
+            }
+        };
+
+        template <typename Codec>
+        constexpr size_t max_size_of()
+        {
+            if constexpr (fixed_codec<Codec>)
+            {
+                return Codec::size;
+            }
+            else
+            {
+                return Codec::max_size;
+            }
+        }
+
+        template <typename Codec, typename T>
+        void write_field(utils::buffer_serializer& buffer, string_encoder& strings, const T& value)
+        {
+            if constexpr (fixed_codec<Codec>)
+            {
+                std::array<uint8_t, Codec::size> bytes;
+                Codec::store(bytes.data(), value);
+                buffer.write(bytes.data(), bytes.size());
+            }
+            else
+            {
+                Codec::write(buffer, strings, value);
+            }
+        }
+
+        // Encodes into a block with room for the codec's maximum size and returns the end
+        template <typename Codec, typename T>
+        uint8_t* store_field(uint8_t* out, string_encoder& strings, const T& value)
+        {
+            if constexpr (fixed_codec<Codec>)
+            {
+                Codec::store(out, value);
+                return out + Codec::size;
+            }
+            else
+            {
+                return Codec::store(out, strings, value);
+            }
+        }
+
+        template <typename Codec, typename T>
+        void read_field(utils::buffer_deserializer& buffer, string_decoder& strings, T& value)
+        {
+            if constexpr (fixed_codec<Codec>)
+            {
+                std::array<uint8_t, Codec::size> bytes;
+                buffer.read(bytes.data(), bytes.size());
+                Codec::load(bytes.data(), value);
+            }
+            else
+            {
+                Codec::read(buffer, strings, value);
+            }
+        }
+
+        template <typename T>
+        struct member_traits;
+
+        template <typename Class, typename Member>
+        struct member_traits<Member Class::*>
+        {
+            using class_type = Class;
+            using member_type = Member;
+        };
+
+        template <typename Field>
+        using field_traits = member_traits<std::remove_cv_t<decltype(Field::member)>>;
+
+        template <typename T, size_t MaxCount>
+        struct list_codec;
+
+        template <typename Field>
+        struct field_codec_of
+        {
+            using type = codec<typename field_traits<Field>::member_type>;
+        };
+
+        template <typename Field>
+            requires requires { Field::max_count; }
+        struct field_codec_of<Field>
+        {
+            using type = list_codec<typename field_traits<Field>::member_type, Field::max_count>;
+        };
+
+        template <typename Field>
+        using field_codec = typename field_codec_of<Field>::type;
+
+        constexpr size_t HEADER_SIZE = sizeof(uint8_t) + sizeof(uint16_t);
+
+        // Largest packet with strings that is assembled on the stack
+        constexpr size_t MAX_STACK_BLOCK_SIZE = 1024;
+
+        template <typename Codec>
+        concept block_codec = fixed_codec<Codec> || requires { &Codec::store; };
+
+        template <typename T, typename Fields>
+        struct fields_codec;
+
+        template <typename T, typename... Fields>
+        struct fields_codec<T, fields<Fields...>>
+        {
+            static_assert((std::is_same_v<typename field_traits<Fields>::class_type, T> && ...),
+                          "Schema fields must be members of the packet");
+
+            static constexpr uint32_t version = fields<Fields...>::version;
+            static constexpr bool is_fixed = (fixed_codec<field_codec<Fields>> && ...);
+            static constexpr size_t max_size = (max_size_of<field_codec<Fields>>() + ...);
+            static constexpr bool is_block =
+                (block_codec<field_codec<Fields>> && ...) && HEADER_SIZE + max_size <= MAX_STACK_BLOCK_SIZE;
+
+            static_assert(max_size <= std::numeric_limits<uint16_t>::max(), "Packet payload too large");
+
+            static void write(utils::buffer_serializer& buffer, string_encoder& strings, const T& packet)
+            {
+                if constexpr (is_block)
+                {
+                    // Appending field by field costs more than the fields themselves, so the packet is assembled at a
+                    // moving cursor in a stack block and appended at once. Fixed layouts fold to compile-time offsets.
+                    std::array<uint8_t, HEADER_SIZE + max_size> bytes;
+                    bytes[0] = static_cast<uint8_t>(version);
+
+                    auto* out = bytes.data() + HEADER_SIZE;
+                    ((out = store_field<field_codec<Fields>>(out, strings, packet.*(Fields::member))), ...);
+
+                    const auto size = static_cast<size_t>(out - bytes.data());
+                    codec<uint16_t>::store(bytes.data() + 1, static_cast<uint16_t>(size - HEADER_SIZE));
+
+                    buffer.write(bytes.data(), size);
+                }
+                else
+                {
+                    buffer.reserve(buffer.size() + HEADER_SIZE + max_size);
+                    buffer.write(static_cast<uint8_t>(version));
+
+                    const auto length_offset = buffer.size();
+                    buffer.write(uint16_t{});
+
+                    (write_field<field_codec<Fields>>(buffer, strings, packet.*(Fields::member)), ...);
+
+                    std::array<uint8_t, sizeof(uint16_t)> length{};
+                    codec<uint16_t>::store(length.data(), static_cast<uint16_t>(buffer.size() - length_offset - length.size()));
+                    buffer.write_at(length_offset, length);
+                }
+            }
+
+            // Per-field reads inline to bounded loads straight from the source, staging the payload first is slower.
+            // A fixed layout from a sender of the same version is loaded at compile-time offsets after one bounds check.
+            static void read(utils::buffer_deserializer& buffer, string_decoder& strings, T& packet, const uint32_t sender_version)
+            {
+                if constexpr (is_fixed)
+                {
+                    if (sender_version == version && buffer.get_remaining_size() >= max_size)
+                    {
+                        const auto payload = buffer.read_view(max_size);
+                        const auto* in = reinterpret_cast<const uint8_t*>(payload.data());
+
+                        ((field_codec<Fields>::load(in, packet.*(Fields::member)), in += field_codec<Fields>::size), ...);
+                        return;
+                    }
+                }
+
+                ((Fields::version <= sender_version ? read_field<field_codec<Fields>>(buffer, strings, packet.*(Fields::member)) : void()),
+                 ...);
+            }
+        };
+
+        template <typename T>
+        using packet_codec = fields_codec<T, typename schema<T>::type>;
+
+        template <typename T>
+        void read_packet(utils::buffer_deserializer& buffer, string_decoder& strings, T& packet)
+        {
+            std::array<uint8_t, HEADER_SIZE> header;
+            buffer.read(header.data(), header.size());
+
+            const uint32_t version = header[0];
+            uint16_t length{};
+            codec<uint16_t>::load(header.data() + 1, length);
+
+            if (version == 0 || length > buffer.get_remaining_size())
+            {
+                throw std::runtime_error("Malformed packet header");
+            }
+
+            const auto end = buffer.get_offset() + length;
+            packet_codec<T>::read(buffer, strings, packet, version);
+
+            if (buffer.get_offset() > end)
+            {
+                throw std::runtime_error("Packet fields overrun their payload");
+            }
+
+            buffer.skip(end - buffer.get_offset());
+        }
+
+        constexpr size_t max_varint_size(const size_t value)
+        {
+            return value < 0x80 ? 1 : 1 + max_varint_size(value >> 7);
+        }
+
+        // Elements are complete nested packets, so they carry their own version
+        template <has_schema T, size_t MaxCount>
+        struct list_codec<std::vector<T>, MaxCount>
+        {
+            static constexpr size_t max_size = max_varint_size(MaxCount) + MaxCount * (HEADER_SIZE + packet_codec<T>::max_size);
+
+            static void write(utils::buffer_serializer& buffer, string_encoder& strings, const std::vector<T>& value)
+            {
+                if (value.size() > MaxCount)
+                {
+                    throw std::runtime_error("Too many elements in packet list");
+                }
+
+                buffer.write_varint(value.size());
+                for (const auto& element : value)
+                {
+                    packet_codec<T>::write(buffer, strings, element);
+                }
+            }
+
+            static void read(utils::buffer_deserializer& buffer, string_decoder& strings, std::vector<T>& value)
+            {
+                const auto count = buffer.read_varint();
+                if (count > MaxCount)
+                {
+                    throw std::runtime_error("Too many elements in packet list");
+                }
+
+                value.resize(static_cast<size_t>(count));
+                for (auto& element : value)
+                {
+                    read_packet(buffer, strings, element);
+                }
+            }
+        };
+    }
+
+    template <has_schema T>
+    constexpr uint32_t schema_version = schema<T>::type::version;
+
+    // Upper bound of the encoded size, header included
+    template <has_schema T>
+    constexpr size_t max_packet_size = schema_detail::HEADER_SIZE + schema_detail::packet_codec<T>::max_size;
+
+    template <has_schema T>
+    void write(utils::buffer_serializer& buffer, string_encoder& strings, const T& packet)
+    {
+        schema_detail::packet_codec<T>::write(buffer, strings, packet);
+    }
+
+    // Throws on truncated or malformed input
+    template <has_schema T>
+    void read(utils::buffer_deserializer& buffer, string_decoder& strings, T& packet)
+    {
+        schema_detail::read_packet(buffer, strings, packet);
+    }
+
+    template <has_schema T>
+    T read(utils::buffer_deserializer& buffer, string_decoder& strings)
+    {
+        T packet{};
+        read(buffer, strings, packet);
+        return packet;
+    }
+}
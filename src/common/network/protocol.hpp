@@ -5,8 +5,12 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "../game/structs.hpp"
+#include "../utils/hash.hpp"
+#include "../utils/merkle_tree.hpp"
 
 namespace network::protocol
 {
@@ -30,11 +34,33 @@ namespace network::protocol
     // Synchronizes quest progression via the Witcher 3 Facts system
     // Examples: quest objectives, tutorial flags, kill counts, discovered locations
 
+    enum class fact_update : uint8_t
+    {
+        set = 0, // SetFact, last writer wins
+        add = 1  // AddFact, the value is a delta
+    };
+
+    // Value after applying an update, adds wrap like the game's int counters instead of overflowing
+    constexpr int32_t apply_fact_update(const int32_t current, const int32_t value, const fact_update update)
+    {
+        return update == fact_update::add ? static_cast<int32_t>(static_cast<uint32_t>(current) + static_cast<uint32_t>(value)) : value;
+    }
+
     struct fact_packet
     {
         std::array<char, MAX_FACT_NAME_LENGTH> fact_name{}; // Quest fact identifier (e.g., "killed_griffin")
         int32_t value{};                                    // Fact value (usually 1, can be counters)
         uint64_t timestamp{};                               // Sync timestamp for ordering
+        fact_update update{};                               // Receivers add the value to theirs for AddFact
+    };
+
+    // Facts set within one coalescing window, one entry per name
+    // The server relays a batch as a batch, so receivers apply it in one go
+    constexpr size_t MAX_FACT_BATCH_SIZE = 32;
+
+    struct fact_batch_packet
+    {
+        std::vector<fact_packet> facts{};
     };
 
     // ---------------------------------------------------------------------------
@@ -60,6 +86,22 @@ namespace network::protocol
         uint64_t timestamp{};                          // Attack timestamp
     };
 
+    // ---------------------------------------------------------------------------
+    // COMBAT SYNC: Consolidated NPC Updates
+    // ---------------------------------------------------------------------------
+    // The server aggregates all attacks on an NPC during one tick and sends a single
+    // update per NPC, excluding the recipient's own hits (already applied locally)
+
+    struct npc_update_packet
+    {
+        std::array<char, MAX_TAG_LENGTH> target_tag{}; // Target NPC tag (e.g., "drowner_001")
+        float damage_amount{};                         // Damage dealt by other players this tick
+        uint16_t hit_count{};                          // Number of attacks by other players this tick
+        bool killed{};                                 // Any attack this tick forced the NPC's death
+        uint64_t killer_guid{};                        // Player who landed the killing blow
+        uint64_t timestamp{};                          // Server tick timestamp
+    };
+
     // ---------------------------------------------------------------------------
     // CUTSCENE SYNC: Story Scene Broadcasting
     // ---------------------------------------------------------------------------
@@ -177,13 +219,60 @@ namespace network::protocol
     {
         uint64_t player_guid{};     // Player's unique ID
         uint32_t total_crowns{};    // Total currency for shared purse
-        uint32_t world_fact_hash{}; // Hash of critical world facts for validation
+        uint64_t world_fact_hash{}; // Root of the sender's world state tree, see WORLD STATE RECONCILIATION
         uint32_t script_version{};  // WitcherScript version for compatibility check
         uint32_t game_time{};       // Current world clock (GameTime in seconds)
         uint16_t weather_id{};      // Current active weather effect ID
         uint64_t timestamp{};       // Heartbeat timestamp
     };
 
+    // ---------------------------------------------------------------------------
+    // WORLD STATE RECONCILIATION: Fact Tree Drill-Down
+    // ---------------------------------------------------------------------------
+    // Every peer keeps a utils::merkle_tree over its facts, keyed by get_fact_hash
+    // with get_fact_state as value. A heartbeat whose root differs from the
+    // server's is answered with the server's children of the root. The client
+    // requests the children of every node that differs in turn, and the facts
+    // of every bucket that differs, so only those facts are resynced.
+
+    // The server holds at most MAX_SNAPSHOT_FACTS facts, a bucket is sent in pages of this size
+    constexpr size_t MAX_BUCKET_PAGE_SIZE = MAX_FACT_BATCH_SIZE;
+
+    inline uint32_t get_fact_hash(const std::string_view fact_name)
+    {
+        return static_cast<uint32_t>(utils::hash::compute(fact_name));
+    }
+
+    constexpr uint64_t get_fact_state(const int32_t value)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+    struct world_state_nodes_request_packet
+    {
+        uint16_t node{}; // Interior tree node whose children are requested
+    };
+
+    struct world_state_nodes_packet
+    {
+        uint16_t node{};                                             // Interior tree node
+        std::array<uint64_t, utils::merkle_tree::FANOUT> children{}; // Digests of its children
+    };
+
+    struct world_state_bucket_request_packet
+    {
+        uint16_t bucket{}; // Bucket whose facts are requested
+        uint32_t offset{}; // First fact of the page, facts are ordered by get_fact_hash
+    };
+
+    struct world_state_bucket_packet
+    {
+        uint16_t bucket{};                // Bucket the facts belong to
+        uint32_t offset{};                // Index of the first fact in facts
+        uint32_t fact_count{};            // Facts in the whole bucket
+        std::vector<fact_packet> facts{}; // Absolute values, update is always set
+    };
+
     constexpr size_t MAX_PLAYER_STATE_BINARY = 256;
 
     struct player_state_packet
@@ -205,7 +294,9 @@ namespace network::protocol
     // ===========================================================================
 
     using W3mFactPacket = fact_packet;
+    using W3mFactBatchPacket = fact_batch_packet;
     using W3mAttackPacket = attack_packet;
+    using W3mNpcUpdatePacket = npc_update_packet;
     using W3mCutscenePacket = cutscene_packet;
     using W3mAnimPacket = anim_packet;
     using W3mVehiclePacket = vehicle_packet;
@@ -215,6 +306,10 @@ namespace network::protocol
     using W3mHandshakePacket = handshake_packet;
     using W3mHeartbeatPacket = heartbeat_packet;
     using W3mPlayerStatePacket = player_state_packet;
+    using W3mWorldStateNodesRequestPacket = world_state_nodes_request_packet;
+    using W3mWorldStateNodesPacket = world_state_nodes_packet;
+    using W3mWorldStateBucketRequestPacket = world_state_bucket_request_packet;
+    using W3mWorldStateBucketPacket = world_state_bucket_packet;
 
     // ===========================================================================
     // PACKET TYPE ENUMERATION
@@ -223,17 +318,23 @@ namespace network::protocol
 
     enum class packet_type : uint8_t
     {
-        player_state = 0, // Existing: position/rotation/velocity sync
-        fact = 1,         // New: Quest fact sync
-        attack = 2,       // New: Combat attack sync
-        cutscene = 3,     // New: Cutscene trigger sync
-        anim = 4,         // New: Animation sync for contextual actions
-        vehicle = 5,      // New: Vehicle mount/dismount sync
-        quest_lock = 6,   // New: Quest spectatorship and scene locking
-        loot = 7,         // New: Shared loot and instant economy
-        achievement = 8,  // New: Achievement unlock sync
-        handshake = 9,    // New: Session establishment
-        heartbeat = 10    // New: Reconciliation heartbeat for world state
+        player_state = 0,                // Existing: position/rotation/velocity sync
+        fact = 1,                        // New: Quest fact sync
+        attack = 2,                      // New: Combat attack sync
+        cutscene = 3,                    // New: Cutscene trigger sync
+        anim = 4,                        // New: Animation sync for contextual actions
+        vehicle = 5,                     // New: Vehicle mount/dismount sync
+        quest_lock = 6,                  // New: Quest spectatorship and scene locking
+        loot = 7,                        // New: Shared loot and instant economy
+        achievement = 8,                 // New: Achievement unlock sync
+        handshake = 9,                   // New: Session establishment
+        heartbeat = 10,                  // New: Reconciliation heartbeat for world state
+        npc_update = 11,                 // New: Consolidated per-tick NPC damage/death
+        fact_batch = 12,                 // New: Coalesced quest facts
+        world_state_nodes_request = 13,  // New: Fact tree drill-down request
+        world_state_nodes = 14,          // New: Children of a fact tree node
+        world_state_bucket_request = 15, // New: Divergent bucket request
+        world_state_bucket = 16          // New: Facts of a divergent bucket
     };
 
     // ===========================================================================
@@ -242,7 +343,7 @@ namespace network::protocol
 
     // Safe string copy into fixed-size arrays
     template <size_t N>
-    inline void copy_string(std::array<char, N>& dest, const std::string& src)
+    inline void copy_string(std::array<char, N>& dest, const std::string_view src)
     {
         const size_t copy_len = std::min(src.size(), N - 1);
         std::memcpy(dest.data(), src.data(), copy_len);
@@ -255,4 +356,11 @@ namespace network::protocol
     {
         return std::string(src.data(), strnlen(src.data(), N));
     }
+
+    // Non-owning variant of extract_string, only valid as long as the packet is
+    template <size_t N>
+    inline std::string_view view_string(const std::array<char, N>& src)
+    {
+        return std::string_view(src.data(), strnlen(src.data(), N));
+    }
 }
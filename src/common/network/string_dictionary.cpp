@@ -0,0 +1,259 @@
+#include "string_dictionary.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "../game/structs.hpp"
+
+namespace network
+{
+    namespace
+    {
+        std::string_view read_text(utils::buffer_deserializer& buffer)
+        {
+            const auto length = buffer.read_varint();
+            if (length > MAX_INTERNED_LENGTH)
+            {
+                throw std::runtime_error("Dictionary string too long");
+            }
+
+            return buffer.read_view(static_cast<size_t>(length));
+        }
+    }
+
+    void string_encoder::write(utils::buffer_serializer& buffer, const std::string_view text)
+    {
+        if (text.size() > MAX_INTERNED_LENGTH)
+        {
+            throw std::runtime_error("Dictionary string too long");
+        }
+
+        std::array<uint8_t, max_encoded_size(MAX_INTERNED_LENGTH)> data;
+        const auto* end = this->store(data.data(), text);
+
+        buffer.write(data.data(), static_cast<size_t>(end - data.data()));
+    }
+
+    uint8_t* string_encoder::store(uint8_t* out, const std::string_view text)
+    {
+        if (text.size() > MAX_INTERNED_LENGTH)
+        {
+            throw std::runtime_error("Dictionary string too long");
+        }
+
+        const auto id = this->find_or_add(text);
+        const auto has_text = id == 0 || !this->acknowledged_[id - 1];
+
+        out = utils::store_varint(out, (static_cast<uint64_t>(id) << 1) | (has_text ? 1 : 0));
+
+        if (has_text)
+        {
+            out = utils::store_varint(out, text.size());
+            std::memcpy(out, text.data(), text.size());
+            out += text.size();
+        }
+
+        return out;
+    }
+
+    uint32_t string_encoder::find_or_add(const std::string_view text)
+    {
+        const auto hash = utils::hash::compute(text);
+        const auto mask = this->slots_.size() - 1;
+
+        for (auto i = hash & mask; !this->slots_.empty(); i = (i + 1) & mask)
+        {
+            const auto& entry = this->slots_[i];
+            if (!entry.id)
+            {
+                break;
+            }
+
+            if (entry.hash == hash && this->strings_[entry.id - 1] == text)
+            {
+                return entry.id;
+            }
+        }
+
+        if (this->strings_.size() >= MAX_DICTIONARY_SIZE)
+        {
+            return 0;
+        }
+
+        // At most half full, so probe chains stay short
+        if ((this->strings_.size() + 1) * 2 > this->slots_.size())
+        {
+            this->grow();
+        }
+
+        this->strings_.emplace_back(text);
+        this->acknowledged_.push_back(0);
+
+        const auto id = static_cast<uint32_t>(this->strings_.size());
+        this->insert({hash, id});
+
+        return id;
+    }
+
+    void string_encoder::insert(const slot entry)
+    {
+        const auto mask = this->slots_.size() - 1;
+
+        auto i = entry.hash & mask;
+        while (this->slots_[i].id)
+        {
+            i = (i + 1) & mask;
+        }
+
+        this->slots_[i] = entry;
+    }
+
+    void string_encoder::grow()
+    {
+        auto old_slots = std::move(this->slots_);
+        this->slots_.assign(std::max<size_t>(64, old_slots.size() * 2), {});
+
+        for (const auto& entry : old_slots)
+        {
+            if (entry.id)
+            {
+                this->insert(entry);
+            }
+        }
+    }
+
+    void string_encoder::acknowledge(const uint32_t id)
+    {
+        if (id > 0 && id <= this->acknowledged_.size())
+        {
+            this->acknowledged_[id - 1] = 1;
+        }
+    }
+
+    void string_encoder::reset()
+    {
+        std::ranges::fill(this->acknowledged_, uint8_t{0});
+    }
+
+    void string_decoder::read(utils::buffer_deserializer& buffer, char* dest, const size_t size)
+    {
+        const auto text = this->read(buffer);
+        const auto length = std::min(text.size(), size - 1);
+
+        std::memcpy(dest, text.data(), length);
+        std::memset(dest + length, 0, size - length);
+    }
+
+    std::string_view string_decoder::read(utils::buffer_deserializer& buffer)
+    {
+        const auto header = buffer.read_varint();
+        const auto id = header >> 1;
+        const auto has_text = (header & 1) != 0;
+
+        if (id > MAX_DICTIONARY_SIZE)
+        {
+            throw std::runtime_error("Dictionary id out of range");
+        }
+
+        if (id == 0)
+        {
+            if (!has_text)
+            {
+                throw std::runtime_error("Dictionary literal without text");
+            }
+
+            return read_text(buffer);
+        }
+
+        if (this->strings_.size() < id)
+        {
+            this->strings_.resize(static_cast<size_t>(id));
+        }
+
+        auto& entry = this->strings_[static_cast<size_t>(id - 1)];
+
+        if (has_text)
+        {
+            entry = read_text(buffer);
+            this->pending_acknowledgements_.push_back(static_cast<uint32_t>(id));
+        }
+        else if (!entry)
+        {
+            this->reset_requested_ = true;
+            throw std::runtime_error("Unknown dictionary id");
+        }
+
+        return *entry;
+    }
+
+    std::vector<uint32_t> string_decoder::take_acknowledgements()
+    {
+        auto acknowledgements = std::move(this->pending_acknowledgements_);
+        this->pending_acknowledgements_ = {};
+
+        std::ranges::sort(acknowledgements);
+        const auto duplicates = std::ranges::unique(acknowledgements);
+        acknowledgements.erase(duplicates.begin(), duplicates.end());
+
+        return acknowledgements;
+    }
+
+    bool string_decoder::take_reset_request()
+    {
+        return std::exchange(this->reset_requested_, false);
+    }
+
+    void string_decoder::reset()
+    {
+        this->strings_.clear();
+        this->pending_acknowledgements_.clear();
+        this->reset_requested_ = false;
+    }
+
+    std::vector<std::string> serialize_acknowledgements(const std::vector<uint32_t>& ids)
+    {
+        std::vector<std::string> payloads{};
+
+        for (size_t offset = 0; offset < ids.size(); offset += MAX_ACKNOWLEDGEMENTS_PER_PACKET)
+        {
+            const auto count = std::min(ids.size() - offset, MAX_ACKNOWLEDGEMENTS_PER_PACKET);
+
+            utils::buffer_serializer buffer{};
+            buffer.write(game::PROTOCOL);
+            buffer.write_varint(count);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                buffer.write_varint(ids[offset + i]);
+            }
+
+            payloads.emplace_back(buffer.move_buffer());
+        }
+
+        return payloads;
+    }
+
+    void apply_acknowledgements(string_encoder& encoder, const std::string_view& data)
+    {
+        utils::buffer_deserializer buffer(data);
+        if (buffer.read<uint32_t>() != game::PROTOCOL)
+        {
+            return;
+        }
+
+        const auto count = buffer.read_varint();
+        if (count > MAX_ACKNOWLEDGEMENTS_PER_PACKET)
+        {
+            throw std::runtime_error("Too many dictionary acknowledgements");
+        }
+
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            const auto id = buffer.read_varint();
+            if (id <= MAX_DICTIONARY_SIZE)
+            {
+                encoder.acknowledge(static_cast<uint32_t>(id));
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../utils/byte_buffer.hpp"
+#include "../utils/hash.hpp"
+
+namespace network
+{
+    // ===========================================================================
+    // SESSION STRING DICTIONARY
+    // ===========================================================================
+    // Fact names, NPC tags, item names and cutscene paths repeat constantly but
+    // used to be shipped as fixed, mostly zero-padded arrays.
+    // Each link keeps a dictionary per direction: the first time a string is
+    // sent it carries its text and gets a varint id, later packets only send the id.
+    // Definitions are repeated until the peer acknowledges them, so a dropped
+    // datagram never leaves the receiver with an id it can't resolve.
+    //
+    // Wire format of a string field: varint (id << 1 | has_text) [varint length, text]
+    // Id 0 is a literal that is never added to the dictionary.
+    // ===========================================================================
+
+    constexpr uint32_t MAX_DICTIONARY_SIZE = 4096;
+    constexpr size_t MAX_INTERNED_LENGTH = 256;
+    constexpr size_t MAX_ACKNOWLEDGEMENTS_PER_PACKET = 256;
+
+    class string_encoder
+    {
+      public:
+        void write(utils::buffer_serializer& buffer, std::string_view text);
+
+        template <size_t N>
+        void write(utils::buffer_serializer& buffer, const std::array<char, N>& text)
+        {
+            this->write(buffer, std::string_view(text.data(), strnlen(text.data(), N)));
+        }
+
+        template <size_t N>
+        void write(utils::buffer_serializer& buffer, const char (&text)[N])
+        {
+            this->write(buffer, std::string_view(text, strnlen(text, N)));
+        }
+
+        // Encodes straight into out, which needs room for max_encoded_size(text.size()), and returns the end
+        uint8_t* store(uint8_t* out, std::string_view text);
+
+        template <size_t N>
+        uint8_t* store(uint8_t* out, const std::array<char, N>& text)
+        {
+            return this->store(out, std::string_view(text.data(), strnlen(text.data(), N)));
+        }
+
+        template <size_t N>
+        uint8_t* store(uint8_t* out, const char (&text)[N])
+        {
+            return this->store(out, std::string_view(text, strnlen(text, N)));
+        }
+
+        // varint (id << 1 | has_text), varint length, text
+        static constexpr size_t max_encoded_size(const size_t length)
+        {
+            return 3 + 2 + length;
+        }
+
+        void acknowledge(uint32_t id);
+
+        // Peer lost its dictionary: keep the ids, but resend every definition
+        void reset();
+
+        size_t size() const
+        {
+            return this->acknowledged_.size();
+        }
+
+      private:
+        // Open addressing over the string hashes, every packet with a string field looks one up
+        struct slot
+        {
+            uint64_t hash{};
+            uint32_t id{};
+        };
+
+        std::vector<slot> slots_{};
+        std::vector<std::string> strings_{};
+        std::vector<uint8_t> acknowledged_{};
+
+        // Returns 0 once the dictionary is full
+        uint32_t find_or_add(std::string_view text);
+        void insert(slot entry);
+        void grow();
+    };
+
+    class string_decoder
+    {
+      public:
+        // Throws on malformed input or an id that was never defined
+        template <size_t N>
+        void read(utils::buffer_deserializer& buffer, std::array<char, N>& dest)
+        {
+            this->read(buffer, dest.data(), N);
+        }
+
+        template <size_t N>
+        void read(utils::buffer_deserializer& buffer, char (&dest)[N])
+        {
+            this->read(buffer, dest, N);
+        }
+
+        // Truncates to size - 1 and zero fills the rest, so the result is always null terminated
+        void read(utils::buffer_deserializer& buffer, char* dest, size_t size);
+
+        std::vector<uint32_t> take_acknowledgements();
+        bool take_reset_request();
+
+        void reset();
+
+      private:
+        std::vector<std::optional<std::string>> strings_{};
+        std::vector<uint32_t> pending_acknowledgements_{};
+        bool reset_requested_{false};
+
+        // Points into the packet buffer or the dictionary, only valid until the next call
+        std::string_view read(utils::buffer_deserializer& buffer);
+    };
+
+    struct string_dictionary
+    {
+        string_encoder outgoing{};
+        string_decoder incoming{};
+    };
+
+    // "dict_ack" payloads, at most MAX_ACKNOWLEDGEMENTS_PER_PACKET ids each
+    std::vector<std::string> serialize_acknowledgements(const std::vector<uint32_t>& ids);
+    void apply_acknowledgements(string_encoder& encoder, const std::string_view& data);
+}
@@ -0,0 +1,213 @@
+#include "world_snapshot.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "protocol.hpp"
+
+#include "../utils/compression.hpp"
+#include "../utils/hash.hpp"
+
+namespace network
+{
+    namespace
+    {
+        uint32_t get_chunk_count(const size_t size)
+        {
+            return static_cast<uint32_t>((size + SNAPSHOT_CHUNK_SIZE - 1) / SNAPSHOT_CHUNK_SIZE);
+        }
+
+        size_t get_chunk_size(const size_t total_size, const uint32_t index)
+        {
+            return std::min(SNAPSHOT_CHUNK_SIZE, total_size - index * SNAPSHOT_CHUNK_SIZE);
+        }
+
+        // Largest serialized snapshot within the limits, anything bigger is a decompression bomb
+        constexpr size_t MAX_RAW_SNAPSHOT_SIZE = 16 + MAX_SNAPSHOT_FACTS * (protocol::MAX_FACT_NAME_LENGTH + 8);
+    }
+
+    std::string serialize_snapshot(const world_snapshot& snapshot)
+    {
+        utils::buffer_serializer buffer{};
+        buffer.write(snapshot.total_crowns);
+        buffer.write(snapshot.game_time);
+        buffer.write(snapshot.weather_id);
+        buffer.write_varint(snapshot.facts.size());
+
+        for (const auto& [name, value] : snapshot.facts)
+        {
+            buffer.write_varint(name.size());
+            buffer.write(name.data(), name.size());
+            buffer.write(value);
+        }
+
+        return buffer.move_buffer();
+    }
+
+    world_snapshot deserialize_snapshot(const std::string_view data)
+    {
+        utils::buffer_deserializer buffer(data);
+
+        world_snapshot snapshot{};
+        snapshot.total_crowns = buffer.read<uint32_t>();
+        snapshot.game_time = buffer.read<uint32_t>();
+        snapshot.weather_id = buffer.read<uint16_t>();
+
+        const auto fact_count = buffer.read_varint();
+        if (fact_count > MAX_SNAPSHOT_FACTS)
+        {
+            throw std::runtime_error("Too many facts in world snapshot");
+        }
+
+        snapshot.facts.reserve(static_cast<size_t>(fact_count));
+
+        for (uint64_t i = 0; i < fact_count; ++i)
+        {
+            const auto length = buffer.read_varint();
+            if (length >= protocol::MAX_FACT_NAME_LENGTH)
+            {
+                throw std::runtime_error("Fact name too long in world snapshot");
+            }
+
+            auto name = std::string(buffer.read_view(static_cast<size_t>(length)));
+            const auto value = buffer.read<int32_t>();
+
+            snapshot.facts.emplace_back(std::move(name), value);
+        }
+
+        if (buffer.get_remaining_size() != 0)
+        {
+            throw std::runtime_error("Trailing data in world snapshot");
+        }
+
+        return snapshot;
+    }
+
+    std::string compress_snapshot(const world_snapshot& snapshot)
+    {
+        // The fastest level is about 20 times quicker than the best one for a third more chunks
+        return utils::compression::zlib::compress(serialize_snapshot(snapshot), utils::compression::zlib::fastest_level);
+    }
+
+    world_snapshot decompress_snapshot(const std::string& data)
+    {
+        std::string raw_data{};
+        if (!utils::compression::zlib::decompress_into(raw_data, data, 0, MAX_RAW_SNAPSHOT_SIZE))
+        {
+            throw std::runtime_error("Failed to decompress world snapshot");
+        }
+
+        return deserialize_snapshot(raw_data);
+    }
+
+    snapshot_transfer::snapshot_transfer(const uint64_t snapshot_id, const world_snapshot& snapshot)
+        : id(snapshot_id),
+          data(compress_snapshot(snapshot))
+    {
+        if (this->data.empty() || this->data.size() > MAX_SNAPSHOT_SIZE)
+        {
+            throw std::runtime_error("Failed to compress world snapshot");
+        }
+
+        this->checksum = utils::hash::compute(this->data.data(), this->data.size());
+    }
+
+    uint32_t snapshot_transfer::get_chunk_count() const
+    {
+        return network::get_chunk_count(this->data.size());
+    }
+
+    void snapshot_transfer::write_chunk(utils::buffer_serializer& buffer, const uint32_t index) const
+    {
+        if (index >= this->get_chunk_count())
+        {
+            throw std::runtime_error("Snapshot chunk out of range");
+        }
+
+        const auto size = get_chunk_size(this->data.size(), index);
+
+        buffer.write(this->id);
+        buffer.write(this->checksum);
+        buffer.write(static_cast<uint32_t>(this->data.size()));
+        buffer.write(index);
+        buffer.write_varint(size);
+        buffer.write(this->data.data() + index * SNAPSHOT_CHUNK_SIZE, size);
+    }
+
+    snapshot_chunk read_snapshot_chunk(utils::buffer_deserializer& buffer)
+    {
+        snapshot_chunk chunk{};
+        chunk.snapshot_id = buffer.read<uint64_t>();
+        chunk.checksum = buffer.read<uint64_t>();
+        chunk.total_size = buffer.read<uint32_t>();
+        chunk.index = buffer.read<uint32_t>();
+
+        if (chunk.snapshot_id == 0 || chunk.total_size == 0 || chunk.total_size > MAX_SNAPSHOT_SIZE)
+        {
+            throw std::runtime_error("Invalid world snapshot header");
+        }
+
+        if (chunk.index >= get_chunk_count(chunk.total_size))
+        {
+            throw std::runtime_error("Snapshot chunk out of range");
+        }
+
+        const auto size = buffer.read_varint();
+        if (size != get_chunk_size(chunk.total_size, chunk.index))
+        {
+            throw std::runtime_error("Invalid snapshot chunk size");
+        }
+
+        chunk.data = buffer.read_view(static_cast<size_t>(size));
+        return chunk;
+    }
+
+    void snapshot_receiver::add_chunk(const snapshot_chunk& chunk)
+    {
+        if (chunk.snapshot_id != this->snapshot_id_ || chunk.checksum != this->checksum_ || chunk.total_size != this->data_.size())
+        {
+            this->snapshot_id_ = chunk.snapshot_id;
+            this->checksum_ = chunk.checksum;
+            this->next_chunk_ = 0;
+            this->data_.assign(chunk.total_size, '\0');
+            this->received_.assign(network::get_chunk_count(chunk.total_size), false);
+        }
+
+        if (this->received_[chunk.index])
+        {
+            return;
+        }
+
+        std::copy(chunk.data.begin(), chunk.data.end(), this->data_.begin() + chunk.index * SNAPSHOT_CHUNK_SIZE);
+        this->received_[chunk.index] = true;
+
+        while (this->next_chunk_ < this->received_.size() && this->received_[this->next_chunk_])
+        {
+            ++this->next_chunk_;
+        }
+    }
+
+    world_snapshot snapshot_receiver::get_snapshot() const
+    {
+        if (!this->is_complete())
+        {
+            throw std::runtime_error("World snapshot is incomplete");
+        }
+
+        if (utils::hash::compute(this->data_.data(), this->data_.size()) != this->checksum_)
+        {
+            throw std::runtime_error("World snapshot checksum mismatch");
+        }
+
+        return decompress_snapshot(this->data_);
+    }
+
+    void snapshot_receiver::reset()
+    {
+        this->snapshot_id_ = 0;
+        this->checksum_ = 0;
+        this->next_chunk_ = 0;
+        this->data_.clear();
+        this->received_.clear();
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../utils/byte_buffer.hpp"
+
+namespace network
+{
+    // ===========================================================================
+    // WORLD SNAPSHOT
+    // ===========================================================================
+    // A player joining mid-session only sees facts broadcast after they connect.
+    // The server keeps the session's world state and hands it to late joiners as
+    // one zlib compressed snapshot, split into chunks that fit a datagram.
+    //
+    // The client drives the transfer: "snapshot_request" carries the snapshot id
+    // it is assembling (0 for a new one) and the first chunk it is missing, the
+    // server answers with up to SNAPSHOT_WINDOW chunks from there. Lost chunks or
+    // a reconnect just lead to a request that resumes at the gap. A request past
+    // the last chunk ends the transfer.
+    //
+    // Chunk wire format: snapshot id, checksum (utils::hash of the compressed
+    // snapshot), compressed size, chunk index, varint length, data
+    // ===========================================================================
+
+    constexpr size_t SNAPSHOT_CHUNK_SIZE = 1024;
+    constexpr size_t SNAPSHOT_WINDOW = 16;
+    constexpr size_t MAX_SNAPSHOT_SIZE = 4 * 1024 * 1024;
+    constexpr size_t MAX_SNAPSHOT_FACTS = 64 * 1024;
+
+    struct world_snapshot
+    {
+        uint32_t total_crowns{};
+        uint32_t game_time{};
+        uint16_t weather_id{};
+        std::vector<std::pair<std::string, int32_t>> facts{};
+    };
+
+    // Uncompressed layout, also used by the server's session journal
+    std::string serialize_snapshot(const world_snapshot& snapshot);
+    world_snapshot deserialize_snapshot(std::string_view data);
+
+    std::string compress_snapshot(const world_snapshot& snapshot);
+
+    // Both throw if the data is corrupt or exceeds the limits above
+    world_snapshot decompress_snapshot(const std::string& data);
+
+    // Sender side, immutable once built so any number of joiners can stream it
+    struct snapshot_transfer
+    {
+        uint64_t id{};
+        uint64_t checksum{};
+        std::string data{};
+
+        snapshot_transfer(uint64_t snapshot_id, const world_snapshot& snapshot);
+
+        uint32_t get_chunk_count() const;
+        void write_chunk(utils::buffer_serializer& buffer, uint32_t index) const;
+    };
+
+    struct snapshot_chunk
+    {
+        uint64_t snapshot_id{};
+        uint64_t checksum{};
+        uint32_t total_size{};
+        uint32_t index{};
+        std::string_view data{};
+    };
+
+    snapshot_chunk read_snapshot_chunk(utils::buffer_deserializer& buffer);
+
+    // Receiver side, assembles chunks in any order
+    class snapshot_receiver
+    {
+      public:
+        // A chunk of a different snapshot restarts the transfer
+        void add_chunk(const snapshot_chunk& chunk);
+
+        // Id to request, 0 until the first chunk arrived
+        uint64_t get_snapshot_id() const
+        {
+            return this->snapshot_id_;
+        }
+
+        // First chunk still missing, the chunk count once complete
+        uint32_t get_next_chunk() const
+        {
+            return this->next_chunk_;
+        }
+
+        uint32_t get_chunk_count() const
+        {
+            return static_cast<uint32_t>(this->received_.size());
+        }
+
+        bool is_complete() const
+        {
+            return this->snapshot_id_ != 0 && this->next_chunk_ == this->received_.size();
+        }
+
+        // Verifies and decompresses a complete snapshot, throws on mismatch
+        world_snapshot get_snapshot() const;
+
+        void reset();
+
+      private:
+        uint64_t snapshot_id_{};
+        uint64_t checksum_{};
+        uint32_t next_chunk_{};
+        std::string data_{};
+        std::vector<bool> received_{};
+    };
+}
@@ -0,0 +1,216 @@
+#include "session_cipher.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace security
+{
+    namespace
+    {
+        constexpr char KEY_INFO[] = "w3m session keys";
+        constexpr size_t NONCE_SIZE = 12;
+
+        std::array<uint8_t, NONCE_SIZE> make_nonce(const uint64_t sequence)
+        {
+            std::array<uint8_t, NONCE_SIZE> nonce{};
+            for (size_t i = 0; i < sizeof(sequence); ++i)
+            {
+                nonce[NONCE_SIZE - sizeof(sequence) + i] = static_cast<uint8_t>(sequence >> (i * 8));
+            }
+
+            return nonce;
+        }
+
+        void write_sequence(char* data, const uint64_t sequence)
+        {
+            for (size_t i = 0; i < sizeof(sequence); ++i)
+            {
+                data[i] = static_cast<char>(sequence >> (i * 8));
+            }
+        }
+
+        uint64_t read_sequence(const char* data)
+        {
+            uint64_t sequence = 0;
+            for (size_t i = 0; i < sizeof(sequence); ++i)
+            {
+                sequence |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (i * 8);
+            }
+
+            return sequence;
+        }
+
+        // Authenticates header and sequence, then runs the cipher over the rest of the packet in place
+        bool process(const chacha20poly1305_state& keyed_state, std::string& packet, const size_t header_size, const uint64_t sequence,
+                     const int direction, uint8_t* tag)
+        {
+            auto state = keyed_state;
+            const auto nonce = make_nonce(sequence);
+            auto* data = reinterpret_cast<uint8_t*>(packet.data());
+
+            const auto payload_offset = header_size + SEQUENCE_SIZE;
+            const auto payload_size = static_cast<unsigned long>(packet.size() - payload_offset);
+            unsigned long tag_size = TAG_SIZE;
+
+            const auto success =
+                chacha20poly1305_setiv(&state, nonce.data(), static_cast<unsigned long>(nonce.size())) == CRYPT_OK &&
+                chacha20poly1305_add_aad(&state, data, static_cast<unsigned long>(payload_offset)) == CRYPT_OK &&
+                (direction == CHACHA20POLY1305_ENCRYPT
+                     ? chacha20poly1305_encrypt(&state, data + payload_offset, payload_size, data + payload_offset)
+                     : chacha20poly1305_decrypt(&state, data + payload_offset, payload_size, data + payload_offset)) == CRYPT_OK &&
+                chacha20poly1305_done(&state, tag, &tag_size) == CRYPT_OK;
+
+            zeromem(&state, sizeof(state));
+            return success && tag_size == TAG_SIZE;
+        }
+    }
+
+    session_keys derive_session_keys(const utils::cryptography::ecc::key& private_key, const utils::cryptography::ecc::key& peer_key,
+                                     const std::string_view nonce, const session_role role)
+    {
+        if (!private_key.is_valid() || !peer_key.is_valid())
+        {
+            throw std::runtime_error("Invalid session key exchange");
+        }
+
+        uint8_t shared_secret[128]{};
+        unsigned long shared_secret_size = sizeof(shared_secret);
+
+        if (ecc_shared_secret(&private_key.get(), &peer_key.get(), shared_secret, &shared_secret_size) != CRYPT_OK)
+        {
+            throw std::runtime_error("Session key exchange failed");
+        }
+
+        // Client to server key first, then server to client
+        uint8_t key_material[2 * SESSION_KEY_SIZE]{};
+        const auto* salt = reinterpret_cast<const uint8_t*>(nonce.data());
+        const auto* info = reinterpret_cast<const uint8_t*>(KEY_INFO);
+
+        const auto result = hkdf(find_hash("sha256"), salt, static_cast<unsigned long>(nonce.size()), info, sizeof(KEY_INFO) - 1,
+                                 shared_secret, shared_secret_size, key_material, sizeof(key_material));
+
+        zeromem(shared_secret, sizeof(shared_secret));
+
+        if (result != CRYPT_OK)
+        {
+            zeromem(key_material, sizeof(key_material));
+            throw std::runtime_error("Session key derivation failed");
+        }
+
+        session_keys keys{};
+        const auto* client_key = key_material;
+        const auto* server_key = key_material + SESSION_KEY_SIZE;
+
+        memcpy(keys.send.data(), role == session_role::client ? client_key : server_key, SESSION_KEY_SIZE);
+        memcpy(keys.receive.data(), role == session_role::client ? server_key : client_key, SESSION_KEY_SIZE);
+
+        zeromem(key_material, sizeof(key_material));
+        return keys;
+    }
+
+    bool replay_window::is_fresh(const uint64_t sequence) const
+    {
+        if (sequence == 0)
+        {
+            return false;
+        }
+
+        if (sequence > this->highest_)
+        {
+            return true;
+        }
+
+        if (this->highest_ - sequence >= SIZE)
+        {
+            return false;
+        }
+
+        const auto word = this->bitmap_[(sequence / 64) % BITMAP_WORDS];
+        return ((word >> (sequence % 64)) & 1) == 0;
+    }
+
+    void replay_window::mark(const uint64_t sequence)
+    {
+        if (sequence > this->highest_)
+        {
+            // Clear the words the window slides over, at most all of them
+            const auto current_word = this->highest_ / 64;
+            const auto new_word = sequence / 64;
+            const auto cleared_words = std::min<uint64_t>(new_word - current_word, BITMAP_WORDS);
+
+            for (uint64_t i = 1; i <= cleared_words; ++i)
+            {
+                this->bitmap_[(current_word + i) % BITMAP_WORDS] = 0;
+            }
+
+            this->highest_ = sequence;
+        }
+
+        this->bitmap_[(sequence / 64) % BITMAP_WORDS] |= uint64_t{1} << (sequence % 64);
+    }
+
+    session_cipher::session_cipher(const session_keys& keys)
+    {
+        if (chacha20poly1305_init(&this->send_state_, keys.send.data(), SESSION_KEY_SIZE) != CRYPT_OK ||
+            chacha20poly1305_init(&this->receive_state_, keys.receive.data(), SESSION_KEY_SIZE) != CRYPT_OK)
+        {
+            throw std::runtime_error("Failed to initialize session cipher");
+        }
+    }
+
+    session_cipher::~session_cipher()
+    {
+        zeromem(&this->send_state_, sizeof(this->send_state_));
+        zeromem(&this->receive_state_, sizeof(this->receive_state_));
+    }
+
+    bool session_cipher::seal(std::string& packet, const size_t header_size)
+    {
+        if (packet.size() < header_size + SEQUENCE_SIZE)
+        {
+            return false;
+        }
+
+        const auto sequence = this->next_sequence_++;
+        write_sequence(packet.data() + header_size, sequence);
+
+        uint8_t tag[TAG_SIZE]{};
+        if (!process(this->send_state_, packet, header_size, sequence, CHACHA20POLY1305_ENCRYPT, tag))
+        {
+            return false;
+        }
+
+        packet.append(reinterpret_cast<const char*>(tag), TAG_SIZE);
+        return true;
+    }
+
+    bool session_cipher::open(std::string& packet, const size_t header_size)
+    {
+        if (packet.size() < header_size + SEAL_OVERHEAD)
+        {
+            return false;
+        }
+
+        const auto sequence = read_sequence(packet.data() + header_size);
+        if (!this->replay_window_.is_fresh(sequence))
+        {
+            return false;
+        }
+
+        uint8_t received_tag[TAG_SIZE]{};
+        memcpy(received_tag, packet.data() + packet.size() - TAG_SIZE, TAG_SIZE);
+        packet.resize(packet.size() - TAG_SIZE);
+
+        uint8_t tag[TAG_SIZE]{};
+        if (!process(this->receive_state_, packet, header_size, sequence, CHACHA20POLY1305_DECRYPT, tag) ||
+            mem_neq(tag, received_tag, TAG_SIZE) != 0)
+        {
+            return false;
+        }
+
+        // Only authentic packets move the window, forged sequences can't push it forward
+        this->replay_window_.mark(sequence);
+        return true;
+    }
+}
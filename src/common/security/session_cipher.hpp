@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../utils/cryptography.hpp"
+
+namespace security
+{
+    // ===========================================================================
+    // SESSION ENCRYPTION
+    // ===========================================================================
+    // After a client authenticated, both ends derive a ChaCha20-Poly1305 key per
+    // direction from an ECDH exchange between the client's identity key and an
+    // ephemeral server key, salted with the authentication nonce.
+    //
+    // Sealed layout: header (authenticated, not encrypted), u64 sequence,
+    // ciphertext, tag. The sequence is the nonce and never repeats for a key,
+    // receivers drop sequences they have seen or that fell out of the window.
+    // ===========================================================================
+
+    constexpr size_t SESSION_KEY_SIZE = 32;
+    constexpr size_t SEQUENCE_SIZE = sizeof(uint64_t);
+    constexpr size_t TAG_SIZE = 16;
+    constexpr size_t SEAL_OVERHEAD = SEQUENCE_SIZE + TAG_SIZE;
+
+    enum class session_role
+    {
+        client,
+        server,
+    };
+
+    struct session_keys
+    {
+        std::array<uint8_t, SESSION_KEY_SIZE> send{};
+        std::array<uint8_t, SESSION_KEY_SIZE> receive{};
+    };
+
+    // Throws if the keys are on different curves or the exchange fails
+    session_keys derive_session_keys(const utils::cryptography::ecc::key& private_key, const utils::cryptography::ecc::key& peer_key,
+                                     std::string_view nonce, session_role role);
+
+    // Sliding bitmap of received sequences as in RFC 6479, tolerates reordering within SIZE packets
+    class replay_window
+    {
+      public:
+        static constexpr size_t BITMAP_WORDS = 16;
+
+        // The newest word is only partially in use
+        static constexpr uint64_t SIZE = (BITMAP_WORDS - 1) * 64;
+
+        bool is_fresh(uint64_t sequence) const;
+        void mark(uint64_t sequence);
+
+      private:
+        std::array<uint64_t, BITMAP_WORDS> bitmap_{};
+        uint64_t highest_{};
+    };
+
+    class session_cipher
+    {
+      public:
+        explicit session_cipher(const session_keys& keys);
+        ~session_cipher();
+
+        session_cipher(session_cipher&&) = delete;
+        session_cipher(const session_cipher&) = delete;
+        session_cipher& operator=(session_cipher&&) = delete;
+        session_cipher& operator=(const session_cipher&) = delete;
+
+        // packet holds header_size bytes of header, SEQUENCE_SIZE bytes reserved for the sequence, then the plaintext.
+        // Fills in the sequence, encrypts in place and appends the tag, so reserve TAG_SIZE to avoid a reallocation.
+        // Safe to call from several threads.
+        bool seal(std::string& packet, size_t header_size);
+
+        // Verifies, decrypts in place and strips the tag, the plaintext starts at header_size + SEQUENCE_SIZE.
+        // Fails for forged, corrupt or replayed packets, which leaves the packet garbled. Only call from one thread.
+        bool open(std::string& packet, size_t header_size);
+
+      private:
+        // Keyed states, copied per packet as finishing a packet wipes the key
+        chacha20poly1305_state send_state_{};
+        chacha20poly1305_state receive_state_{};
+
+        std::atomic_uint64_t next_sequence_{1};
+        replay_window replay_window_{};
+    };
+}
@@ -0,0 +1,375 @@
+#include "binary_patch.hpp"
+#include "byte_buffer.hpp"
+#include "compression.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace utils::binary_patch
+{
+    namespace
+    {
+        constexpr uint32_t PATCH_MAGIC = 0x504D3357; // "W3MP"
+        constexpr uint32_t PATCH_VERSION = 1;
+        constexpr size_t HEADER_SIZE = 16;
+
+        constexpr uint8_t OP_COPY = 0;
+        constexpr uint8_t OP_INSERT = 1;
+
+        // The base is indexed every STRIDE bytes, so any common run of WINDOW + STRIDE - 1 bytes is found
+        constexpr size_t WINDOW = 32;
+        constexpr size_t STRIDE = 16;
+
+        constexpr size_t COPY_BUFFER_SIZE = 1024 * 1024;
+
+        // Type and two varints
+        constexpr size_t MAX_OPERATION_HEADER_SIZE = 1 + 2 * MAX_VARINT_SIZE;
+
+        // Polynomial rolling hash over WINDOW bytes, modulo 2^64
+        constexpr uint64_t HASH_FACTOR = 0x100000001B3;
+
+        constexpr uint64_t get_outgoing_factor()
+        {
+            uint64_t factor = 1;
+            for (size_t i = 1; i < WINDOW; ++i)
+            {
+                factor *= HASH_FACTOR;
+            }
+
+            return factor;
+        }
+
+        constexpr uint64_t OUTGOING_FACTOR = get_outgoing_factor();
+
+        uint64_t hash_window(const std::string_view data, const size_t offset)
+        {
+            uint64_t hash = 0;
+            for (size_t i = 0; i < WINDOW; ++i)
+            {
+                hash = hash * HASH_FACTOR + static_cast<uint8_t>(data[offset + i]);
+            }
+
+            return hash;
+        }
+
+        uint64_t roll_window(const uint64_t hash, const char outgoing, const char incoming)
+        {
+            return (hash - static_cast<uint8_t>(outgoing) * OUTGOING_FACTOR) * HASH_FACTOR + static_cast<uint8_t>(incoming);
+        }
+
+        std::unordered_map<uint64_t, size_t> index_base(const std::string_view base)
+        {
+            std::unordered_map<uint64_t, size_t> index{};
+            if (base.size() < WINDOW)
+            {
+                return index;
+            }
+
+            index.reserve(base.size() / STRIDE + 1);
+
+            auto hash = hash_window(base, 0);
+            for (size_t offset = 0;; ++offset)
+            {
+                // The first occurrence wins, later duplicates are just as good a match
+                if (offset % STRIDE == 0)
+                {
+                    index.try_emplace(hash, offset);
+                }
+
+                if (offset + WINDOW >= base.size())
+                {
+                    break;
+                }
+
+                hash = roll_window(hash, base[offset], base[offset + WINDOW]);
+            }
+
+            return index;
+        }
+
+        class operation_writer
+        {
+          public:
+            explicit operation_writer(const std::string_view target)
+                : target_(target)
+            {
+            }
+
+            void insert(const size_t start, const size_t end)
+            {
+                if (start < end)
+                {
+                    this->buffer_.write(OP_INSERT);
+                    this->buffer_.write_varint(end - start);
+                    this->buffer_.write(this->target_.data() + start, end - start);
+                }
+            }
+
+            void copy(const size_t offset, const size_t length)
+            {
+                this->buffer_.write(OP_COPY);
+                this->buffer_.write_varint(offset);
+                this->buffer_.write_varint(length);
+            }
+
+            std::string_view get_view() const
+            {
+                return this->buffer_.get_view();
+            }
+
+          private:
+            std::string_view target_{};
+            buffer_serializer buffer_{};
+        };
+
+        // The operations one container block at a time. Operations can straddle blocks, so the unread tail of a block
+        // is kept in front of the next one.
+        class operation_reader
+        {
+          public:
+            operation_reader(const std::string_view operations, const size_t max_size)
+                : blocks_(operations),
+                  max_size_(max_size)
+            {
+            }
+
+            // Whether count bytes are available, fewer only at the end or on corrupt data
+            bool fill(const size_t count)
+            {
+                while (this->get_available().size() < count)
+                {
+                    if (!this->blocks_.read_next(this->block_) || this->block_.size() > this->max_size_ - this->read_size_)
+                    {
+                        return false;
+                    }
+
+                    this->read_size_ += this->block_.size();
+
+                    if (this->offset_ == this->buffer_.size())
+                    {
+                        std::swap(this->buffer_, this->block_);
+                    }
+                    else
+                    {
+                        this->buffer_.erase(0, this->offset_);
+                        this->buffer_.append(this->block_);
+                    }
+
+                    this->offset_ = 0;
+                }
+
+                return true;
+            }
+
+            std::string_view get_available() const
+            {
+                return std::string_view(this->buffer_).substr(this->offset_);
+            }
+
+            std::string_view take(const size_t length)
+            {
+                const auto data = this->get_available().substr(0, length);
+                this->offset_ += data.size();
+                return data;
+            }
+
+            bool is_complete() const
+            {
+                return this->blocks_.is_complete() && this->offset_ == this->buffer_.size();
+            }
+
+          private:
+            compression::zlib::block_reader blocks_;
+            std::string buffer_{};
+            std::string block_{};
+            size_t offset_{};
+            size_t read_size_{};
+            size_t max_size_{};
+        };
+    }
+
+    std::string create_patch(const std::string_view base, const std::string_view target)
+    {
+        const auto index = index_base(base);
+        operation_writer operations(target);
+
+        size_t insert_start = 0;
+        size_t offset = 0;
+        uint64_t hash = target.size() >= WINDOW ? hash_window(target, 0) : 0;
+
+        while (offset + WINDOW <= target.size())
+        {
+            const auto match = index.find(hash);
+            if (match != index.end() && target.compare(offset, WINDOW, base.substr(match->second, WINDOW)) == 0)
+            {
+                auto target_start = offset;
+                auto base_start = match->second;
+
+                // Grow the match backwards into the pending insert, then forwards as far as it goes
+                while (target_start > insert_start && base_start > 0 && target[target_start - 1] == base[base_start - 1])
+                {
+                    --target_start;
+                    --base_start;
+                }
+
+                auto length = offset - target_start + WINDOW;
+                while (target_start + length < target.size() && base_start + length < base.size() &&
+                       target[target_start + length] == base[base_start + length])
+                {
+                    ++length;
+                }
+
+                operations.insert(insert_start, target_start);
+                operations.copy(base_start, length);
+
+                offset = target_start + length;
+                insert_start = offset;
+
+                if (offset + WINDOW <= target.size())
+                {
+                    hash = hash_window(target, offset);
+                }
+
+                continue;
+            }
+
+            if (offset + WINDOW >= target.size())
+            {
+                break;
+            }
+
+            hash = roll_window(hash, target[offset], target[offset + WINDOW]);
+            ++offset;
+        }
+
+        operations.insert(insert_start, target.size());
+
+        const auto compressed_operations = compression::zlib::compress_blocks(operations.get_view(), compression::zlib::best_level);
+        if (compressed_operations.empty())
+        {
+            throw std::runtime_error("Failed to compress patch");
+        }
+
+        buffer_serializer buffer{};
+        buffer.reserve(compressed_operations.size() + HEADER_SIZE);
+        buffer.write(PATCH_MAGIC);
+        buffer.write(PATCH_VERSION);
+        buffer.write(static_cast<uint64_t>(target.size()));
+        buffer.write(compressed_operations.data(), compressed_operations.size());
+
+        return buffer.move_buffer();
+    }
+
+    std::optional<uint64_t> get_target_size(const std::string_view patch)
+    {
+        try
+        {
+            buffer_deserializer buffer(patch);
+            if (buffer.read<uint32_t>() != PATCH_MAGIC || buffer.read<uint32_t>() != PATCH_VERSION)
+            {
+                return std::nullopt;
+            }
+
+            return buffer.read<uint64_t>();
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+    }
+
+    bool apply_patch(std::istream& base, const std::string_view patch, const std::function<bool(std::string_view)>& output)
+    {
+        const auto target_size = get_target_size(patch);
+        if (!target_size)
+        {
+            return false;
+        }
+
+        // Every operation emits at least one byte for at most a few dozen bytes of overhead, anything larger is corrupt
+        const auto max_operations_size = static_cast<size_t>(std::min<uint64_t>(*target_size, SIZE_MAX / 64) * 32 + 64);
+
+        operation_reader operations(patch.substr(HEADER_SIZE), max_operations_size);
+
+        std::string copy_buffer{};
+        uint64_t written = 0;
+
+        try
+        {
+            while (operations.fill(MAX_OPERATION_HEADER_SIZE) || !operations.get_available().empty())
+            {
+                buffer_deserializer buffer(operations.get_available());
+                const auto type = buffer.read<uint8_t>();
+
+                if (type == OP_INSERT)
+                {
+                    auto length = buffer.read_varint();
+                    if (length > *target_size - written)
+                    {
+                        return false;
+                    }
+
+                    (void)operations.take(operations.get_available().size() - buffer.get_remaining_size());
+                    written += length;
+
+                    // Inserts can be larger than a block, they are passed on as the blocks arrive
+                    while (length > 0)
+                    {
+                        if (!operations.fill(1))
+                        {
+                            return false;
+                        }
+
+                        const auto data = operations.take(static_cast<size_t>(std::min<uint64_t>(length, SIZE_MAX)));
+                        if (!output(data))
+                        {
+                            return false;
+                        }
+
+                        length -= data.size();
+                    }
+                }
+                else if (type == OP_COPY)
+                {
+                    const auto offset = buffer.read_varint();
+                    auto length = buffer.read_varint();
+                    if (length > *target_size - written)
+                    {
+                        return false;
+                    }
+
+                    (void)operations.take(operations.get_available().size() - buffer.get_remaining_size());
+
+                    base.clear();
+                    base.seekg(static_cast<std::streamoff>(offset));
+
+                    while (length > 0)
+                    {
+                        const auto chunk_size = static_cast<size_t>(std::min<uint64_t>(length, COPY_BUFFER_SIZE));
+                        copy_buffer.resize(chunk_size);
+
+                        base.read(copy_buffer.data(), static_cast<std::streamsize>(chunk_size));
+                        if (static_cast<size_t>(base.gcount()) != chunk_size || !output(copy_buffer))
+                        {
+                            return false;
+                        }
+
+                        length -= chunk_size;
+                        written += chunk_size;
+                    }
+                }
+                else
+                {
+                    return false;
+                }
+            }
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+
+        return operations.is_complete() && written == *target_size;
+    }
+}
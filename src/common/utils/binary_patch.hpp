@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace utils::binary_patch
+{
+    // ===========================================================================
+    // BINARY DELTA PATCHES
+    // ===========================================================================
+    // A patch rebuilds a target file from a base file with two operations: copy
+    // a range of the base, or insert new bytes. Small changes to a large binary
+    // become a few inserts between long copies.
+    //
+    // Layout: "W3MP", u32 version, u64 target size, then the operations as a
+    // zlib block container. Each operation is a u8 type followed by varints:
+    // COPY base offset and length, INSERT length and the bytes.
+    //
+    // Applying reads the base with random access and emits the target in
+    // pieces, so neither file has to fit in memory.
+    // ===========================================================================
+
+    // Offline, for publishing updates. Matches are found on 32 byte windows, shorter common runs are inserted.
+    std::string create_patch(std::string_view base, std::string_view target);
+
+    // Nothing if the data is not a patch
+    std::optional<uint64_t> get_target_size(std::string_view patch);
+
+    // Passes the target to output piece by piece, output returning false aborts. Returns false on a corrupt patch,
+    // a base that is too short or an aborted output.
+    bool apply_patch(std::istream& base, std::string_view patch, const std::function<bool(std::string_view)>& output);
+}
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace utils
+{
+    // Bit-granular companions to buffer_serializer/buffer_deserializer.
+    // Fields are packed LSB-first into little-endian bytes, so the encoding is identical on every host.
+
+    namespace bit_buffer_detail
+    {
+        inline uint64_t load_le64(const uint8_t* data)
+        {
+            uint64_t value{};
+
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                memcpy(&value, data, sizeof(value));
+            }
+            else
+            {
+                for (size_t i = 0; i < sizeof(value); ++i)
+                {
+                    value |= static_cast<uint64_t>(data[i]) << (i * 8);
+                }
+            }
+
+            return value;
+        }
+
+        inline uint64_t mask(const uint32_t bits)
+        {
+            return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+        }
+
+        inline uint64_t quantization_steps(const uint32_t bits)
+        {
+            if (bits == 0 || bits > 32)
+            {
+                throw std::runtime_error("Invalid quantization width");
+            }
+
+            return mask(bits);
+        }
+    }
+
+    class bit_writer
+    {
+      public:
+        bit_writer() = default;
+
+        void write_bits(uint64_t value, const uint32_t bits)
+        {
+            if (bits > 64)
+            {
+                throw std::runtime_error("Invalid bit field width");
+            }
+
+            if (bits == 0)
+            {
+                return;
+            }
+
+            value &= bit_buffer_detail::mask(bits);
+
+            this->scratch_ |= value << this->scratch_bits_;
+            const auto total_bits = this->scratch_bits_ + bits;
+
+            if (total_bits < 64)
+            {
+                this->scratch_bits_ = total_bits;
+                return;
+            }
+
+            this->flush_scratch(8);
+            this->scratch_ = this->scratch_bits_ ? value >> (64 - this->scratch_bits_) : 0;
+            this->scratch_bits_ = total_bits - 64;
+        }
+
+        void write_bool(const bool value)
+        {
+            this->write_bits(value ? 1 : 0, 1);
+        }
+
+        // LEB128 groups, not byte aligned
+        void write_varint(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                this->write_bits((value & 0x7F) | 0x80, 8);
+                value >>= 7;
+            }
+
+            this->write_bits(value, 8);
+        }
+
+        void write_zigzag(const int64_t value)
+        {
+            this->write_varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        // Maps [min, max] onto 2^bits - 1 evenly spaced steps; values outside the range are clamped
+        void write_quantized(const float value, const float min, const float max, const uint32_t bits)
+        {
+            const auto steps = bit_buffer_detail::quantization_steps(bits);
+
+            auto normalized = (value - min) / (max - min);
+            if (!(normalized > 0.0f))
+            {
+                normalized = 0.0f;
+            }
+            else if (normalized > 1.0f)
+            {
+                normalized = 1.0f;
+            }
+
+            const auto quantized = static_cast<uint64_t>(std::lround(static_cast<double>(normalized) * static_cast<double>(steps)));
+            this->write_bits(quantized, bits);
+        }
+
+        void write_bytes(const void* data, const size_t length)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+
+            if (this->scratch_bits_ == 0)
+            {
+                this->buffer_.append(reinterpret_cast<const char*>(bytes), length);
+                return;
+            }
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                this->write_bits(bytes[i], 8);
+            }
+        }
+
+        void write_string(const std::string_view str)
+        {
+            this->write_varint(str.size());
+            this->write_bytes(str.data(), str.size());
+        }
+
+        // Pads with zero bits up to the next byte boundary
+        void align()
+        {
+            this->scratch_bits_ = (this->scratch_bits_ + 7) & ~7u;
+            this->flush_scratch(this->scratch_bits_ / 8);
+            this->scratch_ = 0;
+            this->scratch_bits_ = 0;
+        }
+
+        size_t get_bit_count() const
+        {
+            return this->buffer_.size() * 8 + this->scratch_bits_;
+        }
+
+        // Aligns the stream, later writes start on the next byte
+        const std::string& get_buffer()
+        {
+            this->align();
+            return this->buffer_;
+        }
+
+        std::string move_buffer()
+        {
+            this->align();
+            return std::move(this->buffer_);
+        }
+
+      private:
+        std::string buffer_{};
+        uint64_t scratch_{0};
+        uint32_t scratch_bits_{0};
+
+        void flush_scratch(const size_t bytes)
+        {
+            char data[8]{};
+            for (size_t i = 0; i < bytes; ++i)
+            {
+                data[i] = static_cast<char>(static_cast<uint8_t>(this->scratch_ >> (i * 8)));
+            }
+
+            this->buffer_.append(data, bytes);
+        }
+    };
+
+    class bit_reader
+    {
+      public:
+        template <typename T>
+        bit_reader(const std::basic_string_view<T>& buffer)
+            : data_(reinterpret_cast<const uint8_t*>(buffer.data())),
+              size_(buffer.size() * sizeof(T))
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Type must be trivially copyable");
+        }
+
+        template <typename T>
+        bit_reader(const std::basic_string<T>& buffer)
+            : bit_reader(std::basic_string_view<T>(buffer.data(), buffer.size()))
+        {
+        }
+
+        uint64_t read_bits(const uint32_t bits)
+        {
+            if (bits > 64)
+            {
+                throw std::runtime_error("Invalid bit field width");
+            }
+
+            if (bits > this->get_remaining_bits())
+            {
+                throw std::runtime_error("Out of bounds read from bit buffer");
+            }
+
+            if (bits == 0)
+            {
+                return 0;
+            }
+
+            auto byte_index = this->offset_ >> 3;
+            const auto bit_index = static_cast<uint32_t>(this->offset_ & 7);
+
+            // One unaligned load covers up to 57 bits
+            if (bits <= 64 - bit_index && byte_index + 8 <= this->size_)
+            {
+                const auto word = bit_buffer_detail::load_le64(this->data_ + byte_index);
+                this->offset_ += bits;
+                return (word >> bit_index) & bit_buffer_detail::mask(bits);
+            }
+
+            uint64_t result = 0;
+            uint32_t produced = 0;
+            uint32_t shift = bit_index;
+
+            while (produced < bits)
+            {
+                const auto take = std::min(8 - shift, bits - produced);
+                const uint64_t chunk = (this->data_[byte_index] >> shift) & bit_buffer_detail::mask(take);
+
+                result |= chunk << produced;
+                produced += take;
+                shift = 0;
+                ++byte_index;
+            }
+
+            this->offset_ += bits;
+            return result;
+        }
+
+        bool read_bool()
+        {
+            return this->read_bits(1) != 0;
+        }
+
+        uint64_t read_varint()
+        {
+            uint64_t result = 0;
+
+            for (uint32_t shift = 0; shift < 64; shift += 7)
+            {
+                const auto byte = this->read_bits(8);
+                result |= (byte & 0x7F) << shift;
+
+                if ((byte & 0x80) == 0)
+                {
+                    return result;
+                }
+            }
+
+            throw std::runtime_error("Overlong varint in bit buffer");
+        }
+
+        int64_t read_zigzag()
+        {
+            const auto value = this->read_varint();
+            return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+        }
+
+        float read_quantized(const float min, const float max, const uint32_t bits)
+        {
+            const auto steps = bit_buffer_detail::quantization_steps(bits);
+            const auto quantized = this->read_bits(bits);
+
+            return min + static_cast<float>(static_cast<double>(quantized) / static_cast<double>(steps) * (max - min));
+        }
+
+        void read_bytes(void* data, const size_t length)
+        {
+            if (length > this->get_remaining_bits() / 8)
+            {
+                throw std::runtime_error("Out of bounds read from bit buffer");
+            }
+
+            auto* bytes = static_cast<uint8_t*>(data);
+
+            if ((this->offset_ & 7) == 0)
+            {
+                memcpy(bytes, this->data_ + (this->offset_ >> 3), length);
+                this->offset_ += length * 8;
+                return;
+            }
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                bytes[i] = static_cast<uint8_t>(this->read_bits(8));
+            }
+        }
+
+        std::string read_string()
+        {
+            const auto size = this->read_varint();
+            if (size > this->get_remaining_bits() / 8)
+            {
+                throw std::runtime_error("Out of bounds read from bit buffer");
+            }
+
+            std::string result{};
+            result.resize(static_cast<size_t>(size));
+            this->read_bytes(result.data(), result.size());
+
+            return result;
+        }
+
+        void align()
+        {
+            const auto aligned = (this->offset_ + 7) & ~size_t{7};
+            if (aligned > this->size_ * 8)
+            {
+                throw std::runtime_error("Out of bounds read from bit buffer");
+            }
+
+            this->offset_ = aligned;
+        }
+
+        size_t get_remaining_bits() const
+        {
+            return this->size_ * 8 - this->offset_;
+        }
+
+        size_t get_bit_offset() const
+        {
+            return this->offset_;
+        }
+
+      private:
+        const uint8_t* data_{};
+        size_t size_{};
+        size_t offset_{0};
+    };
+}
@@ -1,12 +1,34 @@
 #pragma once
 
+#include <array>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <stdexcept>
 #include <cstring>
+#include <cstdint>
 
 namespace utils
 {
+    constexpr size_t MAX_VARINT_SIZE = 10;
+
+    // Writes value as little-endian base 128 and returns the end of the written bytes
+    inline uint8_t* store_varint(uint8_t* out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            *out++ = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+
+        *out++ = static_cast<uint8_t>(value);
+        return out;
+    }
+
+    // The deserializer doesn't own its data. The read_view/read_span family returns views into the buffer it was
+    // constructed from instead of copies: they stay valid as long as that storage is alive and unmodified, which for
+    // a network handler means until it returns. Copy anything that has to outlive the handler.
     class buffer_deserializer
     {
       public:
@@ -40,6 +62,46 @@ namespace utils
             this->offset_ += length;
         }
 
+        void skip(const size_t length)
+        {
+            if (length > this->get_remaining_size())
+            {
+                throw std::runtime_error("Out of bounds read from byte buffer");
+            }
+
+            this->offset_ += length;
+        }
+
+        std::string_view read_view(const size_t length)
+        {
+            if (length > this->get_remaining_size())
+            {
+                throw std::runtime_error("Out of bounds read from byte buffer");
+            }
+
+            const auto* data = reinterpret_cast<const char*>(this->buffer_.data() + this->offset_);
+            this->offset_ += length;
+
+            return {data, length};
+        }
+
+        // Only byte-aligned element types, the view isn't aligned for anything wider
+        template <typename T = std::byte>
+        std::span<const T> read_span(const size_t count)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && alignof(T) == 1, "Type must be trivially copyable and byte aligned");
+
+            if (count > this->get_remaining_size() / sizeof(T))
+            {
+                throw std::runtime_error("Out of bounds read from byte buffer");
+            }
+
+            const auto* data = reinterpret_cast<const T*>(this->buffer_.data() + this->offset_);
+            this->offset_ += count * sizeof(T);
+
+            return {data, count};
+        }
+
         std::string read_data(const size_t length)
         {
             std::string result{};
@@ -60,6 +122,25 @@ namespace utils
             return object;
         }
 
+        // LEB128 encoded unsigned integer
+        uint64_t read_varint()
+        {
+            uint64_t result = 0;
+
+            for (uint32_t shift = 0; shift < 64; shift += 7)
+            {
+                const auto byte = this->read<uint8_t>();
+                result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+                if ((byte & 0x80) == 0)
+                {
+                    return result;
+                }
+            }
+
+            throw std::runtime_error("Overlong varint in byte buffer");
+        }
+
         template <typename T>
         std::vector<T> read_vector()
         {
@@ -96,6 +177,21 @@ namespace utils
             return result;
         }
 
+        // Counterpart of read_string
+        std::string_view read_string_view()
+        {
+            const auto size = this->read<uint32_t>();
+            return this->read_view(size);
+        }
+
+        // Counterpart of read_vector
+        template <typename T>
+        std::span<const T> read_vector_span()
+        {
+            const auto size = this->read<uint32_t>();
+            return this->read_span<T>(size);
+        }
+
         size_t get_remaining_size() const
         {
             return this->buffer_.size() - offset_;
@@ -106,6 +202,11 @@ namespace utils
             return this->read_data(this->get_remaining_size());
         }
 
+        std::string_view get_remaining_view()
+        {
+            return this->read_view(this->get_remaining_size());
+        }
+
         size_t get_offset() const
         {
             return this->offset_;
@@ -116,14 +217,78 @@ namespace utils
         std::basic_string_view<std::byte> buffer_{};
     };
 
+    // Writes into one of three kinds of storage:
+    //  - its own string (default)
+    //  - a caller-provided string, e.g. a member or thread_local reused across messages; reset() keeps its capacity
+    //  - a fixed buffer such as a stack array, which throws instead of growing
+    // Only the string modes have get_buffer()/move_buffer(), get_view() works for all of them.
     class buffer_serializer
     {
       public:
         buffer_serializer() = default;
 
+        // Clears the storage but keeps its allocation
+        explicit buffer_serializer(std::string& storage)
+            : storage_(&storage)
+        {
+            storage.clear();
+        }
+
+        buffer_serializer(void* data, const size_t capacity)
+            : storage_(nullptr),
+              fixed_data_(static_cast<char*>(data)),
+              fixed_capacity_(capacity)
+        {
+        }
+
+        template <size_t N>
+        explicit buffer_serializer(std::array<char, N>& data)
+            : buffer_serializer(data.data(), N)
+        {
+        }
+
+        buffer_serializer(const buffer_serializer&) = delete;
+        buffer_serializer& operator=(const buffer_serializer&) = delete;
+
+        buffer_serializer(buffer_serializer&& obj) noexcept
+        {
+            this->operator=(std::move(obj));
+        }
+
+        buffer_serializer& operator=(buffer_serializer&& obj) noexcept
+        {
+            if (this != &obj)
+            {
+                this->buffer_ = std::move(obj.buffer_);
+                this->storage_ = obj.storage_ == &obj.buffer_ ? &this->buffer_ : obj.storage_;
+                this->fixed_data_ = obj.fixed_data_;
+                this->fixed_capacity_ = obj.fixed_capacity_;
+                this->fixed_size_ = obj.fixed_size_;
+
+                obj.storage_ = &obj.buffer_;
+                obj.fixed_data_ = nullptr;
+                obj.fixed_capacity_ = 0;
+                obj.fixed_size_ = 0;
+            }
+
+            return *this;
+        }
+
         void write(const void* buffer, const size_t length)
         {
-            this->buffer_.append(static_cast<const char*>(buffer), length);
+            if (this->storage_)
+            {
+                this->storage_->append(static_cast<const char*>(buffer), length);
+                return;
+            }
+
+            if (length > this->fixed_capacity_ - this->fixed_size_)
+            {
+                throw std::runtime_error("Byte buffer overflow");
+            }
+
+            memcpy(this->fixed_data_ + this->fixed_size_, buffer, length);
+            this->fixed_size_ += length;
         }
 
         void write(const char* text)
@@ -147,9 +312,15 @@ namespace utils
             this->write_string(str, strlen(str));
         }
 
+        void write_varint(const uint64_t value)
+        {
+            uint8_t data[MAX_VARINT_SIZE];
+            this->write(data, static_cast<size_t>(store_varint(data, value) - data));
+        }
+
         void write(const buffer_serializer& object)
         {
-            const auto& buffer = object.get_buffer();
+            const auto buffer = object.get_view();
             this->write(buffer.data(), buffer.size());
         }
 
@@ -175,17 +346,91 @@ namespace utils
             this->write(vec);
         }
 
+        // Overwrites bytes that were already written, e.g. a length prefix
+        void write_at(const size_t offset, const void* data, const size_t length)
+        {
+            if (offset + length > this->size())
+            {
+                throw std::runtime_error("Out of bounds write to byte buffer");
+            }
+
+            memcpy(this->data() + offset, data, length);
+        }
+
+        template <typename T>
+        void write_at(const size_t offset, const T& object)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Type must be trivially copyable");
+            this->write_at(offset, &object, sizeof(object));
+        }
+
+        // Fixed buffers can't grow, asking for more than they hold fails early
+        void reserve(const size_t length)
+        {
+            if (this->storage_)
+            {
+                this->storage_->reserve(length);
+            }
+            else if (length > this->fixed_capacity_)
+            {
+                throw std::runtime_error("Byte buffer overflow");
+            }
+        }
+
+        // Starts a new message in the same storage without releasing it
+        void reset()
+        {
+            if (this->storage_)
+            {
+                this->storage_->clear();
+            }
+            else
+            {
+                this->fixed_size_ = 0;
+            }
+        }
+
+        size_t size() const
+        {
+            return this->storage_ ? this->storage_->size() : this->fixed_size_;
+        }
+
+        std::string_view get_view() const
+        {
+            return this->storage_ ? std::string_view(*this->storage_) : std::string_view(this->fixed_data_, this->fixed_size_);
+        }
+
         const std::string& get_buffer() const
         {
-            return this->buffer_;
+            return *this->get_storage();
         }
 
         std::string move_buffer()
         {
-            return std::move(this->buffer_);
+            return std::move(*this->get_storage());
         }
 
       private:
         std::string buffer_{};
+        std::string* storage_{&this->buffer_};
+
+        char* fixed_data_{};
+        size_t fixed_capacity_{};
+        size_t fixed_size_{};
+
+        char* data()
+        {
+            return this->storage_ ? this->storage_->data() : this->fixed_data_;
+        }
+
+        std::string* get_storage() const
+        {
+            if (!this->storage_)
+            {
+                throw std::runtime_error("Fixed byte buffer has no string storage");
+            }
+
+            return this->storage_;
+        }
     };
 }
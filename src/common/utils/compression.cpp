@@ -1,9 +1,18 @@
 #include "compression.hpp"
+#include "thread.hpp"
 
 #include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
-
-#include "io.hpp"
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace utils::compression
 {
@@ -11,97 +20,933 @@ namespace utils::compression
     {
         namespace
         {
-            class zlib_stream
+            constexpr size_t MIN_OUTPUT_SIZE = 256;
+
+            // zlib counts in uInt, larger inputs are fed in slices
+            constexpr size_t MAX_STEP_SIZE = std::numeric_limits<uInt>::max();
+
+            // Dictionary streams are small, a small hash table keeps the per-message reset cheap
+            constexpr int DICTIONARY_MEM_LEVEL = 4;
+
+            // Trainer parameters: k-gram length used to score content and length of the picked segments
+            constexpr size_t TRAINING_GRAM_SIZE = 6;
+            constexpr size_t TRAINING_SEGMENT_SIZE = 48;
+
+            uint64_t read_gram(const char* data)
             {
-              public:
-                zlib_stream()
+                uint64_t gram = 0;
+                memcpy(&gram, data, TRAINING_GRAM_SIZE);
+                return gram;
+            }
+
+            compressor& get_thread_compressor()
+            {
+                thread_local compressor instance{};
+                return instance;
+            }
+
+            decompressor& get_thread_decompressor()
+            {
+                thread_local decompressor instance{};
+                return instance;
+            }
+
+            constexpr char BLOCK_MAGIC[] = {'W', '3', 'M', 'Z'};
+            constexpr size_t BLOCK_HEADER_SIZE = sizeof(BLOCK_MAGIC) + sizeof(uint32_t);
+            constexpr size_t BLOCK_FRAME_SIZE = 2 * sizeof(uint32_t);
+
+            struct block_frame
+            {
+                size_t raw_size{};
+                std::string_view data{};
+                size_t output_offset{};
+            };
+
+            void append_u32(std::string& output, const uint32_t value)
+            {
+                for (size_t i = 0; i < sizeof(value); ++i)
+                {
+                    output.push_back(static_cast<char>(value >> (i * 8)));
+                }
+            }
+
+            uint32_t read_u32(const char* data)
+            {
+                uint32_t value = 0;
+                for (size_t i = 0; i < sizeof(value); ++i)
+                {
+                    value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (i * 8);
+                }
+
+                return value;
+            }
+
+            bool read_block_header(const std::string_view data, size_t& block_size)
+            {
+                if (!is_block_container(data))
+                {
+                    return false;
+                }
+
+                block_size = read_u32(data.data() + sizeof(BLOCK_MAGIC));
+                return block_size != 0;
+            }
+
+            // Advances offset past the frame, nothing on truncated data or impossible sizes
+            std::optional<block_frame> read_block_frame(const std::string_view data, size_t& offset, const size_t block_size)
+            {
+                if (data.size() - offset < BLOCK_FRAME_SIZE)
+                {
+                    return {};
+                }
+
+                block_frame frame{};
+                frame.raw_size = read_u32(data.data() + offset);
+                const size_t stored_size = read_u32(data.data() + offset + sizeof(uint32_t));
+                offset += BLOCK_FRAME_SIZE;
+
+                // Blocks are only compressed if that makes them smaller
+                if (frame.raw_size > block_size || stored_size > frame.raw_size || data.size() - offset < stored_size)
+                {
+                    return {};
+                }
+
+                frame.data = data.substr(offset, stored_size);
+                offset += stored_size;
+
+                return frame;
+            }
+
+            // Inflates straight into the block's place in the output
+            bool decode_block(const block_frame& frame, const std::span<char> output)
+            {
+                if (frame.data.size() == frame.raw_size)
+                {
+                    memcpy(output.data(), frame.data.data(), frame.raw_size);
+                    return true;
+                }
+
+                return get_thread_decompressor().decompress(output, frame.data);
+            }
+
+            // One batch of run_jobs. Helpers that only start once the caller closed the batch leave it alone, so the
+            // caller never waits on helpers still queued behind other work.
+            struct job_batch
+            {
+                std::function<bool(size_t)> job{};
+                size_t count{};
+
+                std::atomic_size_t next_job{0};
+                std::atomic_bool failed{false};
+
+                std::mutex mutex{};
+                std::condition_variable finished{};
+                size_t active_helpers{0};
+                bool closed{false};
+
+                void work()
                 {
-                    memset(&stream_, 0, sizeof(stream_));
-                    valid_ = inflateInit(&stream_) == Z_OK;
+                    for (auto index = this->next_job++; index < this->count && !this->failed; index = this->next_job++)
+                    {
+                        if (!this->job(index))
+                        {
+                            this->failed = true;
+                        }
+                    }
                 }
 
-                zlib_stream(zlib_stream&&) = delete;
-                zlib_stream(const zlib_stream&) = delete;
-                zlib_stream& operator=(zlib_stream&&) = delete;
-                zlib_stream& operator=(const zlib_stream&) = delete;
+                void help()
+                {
+                    {
+                        std::lock_guard _{this->mutex};
+                        if (this->closed)
+                        {
+                            return;
+                        }
+
+                        ++this->active_helpers;
+                    }
 
-                ~zlib_stream()
+                    this->work();
+
+                    std::lock_guard _{this->mutex};
+                    if (--this->active_helpers == 0)
+                    {
+                        this->finished.notify_all();
+                    }
+                }
+
+                void close()
+                {
+                    std::unique_lock lock{this->mutex};
+                    this->closed = true;
+                    this->finished.wait(lock, [this] { return this->active_helpers == 0; });
+                }
+            };
+
+            // Workers shared by every block container call, one per core besides the caller's
+            class worker_pool
+            {
+              public:
+                explicit worker_pool(const size_t worker_count)
                 {
-                    if (valid_)
+                    this->workers_.reserve(worker_count);
+                    for (size_t i = 0; i < worker_count; ++i)
                     {
-                        inflateEnd(&stream_);
+                        this->workers_.emplace_back(utils::thread::create_named_jthread(
+                            "Compression Worker", [this](const std::stop_token& stop_token) { this->run(stop_token); }));
                     }
                 }
 
-                z_stream& get()
+                ~worker_pool()
                 {
-                    return stream_; //
+                    for (auto& worker : this->workers_)
+                    {
+                        worker.request_stop();
+                    }
+
+                    this->wake_.notify_all();
+                }
+
+                worker_pool(worker_pool&&) = delete;
+                worker_pool(const worker_pool&) = delete;
+                worker_pool& operator=(worker_pool&&) = delete;
+                worker_pool& operator=(const worker_pool&) = delete;
+
+                size_t get_worker_count() const
+                {
+                    return this->workers_.size();
                 }
 
-                bool is_valid() const
+                void submit(std::shared_ptr<job_batch> batch, const size_t helper_count)
                 {
-                    return valid_;
+                    {
+                        std::lock_guard _{this->mutex_};
+                        for (size_t i = 0; i < helper_count; ++i)
+                        {
+                            this->queue_.push_back(batch);
+                        }
+                    }
+
+                    this->wake_.notify_all();
                 }
 
               private:
-                bool valid_{false};
-                z_stream stream_{};
+                std::mutex mutex_{};
+                std::condition_variable_any wake_{};
+                std::deque<std::shared_ptr<job_batch>> queue_{};
+                std::vector<std::jthread> workers_{};
+
+                void run(const std::stop_token& stop_token)
+                {
+                    while (true)
+                    {
+                        std::shared_ptr<job_batch> batch{};
+
+                        {
+                            std::unique_lock lock{this->mutex_};
+                            if (!this->wake_.wait(lock, stop_token, [this] { return !this->queue_.empty(); }))
+                            {
+                                return;
+                            }
+
+                            batch = std::move(this->queue_.front());
+                            this->queue_.pop_front();
+                        }
+
+                        batch->help();
+                    }
+                }
             };
+
+            worker_pool& get_worker_pool()
+            {
+                // Never destroyed: joining threads from static destructors can deadlock when the client DLL unloads
+                static auto* pool = new worker_pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+                return *pool;
+            }
+
+            // Runs job(0) to job(count - 1) on up to thread_count threads including the caller, stops at the first failure
+            template <typename Job>
+            bool run_jobs(const size_t count, size_t thread_count, const Job& job)
+            {
+                if (count == 0)
+                {
+                    return true;
+                }
+
+                auto& pool = get_worker_pool();
+                if (thread_count == 0)
+                {
+                    thread_count = pool.get_worker_count() + 1;
+                }
+
+                const auto helper_count = std::min({thread_count, count, pool.get_worker_count() + 1}) - 1;
+
+                auto batch = std::make_shared<job_batch>();
+                batch->job = std::cref(job);
+                batch->count = count;
+
+                if (helper_count > 0)
+                {
+                    pool.submit(batch, helper_count);
+                }
+
+                batch->work();
+                batch->close();
+
+                return !batch->failed;
+            }
         }
 
-        std::string decompress(const std::string& data)
+        dictionary::dictionary(std::string data)
+            : data_(std::move(data))
         {
-            std::string buffer{};
-            zlib_stream stream_container{};
-            if (!stream_container.is_valid())
+            if (this->data_.empty() || this->data_.size() > MAX_SIZE)
             {
-                return {};
+                throw std::runtime_error("Invalid compression dictionary size");
+            }
+
+            this->id_ = static_cast<uint32_t>(
+                adler32(adler32(0, nullptr, 0), reinterpret_cast<const Bytef*>(this->data_.data()), static_cast<uInt>(this->data_.size())));
+        }
+
+        std::string train_dictionary(const std::vector<std::string>& samples, const size_t max_size)
+        {
+            constexpr auto none = std::numeric_limits<uint32_t>::max();
+
+            // k-grams get dense ids, a sample is scanned as the ids at each of its offsets
+            std::unordered_map<uint64_t, uint32_t> gram_ids{};
+            std::vector<std::vector<uint32_t>> sample_grams(samples.size());
+
+            // Score of a k-gram: number of samples containing it, zeroed once the dictionary covers it
+            std::vector<uint32_t> scores{};
+            std::vector<uint32_t> last_sample{};
+
+            for (uint32_t s = 0; s < samples.size(); ++s)
+            {
+                const auto& sample = samples[s];
+                auto& grams = sample_grams[s];
+
+                for (size_t i = 0; i + TRAINING_GRAM_SIZE <= sample.size(); ++i)
+                {
+                    const auto [entry, inserted] = gram_ids.try_emplace(read_gram(sample.data() + i), static_cast<uint32_t>(scores.size()));
+                    if (inserted)
+                    {
+                        scores.push_back(0);
+                        last_sample.push_back(none);
+                    }
+
+                    const auto id = entry->second;
+                    if (last_sample[id] != s)
+                    {
+                        last_sample[id] = s;
+                        ++scores[id];
+                    }
+
+                    grams.push_back(id);
+                }
+            }
+
+            std::vector<std::string_view> segments{};
+            size_t total_size = 0;
+
+            // Greedy: take the segment with the highest uncovered score, segments picked first end up last
+            while (total_size < max_size)
+            {
+                const auto segment_size = std::min(TRAINING_SEGMENT_SIZE, max_size - total_size);
+                if (segment_size < TRAINING_GRAM_SIZE)
+                {
+                    break;
+                }
+
+                const auto gram_count = segment_size - TRAINING_GRAM_SIZE + 1;
+
+                uint64_t best_score = 0;
+                size_t best_sample = 0;
+                size_t best_offset = 0;
+
+                for (size_t s = 0; s < samples.size(); ++s)
+                {
+                    const auto& grams = sample_grams[s];
+                    if (grams.size() < gram_count)
+                    {
+                        continue;
+                    }
+
+                    uint64_t score = 0;
+                    for (size_t i = 0; i < grams.size(); ++i)
+                    {
+                        score += scores[grams[i]];
+
+                        if (i >= gram_count)
+                        {
+                            score -= scores[grams[i - gram_count]];
+                        }
+
+                        if (i + 1 >= gram_count && score > best_score)
+                        {
+                            best_score = score;
+                            best_sample = s;
+                            best_offset = i + 1 - gram_count;
+                        }
+                    }
+                }
+
+                // Scores of 1 only occur in a single sample, nothing worth sharing is left
+                if (best_score <= gram_count)
+                {
+                    break;
+                }
+
+                const auto& grams = sample_grams[best_sample];
+                for (size_t i = 0; i < gram_count; ++i)
+                {
+                    scores[grams[best_offset + i]] = 0;
+                }
+
+                segments.push_back(std::string_view(samples[best_sample]).substr(best_offset, segment_size));
+                total_size += segment_size;
+            }
+
+            std::string result{};
+            result.reserve(total_size);
+
+            for (auto segment = segments.rbegin(); segment != segments.rend(); ++segment)
+            {
+                result.append(*segment);
+            }
+
+            return result;
+        }
+
+        struct compressor::state
+        {
+            z_stream stream{};
+            bool valid{false};
+            int level{Z_DEFAULT_COMPRESSION};
+
+            // Dictionary mode: a stream with the dictionary already hashed in, copied for every message
+            const zlib::dictionary* dictionary{};
+            z_stream primed{};
+            bool primed_valid{false};
+
+            state()
+            {
+                this->valid = deflateInit(&this->stream, this->level) == Z_OK;
+            }
+
+            explicit state(const zlib::dictionary& dictionary)
+                : dictionary(&dictionary)
+            {
+                this->valid = deflateInit2(&this->stream, this->level, Z_DEFLATED, -dictionary::WINDOW_BITS, DICTIONARY_MEM_LEVEL,
+                                           Z_DEFAULT_STRATEGY) == Z_OK;
+                this->primed_valid = deflateInit2(&this->primed, this->level, Z_DEFLATED, -dictionary::WINDOW_BITS,
+                                                  DICTIONARY_MEM_LEVEL, Z_DEFAULT_STRATEGY) == Z_OK &&
+                                     this->set_dictionary(this->primed);
+            }
+
+            ~state()
+            {
+                if (this->valid)
+                {
+                    deflateEnd(&this->stream);
+                }
+
+                if (this->primed_valid)
+                {
+                    deflateEnd(&this->primed);
+                }
+            }
+
+            bool set_dictionary(z_stream& target) const
+            {
+                const auto data = this->dictionary->get_data();
+                return deflateSetDictionary(&target, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())) == Z_OK;
+            }
+
+            // Nothing has been fed since the reset, so switching levels doesn't flush anything
+            bool reset(z_stream& target, const int new_level)
+            {
+                if (deflateReset(&target) != Z_OK)
+                {
+                    return false;
+                }
+
+                if (this->level != new_level && deflateParams(&target, new_level, Z_DEFAULT_STRATEGY) != Z_OK)
+                {
+                    return false;
+                }
+
+                this->level = new_level;
+                return true;
+            }
+
+            bool prepare(const int new_level)
+            {
+                if (!this->dictionary)
+                {
+                    return this->valid && this->reset(this->stream, new_level);
+                }
+
+                if (!this->primed_valid)
+                {
+                    return false;
+                }
+
+                if (this->level != new_level && (!this->reset(this->primed, new_level) || !this->set_dictionary(this->primed)))
+                {
+                    return false;
+                }
+
+                // Hashing a few KiB of dictionary costs far more than copying the primed state
+                if (this->valid)
+                {
+                    deflateEnd(&this->stream);
+                }
+
+                this->valid = deflateCopy(&this->stream, &this->primed) == Z_OK;
+                return this->valid;
             }
 
+            state(state&&) = delete;
+            state(const state&) = delete;
+            state& operator=(state&&) = delete;
+            state& operator=(const state&) = delete;
+        };
+
+        compressor::compressor()
+            : state_(std::make_unique<state>())
+        {
+        }
+
+        compressor::compressor(const dictionary& dictionary)
+            : state_(std::make_unique<state>(dictionary))
+        {
+        }
+
+        compressor::~compressor() = default;
+        compressor::compressor(compressor&&) noexcept = default;
+        compressor& compressor::operator=(compressor&&) noexcept = default;
+
+        bool compressor::compress(std::string& output, const std::string_view data, const int level)
+        {
+            output.clear();
+
+            if (!this->state_ || !this->state_->prepare(level))
+            {
+                return false;
+            }
+
+            auto& stream = this->state_->stream;
+
+            // One pass into a buffer of the worst case size, unless the input is too large for zlib's counters
+            const auto bound = data.size() <= MAX_STEP_SIZE ? deflateBound(&stream, static_cast<uLong>(data.size())) : MAX_STEP_SIZE;
+            output.resize(std::max<size_t>(bound, MIN_OUTPUT_SIZE));
+
+            size_t input_offset = 0;
+            size_t output_offset = 0;
             int ret{};
-            size_t offset = 0;
-            static thread_local uint8_t dest[CHUNK] = {0};
-            auto& stream = stream_container.get();
 
             do
             {
-                const auto input_size = std::min(sizeof(dest), data.size() - offset);
-                stream.avail_in = static_cast<uInt>(input_size);
-                stream.next_in = reinterpret_cast<const Bytef*>(data.data()) + offset;
-                offset += stream.avail_in;
+                const auto input_step = std::min(data.size() - input_offset, MAX_STEP_SIZE);
+                stream.next_in = reinterpret_cast<const Bytef*>(data.data() + input_offset);
+                stream.avail_in = static_cast<uInt>(input_step);
+
+                const auto flush = input_offset + input_step == data.size() ? Z_FINISH : Z_NO_FLUSH;
 
                 do
                 {
-                    stream.avail_out = sizeof(dest);
-                    stream.next_out = dest;
+                    if (output_offset == output.size())
+                    {
+                        output.resize(output.size() * 2);
+                    }
+
+                    const auto output_step = std::min(output.size() - output_offset, MAX_STEP_SIZE);
+                    stream.next_out = reinterpret_cast<Bytef*>(output.data() + output_offset);
+                    stream.avail_out = static_cast<uInt>(output_step);
+
+                    ret = deflate(&stream, flush);
+                    if (ret == Z_STREAM_ERROR)
+                    {
+                        output.clear();
+                        return false;
+                    }
+
+                    output_offset += output_step - stream.avail_out;
+                } while (stream.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+
+                input_offset += input_step;
+            } while (input_offset < data.size());
+
+            output.resize(output_offset);
+            return true;
+        }
+
+        struct decompressor::state
+        {
+            z_stream stream{};
+            bool valid{false};
+            const zlib::dictionary* dictionary{};
+
+            state()
+            {
+                this->valid = inflateInit(&this->stream) == Z_OK;
+            }
+
+            explicit state(const zlib::dictionary& dictionary)
+                : dictionary(&dictionary)
+            {
+                this->valid = inflateInit2(&this->stream, -dictionary::WINDOW_BITS) == Z_OK;
+            }
+
+            bool reset()
+            {
+                if (!this->valid || inflateReset(&this->stream) != Z_OK)
+                {
+                    return false;
+                }
+
+                // Raw streams take the dictionary up front instead of asking for it with Z_NEED_DICT
+                if (!this->dictionary)
+                {
+                    return true;
+                }
+
+                const auto data = this->dictionary->get_data();
+                return inflateSetDictionary(&this->stream, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())) ==
+                       Z_OK;
+            }
 
-                    ret = inflate(&stream, Z_NO_FLUSH);
-                    if (ret != Z_OK && ret != Z_STREAM_END)
+            ~state()
+            {
+                if (this->valid)
+                {
+                    inflateEnd(&this->stream);
+                }
+            }
+
+            state(state&&) = delete;
+            state(const state&) = delete;
+            state& operator=(state&&) = delete;
+            state& operator=(const state&) = delete;
+        };
+
+        decompressor::decompressor()
+            : state_(std::make_unique<state>())
+        {
+        }
+
+        decompressor::decompressor(const dictionary& dictionary)
+            : state_(std::make_unique<state>(dictionary))
+        {
+        }
+
+        decompressor::~decompressor() = default;
+        decompressor::decompressor(decompressor&&) noexcept = default;
+        decompressor& decompressor::operator=(decompressor&&) noexcept = default;
+
+        bool decompressor::decompress(std::string& output, const std::string_view data, const size_t size_hint, const size_t max_size)
+        {
+            output.clear();
+
+            if (!this->state_ || !this->state_->reset())
+            {
+                return false;
+            }
+
+            auto& stream = this->state_->stream;
+
+            // Inflate straight into the output, growing it geometrically when the hint was too small
+            auto capacity = size_hint ? size_hint : std::max(data.size() * 4, MIN_OUTPUT_SIZE);
+            output.resize(std::min(capacity, max_size));
+
+            size_t input_offset = 0;
+            size_t output_offset = 0;
+
+            while (true)
+            {
+                if (stream.avail_in == 0 && input_offset < data.size())
+                {
+                    const auto input_step = std::min(data.size() - input_offset, MAX_STEP_SIZE);
+                    stream.next_in = reinterpret_cast<const Bytef*>(data.data() + input_offset);
+                    stream.avail_in = static_cast<uInt>(input_step);
+                    input_offset += input_step;
+                }
+
+                if (output_offset == output.size())
+                {
+                    if (output.size() >= max_size)
                     {
-                        return {};
+                        // Full, but the stream might end exactly here
+                        unsigned char probe{};
+                        stream.next_out = &probe;
+                        stream.avail_out = 1;
+
+                        if (inflate(&stream, Z_NO_FLUSH) == Z_STREAM_END && stream.avail_out == 1)
+                        {
+                            break;
+                        }
+
+                        output.clear();
+                        return false;
                     }
 
-                    buffer.insert(buffer.end(), dest, dest + sizeof(dest) - stream.avail_out);
-                } while (stream.avail_out == 0);
-            } while (ret != Z_STREAM_END);
+                    output.resize(std::min(output.size() * 2, max_size));
+                }
+
+                const auto output_step = std::min(output.size() - output_offset, MAX_STEP_SIZE);
+                stream.next_out = reinterpret_cast<Bytef*>(output.data() + output_offset);
+                stream.avail_out = static_cast<uInt>(output_step);
+
+                const auto ret = inflate(&stream, Z_NO_FLUSH);
+                output_offset += output_step - stream.avail_out;
+
+                if (ret == Z_STREAM_END)
+                {
+                    break;
+                }
+
+                // Z_BUF_ERROR with input left means the output was full, without input the data is truncated
+                if (ret != Z_OK && !(ret == Z_BUF_ERROR && stream.avail_out == 0))
+                {
+                    output.clear();
+                    return false;
+                }
+            }
+
+            output.resize(output_offset);
+            return true;
+        }
+
+        bool decompressor::decompress(const std::span<char> output, const std::string_view data)
+        {
+            if (!this->state_ || !this->state_->reset())
+            {
+                return false;
+            }
+
+            auto& stream = this->state_->stream;
+
+            size_t input_offset = 0;
+            size_t output_offset = 0;
 
-            return buffer;
+            while (true)
+            {
+                if (stream.avail_in == 0 && input_offset < data.size())
+                {
+                    const auto input_step = std::min(data.size() - input_offset, MAX_STEP_SIZE);
+                    stream.next_in = reinterpret_cast<const Bytef*>(data.data() + input_offset);
+                    stream.avail_in = static_cast<uInt>(input_step);
+                    input_offset += input_step;
+                }
+
+                if (output_offset == output.size())
+                {
+                    // Full, the stream has to end exactly here
+                    unsigned char probe{};
+                    stream.next_out = &probe;
+                    stream.avail_out = 1;
+
+                    return inflate(&stream, Z_NO_FLUSH) == Z_STREAM_END && stream.avail_out == 1;
+                }
+
+                const auto output_step = std::min(output.size() - output_offset, MAX_STEP_SIZE);
+                stream.next_out = reinterpret_cast<Bytef*>(output.data() + output_offset);
+                stream.avail_out = static_cast<uInt>(output_step);
+
+                const auto ret = inflate(&stream, Z_NO_FLUSH);
+                output_offset += output_step - stream.avail_out;
+
+                if (ret == Z_STREAM_END)
+                {
+                    return output_offset == output.size();
+                }
+
+                if (ret != Z_OK && !(ret == Z_BUF_ERROR && stream.avail_out == 0))
+                {
+                    return false;
+                }
+            }
+        }
+
+        std::string compress(const std::string_view data, const int level)
+        {
+            std::string result{};
+            (void)get_thread_compressor().compress(result, data, level);
+            return result;
         }
 
-        std::string compress(const std::string& data)
+        std::string decompress(const std::string_view data, const size_t size_hint, const size_t max_size)
         {
             std::string result{};
-            auto length = compressBound(static_cast<uLong>(data.size()));
-            result.resize(length);
+            (void)get_thread_decompressor().decompress(result, data, size_hint, max_size);
+            return result;
+        }
 
-            if (compress2(reinterpret_cast<Bytef*>(result.data()), &length, reinterpret_cast<const Bytef*>(data.data()),
-                          static_cast<uLong>(data.size()), Z_BEST_COMPRESSION) != Z_OK)
+        bool compress_into(std::string& output, const std::string_view data, const int level)
+        {
+            return get_thread_compressor().compress(output, data, level);
+        }
+
+        bool decompress_into(std::string& output, const std::string_view data, const size_t size_hint, const size_t max_size)
+        {
+            return get_thread_decompressor().decompress(output, data, size_hint, max_size);
+        }
+
+        bool is_block_container(const std::string_view data)
+        {
+            return data.size() >= BLOCK_HEADER_SIZE && memcmp(data.data(), BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) == 0;
+        }
+
+        std::string compress_blocks(const std::string_view data, const int level, const size_t block_size, const size_t thread_count)
+        {
+            if (block_size == 0 || block_size > std::numeric_limits<uint32_t>::max())
+            {
+                return {};
+            }
+
+            const auto block_count = (data.size() + block_size - 1) / block_size;
+            std::vector<std::string> blocks(block_count);
+
+            const auto success = run_jobs(block_count, thread_count, [&](const size_t index) {
+                const auto raw_block = data.substr(index * block_size, block_size);
+                auto& block = blocks[index];
+
+                if (!compress_into(block, raw_block, level))
+                {
+                    return false;
+                }
+
+                if (block.size() >= raw_block.size())
+                {
+                    block.assign(raw_block);
+                }
+
+                return true;
+            });
+
+            if (!success)
             {
                 return {};
             }
 
-            result.resize(length);
+            size_t total_size = BLOCK_HEADER_SIZE + (block_count + 1) * BLOCK_FRAME_SIZE;
+            for (const auto& block : blocks)
+            {
+                total_size += block.size();
+            }
+
+            std::string result{};
+            result.reserve(total_size);
+            result.append(BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+            append_u32(result, static_cast<uint32_t>(block_size));
+
+            for (size_t i = 0; i < block_count; ++i)
+            {
+                append_u32(result, static_cast<uint32_t>(std::min(block_size, data.size() - i * block_size)));
+                append_u32(result, static_cast<uint32_t>(blocks[i].size()));
+                result.append(blocks[i]);
+            }
+
+            append_u32(result, 0);
+            append_u32(result, 0);
+
             return result;
         }
+
+        bool decompress_blocks(std::string& output, const std::string_view data, const size_t max_size, const size_t thread_count)
+        {
+            output.clear();
+
+            size_t block_size{};
+            if (!read_block_header(data, block_size))
+            {
+                return false;
+            }
+
+            // Index the blocks first, their sizes give every block its place in the output
+            std::vector<block_frame> frames{};
+            size_t offset = BLOCK_HEADER_SIZE;
+            size_t total_size = 0;
+
+            while (true)
+            {
+                auto frame = read_block_frame(data, offset, block_size);
+                if (!frame || frame->raw_size > max_size - total_size)
+                {
+                    return false;
+                }
+
+                if (frame->raw_size == 0)
+                {
+                    break;
+                }
+
+                frame->output_offset = total_size;
+                total_size += frame->raw_size;
+                frames.emplace_back(*frame);
+            }
+
+            if (offset != data.size())
+            {
+                return false;
+            }
+
+            output.resize(total_size);
+
+            const auto success = run_jobs(frames.size(), thread_count, [&](const size_t index) {
+                const auto& frame = frames[index];
+                return decode_block(frame, std::span(output.data() + frame.output_offset, frame.raw_size));
+            });
+
+            if (!success)
+            {
+                output.clear();
+                return false;
+            }
+
+            return true;
+        }
+
+        block_reader::block_reader(const std::string_view data)
+            : data_(data),
+              offset_(BLOCK_HEADER_SIZE)
+        {
+            // A block size of 0 marks the reader as failed
+            if (!read_block_header(this->data_, this->block_size_))
+            {
+                this->block_size_ = 0;
+            }
+        }
+
+        bool block_reader::read_next(std::string& output)
+        {
+            output.clear();
+
+            if (this->block_size_ == 0)
+            {
+                return false;
+            }
+
+            const auto frame = read_block_frame(this->data_, this->offset_, this->block_size_);
+            if (!frame || frame->raw_size == 0)
+            {
+                this->complete_ = frame && this->offset_ == this->data_.size();
+                this->block_size_ = 0;
+                return false;
+            }
+
+            output.resize(frame->raw_size);
+            if (!decode_block(*frame, output))
+            {
+                output.clear();
+                this->block_size_ = 0;
+                return false;
+            }
+
+            return true;
+        }
     }
 }
@@ -1,14 +1,155 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
-
-#define CHUNK 16384u
+#include <string_view>
+#include <vector>
 
 namespace utils::compression
 {
     namespace zlib
     {
-        std::string compress(const std::string& data);
-        std::string decompress(const std::string& data);
+        // zlib levels, 1 is fastest, 9 smallest
+        constexpr int fastest_level = 1;
+        constexpr int default_level = 6;
+        constexpr int best_level = 9;
+
+        // Preset dictionary for messages too small to compress on their own, e.g. single datagrams.
+        // Both ends need the same bytes. Content that occurs most often belongs at the end, it is closest to the data.
+        // Dictionary streams are raw deflate with a small window and carry no header or checksum.
+        class dictionary
+        {
+          public:
+            static constexpr int WINDOW_BITS = 12;
+            static constexpr size_t MAX_SIZE = (size_t{1} << WINDOW_BITS) - 262;
+
+            explicit dictionary(std::string data);
+
+            std::string_view get_data() const
+            {
+                return this->data_;
+            }
+
+            // adler32, identifies the dictionary e.g. in logs
+            uint32_t get_id() const
+            {
+                return this->id_;
+            }
+
+          private:
+            std::string data_{};
+            uint32_t id_{};
+        };
+
+        // Offline trainer: picks the byte segments that recur in the most samples, e.g. captured datagrams
+        std::string train_dictionary(const std::vector<std::string>& samples, size_t max_size = dictionary::MAX_SIZE);
+
+        // Deflate state kept across calls instead of being set up and torn down for every message.
+        // Not thread safe: own one per connection or worker, or use the free functions below, which use one per thread.
+        class compressor
+        {
+          public:
+            compressor();
+
+            // The dictionary has to outlive the compressor
+            explicit compressor(const dictionary& dictionary);
+            ~compressor();
+
+            compressor(compressor&&) noexcept;
+            compressor& operator=(compressor&&) noexcept;
+
+            compressor(const compressor&) = delete;
+            compressor& operator=(const compressor&) = delete;
+
+            // Replaces the content of output, keeping its capacity. Returns false on failure.
+            bool compress(std::string& output, std::string_view data, int level = best_level);
+
+          private:
+            struct state;
+            std::unique_ptr<state> state_{};
+        };
+
+        class decompressor
+        {
+          public:
+            decompressor();
+            explicit decompressor(const dictionary& dictionary);
+            ~decompressor();
+
+            decompressor(decompressor&&) noexcept;
+            decompressor& operator=(decompressor&&) noexcept;
+
+            decompressor(const decompressor&) = delete;
+            decompressor& operator=(const decompressor&) = delete;
+
+            // Replaces the content of output, keeping its capacity. size_hint is the expected decompressed size, if known.
+            // Fails on corrupt or truncated data and on output larger than max_size.
+            bool decompress(std::string& output, std::string_view data, size_t size_hint = 0, size_t max_size = SIZE_MAX);
+
+            // Inflates into caller memory of the exact decompressed size. Fails unless the data fills it exactly.
+            bool decompress(std::span<char> output, std::string_view data);
+
+          private:
+            struct state;
+            std::unique_ptr<state> state_{};
+        };
+
+        // Thread-local contexts, empty strings on failure
+        std::string compress(std::string_view data, int level = best_level);
+        std::string decompress(std::string_view data, size_t size_hint = 0, size_t max_size = SIZE_MAX);
+
+        bool compress_into(std::string& output, std::string_view data, int level = best_level);
+        bool decompress_into(std::string& output, std::string_view data, size_t size_hint = 0, size_t max_size = SIZE_MAX);
+
+        // ===========================================================================
+        // BLOCK CONTAINER
+        // ===========================================================================
+        // Multi-megabyte blobs like session snapshots are split into independent
+        // zlib blocks, which are compressed and decompressed on the calling thread
+        // and a worker pool shared by all calls. Blocks inflate straight into
+        // their place in the output, and the output does not depend on the thread
+        // count. block_reader walks the blocks one at a time instead, without
+        // holding the whole raw blob.
+        //
+        // Layout: "W3MZ", block size, then per block its raw size, stored size and
+        // data. A stored size equal to the raw size marks a block kept as is, a
+        // raw size of 0 ends the container. All sizes are u32.
+        // ===========================================================================
+
+        constexpr size_t default_block_size = 1024 * 1024;
+
+        bool is_block_container(std::string_view data);
+
+        // thread_count caps the threads used including the caller, 0 uses every core. Empty string on failure.
+        std::string compress_blocks(std::string_view data, int level = default_level, size_t block_size = default_block_size,
+                                    size_t thread_count = 0);
+
+        // Replaces the content of output. Fails on corrupt or truncated data and on output larger than max_size.
+        bool decompress_blocks(std::string& output, std::string_view data, size_t max_size = SIZE_MAX, size_t thread_count = 0);
+
+        class block_reader
+        {
+          public:
+            // The container has to outlive the reader
+            explicit block_reader(std::string_view data);
+
+            // Replaces the content of output with the next block. Returns false at the end or on corrupt data.
+            bool read_next(std::string& output);
+
+            // Whether the end of the container was reached, as opposed to read_next failing
+            bool is_complete() const
+            {
+                return this->complete_;
+            }
+
+          private:
+            std::string_view data_{};
+            size_t offset_{};
+            size_t block_size_{};
+            bool complete_{};
+        };
     }
 };
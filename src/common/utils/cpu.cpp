@@ -0,0 +1,82 @@
+#include "cpu.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_X86 1
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace utils::cpu
+{
+    namespace
+    {
+#ifdef CPU_X86
+        std::array<uint32_t, 4> read_cpuid(const uint32_t leaf)
+        {
+            std::array<uint32_t, 4> registers{};
+
+#ifdef _MSC_VER
+            int values[4]{};
+            __cpuidex(values, static_cast<int>(leaf), 0);
+            std::memcpy(registers.data(), values, sizeof(values));
+#else
+            __cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+
+            return registers;
+        }
+
+        uint64_t read_xcr0()
+        {
+#ifdef _MSC_VER
+            return _xgetbv(0);
+#else
+            uint32_t low{};
+            uint32_t high{};
+            __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+            return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+        }
+#endif
+
+        features detect_features()
+        {
+            features result{};
+
+#ifdef CPU_X86
+            const auto max_leaf = read_cpuid(0)[0];
+            if (max_leaf < 1)
+            {
+                return result;
+            }
+
+            const auto leaf_1 = read_cpuid(1);
+            result.sse2 = (leaf_1[3] & (1u << 26)) != 0;
+            result.sse42 = (leaf_1[2] & (1u << 20)) != 0;
+
+            // AVX and OSXSAVE, and the OS has to preserve the YMM registers
+            const auto has_avx = (leaf_1[2] & (1u << 27)) != 0 && (leaf_1[2] & (1u << 28)) != 0 && (read_xcr0() & 6) == 6;
+            if (has_avx && max_leaf >= 7)
+            {
+                result.avx2 = (read_cpuid(7)[1] & (1u << 5)) != 0;
+            }
+#endif
+
+            return result;
+        }
+    }
+
+    const features& get_features()
+    {
+        static const auto result = detect_features();
+        return result;
+    }
+}
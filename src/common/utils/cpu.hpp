@@ -0,0 +1,14 @@
+#pragma once
+
+namespace utils::cpu
+{
+    // Instruction sets the CPU and OS support, detected once. All false on other architectures.
+    struct features
+    {
+        bool sse2{};
+        bool sse42{};
+        bool avx2{};
+    };
+
+    const features& get_features();
+}
@@ -2,7 +2,9 @@
 
 #include <random>
 #include <memory>
+#include <mutex>
 #include <cstring>
+#include <fstream>
 
 #include "nt.hpp"
 #include "string.hpp"
@@ -109,8 +111,10 @@ namespace utils::cryptography
                 this->descriptor_.add_entropy(static_cast<const uint8_t*>(data), ul(length), this->state_.get());
             }
 
+            // libtomcrypt is built without LTC_PTHREAD, so concurrent reads are serialized here
             void read(void* data, const size_t length) const
             {
+                std::lock_guard _{this->mutex_};
                 this->descriptor_.read(static_cast<unsigned char*>(data), ul(length), this->get_state());
             }
 
@@ -118,6 +122,7 @@ namespace utils::cryptography
             int id_;
             std::unique_ptr<prng_state> state_;
             const ltc_prng_descriptor& descriptor_;
+            mutable std::mutex mutex_{};
 
             void auto_seed() const
             {
@@ -141,6 +146,47 @@ namespace utils::cryptography
         };
 
         const prng prng_(fortuna_desc);
+
+        int get_hex_value(const char c)
+        {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+
+            return -1;
+        }
+
+        // Large reads keep the syscall count low, the buffer is reused per thread
+        constexpr size_t FILE_CHUNK_SIZE = 1024 * 1024;
+
+        template <typename Hasher>
+        std::optional<typename Hasher::digest> hash_file(const std::filesystem::path& file)
+        {
+            std::ifstream stream(file, std::ios::binary);
+            if (!stream)
+            {
+                return std::nullopt;
+            }
+
+            thread_local std::unique_ptr<char[]> buffer = std::make_unique<char[]>(FILE_CHUNK_SIZE);
+
+            Hasher hasher{};
+            while (stream)
+            {
+                stream.read(buffer.get(), FILE_CHUNK_SIZE);
+                hasher.update(buffer.get(), static_cast<size_t>(stream.gcount()));
+            }
+
+            if (!stream.eof())
+            {
+                return std::nullopt;
+            }
+
+            return hasher.finalize();
+        }
     }
 
     ecc::key::key()
@@ -224,7 +270,7 @@ namespace utils::cryptography
         }
     }
 
-    void ecc::key::deserialize(const std::string& key)
+    void ecc::key::deserialize(const std::string_view key)
     {
         this->free();
 
@@ -336,7 +382,7 @@ namespace utils::cryptography
         return std::string(cs(buffer), length);
     }
 
-    bool ecc::verify_message(const key& key, const std::string& message, const std::string& signature)
+    bool ecc::verify_message(const key& key, const std::string& message, const std::string_view signature)
     {
         if (!key.is_valid())
             return false;
@@ -522,6 +568,41 @@ namespace utils::cryptography
         return dec_data;
     }
 
+    bool matches_hex(const std::span<const uint8_t> digest, const std::string_view hex)
+    {
+        if (hex.size() != digest.size() * 2)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < digest.size(); ++i)
+        {
+            const auto high = get_hex_value(hex[i * 2]);
+            const auto low = get_hex_value(hex[i * 2 + 1]);
+
+            if (high < 0 || low < 0 || ((high << 4) | low) != digest[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string to_hex(const std::span<const uint8_t> digest)
+    {
+        constexpr char digits[] = "0123456789ABCDEF";
+
+        std::string result(digest.size() * 2, '\0');
+        for (size_t i = 0; i < digest.size(); ++i)
+        {
+            result[i * 2] = digits[digest[i] >> 4];
+            result[i * 2 + 1] = digits[digest[i] & 0xF];
+        }
+
+        return result;
+    }
+
     std::string hmac_sha1::compute(const std::string& data, const std::string& key)
     {
         std::string buffer;
@@ -545,18 +626,19 @@ namespace utils::cryptography
 
     std::string sha1::compute(const uint8_t* data, const size_t length, const bool hex)
     {
-        uint8_t buffer[20] = {0};
+        hasher instance{};
+        instance.update(data, length);
 
-        hash_state state;
-        sha1_init(&state);
-        sha1_process(&state, data, ul(length));
-        sha1_done(&state, buffer);
+        const auto digest = instance.finalize();
+        if (hex)
+            return to_hex(digest);
 
-        std::string hash(cs(buffer), sizeof(buffer));
-        if (!hex)
-            return hash;
+        return std::string(cs(digest.data()), digest.size());
+    }
 
-        return string::dump_hex(hash, "");
+    std::optional<sha1::digest> sha1::compute_file(const std::filesystem::path& file)
+    {
+        return hash_file<hasher>(file);
     }
 
     std::string sha256::compute(const std::string& data, const bool hex)
@@ -566,18 +648,19 @@ namespace utils::cryptography
 
     std::string sha256::compute(const uint8_t* data, const size_t length, const bool hex)
     {
-        uint8_t buffer[32] = {0};
+        hasher instance{};
+        instance.update(data, length);
 
-        hash_state state;
-        sha256_init(&state);
-        sha256_process(&state, data, ul(length));
-        sha256_done(&state, buffer);
+        const auto digest = instance.finalize();
+        if (hex)
+            return to_hex(digest);
 
-        std::string hash(cs(buffer), sizeof(buffer));
-        if (!hex)
-            return hash;
+        return std::string(cs(digest.data()), digest.size());
+    }
 
-        return string::dump_hex(hash, "");
+    std::optional<sha256::digest> sha256::compute_file(const std::filesystem::path& file)
+    {
+        return hash_file<hasher>(file);
     }
 
     std::string sha512::compute(const std::string& data, const bool hex)
@@ -587,18 +670,19 @@ namespace utils::cryptography
 
     std::string sha512::compute(const uint8_t* data, const size_t length, const bool hex)
     {
-        uint8_t buffer[64] = {0};
+        hasher instance{};
+        instance.update(data, length);
 
-        hash_state state;
-        sha512_init(&state);
-        sha512_process(&state, data, ul(length));
-        sha512_done(&state, buffer);
+        const auto digest = instance.finalize();
+        if (hex)
+            return to_hex(digest);
 
-        std::string hash(cs(buffer), sizeof(buffer));
-        if (!hex)
-            return hash;
+        return std::string(cs(digest.data()), digest.size());
+    }
 
-        return string::dump_hex(hash, "");
+    std::optional<sha512::digest> sha512::compute_file(const std::filesystem::path& file)
+    {
+        return hash_file<hasher>(file);
     }
 
     std::string base64::encode(const uint8_t* data, const size_t len)
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <tomcrypt.h>
 
@@ -28,7 +34,7 @@ namespace utils::cryptography
 
             void set(const std::string& pub_key_buffer);
 
-            void deserialize(const std::string& key);
+            void deserialize(std::string_view key);
 
             std::string serialize(int type = PK_PRIVATE) const;
 
@@ -48,7 +54,7 @@ namespace utils::cryptography
         key generate_key(int bits);
         key generate_key(int bits, const std::string& entropy);
         std::string sign_message(const key& key, const std::string& message);
-        bool verify_message(const key& key, const std::string& message, const std::string& signature);
+        bool verify_message(const key& key, const std::string& message, std::string_view signature);
 
         bool encrypt(const key& key, std::string& data);
         bool decrypt(const key& key, std::string& data);
@@ -77,6 +83,64 @@ namespace utils::cryptography
         std::string decrypt(const std::string& data, const std::string& iv, const std::string& key);
     }
 
+    // Incremental hashing for data that arrives in pieces, e.g. download callbacks or a file read in slices.
+    // Digests are raw bytes, only convert them to text if it is needed.
+    template <size_t DigestSize, int (*Init)(hash_state*), int (*Process)(hash_state*, const unsigned char*, unsigned long),
+              int (*Done)(hash_state*, unsigned char*)>
+    class basic_hasher
+    {
+      public:
+        static constexpr size_t DIGEST_SIZE = DigestSize;
+        using digest = std::array<uint8_t, DigestSize>;
+
+        basic_hasher()
+        {
+            this->reset();
+        }
+
+        void reset()
+        {
+            Init(&this->state_);
+        }
+
+        void update(const void* data, size_t length)
+        {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+
+            // unsigned long is 32 bits on Windows
+            while (length > 0)
+            {
+                const auto step = std::min<size_t>(length, UINT32_MAX);
+                Process(&this->state_, bytes, static_cast<unsigned long>(step));
+
+                bytes += step;
+                length -= step;
+            }
+        }
+
+        void update(const std::string_view data)
+        {
+            this->update(data.data(), data.size());
+        }
+
+        // Also resets the hasher for the next message
+        digest finalize()
+        {
+            digest result{};
+            Done(&this->state_, result.data());
+            this->reset();
+
+            return result;
+        }
+
+      private:
+        hash_state state_{};
+    };
+
+    // Case insensitive, without allocating
+    bool matches_hex(std::span<const uint8_t> digest, std::string_view hex);
+    std::string to_hex(std::span<const uint8_t> digest);
+
     namespace hmac_sha1
     {
         std::string compute(const std::string& data, const std::string& key);
@@ -84,20 +148,38 @@ namespace utils::cryptography
 
     namespace sha1
     {
+        using hasher = basic_hasher<20, sha1_init, sha1_process, sha1_done>;
+        using digest = hasher::digest;
+
         std::string compute(const std::string& data, bool hex = false);
         std::string compute(const uint8_t* data, size_t length, bool hex = false);
+
+        // Streams the file through the hasher, nothing if it can't be read
+        std::optional<digest> compute_file(const std::filesystem::path& file);
     }
 
     namespace sha256
     {
+        using hasher = basic_hasher<32, sha256_init, sha256_process, sha256_done>;
+        using digest = hasher::digest;
+
         std::string compute(const std::string& data, bool hex = false);
         std::string compute(const uint8_t* data, size_t length, bool hex = false);
+
+        // Streams the file through the hasher, nothing if it can't be read
+        std::optional<digest> compute_file(const std::filesystem::path& file);
     }
 
     namespace sha512
     {
+        using hasher = basic_hasher<64, sha512_init, sha512_process, sha512_done>;
+        using digest = hasher::digest;
+
         std::string compute(const std::string& data, bool hex = false);
         std::string compute(const uint8_t* data, size_t length, bool hex = false);
+
+        // Streams the file through the hasher, nothing if it can't be read
+        std::optional<digest> compute_file(const std::filesystem::path& file);
     }
 
     namespace base64
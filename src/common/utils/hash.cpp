@@ -0,0 +1,310 @@
+#include "hash.hpp"
+#include "cpu.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HASH_X86 1
+
+#include <immintrin.h>
+
+// MSVC compiles intrinsics of any instruction set, GCC and Clang only inside functions targeting it
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_INSTRUCTIONS(instructions)
+#else
+#define TARGET_INSTRUCTIONS(instructions) __attribute__((target(instructions)))
+#endif
+#endif
+
+namespace utils::hash
+{
+    namespace
+    {
+        // Pseudo-random input shared with the upstream XXH3 sanity checks
+        constexpr auto make_test_input()
+        {
+            std::array<char, 2048> input{};
+            uint64_t generator = detail::PRIME32_1;
+
+            for (auto& c : input)
+            {
+                c = static_cast<char>(static_cast<uint8_t>(generator >> 56));
+                generator *= detail::PRIME64_1;
+            }
+
+            return input;
+        }
+
+        constexpr auto test_input = make_test_input();
+
+        constexpr bool matches(const size_t length, const uint64_t expected)
+        {
+            return compute(std::string_view(test_input.data(), length)) == expected;
+        }
+
+        // Reference values from XXH3_64bits, at least one per length class
+        static_assert(matches(0, 0x2D06800538D394C2));
+        static_assert(matches(1, 0xC44BDFF4074EECDB));
+        static_assert(matches(3, 0x3F968B83E9A87DC3));
+        static_assert(matches(4, 0xCEB277F560083438));
+        static_assert(matches(8, 0x92731F68D8A8A634));
+        static_assert(matches(9, 0x56D6BD7878198283));
+        static_assert(matches(16, 0x027B4CB04C597E4B));
+        static_assert(matches(17, 0x0E1175449B89E26F));
+        static_assert(matches(48, 0x7DEC70F0C65E9E15));
+        static_assert(matches(80, 0x343EA68F9ABB0DA5));
+        static_assert(matches(112, 0xDA9C79C5E82B6452));
+        static_assert(matches(128, 0xE774EFC8B7526505));
+        static_assert(matches(129, 0xFD683CD797A1F6F8));
+        static_assert(matches(195, 0x64586F630891D72F));
+        static_assert(matches(240, 0xC0D6647A0E620F7E));
+        static_assert(matches(241, 0x281410FD53152172));
+        static_assert(matches(403, 0x8F23B428730C6887));
+        static_assert(matches(1024, 0x95C63C696323768E));
+        static_assert(matches(1025, 0x890C433F563CA294));
+        static_assert(matches(2048, 0x8C9A8E3F25D392D6));
+        static_assert(compute("witcher") == 0xD47820AA60BEB71D);
+
+        using detail::accumulators;
+
+        // Same structure as detail::hash_long_scalar, Stripes provides the stripe and scramble steps
+        template <typename Stripes>
+        uint64_t hash_long_loop(const char* input, const size_t length)
+        {
+            using namespace detail;
+
+            constexpr size_t stripes_per_block = (SECRET.size() - STRIPE_LENGTH) / SECRET_CONSUME_RATE;
+            constexpr size_t block_length = STRIPE_LENGTH * stripes_per_block;
+
+            const auto* secret = SECRET.data();
+            const auto* scramble_secret = secret + SECRET.size() - STRIPE_LENGTH;
+
+            alignas(32) auto acc = initial_accumulators();
+            const size_t block_count = (length - 1) / block_length;
+
+            for (size_t block = 0; block < block_count; ++block)
+            {
+                const auto* block_input = input + block * block_length;
+                for (size_t stripe = 0; stripe < stripes_per_block; ++stripe)
+                {
+                    Stripes::accumulate(acc, block_input + stripe * STRIPE_LENGTH, secret + stripe * SECRET_CONSUME_RATE);
+                }
+
+                Stripes::scramble(acc, scramble_secret);
+            }
+
+            const auto* tail = input + block_count * block_length;
+            const size_t last_stripes = ((length - 1) - block_length * block_count) / STRIPE_LENGTH;
+
+            for (size_t stripe = 0; stripe < last_stripes; ++stripe)
+            {
+                Stripes::accumulate(acc, tail + stripe * STRIPE_LENGTH, secret + stripe * SECRET_CONSUME_RATE);
+            }
+
+            Stripes::accumulate(acc, input + length - STRIPE_LENGTH, scramble_secret - 7);
+
+            return merge_accumulators(acc, length);
+        }
+
+        struct generic_stripes
+        {
+            static void accumulate(accumulators& acc, const char* input, const uint8_t* secret)
+            {
+                detail::accumulate_stripe(acc, input, static_cast<size_t>(secret - detail::SECRET.data()));
+            }
+
+            static void scramble(accumulators& acc, const uint8_t*)
+            {
+                detail::scramble(acc);
+            }
+        };
+
+        uint64_t hash_long_generic(const char* input, const size_t length)
+        {
+            return hash_long_loop<generic_stripes>(input, length);
+        }
+
+#ifdef HASH_X86
+        struct sse2_stripes
+        {
+            TARGET_INSTRUCTIONS("sse2")
+            static void accumulate(accumulators& acc, const char* input, const uint8_t* secret)
+            {
+                auto* acc_vec = reinterpret_cast<__m128i*>(acc.data());
+
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    const auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+                    const auto key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+                    const auto data_key = _mm_xor_si128(data, key);
+                    const auto data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+                    const auto product = _mm_mul_epu32(data_key, data_key_hi);
+                    const auto data_swap = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+                    const auto value = _mm_load_si128(acc_vec + i);
+                    _mm_store_si128(acc_vec + i, _mm_add_epi64(value, _mm_add_epi64(product, data_swap)));
+                }
+            }
+
+            TARGET_INSTRUCTIONS("sse2")
+            static void scramble(accumulators& acc, const uint8_t* secret)
+            {
+                auto* acc_vec = reinterpret_cast<__m128i*>(acc.data());
+                const auto prime = _mm_set1_epi32(static_cast<int>(detail::PRIME32_1));
+
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    auto value = _mm_load_si128(acc_vec + i);
+                    value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+                    const auto key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+                    const auto data_key = _mm_xor_si128(value, key);
+                    const auto data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+
+                    const auto product_lo = _mm_mul_epu32(data_key, prime);
+                    const auto product_hi = _mm_mul_epu32(data_key_hi, prime);
+                    _mm_store_si128(acc_vec + i, _mm_add_epi64(product_lo, _mm_slli_epi64(product_hi, 32)));
+                }
+            }
+        };
+
+        struct avx2_stripes
+        {
+            TARGET_INSTRUCTIONS("avx2")
+            static void accumulate(accumulators& acc, const char* input, const uint8_t* secret)
+            {
+                auto* acc_vec = reinterpret_cast<__m256i*>(acc.data());
+
+                for (size_t i = 0; i < 2; ++i)
+                {
+                    const auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input) + i);
+                    const auto key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i);
+                    const auto data_key = _mm256_xor_si256(data, key);
+                    const auto data_key_hi = _mm256_srli_epi64(data_key, 32);
+                    const auto product = _mm256_mul_epu32(data_key, data_key_hi);
+                    const auto data_swap = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+                    const auto value = _mm256_load_si256(acc_vec + i);
+                    _mm256_store_si256(acc_vec + i, _mm256_add_epi64(value, _mm256_add_epi64(product, data_swap)));
+                }
+            }
+
+            TARGET_INSTRUCTIONS("avx2")
+            static void scramble(accumulators& acc, const uint8_t* secret)
+            {
+                auto* acc_vec = reinterpret_cast<__m256i*>(acc.data());
+                const auto prime = _mm256_set1_epi32(static_cast<int>(detail::PRIME32_1));
+
+                for (size_t i = 0; i < 2; ++i)
+                {
+                    auto value = _mm256_load_si256(acc_vec + i);
+                    value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+                    const auto key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i);
+                    const auto data_key = _mm256_xor_si256(value, key);
+                    const auto data_key_hi = _mm256_srli_epi64(data_key, 32);
+
+                    const auto product_lo = _mm256_mul_epu32(data_key, prime);
+                    const auto product_hi = _mm256_mul_epu32(data_key_hi, prime);
+                    _mm256_store_si256(acc_vec + i, _mm256_add_epi64(product_lo, _mm256_slli_epi64(product_hi, 32)));
+                }
+            }
+        };
+
+        // The loop is instantiated inside a function targeting the instructions, so the stripe steps get inlined
+        TARGET_INSTRUCTIONS("sse2")
+        uint64_t hash_long_sse2(const char* input, const size_t length)
+        {
+            return hash_long_loop<sse2_stripes>(input, length);
+        }
+
+        TARGET_INSTRUCTIONS("avx2")
+        uint64_t hash_long_avx2(const char* input, const size_t length)
+        {
+            return hash_long_loop<avx2_stripes>(input, length);
+        }
+#endif
+
+        using hash_long_function = uint64_t (*)(const char* input, size_t length);
+
+        hash_long_function get_hash_long(const instruction_set instructions)
+        {
+            if (!is_supported(instructions))
+            {
+                throw std::runtime_error("Instruction set not supported: " + std::string(get_name(instructions)));
+            }
+
+            switch (instructions)
+            {
+#ifdef HASH_X86
+            case instruction_set::avx2:
+                return hash_long_avx2;
+            case instruction_set::sse2:
+                return hash_long_sse2;
+#endif
+            default:
+                return hash_long_generic;
+            }
+        }
+    }
+
+    uint64_t detail::hash_long(const char* input, const size_t length)
+    {
+        static const auto best = get_hash_long(get_best_instruction_set());
+        return best(input, length);
+    }
+
+    bool is_supported(const instruction_set instructions)
+    {
+        switch (instructions)
+        {
+        case instruction_set::generic:
+            return true;
+#ifdef HASH_X86
+        case instruction_set::sse2:
+            return cpu::get_features().sse2;
+        case instruction_set::avx2:
+            return cpu::get_features().avx2;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    instruction_set get_best_instruction_set()
+    {
+        for (const auto instructions : {instruction_set::avx2, instruction_set::sse2})
+        {
+            if (is_supported(instructions))
+            {
+                return instructions;
+            }
+        }
+
+        return instruction_set::generic;
+    }
+
+    std::string_view get_name(const instruction_set instructions)
+    {
+        switch (instructions)
+        {
+        case instruction_set::sse2:
+            return "sse2";
+        case instruction_set::avx2:
+            return "avx2";
+        default:
+            return "generic";
+        }
+    }
+
+    uint64_t compute(const std::string_view data, const instruction_set instructions)
+    {
+        const auto hash_long = get_hash_long(instructions);
+
+        if (data.size() <= detail::MIDSIZE_MAX)
+        {
+            return compute(data);
+        }
+
+        return hash_long(data.data(), data.size());
+    }
+}
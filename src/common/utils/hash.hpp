@@ -0,0 +1,388 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#ifdef _M_X64
+#include <intrin.h>
+#endif
+
+namespace utils::hash
+{
+    // XXH3-64 with seed 0 and the default secret.
+    // Non-cryptographic, but the value only depends on the input bytes: unlike std::hash it is identical across
+    // compilers, standard libraries and platforms, so it can be sent over the wire or compared between peers.
+    // Usable in constant expressions; inputs over 240 bytes take the best block loop the CPU supports at runtime.
+
+    namespace detail
+    {
+        constexpr uint32_t PRIME32_1 = 0x9E3779B1U;
+        constexpr uint32_t PRIME32_2 = 0x85EBCA77U;
+        constexpr uint32_t PRIME32_3 = 0xC2B2AE3DU;
+
+        constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+        constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+        constexpr uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+        constexpr uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+        constexpr size_t STRIPE_LENGTH = 64;
+        constexpr size_t SECRET_CONSUME_RATE = 8;
+        constexpr size_t ACCUMULATOR_COUNT = STRIPE_LENGTH / sizeof(uint64_t);
+        constexpr size_t MIDSIZE_MAX = 240;
+
+        alignas(64) constexpr std::array<uint8_t, 192> SECRET = {
+            0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+            0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+            0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+            0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+            0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+            0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+            0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+            0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+            0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+            0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+            0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+            0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+        };
+
+        // Byte is char for caller input and uint8_t for the secret; both are read little-endian
+        template <typename Byte, typename T>
+        constexpr T read_le(const Byte* data)
+        {
+            if (!std::is_constant_evaluated() && std::endian::native == std::endian::little)
+            {
+                T value;
+                std::memcpy(&value, data, sizeof(value));
+                return value;
+            }
+
+            T value{};
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                value |= static_cast<T>(static_cast<uint8_t>(data[i])) << (i * 8);
+            }
+
+            return value;
+        }
+
+        template <typename Byte>
+        constexpr uint32_t read32(const Byte* data)
+        {
+            return read_le<Byte, uint32_t>(data);
+        }
+
+        template <typename Byte>
+        constexpr uint64_t read64(const Byte* data)
+        {
+            return read_le<Byte, uint64_t>(data);
+        }
+
+        constexpr uint64_t secret64(const size_t offset)
+        {
+            return read64(SECRET.data() + offset);
+        }
+
+        constexpr uint64_t byteswap64(const uint64_t value)
+        {
+            uint64_t result = 0;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                result |= ((value >> (i * 8)) & 0xFF) << ((7 - i) * 8);
+            }
+
+            return result;
+        }
+
+        // Low and high halves of the 128-bit product, xored
+        constexpr uint64_t mul128_fold64(const uint64_t lhs, const uint64_t rhs)
+        {
+#ifdef __SIZEOF_INT128__
+            const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+            return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+#ifdef _M_X64
+            if (!std::is_constant_evaluated())
+            {
+                uint64_t upper{};
+                const auto lower = _umul128(lhs, rhs, &upper);
+                return lower ^ upper;
+            }
+#endif
+
+            const uint64_t lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+            const uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+            const uint64_t lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+            const uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+
+            const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+            const uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+            const uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+
+            return lower ^ upper;
+#endif
+        }
+
+        constexpr uint64_t xxh64_avalanche(uint64_t hash)
+        {
+            hash ^= hash >> 33;
+            hash *= PRIME64_2;
+            hash ^= hash >> 29;
+            hash *= PRIME64_3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        constexpr uint64_t avalanche(uint64_t hash)
+        {
+            hash ^= hash >> 37;
+            hash *= PRIME_MX1;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        constexpr uint64_t rrmxmx(uint64_t hash, const uint64_t length)
+        {
+            hash ^= std::rotl(hash, 49) ^ std::rotl(hash, 24);
+            hash *= PRIME_MX2;
+            hash ^= (hash >> 35) + length;
+            hash *= PRIME_MX2;
+            hash ^= hash >> 28;
+            return hash;
+        }
+
+        template <typename Byte>
+        constexpr uint64_t mix16(const Byte* input, const size_t secret_offset)
+        {
+            return mul128_fold64(read64(input) ^ secret64(secret_offset), read64(input + 8) ^ secret64(secret_offset + 8));
+        }
+
+        template <typename Byte>
+        constexpr uint64_t hash_1to3(const Byte* input, const size_t length)
+        {
+            const auto c1 = static_cast<uint8_t>(input[0]);
+            const auto c2 = static_cast<uint8_t>(input[length >> 1]);
+            const auto c3 = static_cast<uint8_t>(input[length - 1]);
+
+            const uint32_t combined = (static_cast<uint32_t>(c1) << 16) | (static_cast<uint32_t>(c2) << 24) | c3 |
+                                      (static_cast<uint32_t>(length) << 8);
+            const uint64_t flip = read32(SECRET.data()) ^ read32(SECRET.data() + 4);
+
+            return xxh64_avalanche(combined ^ flip);
+        }
+
+        template <typename Byte>
+        constexpr uint64_t hash_4to8(const Byte* input, const size_t length)
+        {
+            const uint64_t input64 = read32(input + length - 4) + (static_cast<uint64_t>(read32(input)) << 32);
+            const uint64_t flip = secret64(8) ^ secret64(16);
+
+            return rrmxmx(input64 ^ flip, length);
+        }
+
+        template <typename Byte>
+        constexpr uint64_t hash_9to16(const Byte* input, const size_t length)
+        {
+            const uint64_t lo = read64(input) ^ (secret64(24) ^ secret64(32));
+            const uint64_t hi = read64(input + length - 8) ^ (secret64(40) ^ secret64(48));
+
+            return avalanche(length + byteswap64(lo) + hi + mul128_fold64(lo, hi));
+        }
+
+        template <typename Byte>
+        constexpr uint64_t hash_17to128(const Byte* input, const size_t length)
+        {
+            uint64_t acc = length * PRIME64_1;
+
+            if (length > 32)
+            {
+                if (length > 64)
+                {
+                    if (length > 96)
+                    {
+                        acc += mix16(input + 48, 96);
+                        acc += mix16(input + length - 64, 112);
+                    }
+
+                    acc += mix16(input + 32, 64);
+                    acc += mix16(input + length - 48, 80);
+                }
+
+                acc += mix16(input + 16, 32);
+                acc += mix16(input + length - 32, 48);
+            }
+
+            acc += mix16(input, 0);
+            acc += mix16(input + length - 16, 16);
+
+            return avalanche(acc);
+        }
+
+        template <typename Byte>
+        constexpr uint64_t hash_129to240(const Byte* input, const size_t length)
+        {
+            uint64_t acc = length * PRIME64_1;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                acc += mix16(input + 16 * i, 16 * i);
+            }
+
+            acc = avalanche(acc);
+
+            uint64_t acc_end = mix16(input + length - 16, 136 - 17);
+            for (size_t i = 8; i < length / 16; ++i)
+            {
+                acc_end += mix16(input + 16 * i, 16 * (i - 8) + 3);
+            }
+
+            return avalanche(acc + acc_end);
+        }
+
+        using accumulators = std::array<uint64_t, ACCUMULATOR_COUNT>;
+
+        template <typename Byte>
+        constexpr void accumulate_stripe(accumulators& acc, const Byte* input, const size_t secret_offset)
+        {
+            for (size_t i = 0; i < ACCUMULATOR_COUNT; ++i)
+            {
+                const auto data = read64(input + 8 * i);
+                const auto key = data ^ secret64(secret_offset + 8 * i);
+
+                acc[i ^ 1] += data;
+                acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+            }
+        }
+
+        constexpr void scramble(accumulators& acc)
+        {
+            for (size_t i = 0; i < ACCUMULATOR_COUNT; ++i)
+            {
+                acc[i] ^= acc[i] >> 47;
+                acc[i] ^= secret64(SECRET.size() - STRIPE_LENGTH + 8 * i);
+                acc[i] *= PRIME32_1;
+            }
+        }
+
+        constexpr accumulators initial_accumulators()
+        {
+            return {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+        }
+
+        constexpr uint64_t merge_accumulators(const accumulators& acc, const size_t length)
+        {
+            uint64_t result = length * PRIME64_1;
+            for (size_t i = 0; i < ACCUMULATOR_COUNT / 2; ++i)
+            {
+                result += mul128_fold64(acc[2 * i] ^ secret64(11 + 16 * i), acc[2 * i + 1] ^ secret64(11 + 16 * i + 8));
+            }
+
+            return avalanche(result);
+        }
+
+        // Reference loop, only used during constant evaluation
+        template <typename Byte>
+        constexpr uint64_t hash_long_scalar(const Byte* input, const size_t length)
+        {
+            constexpr size_t stripes_per_block = (SECRET.size() - STRIPE_LENGTH) / SECRET_CONSUME_RATE;
+            constexpr size_t block_length = STRIPE_LENGTH * stripes_per_block;
+
+            auto acc = initial_accumulators();
+            const size_t block_count = (length - 1) / block_length;
+
+            for (size_t block = 0; block < block_count; ++block)
+            {
+                for (size_t stripe = 0; stripe < stripes_per_block; ++stripe)
+                {
+                    accumulate_stripe(acc, input + block * block_length + stripe * STRIPE_LENGTH, stripe * SECRET_CONSUME_RATE);
+                }
+
+                scramble(acc);
+            }
+
+            const size_t last_stripes = ((length - 1) - block_length * block_count) / STRIPE_LENGTH;
+            for (size_t stripe = 0; stripe < last_stripes; ++stripe)
+            {
+                accumulate_stripe(acc, input + block_count * block_length + stripe * STRIPE_LENGTH, stripe * SECRET_CONSUME_RATE);
+            }
+
+            accumulate_stripe(acc, input + length - STRIPE_LENGTH, SECRET.size() - STRIPE_LENGTH - 7);
+
+            return merge_accumulators(acc, length);
+        }
+
+        uint64_t hash_long(const char* input, size_t length);
+    }
+
+    // Block loops for inputs over 240 bytes, all of them produce the same values
+    enum class instruction_set
+    {
+        generic,
+        sse2,
+        avx2,
+    };
+
+    bool is_supported(instruction_set instructions);
+
+    // Best one the CPU and OS support, the one compute() uses
+    instruction_set get_best_instruction_set();
+
+    std::string_view get_name(instruction_set instructions);
+
+    constexpr uint64_t compute(const std::string_view data)
+    {
+        const auto* input = data.data();
+        const auto length = data.size();
+
+        if (length == 0)
+        {
+            return detail::xxh64_avalanche(detail::secret64(56) ^ detail::secret64(64));
+        }
+
+        if (length <= 3)
+        {
+            return detail::hash_1to3(input, length);
+        }
+
+        if (length <= 8)
+        {
+            return detail::hash_4to8(input, length);
+        }
+
+        if (length <= 16)
+        {
+            return detail::hash_9to16(input, length);
+        }
+
+        if (length <= 128)
+        {
+            return detail::hash_17to128(input, length);
+        }
+
+        if (length <= detail::MIDSIZE_MAX)
+        {
+            return detail::hash_129to240(input, length);
+        }
+
+        if (std::is_constant_evaluated())
+        {
+            return detail::hash_long_scalar(input, length);
+        }
+
+        return detail::hash_long(input, length);
+    }
+
+    inline uint64_t compute(const void* data, const size_t length)
+    {
+        return compute(std::string_view(static_cast<const char*>(data), length));
+    }
+
+    // Forces the block loop, e.g. to compare them. Throws for unsupported instruction sets.
+    uint64_t compute(std::string_view data, instruction_set instructions);
+}
@@ -0,0 +1,134 @@
+#include "merkle_tree.hpp"
+#include "hash.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+namespace utils
+{
+    namespace
+    {
+        template <typename T>
+        void store_le(uint8_t* out, const T value)
+        {
+            for (size_t i = 0; i < sizeof(T); ++i)
+            {
+                out[i] = static_cast<uint8_t>(value >> (i * 8));
+            }
+        }
+
+        uint64_t hash_entry(const uint32_t key, const uint64_t value)
+        {
+            std::array<uint8_t, sizeof(key) + sizeof(value)> bytes{};
+            store_le(bytes.data(), key);
+            store_le(bytes.data() + sizeof(key), value);
+
+            return hash::compute(bytes.data(), bytes.size());
+        }
+
+        uint64_t hash_children(const uint64_t* children)
+        {
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                return hash::compute(children, merkle_tree::FANOUT * sizeof(uint64_t));
+            }
+            else
+            {
+                std::array<uint8_t, merkle_tree::FANOUT * sizeof(uint64_t)> bytes{};
+                for (size_t i = 0; i < merkle_tree::FANOUT; ++i)
+                {
+                    store_le(bytes.data() + i * sizeof(uint64_t), children[i]);
+                }
+
+                return hash::compute(bytes.data(), bytes.size());
+            }
+        }
+
+        size_t get_first_child(const size_t node)
+        {
+            return node * merkle_tree::FANOUT + 1;
+        }
+    }
+
+    merkle_tree::merkle_tree()
+    {
+        this->clear();
+    }
+
+    void merkle_tree::insert(const uint32_t key, const uint64_t value)
+    {
+        this->add_to_bucket(key, hash_entry(key, value));
+    }
+
+    void merkle_tree::erase(const uint32_t key, const uint64_t value)
+    {
+        this->add_to_bucket(key, 0 - hash_entry(key, value));
+    }
+
+    void merkle_tree::update(const uint32_t key, const uint64_t old_value, const uint64_t new_value)
+    {
+        if (old_value != new_value)
+        {
+            this->add_to_bucket(key, hash_entry(key, new_value) - hash_entry(key, old_value));
+        }
+    }
+
+    void merkle_tree::clear()
+    {
+        this->nodes_.fill(0);
+
+        for (size_t node = FIRST_BUCKET_NODE; node-- > 0;)
+        {
+            this->rehash_node(node);
+        }
+    }
+
+    std::span<const uint64_t, merkle_tree::FANOUT> merkle_tree::get_children(const size_t node) const
+    {
+        if (node >= FIRST_BUCKET_NODE)
+        {
+            throw std::runtime_error("Merkle tree node has no children");
+        }
+
+        return std::span<const uint64_t, FANOUT>(this->nodes_.data() + get_first_child(node), FANOUT);
+    }
+
+    std::vector<size_t> merkle_tree::find_divergent_children(const size_t node,
+                                                             const std::span<const uint64_t, FANOUT> remote_children) const
+    {
+        const auto local_children = this->get_children(node);
+        const auto first_child = get_first_child(node);
+
+        std::vector<size_t> result{};
+        for (size_t i = 0; i < FANOUT; ++i)
+        {
+            if (local_children[i] != remote_children[i])
+            {
+                result.emplace_back(first_child + i);
+            }
+        }
+
+        return result;
+    }
+
+    void merkle_tree::add_to_bucket(const uint32_t key, const uint64_t delta)
+    {
+        const auto node = FIRST_BUCKET_NODE + get_bucket(key);
+        this->nodes_[node] += delta;
+        this->rehash_parents(node);
+    }
+
+    void merkle_tree::rehash_parents(size_t node)
+    {
+        while (node > 0)
+        {
+            node = (node - 1) / FANOUT;
+            this->rehash_node(node);
+        }
+    }
+
+    void merkle_tree::rehash_node(const size_t node)
+    {
+        this->nodes_[node] = hash_children(this->nodes_.data() + get_first_child(node));
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace utils
+{
+    // Incrementally maintained hash tree over a set of (key, value) entries, e.g. world facts.
+    // Keys are assigned to BUCKET_COUNT buckets by their top bits, so they should already be well distributed.
+    // A bucket digest is the wrapping sum of its entry digests, which makes adding, removing or changing an entry
+    // O(1) on the bucket plus rehashing the DEPTH nodes above it. The root is read without touching the entries.
+    //
+    // Digests only depend on the entry set, not on insertion order or platform. Peers compare roots, then
+    // exchange get_children() of differing nodes level by level; find_divergent_children() on the last level
+    // yields the buckets whose entries have to be resynced.
+    //
+    // Node ids: 0 is the root, the children of n are n * FANOUT + 1 to n * FANOUT + FANOUT, the buckets form the
+    // last level starting at FIRST_BUCKET_NODE.
+    class merkle_tree
+    {
+      public:
+        static constexpr size_t FANOUT = 16;
+        static constexpr size_t DEPTH = 2;
+        static constexpr size_t BUCKET_COUNT = FANOUT * FANOUT;
+        static constexpr size_t FIRST_BUCKET_NODE = 1 + FANOUT;
+        static constexpr size_t NODE_COUNT = FIRST_BUCKET_NODE + BUCKET_COUNT;
+
+        merkle_tree();
+
+        void insert(uint32_t key, uint64_t value);
+        void erase(uint32_t key, uint64_t value);
+        void update(uint32_t key, uint64_t old_value, uint64_t new_value);
+        void clear();
+
+        uint64_t get_root() const
+        {
+            return this->nodes_[0];
+        }
+
+        // Throws for bucket nodes, they have no children
+        std::span<const uint64_t, FANOUT> get_children(size_t node) const;
+
+        // Child node ids of node whose digest differs from the peer's copy of get_children(node)
+        std::vector<size_t> find_divergent_children(size_t node, std::span<const uint64_t, FANOUT> remote_children) const;
+
+        static size_t get_bucket(const uint32_t key)
+        {
+            return key >> 24;
+        }
+
+        static bool is_bucket_node(const size_t node)
+        {
+            return node >= FIRST_BUCKET_NODE && node < NODE_COUNT;
+        }
+
+        static size_t get_bucket_of_node(const size_t node)
+        {
+            return node - FIRST_BUCKET_NODE;
+        }
+
+      private:
+        std::array<uint64_t, NODE_COUNT> nodes_{};
+
+        void add_to_bucket(uint32_t key, uint64_t delta);
+        void rehash_parents(size_t node);
+        void rehash_node(size_t node);
+    };
+
+    static_assert(merkle_tree::BUCKET_COUNT == 1u << 8, "get_bucket takes the top 8 key bits");
+}
@@ -0,0 +1,503 @@
+#include "pattern_scanner.hpp"
+#include "cpu.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PATTERN_SCANNER_X86 1
+
+#include <immintrin.h>
+
+// MSVC compiles intrinsics of any instruction set, GCC and Clang only inside functions targeting it
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_INSTRUCTIONS(instructions)
+#else
+#define TARGET_INSTRUCTIONS(instructions) __attribute__((target(instructions)))
+#endif
+#endif
+
+namespace utils::pattern_scanner
+{
+    namespace
+    {
+        constexpr size_t TILE_SIZE = 64 * 1024;
+        constexpr size_t HISTOGRAM_SAMPLES = 1024 * 1024;
+
+        using byte_histogram = std::array<size_t, 256>;
+        using match_lists = std::vector<std::vector<size_t>>;
+
+        struct fixed_byte
+        {
+            size_t offset{};
+            uint8_t value{};
+        };
+
+        struct compiled_pattern
+        {
+            size_t index{};
+            size_t length{};
+            fixed_byte anchor{};
+
+            // Fixed bytes besides the anchor, rarest first so mismatches show early
+            std::vector<fixed_byte> checks{};
+        };
+
+        struct anchor_group
+        {
+            uint8_t value{};
+            std::vector<compiled_pattern> patterns{};
+        };
+
+        // Every anchor byte of a batch, so one pass over the data finds the candidates of all groups
+        struct anchor_set
+        {
+            std::vector<anchor_group> groups{};
+            std::array<size_t, 256> group_indices{};
+
+            // Membership bitmap indexed by the low nibble, bit n of a row stands for high nibble n or n + 8
+            std::array<uint8_t, 16> low_rows{};
+            std::array<uint8_t, 16> high_rows{};
+        };
+
+        struct scan_range
+        {
+            const uint8_t* start{};
+            const uint8_t* end{};
+        };
+
+        using tile_scanner = void (*)(const scan_range& range, const anchor_set& anchors, const uint8_t* tile_start,
+                                      const uint8_t* tile_end, match_lists& matches);
+
+        byte_histogram sample_histogram(const std::span<const uint8_t> data)
+        {
+            byte_histogram histogram{};
+            const auto stride = std::max<size_t>(1, data.size() / HISTOGRAM_SAMPLES);
+
+            for (size_t i = 0; i < data.size(); i += stride)
+            {
+                ++histogram[data[i]];
+            }
+
+            return histogram;
+        }
+
+        compiled_pattern compile_pattern(const size_t index, const pattern& pattern, const byte_histogram& histogram)
+        {
+            std::vector<fixed_byte> fixed_bytes{};
+            for (size_t i = 0; i < pattern.size(); ++i)
+            {
+                if (!pattern.is_wildcard(i))
+                {
+                    fixed_bytes.push_back({i, pattern.get_byte(i)});
+                }
+            }
+
+            if (fixed_bytes.empty())
+            {
+                throw std::runtime_error("Pattern has no fixed bytes");
+            }
+
+            std::stable_sort(fixed_bytes.begin(), fixed_bytes.end(),
+                             [&](const fixed_byte& a, const fixed_byte& b) { return histogram[a.value] < histogram[b.value]; });
+
+            compiled_pattern result{};
+            result.index = index;
+            result.length = pattern.size();
+            result.anchor = fixed_bytes.front();
+            result.checks.assign(fixed_bytes.begin() + 1, fixed_bytes.end());
+
+            return result;
+        }
+
+        anchor_set group_patterns(const std::vector<pattern>& patterns, const byte_histogram& histogram)
+        {
+            anchor_set anchors{};
+            anchors.group_indices.fill(SIZE_MAX);
+
+            for (size_t i = 0; i < patterns.size(); ++i)
+            {
+                auto compiled = compile_pattern(i, patterns[i], histogram);
+                const auto value = compiled.anchor.value;
+                auto& group_index = anchors.group_indices[value];
+
+                if (group_index == SIZE_MAX)
+                {
+                    group_index = anchors.groups.size();
+                    anchors.groups.emplace_back().value = value;
+
+                    auto& rows = value < 0x80 ? anchors.low_rows : anchors.high_rows;
+                    rows[value & 0x0F] |= static_cast<uint8_t>(1 << ((value >> 4) & 7));
+                }
+
+                anchors.groups[group_index].patterns.emplace_back(std::move(compiled));
+            }
+
+            return anchors;
+        }
+
+        // Verifies every pattern of the group whose anchor byte sits at position
+        void verify_candidate(const scan_range& range, const uint8_t* position, const anchor_group& group, match_lists& matches)
+        {
+            for (const auto& pattern : group.patterns)
+            {
+                if (static_cast<size_t>(position - range.start) < pattern.anchor.offset)
+                {
+                    continue;
+                }
+
+                const auto* start = position - pattern.anchor.offset;
+                if (static_cast<size_t>(range.end - start) < pattern.length)
+                {
+                    continue;
+                }
+
+                const auto matches_pattern = std::all_of(pattern.checks.begin(), pattern.checks.end(),
+                                                         [&](const fixed_byte& check) { return start[check.offset] == check.value; });
+
+                if (matches_pattern)
+                {
+                    matches[pattern.index].push_back(static_cast<size_t>(start - range.start));
+                }
+            }
+        }
+
+        void verify_candidates(const scan_range& range, const anchor_set& anchors, const uint8_t* position, uint64_t mask,
+                               match_lists& matches)
+        {
+            while (mask)
+            {
+                const auto* candidate = position + std::countr_zero(mask);
+                verify_candidate(range, candidate, anchors.groups[anchors.group_indices[*candidate]], matches);
+                mask &= mask - 1;
+            }
+        }
+
+        void scan_tile_generic(const scan_range& range, const anchor_set& anchors, const uint8_t* tile_start, const uint8_t* tile_end,
+                               match_lists& matches)
+        {
+            // memchr beats the table for a single anchor byte
+            if (anchors.groups.size() == 1)
+            {
+                const auto& group = anchors.groups.front();
+                const auto* position = tile_start;
+
+                while (position < tile_end)
+                {
+                    position = static_cast<const uint8_t*>(std::memchr(position, group.value, static_cast<size_t>(tile_end - position)));
+                    if (!position)
+                    {
+                        break;
+                    }
+
+                    verify_candidate(range, position, group, matches);
+                    ++position;
+                }
+
+                return;
+            }
+
+            for (const auto* position = tile_start; position < tile_end; ++position)
+            {
+                const auto group_index = anchors.group_indices[*position];
+                if (group_index != SIZE_MAX)
+                {
+                    verify_candidate(range, position, anchors.groups[group_index], matches);
+                }
+            }
+        }
+
+#ifdef PATTERN_SCANNER_X86
+        // 0xFF for every byte that is an anchor: the row picked by its low nibble has the bit of its high nibble set
+        TARGET_INSTRUCTIONS("sse4.2")
+        __m128i find_anchors_sse42(const __m128i data, const __m128i low_rows, const __m128i high_rows, const __m128i bits)
+        {
+            const auto nibble_mask = _mm_set1_epi8(0x0F);
+            const auto low_nibbles = _mm_and_si128(data, nibble_mask);
+            const auto high_nibbles = _mm_and_si128(_mm_srli_epi16(data, 4), nibble_mask);
+
+            // The top bit of each byte selects the rows of high nibbles 8 to 15
+            const auto rows = _mm_blendv_epi8(_mm_shuffle_epi8(low_rows, low_nibbles), _mm_shuffle_epi8(high_rows, low_nibbles), data);
+            const auto bit = _mm_shuffle_epi8(bits, high_nibbles);
+
+            return _mm_cmpeq_epi8(_mm_and_si128(rows, bit), bit);
+        }
+
+        TARGET_INSTRUCTIONS("sse4.2")
+        void scan_tile_sse42(const scan_range& range, const anchor_set& anchors, const uint8_t* tile_start, const uint8_t* tile_end,
+                             match_lists& matches)
+        {
+            const auto low_rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(anchors.low_rows.data()));
+            const auto high_rows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(anchors.high_rows.data()));
+            const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+            const auto* position = tile_start;
+            for (; tile_end - position >= 32; position += 32)
+            {
+                const auto low = find_anchors_sse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(position)), low_rows, high_rows, bits);
+                const auto high =
+                    find_anchors_sse42(_mm_loadu_si128(reinterpret_cast<const __m128i*>(position + 16)), low_rows, high_rows, bits);
+
+                // Rare anchors mostly leave both halves empty, one test skips them
+                const auto any = _mm_or_si128(low, high);
+                if (_mm_testz_si128(any, any))
+                {
+                    continue;
+                }
+
+                const auto mask = static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(low))) |
+                                  (static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(high))) << 16);
+
+                verify_candidates(range, anchors, position, mask, matches);
+            }
+
+            scan_tile_generic(range, anchors, position, tile_end, matches);
+        }
+
+        TARGET_INSTRUCTIONS("avx2")
+        __m256i find_anchors_avx2(const __m256i data, const __m256i low_rows, const __m256i high_rows, const __m256i bits)
+        {
+            const auto nibble_mask = _mm256_set1_epi8(0x0F);
+            const auto low_nibbles = _mm256_and_si256(data, nibble_mask);
+            const auto high_nibbles = _mm256_and_si256(_mm256_srli_epi16(data, 4), nibble_mask);
+
+            const auto rows =
+                _mm256_blendv_epi8(_mm256_shuffle_epi8(low_rows, low_nibbles), _mm256_shuffle_epi8(high_rows, low_nibbles), data);
+            const auto bit = _mm256_shuffle_epi8(bits, high_nibbles);
+
+            return _mm256_cmpeq_epi8(_mm256_and_si256(rows, bit), bit);
+        }
+
+        TARGET_INSTRUCTIONS("avx2")
+        void scan_tile_avx2(const scan_range& range, const anchor_set& anchors, const uint8_t* tile_start, const uint8_t* tile_end,
+                            match_lists& matches)
+        {
+            // Shuffles look up within each 128 bit lane, both lanes get the same tables
+            const auto low_rows = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(anchors.low_rows.data())));
+            const auto high_rows =
+                _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(anchors.high_rows.data())));
+            const auto bits = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+
+            const auto* position = tile_start;
+            for (; tile_end - position >= 64; position += 64)
+            {
+                const auto low =
+                    find_anchors_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(position)), low_rows, high_rows, bits);
+                const auto high =
+                    find_anchors_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(position + 32)), low_rows, high_rows, bits);
+
+                const auto any = _mm256_or_si256(low, high);
+                if (_mm256_testz_si256(any, any))
+                {
+                    continue;
+                }
+
+                const auto mask = static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(low))) |
+                                  (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high))) << 32);
+
+                verify_candidates(range, anchors, position, mask, matches);
+            }
+
+            scan_tile_generic(range, anchors, position, tile_end, matches);
+        }
+#endif
+
+        tile_scanner get_tile_scanner(const instruction_set instructions)
+        {
+            if (!is_supported(instructions))
+            {
+                throw std::runtime_error("Instruction set not supported: " + std::string(get_name(instructions)));
+            }
+
+            switch (instructions)
+            {
+#ifdef PATTERN_SCANNER_X86
+            case instruction_set::avx2:
+                return scan_tile_avx2;
+            case instruction_set::sse42:
+                return scan_tile_sse42;
+#endif
+            default:
+                return scan_tile_generic;
+            }
+        }
+
+        uint8_t parse_nibble(const char value)
+        {
+            if (value >= '0' && value <= '9')
+            {
+                return static_cast<uint8_t>(value - '0');
+            }
+
+            if (value >= 'A' && value <= 'F')
+            {
+                return static_cast<uint8_t>(value - 'A' + 10);
+            }
+
+            if (value >= 'a' && value <= 'f')
+            {
+                return static_cast<uint8_t>(value - 'a' + 10);
+            }
+
+            throw std::runtime_error("Invalid pattern");
+        }
+    }
+
+    bool is_supported(const instruction_set instructions)
+    {
+        switch (instructions)
+        {
+        case instruction_set::generic:
+            return true;
+#ifdef PATTERN_SCANNER_X86
+        case instruction_set::sse42:
+            return cpu::get_features().sse42;
+        case instruction_set::avx2:
+            return cpu::get_features().avx2;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    instruction_set get_best_instruction_set()
+    {
+        for (const auto instructions : {instruction_set::avx2, instruction_set::sse42})
+        {
+            if (is_supported(instructions))
+            {
+                return instructions;
+            }
+        }
+
+        return instruction_set::generic;
+    }
+
+    std::string_view get_name(const instruction_set instructions)
+    {
+        switch (instructions)
+        {
+        case instruction_set::sse42:
+            return "sse4.2";
+        case instruction_set::avx2:
+            return "avx2";
+        default:
+            return "generic";
+        }
+    }
+
+    pattern::pattern(const std::string_view text)
+    {
+        uint8_t nibble = 0;
+        auto has_nibble = false;
+
+        for (const auto value : text)
+        {
+            if (value == ' ')
+            {
+                continue;
+            }
+
+            if (value == '?')
+            {
+                if (has_nibble)
+                {
+                    throw std::runtime_error("Invalid pattern");
+                }
+
+                this->mask_.push_back('?');
+                this->bytes_.push_back(0);
+                continue;
+            }
+
+            const auto current_nibble = parse_nibble(value);
+
+            if (!has_nibble)
+            {
+                has_nibble = true;
+                nibble = current_nibble;
+            }
+            else
+            {
+                has_nibble = false;
+
+                this->mask_.push_back('x');
+                this->bytes_.push_back(static_cast<uint8_t>((nibble << 4) | current_nibble));
+            }
+        }
+
+        if (has_nibble)
+        {
+            throw std::runtime_error("Invalid pattern");
+        }
+
+        while (!this->mask_.empty() && this->mask_.back() == '?')
+        {
+            this->mask_.pop_back();
+            this->bytes_.pop_back();
+        }
+    }
+
+    std::vector<std::vector<size_t>> find(const std::span<const uint8_t> data, const std::vector<pattern>& patterns,
+                                          const scan_options& options)
+    {
+        const auto scan_tile = get_tile_scanner(options.instructions);
+        const auto anchors = group_patterns(patterns, sample_histogram(data));
+        const scan_range range{data.data(), data.data() + data.size()};
+
+        const auto tile_count = (data.size() + TILE_SIZE - 1) / TILE_SIZE;
+        const auto default_thread_count = std::max<size_t>(1, std::thread::hardware_concurrency() / 2);
+        const auto thread_count = std::min(options.thread_count ? options.thread_count : default_thread_count, tile_count);
+
+        std::mutex mutex{};
+        match_lists matches(patterns.size());
+        std::atomic<size_t> next_tile{0};
+
+        const auto scan_tiles = [&] {
+            match_lists local_matches(matches.size());
+
+            for (auto tile = next_tile++; tile < tile_count; tile = next_tile++)
+            {
+                const auto* tile_start = range.start + tile * TILE_SIZE;
+                const auto* tile_end = tile_start + std::min(TILE_SIZE, data.size() - tile * TILE_SIZE);
+
+                scan_tile(range, anchors, tile_start, tile_end, local_matches);
+            }
+
+            std::lock_guard _(mutex);
+            for (size_t i = 0; i < matches.size(); ++i)
+            {
+                matches[i].insert(matches[i].end(), local_matches[i].begin(), local_matches[i].end());
+            }
+        };
+
+        std::vector<std::thread> threads{};
+        for (size_t i = 1; i < thread_count; ++i)
+        {
+            threads.emplace_back(scan_tiles);
+        }
+
+        scan_tiles();
+
+        for (auto& thread : threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+
+        for (auto& pattern_matches : matches)
+        {
+            std::sort(pattern_matches.begin(), pattern_matches.end());
+        }
+
+        return matches;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils::pattern_scanner
+{
+    // ===========================================================================
+    // PATTERN SCANNING
+    // ===========================================================================
+    // Finds byte patterns with wildcards in a range, a whole batch in one pass.
+    // Each pattern is anchored on its rarest fixed byte, judged by a histogram
+    // sampled from the range, and patterns sharing an anchor byte are verified
+    // together. A single pass tests every byte against all anchor bytes at
+    // once through nibble lookup tables, with SIMD shuffles picked at runtime,
+    // and tiles of the range are spread over threads. Only candidates are
+    // verified, rarest bytes first.
+    //
+    // Platform independent, utils::hook::signature applies it to modules.
+    // ===========================================================================
+
+    enum class instruction_set
+    {
+        generic,
+        sse42,
+        avx2,
+    };
+
+    bool is_supported(instruction_set instructions);
+
+    // Best one the CPU and OS support
+    instruction_set get_best_instruction_set();
+
+    std::string_view get_name(instruction_set instructions);
+
+    class pattern
+    {
+      public:
+        // IDA style hex bytes, every ? is one wildcard byte and spaces are ignored. Trailing wildcards are dropped.
+        // Throws on invalid input.
+        explicit pattern(std::string_view text);
+
+        size_t size() const
+        {
+            return this->mask_.size();
+        }
+
+        bool is_wildcard(const size_t index) const
+        {
+            return this->mask_[index] == '?';
+        }
+
+        uint8_t get_byte(const size_t index) const
+        {
+            return this->bytes_[index];
+        }
+
+      private:
+        std::string mask_{};
+        std::basic_string<uint8_t> bytes_{};
+    };
+
+    struct scan_options
+    {
+        // 0 uses half of the available cores
+        size_t thread_count = 0;
+        instruction_set instructions = get_best_instruction_set();
+    };
+
+    // Offsets of all matches, one sorted list per pattern in the same order.
+    // Throws for patterns without a fixed byte and unsupported instruction sets.
+    std::vector<std::vector<size_t>> find(std::span<const uint8_t> data, const std::vector<pattern>& patterns,
+                                          const scan_options& options = {});
+}
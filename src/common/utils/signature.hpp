@@ -3,6 +3,8 @@
 
 #ifdef _WIN32
 
+#include "pattern_scanner.hpp"
+
 namespace utils::hook
 {
     class signature final
@@ -46,30 +48,51 @@ namespace utils::hook
         }
 
         signature(const std::string& pattern, void* start, const size_t length)
-            : start_(static_cast<uint8_t*>(start)),
+            : pattern_(pattern),
+              start_(static_cast<uint8_t*>(start)),
               length_(length)
         {
-            this->load_pattern(pattern);
         }
 
         signature_result process() const;
 
       private:
-        std::string mask_;
-        std::basic_string<uint8_t> pattern_;
+        friend class signature_batch;
+
+        pattern_scanner::pattern pattern_;
 
         uint8_t* start_;
         size_t length_;
+    };
 
-        void load_pattern(const std::string& pattern);
+    // Resolves many patterns in one pass over the range, far cheaper than one signature::process per pattern.
+    // Every pattern needs at least one fixed byte, see utils::pattern_scanner.
+    class signature_batch final
+    {
+      public:
+        explicit signature_batch(const nt::library module = {})
+            : signature_batch(module.get_ptr(), module.get_optional_header()->SizeOfImage)
+        {
+        }
 
-        signature_result process_parallel() const;
-        signature_result process_serial() const;
-        std::vector<size_t> process_range(uint8_t* start, size_t length) const;
-        std::vector<size_t> process_range_linear(uint8_t* start, size_t length) const;
-        std::vector<size_t> process_range_vectorized(uint8_t* start, size_t length) const;
+        signature_batch(void* start, const size_t length)
+            : start_(static_cast<uint8_t*>(start)),
+              length_(length)
+        {
+        }
+
+        // Returns the index of the pattern's result
+        size_t add(const std::string& pattern);
+
+        std::vector<signature::signature_result> process() const;
+
+      private:
+        friend class signature;
+
+        uint8_t* start_;
+        size_t length_;
 
-        bool has_sse_support() const;
+        std::vector<pattern_scanner::pattern> patterns_;
     };
 }
 
@@ -1,24 +1,30 @@
 #pragma once
 
 #include <chrono>
+#include <memory>
 #include <optional>
+#include <string>
 
-#include <game/structs.hpp>
+#include <network/string_dictionary.hpp>
+#include <network/world_snapshot.hpp>
 #include <utils/cryptography.hpp>
 
-struct client
+// Cold per-client data, only touched while authenticating, encoding names or streaming a world snapshot.
+// The per-tick simulation state lives in the columns of client_map.
+struct client_identity
 {
-    std::chrono::high_resolution_clock::time_point last_packet{};
-    uint64_t guid{};
-    std::string name{};
-    game::player_state current_state{};
     std::string authentication_nonce{};
     std::optional<utils::cryptography::ecc::key> public_key{};
-    uint64_t state_id{0};
+
+    // Ephemeral half of the session key exchange, dropped once the session keys are derived
+    std::optional<utils::cryptography::ecc::key> session_key{};
+
+    // Requests are repeated for every state until the client answers, but at most once per interval
+    std::chrono::high_resolution_clock::time_point last_authentication_request{};
     bool has_printed_failure{false};
 
-    bool is_authenticated() const
-    {
-        return this->public_key.has_value();
-    }
+    network::string_dictionary dictionary{};
+
+    // Snapshot this client is downloading, kept until it asks past the last chunk
+    std::shared_ptr<const network::snapshot_transfer> snapshot{};
 };
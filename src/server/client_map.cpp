@@ -0,0 +1,175 @@
+#include "std_include.hpp"
+#include "client_map.hpp"
+
+client_map::index client_map::get_or_create(const network::address& address)
+{
+    const auto [entry, inserted] = this->address_index_.try_emplace(address, static_cast<index>(this->size()));
+    if (!inserted)
+    {
+        return entry->second;
+    }
+
+    this->last_packet_.emplace_back();
+    this->authenticated_.emplace_back(0);
+    this->players_.emplace_back();
+    this->addresses_.emplace_back(address);
+    this->identities_.emplace_back();
+
+    return entry->second;
+}
+
+client_map::index client_map::find(const network::address& address) const
+{
+    const auto i = this->address_index_.find(address);
+    return i == this->address_index_.end() ? npos : i->second;
+}
+
+client_map::index client_map::find_by_guid(const uint64_t guid) const
+{
+    const auto i = this->guid_index_.find(guid);
+    return i == this->guid_index_.end() ? npos : i->second;
+}
+
+void client_map::update_state(const index i, const game::player& player, const clock::time_point now)
+{
+    auto& current = this->players_[i];
+
+    if (current.guid != player.guid && this->is_authenticated(i))
+    {
+        this->deauthenticate(i);
+    }
+
+    const auto state_id = current.state.state_id;
+
+    current = player;
+    current.name.back() = '\0';
+    current.state.state_id = state_id + 1;
+
+    this->last_packet_[i] = now;
+}
+
+void client_map::authenticate(const index i, utils::cryptography::ecc::key key, const clock::time_point now)
+{
+    auto& slot = this->guid_index_.try_emplace(this->players_[i].guid, i).first->second;
+
+    // The same identity reconnecting from a new address supersedes the old session
+    if (slot != i)
+    {
+        this->deauthenticate(slot);
+        this->guid_index_[this->players_[i].guid] = i;
+    }
+
+    this->identities_[i].public_key = std::move(key);
+    this->authenticated_[i] = 1;
+    this->last_packet_[i] = now;
+}
+
+size_t client_map::expire(const clock::time_point cutoff, const std::function<void(const network::address&)>& on_expired)
+{
+    size_t count = 0;
+
+    // Walk backwards so swap-and-pop only ever moves slots that were already checked
+    for (auto i = static_cast<index>(this->size()); i-- > 0;)
+    {
+        if (this->last_packet_[i] >= cutoff)
+        {
+            continue;
+        }
+
+        if (on_expired)
+        {
+            on_expired(this->addresses_[i]);
+        }
+
+        this->erase(i);
+        ++count;
+    }
+
+    return count;
+}
+
+bool client_map::is_consistent() const
+{
+    const auto count = this->size();
+    if (this->last_packet_.size() != count || this->authenticated_.size() != count || this->players_.size() != count ||
+        this->identities_.size() != count || this->address_index_.size() != count)
+    {
+        return false;
+    }
+
+    size_t authenticated = 0;
+
+    for (index i = 0; i < count; ++i)
+    {
+        if (this->find(this->addresses_[i]) != i)
+        {
+            return false;
+        }
+
+        if (this->identities_[i].public_key.has_value() != this->is_authenticated(i))
+        {
+            return false;
+        }
+
+        if (this->is_authenticated(i))
+        {
+            ++authenticated;
+
+            if (this->find_by_guid(this->players_[i].guid) != i)
+            {
+                return false;
+            }
+        }
+    }
+
+    return authenticated == this->guid_index_.size();
+}
+
+void client_map::deauthenticate(const index i)
+{
+    const auto entry = this->guid_index_.find(this->players_[i].guid);
+    if (entry != this->guid_index_.end() && entry->second == i)
+    {
+        this->guid_index_.erase(entry);
+    }
+
+    auto& identity = this->identities_[i];
+    identity.public_key.reset();
+    identity.authentication_nonce.clear();
+    identity.has_printed_failure = false;
+
+    this->authenticated_[i] = 0;
+}
+
+void client_map::erase(const index i)
+{
+    if (this->is_authenticated(i))
+    {
+        this->deauthenticate(i);
+    }
+
+    this->address_index_.erase(this->addresses_[i]);
+
+    const auto last = static_cast<index>(this->size() - 1);
+    if (i != last)
+    {
+        this->last_packet_[i] = this->last_packet_[last];
+        this->authenticated_[i] = this->authenticated_[last];
+        this->players_[i] = this->players_[last];
+        this->addresses_[i] = this->addresses_[last];
+        this->identities_[i] = std::move(this->identities_[last]);
+
+        this->address_index_[this->addresses_[i]] = i;
+
+        if (this->is_authenticated(i))
+        {
+            this->guid_index_[this->players_[i].guid] = i;
+        }
+    }
+
+    this->last_packet_.pop_back();
+    this->authenticated_.pop_back();
+    this->players_.pop_back();
+    this->addresses_.pop_back();
+    this->identities_.pop_back();
+}
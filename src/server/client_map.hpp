@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <game/structs.hpp>
+#include <network/address.hpp>
+
+#include "client.hpp"
+
+// Dense, index-addressed client table.
+// Hot per-tick data is stored as parallel columns so the expiry sweep and state broadcast stream through
+// contiguous memory; identity and crypto data sit in a separate cold column.
+// Slots are compacted with swap-and-pop on removal, so an index is only valid until the next erase.
+// Authenticated clients are additionally indexed by guid for targeted relays.
+class client_map
+{
+  public:
+    using clock = std::chrono::high_resolution_clock;
+    using index = uint32_t;
+
+    static constexpr index npos = ~index{0};
+
+    index get_or_create(const network::address& address);
+    index find(const network::address& address) const;
+    index find_by_guid(uint64_t guid) const;
+
+    // Changing the guid of an authenticated client drops its index entry and forces re-authentication
+    void update_state(index i, const game::player& player, clock::time_point now);
+    void authenticate(index i, utils::cryptography::ecc::key key, clock::time_point now);
+
+    // Forgets the client's key, its next state starts a new authentication
+    void deauthenticate(index i);
+
+    size_t expire(clock::time_point cutoff, const std::function<void(const network::address&)>& on_expired = {});
+
+    size_t size() const
+    {
+        return this->addresses_.size();
+    }
+
+    const network::address& get_address(const index i) const
+    {
+        return this->addresses_[i];
+    }
+
+    const game::player& get_player(const index i) const
+    {
+        return this->players_[i];
+    }
+
+    bool is_authenticated(const index i) const
+    {
+        return this->authenticated_[i] != 0;
+    }
+
+    client_identity& get_identity(const index i)
+    {
+        return this->identities_[i];
+    }
+
+    template <typename F>
+    void for_each_authenticated(F&& callback) const
+    {
+        for (index i = 0; i < this->authenticated_.size(); ++i)
+        {
+            if (this->authenticated_[i])
+            {
+                callback(i);
+            }
+        }
+    }
+
+    bool is_consistent() const;
+
+  private:
+    // Hot columns
+    std::vector<clock::time_point> last_packet_{};
+    std::vector<uint8_t> authenticated_{};
+    std::vector<game::player> players_{};
+    std::vector<network::address> addresses_{};
+
+    // Cold column
+    std::vector<client_identity> identities_{};
+
+    std::unordered_map<network::address, index> address_index_{};
+    std::unordered_map<uint64_t, index> guid_index_{};
+
+    void erase(index i);
+};
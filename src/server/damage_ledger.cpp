@@ -0,0 +1,66 @@
+#include "std_include.hpp"
+#include "damage_ledger.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+damage_ledger::contribution damage_ledger::entry::get_remote_share(const uint64_t recipient_guid) const
+{
+    contribution share{};
+    share.damage = this->total_damage;
+    share.hits = this->hit_count;
+
+    for (const auto& c : this->contributions)
+    {
+        if (c.attacker_guid == recipient_guid)
+        {
+            share.damage -= c.damage;
+            share.hits = static_cast<uint16_t>(share.hits - c.hits);
+            break;
+        }
+    }
+
+    return share;
+}
+
+bool damage_ledger::record(const uint64_t attacker_guid, const network::protocol::attack_packet& attack)
+{
+    if (!std::isfinite(attack.damage_amount) || attack.damage_amount < 0.0f)
+    {
+        return false;
+    }
+
+    const auto target_tag = network::protocol::extract_string(attack.target_tag);
+    if (target_tag.empty())
+    {
+        return false;
+    }
+
+    auto& npc = this->entries_[target_tag];
+
+    // Once an NPC is dead, later hits in the same tick don't change the outcome
+    if (npc.killed)
+    {
+        return true;
+    }
+
+    npc.total_damage += attack.damage_amount;
+    npc.hit_count = static_cast<uint16_t>(std::min<uint32_t>(npc.hit_count + 1u, 0xFFFF));
+
+    auto c = std::ranges::find(npc.contributions, attacker_guid, &contribution::attacker_guid);
+    if (c == npc.contributions.end())
+    {
+        c = npc.contributions.insert(c, contribution{attacker_guid});
+    }
+
+    c->damage += attack.damage_amount;
+    c->hits = static_cast<uint16_t>(std::min<uint32_t>(c->hits + 1u, 0xFFFF));
+
+    if (attack.force_kill)
+    {
+        npc.killed = true;
+        npc.killer_guid = attacker_guid;
+    }
+
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <network/protocol.hpp>
+
+// Per-tick aggregation of player attacks on NPCs.
+// Attacks are recorded as they arrive and flushed once per server frame, so every
+// affected NPC produces exactly one consolidated update instead of one relay per attack.
+class damage_ledger
+{
+  public:
+    struct contribution
+    {
+        uint64_t attacker_guid{};
+        float damage{};
+        uint16_t hits{};
+    };
+
+    struct entry
+    {
+        float total_damage{};
+        uint16_t hit_count{};
+        bool killed{};
+        uint64_t killer_guid{};
+        std::vector<contribution> contributions{};
+
+        // Damage and hits the given player has not applied locally yet
+        contribution get_remote_share(uint64_t recipient_guid) const;
+    };
+
+    using entry_map = std::unordered_map<std::string, entry>;
+
+    // The attacker guid comes from the authenticated sender, not from the packet
+    bool record(uint64_t attacker_guid, const network::protocol::attack_packet& attack);
+
+    template <typename F>
+    void flush(F&& callback)
+    {
+        for (const auto& [target_tag, npc] : this->entries_)
+        {
+            callback(target_tag, npc);
+        }
+
+        this->entries_.clear();
+    }
+
+    bool empty() const
+    {
+        return this->entries_.empty();
+    }
+
+  private:
+    entry_map entries_{};
+};
@@ -33,7 +33,7 @@ namespace
         console::set_title("W3M Server");
         console::log("Starting W3M Server");
 
-        server s{28960};
+        server s{28960, "session"};
 
         console::log("Running on %hu (v4) and %hu (v6)", s.get_ipv4_port(), s.get_ipv6_port());
 
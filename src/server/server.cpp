@@ -3,37 +3,85 @@
 
 #include <utils/string.hpp>
 #include <utils/byte_buffer.hpp>
-#include <network/protocol.hpp>
+#include <network/packet_codec.hpp>
+#include <security/session_cipher.hpp>
 
 #include "console.hpp"
 
 namespace
 {
-    void send_authentication_request(const network::manager& manager, const network::address& source, client& client)
+    // Per-thread scratch storage for outgoing messages. Reset between messages, so sending doesn't allocate once it
+    // has grown to the largest one. Only one of these may be in use per thread at a time.
+    utils::buffer_serializer get_message_buffer()
     {
-        if (client.authentication_nonce.empty())
+        thread_local std::string storage{};
+        return utils::buffer_serializer(storage);
+    }
+
+    // Clients send their state many times a second, one unanswered request per interval is plenty
+    constexpr auto AUTHENTICATION_REQUEST_INTERVAL = 250ms;
+
+    // Clients send their state many times a second and a heartbeat every few seconds, a session that has been quiet
+    // for this long belongs to a client that lost its keys, e.g. it restarted on the same address
+    constexpr auto SESSION_TIMEOUT = 10s;
+
+    // Packets that got through a lapsed session may be unsealed, the client has to prove its identity again
+    void check_session(const network::manager& manager, server::client_map& clients, const network::address& source)
+    {
+        const auto index = clients.find(source);
+        if (index != server::client_map::npos && clients.is_authenticated(index) && !manager.is_sealing(source))
+        {
+            console::log("Session of %s lapsed, authenticating again", source.to_string().data());
+            clients.deauthenticate(index);
+        }
+    }
+
+    void send_authentication_request(network::manager& manager, session_key_pool& session_keys, const network::address& source,
+                                     client_identity& identity, const uint64_t guid, const server::client_map::clock::time_point now)
+    {
+        if (now - identity.last_authentication_request < AUTHENTICATION_REQUEST_INTERVAL)
+        {
+            return;
+        }
+
+        if (identity.authentication_nonce.empty())
         {
-            console::log("Authenticating player: %s (%llX)", source.to_string().data(), client.guid);
-            client.authentication_nonce = utils::cryptography::random::get_challenge();
+            // Drained by a burst of new addresses, the client is answered once a key is ready
+            auto session_key = session_keys.take();
+            if (!session_key)
+            {
+                return;
+            }
+
+            console::log("Authenticating player: %s (%llX)", source.to_string().data(), guid);
+            identity.authentication_nonce = utils::cryptography::random::get_challenge();
+
+            // A session from an earlier handshake is void
+            identity.session_key = std::move(session_key);
+            manager.clear_session(source);
         }
 
+        identity.last_authentication_request = now;
+
         utils::buffer_serializer buffer{};
         buffer.write(game::PROTOCOL);
-        buffer.write_string(client.authentication_nonce);
+        buffer.write_string(identity.authentication_nonce);
+        buffer.write_string(identity.session_key->serialize(PK_PUBLIC));
 
         (void)manager.send(source, "authRequest", buffer.get_buffer());
     }
 
-    void send_killed_command(const network::manager& manager, const network::address& victim, const client& killer)
+    void send_killed_command(const network::manager& manager, const network::address& victim, const uint64_t killer_guid)
     {
         utils::buffer_serializer buffer{};
         buffer.write(game::PROTOCOL);
-        buffer.write(killer.guid);
+        buffer.write(killer_guid);
 
         (void)manager.send(victim, "killed", buffer.get_buffer());
     }
 
-    void handle_authentication_response(server::client_map& clients, const network::address& source, const std::string_view& data)
+    void handle_authentication_response(network::manager& manager, server::client_map& clients, const network::address& source,
+                                        const std::string_view& data)
     {
         utils::buffer_deserializer buffer(data);
         const auto protocol = buffer.read<uint32_t>();
@@ -42,8 +90,9 @@ namespace
             return;
         }
 
-        const auto key = buffer.read_string();
-        const auto signature = buffer.read_string();
+        // Views into the datagram, only used before the handler returns
+        const auto key = buffer.read_string_view();
+        const auto signature = buffer.read_string_view();
 
         utils::cryptography::ecc::key crypto_key{};
         crypto_key.deserialize(key);
@@ -52,38 +101,57 @@ namespace
             return;
         }
 
-        auto& client = clients[source];
+        const auto index = clients.find(source);
+        if (index == server::client_map::npos)
+        {
+            return;
+        }
+
+        // A late duplicate must not restart the session, that would reuse its nonces
+        if (clients.is_authenticated(index))
+        {
+            return;
+        }
+
+        auto& identity = clients.get_identity(index);
+        const auto guid = clients.get_player(index).guid;
 
         const auto print_failure = [&](const char* reason) {
-            if (!client.has_printed_failure)
+            if (!identity.has_printed_failure)
             {
-                client.has_printed_failure = true;
+                identity.has_printed_failure = true;
                 console::log("Authentication failed (%s): %s", source.to_string().data(), reason); //
             }
         };
 
-        if (client.authentication_nonce.empty())
+        if (identity.authentication_nonce.empty() || !identity.session_key)
         {
             print_failure("Nonce not set");
             return;
         }
 
-        if (crypto_key.get_hash() != client.guid)
+        if (crypto_key.get_hash() != guid)
         {
             print_failure("Key doesn't match GUID");
             return;
         }
 
-        if (!verify_message(crypto_key, client.authentication_nonce, signature))
+        if (!verify_message(crypto_key, identity.authentication_nonce, signature))
         {
             print_failure("Invalid signature");
             return;
         }
 
-        client.public_key = std::move(crypto_key);
-        client.last_packet = std::chrono::high_resolution_clock::now();
+        const auto keys =
+            security::derive_session_keys(*identity.session_key, crypto_key, identity.authentication_nonce, security::session_role::server);
+
+        // The client confirms its keys with its first sealed packet, everything it sends unsealed from now on is dropped
+        manager.set_session(source, std::make_shared<security::session_cipher>(keys), true);
+        identity.session_key.reset();
 
-        console::log("[SERVER] Player Authenticated: %llX", client.guid);
+        clients.authenticate(index, std::move(crypto_key), server::client_map::clock::now());
+
+        console::log("[SERVER] Player Authenticated: %llX", guid);
     }
 
     void handle_player_kill(const network::manager& manager, server::client_map& clients, const network::address& source,
@@ -96,26 +164,23 @@ namespace
             return;
         }
 
-        const auto& killer = clients[source];
-        if (!killer.is_authenticated())
+        const auto killer = clients.find(source);
+        if (killer == server::client_map::npos || !clients.is_authenticated(killer))
         {
             return;
         }
 
         const auto player_guid = buffer.read<uint64_t>();
 
-        for (auto& client : clients)
+        const auto victim = clients.find_by_guid(player_guid);
+        if (victim != server::client_map::npos)
         {
-            if (client.second.is_authenticated() && client.second.guid == player_guid)
-            {
-                send_killed_command(manager, client.first, killer);
-                break;
-            }
+            send_killed_command(manager, clients.get_address(victim), clients.get_player(killer).guid);
         }
     }
 
-    void handle_player_state(const network::manager& manager, server::client_map& clients, const network::address& source,
-                             const std::string_view& data)
+    void handle_player_state(network::manager& manager, server::client_map& clients, session_key_pool& session_keys,
+                             const network::address& source, const std::string_view& data)
     {
         utils::buffer_deserializer buffer(data);
         const auto protocol = buffer.read<uint32_t>();
@@ -126,157 +191,445 @@ namespace
 
         const auto player_state = buffer.read<game::player>();
 
-        auto& client = clients[source];
-        client.last_packet = std::chrono::high_resolution_clock::now();
-        client.guid = player_state.guid;
-        client.name.assign(player_state.name.data(), strnlen(player_state.name.data(), player_state.name.size()));
-        client.current_state = std::move(player_state.state);
-        client.state_id += 1;
+        const auto now = server::client_map::clock::now();
+        const auto index = clients.get_or_create(source);
+        clients.update_state(index, player_state, now);
 
-        if (!client.is_authenticated())
+        if (!clients.is_authenticated(index))
         {
-            send_authentication_request(manager, source, client);
+            send_authentication_request(manager, session_keys, source, clients.get_identity(index), player_state.guid, now);
         }
     }
 
     // ===========================================================================
-    // TRUE CO-OP BROADCAST HANDLERS - Quest/Combat/Cutscene Sync
+    // STRING DICTIONARY - Per-client interned names
     // ===========================================================================
 
-    void handle_fact_broadcast(const network::manager& manager, server::client_map& clients, const network::address& source,
-                               const std::string_view& data)
+    server::client_map::index find_authenticated(const server::client_map& clients, const network::address& source)
     {
-        utils::buffer_deserializer buffer(data);
-        const auto protocol = buffer.read<uint32_t>();
-        if (protocol != game::PROTOCOL)
+        const auto index = clients.find(source);
+        if (index == server::client_map::npos || !clients.is_authenticated(index))
         {
-            return;
+            return server::client_map::npos;
         }
 
-        const auto type = buffer.read<network::protocol::packet_type>();
-        if (type != network::protocol::packet_type::fact)
+        return index;
+    }
+
+    void handle_dictionary_ack(server::client_map& clients, const network::address& source, const std::string_view& data)
+    {
+        const auto index = clients.find(source);
+        if (index != server::client_map::npos)
         {
-            return;
+            network::apply_acknowledgements(clients.get_identity(index).dictionary.outgoing, data);
         }
+    }
 
-        // Broadcast to all clients except sender
-        for (const auto& [address, client] : clients)
+    void handle_dictionary_reset(server::client_map& clients, const network::address& source, const std::string_view& /* data */)
+    {
+        const auto index = clients.find(source);
+        if (index != server::client_map::npos)
+        {
+            clients.get_identity(index).dictionary.outgoing.reset();
+        }
+    }
+
+    void send_dictionary_updates(const network::manager& manager, server::client_map& clients)
+    {
+        for (server::client_map::index i = 0; i < clients.size(); ++i)
         {
-            if (address == source)
+            auto& incoming = clients.get_identity(i).dictionary.incoming;
+
+            for (const auto& payload : network::serialize_acknowledgements(incoming.take_acknowledgements()))
             {
-                continue;
+                (void)manager.send(clients.get_address(i), "dict_ack", payload);
             }
 
-            if (client.is_authenticated())
+            if (incoming.take_reset_request())
             {
-                (void)manager.send(address, "fact", std::string(data));
+                utils::buffer_serializer buffer{};
+                buffer.write(game::PROTOCOL);
+
+                (void)manager.send(clients.get_address(i), "dict_reset", buffer.get_buffer());
             }
         }
     }
 
-    void handle_attack_broadcast(const network::manager& manager, server::client_map& clients, const network::address& source,
-                                 const std::string_view& data)
+    // Re-encodes a decoded packet against each recipient's own dictionary
+    template <typename Packet>
+    void relay_packet(const network::manager& manager, server::client_map& clients, const server::client_map::index skip,
+                      const std::string& command, const Packet& packet)
+    {
+        auto buffer = get_message_buffer();
+
+        clients.for_each_authenticated([&](const server::client_map::index i) {
+            if (i == skip)
+            {
+                return;
+            }
+
+            buffer.reset();
+            buffer.write(game::PROTOCOL);
+            network::protocol::write(buffer, clients.get_identity(i).dictionary.outgoing, packet);
+
+            (void)manager.send(clients.get_address(i), command, buffer.get_view());
+        });
+    }
+
+    template <typename Packet>
+    void send_packet(const network::manager& manager, server::client_map& clients, const server::client_map::index receiver,
+                     const std::string& command, const Packet& packet)
+    {
+        auto buffer = get_message_buffer();
+        buffer.write(game::PROTOCOL);
+        network::protocol::write(buffer, clients.get_identity(receiver).dictionary.outgoing, packet);
+
+        (void)manager.send(clients.get_address(receiver), command, buffer.get_view());
+    }
+
+    template <typename Packet>
+    std::optional<std::pair<server::client_map::index, Packet>> read_packet(server::client_map& clients, const network::address& source,
+                                                                            const std::string_view& data)
     {
         utils::buffer_deserializer buffer(data);
         const auto protocol = buffer.read<uint32_t>();
         if (protocol != game::PROTOCOL)
         {
-            return;
+            return std::nullopt;
         }
 
-        const auto type = buffer.read<network::protocol::packet_type>();
-        if (type != network::protocol::packet_type::attack)
+        const auto sender = find_authenticated(clients, source);
+        if (sender == server::client_map::npos)
+        {
+            return std::nullopt;
+        }
+
+        auto packet = network::protocol::read<Packet>(buffer, clients.get_identity(sender).dictionary.incoming);
+        return std::make_pair(sender, std::move(packet));
+    }
+
+    // ===========================================================================
+    // TRUE CO-OP BROADCAST HANDLERS - Quest/Combat/Cutscene Sync
+    // ===========================================================================
+
+    void handle_fact_broadcast(const network::manager& manager, server::client_map& clients, world_state& world,
+                               const network::address& source, const std::string_view& data)
+    {
+        const auto fact = read_packet<network::protocol::fact_packet>(clients, source, data);
+        if (!fact)
         {
             return;
         }
 
+        world.apply_fact(fact->second);
+
         // Broadcast to all clients except sender
-        for (const auto& [address, client] : clients)
+        relay_packet(manager, clients, fact->first, "fact", fact->second);
+    }
+
+    void handle_fact_batch_broadcast(const network::manager& manager, server::client_map& clients, world_state& world,
+                                     const network::address& source, const std::string_view& data)
+    {
+        const auto batch = read_packet<network::protocol::fact_batch_packet>(clients, source, data);
+        if (!batch || batch->second.facts.empty())
         {
-            if (address == source)
-            {
-                continue;
-            }
+            return;
+        }
 
-            if (client.is_authenticated())
-            {
-                (void)manager.send(address, "attack", std::string(data));
-            }
+        for (const auto& fact : batch->second.facts)
+        {
+            world.apply_fact(fact);
         }
+
+        // Relayed as one batch so receivers see the sender's window in one go
+        relay_packet(manager, clients, batch->first, "fact_batch", batch->second);
     }
 
-    void handle_cutscene_broadcast(const network::manager& manager, server::client_map& clients, const network::address& /* source */,
-                                   const std::string_view& data)
+    void handle_loot_broadcast(const network::manager& manager, server::client_map& clients, const network::address& source,
+                               const std::string_view& data)
     {
-        utils::buffer_deserializer buffer(data);
-        const auto protocol = buffer.read<uint32_t>();
-        if (protocol != game::PROTOCOL)
+        const auto loot = read_packet<network::protocol::loot_packet>(clients, source, data);
+        if (!loot)
+        {
+            return;
+        }
+
+        // Broadcast to all clients except sender
+        relay_packet(manager, clients, loot->first, "loot", loot->second);
+    }
+
+    void handle_attack(damage_ledger& ledger, server::client_map& clients, const network::address& source, const std::string_view& data)
+    {
+        const auto attack = read_packet<network::protocol::attack_packet>(clients, source, data);
+        if (!attack)
         {
             return;
         }
 
-        const auto type = buffer.read<network::protocol::packet_type>();
-        if (type != network::protocol::packet_type::cutscene)
+        // Aggregated per tick and relayed by send_npc_updates
+        (void)ledger.record(clients.get_player(attack->first).guid, attack->second);
+    }
+
+    void handle_cutscene_broadcast(const network::manager& manager, server::client_map& clients, const network::address& source,
+                                   const std::string_view& data)
+    {
+        const auto cutscene = read_packet<network::protocol::cutscene_packet>(clients, source, data);
+        if (!cutscene)
         {
             return;
         }
 
         // Broadcast to all clients INCLUDING sender for synchronized playback
-        for (const auto& [address, client] : clients)
+        relay_packet(manager, clients, server::client_map::npos, "cutscene", cutscene->second);
+    }
+
+    // ===========================================================================
+    // WORLD STATE RECONCILIATION - Fact tree drill-down
+    // ===========================================================================
+
+    void send_world_state_nodes(const network::manager& manager, server::client_map& clients, const world_state& world,
+                                const server::client_map::index receiver, const size_t node)
+    {
+        network::protocol::world_state_nodes_packet packet{};
+        packet.node = static_cast<uint16_t>(node);
+
+        const auto children = world.get_fact_tree().get_children(node);
+        std::ranges::copy(children, packet.children.begin());
+
+        send_packet(manager, clients, receiver, "world_state_nodes", packet);
+    }
+
+    void handle_heartbeat(const network::manager& manager, server::client_map& clients, world_state& world,
+                          const network::address& source, const std::string_view& data)
+    {
+        const auto heartbeat = read_packet<network::protocol::heartbeat_packet>(clients, source, data);
+        if (!heartbeat)
         {
-            if (client.is_authenticated())
-            {
-                (void)manager.send(address, "cutscene", std::string(data));
-            }
+            return;
+        }
+
+        world.update_environment(heartbeat->second);
+
+        // Saves the client the round trip of requesting the root's children
+        if (heartbeat->second.world_fact_hash != world.get_fact_tree().get_root())
+        {
+            send_world_state_nodes(manager, clients, world, heartbeat->first, 0);
         }
     }
 
-    void send_state(const network::manager& manager, const server::client_map& clients)
+    void handle_world_state_nodes_request(const network::manager& manager, server::client_map& clients, const world_state& world,
+                                          const network::address& source, const std::string_view& data)
     {
-        std::vector<game::player> states{};
-        states.reserve(clients.size());
+        const auto request = read_packet<network::protocol::world_state_nodes_request_packet>(clients, source, data);
+        // Buckets have no children, their facts are requested instead
+        if (!request || request->second.node >= utils::merkle_tree::FIRST_BUCKET_NODE)
+        {
+            return;
+        }
+
+        send_world_state_nodes(manager, clients, world, request->first, request->second.node);
+    }
 
-        for (const auto& val : clients | std::views::values)
+    void handle_world_state_bucket_request(const network::manager& manager, server::client_map& clients, const world_state& world,
+                                           const network::address& source, const std::string_view& data)
+    {
+        const auto request = read_packet<network::protocol::world_state_bucket_request_packet>(clients, source, data);
+        if (!request || request->second.bucket >= utils::merkle_tree::BUCKET_COUNT)
         {
-            if (!val.is_authenticated())
-            {
-                continue;
-            }
+            return;
+        }
 
-            game::player player{};
-            player.guid = val.guid;
-            player.state = val.current_state;
-            player.state.state_id = val.state_id;
-            utils::string::copy(player.name, val.name.data());
+        send_packet(manager, clients, request->first, "world_state_bucket",
+                    world.get_bucket_page(request->second.bucket, request->second.offset));
+    }
 
-            states.emplace_back(std::move(player));
+    // ===========================================================================
+    // WORLD SNAPSHOT - Catch-up for late joiners
+    // ===========================================================================
+
+    // Compressing a new snapshot happens without the clients lock, so frames and other packets aren't held up by it
+    void handle_snapshot_request(const network::manager& manager, server::client_map& clients, std::unique_lock<std::mutex>& lock,
+                                 world_state& world, const network::address& source, const std::string_view& data)
+    {
+        utils::buffer_deserializer buffer(data);
+        const auto protocol = buffer.read<uint32_t>();
+        if (protocol != game::PROTOCOL)
+        {
+            return;
         }
 
-        utils::buffer_serializer buffer{};
-        buffer.write(game::PROTOCOL);
-        buffer.write_vector(states);
+        auto sender = find_authenticated(clients, source);
+        if (sender == server::client_map::npos)
+        {
+            return;
+        }
+
+        const auto snapshot_id = buffer.read<uint64_t>();
+        const auto first_chunk = buffer.read<uint32_t>();
 
-        for (const auto& client : clients)
+        // Unknown ids, e.g. from before a server restart, get the current snapshot and start over
+        if (!clients.get_identity(sender).snapshot || clients.get_identity(sender).snapshot->id != snapshot_id)
         {
-            if (client.second.is_authenticated())
+            auto snapshot = world.get_cached_snapshot();
+
+            if (!snapshot)
             {
-                (void)manager.send(client.first, "states", buffer.get_buffer());
+                const auto pending = world.prepare_snapshot();
+
+                lock.unlock();
+                snapshot = std::make_shared<const network::snapshot_transfer>(pending.id, pending.snapshot);
+                lock.lock();
+
+                world.cache_snapshot(pending, snapshot);
+
+                // The client may have left or been re-indexed meanwhile
+                sender = find_authenticated(clients, source);
+                if (sender == server::client_map::npos)
+                {
+                    return;
+                }
             }
+
+            clients.get_identity(sender).snapshot = std::move(snapshot);
+
+            console::log("Sending world snapshot %llu to %s: %zu facts, %zu bytes", clients.get_identity(sender).snapshot->id,
+                         source.to_string().data(), world.get_fact_count(), clients.get_identity(sender).snapshot->data.size());
+        }
+
+        auto& identity = clients.get_identity(sender);
+        const auto snapshot = identity.snapshot;
+        const auto chunk_count = snapshot->get_chunk_count();
+        const auto start = snapshot->id == snapshot_id ? first_chunk : 0;
+
+        if (start >= chunk_count)
+        {
+            identity.snapshot.reset();
+            return;
+        }
+
+        const auto end = static_cast<uint32_t>(std::min<size_t>(chunk_count, start + network::SNAPSHOT_WINDOW));
+        auto message = get_message_buffer();
+
+        for (auto i = start; i < end; ++i)
+        {
+            message.reset();
+            message.write(game::PROTOCOL);
+            snapshot->write_chunk(message, i);
+
+            (void)manager.send(source, "snapshot_chunk", message.get_view());
+        }
+    }
+
+    void send_npc_updates(const network::manager& manager, server::client_map& clients, damage_ledger& ledger)
+    {
+        if (ledger.empty())
+        {
+            return;
         }
+
+        const auto timestamp = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        auto buffer = get_message_buffer();
+
+        ledger.flush([&](const std::string& target_tag, const damage_ledger::entry& npc) {
+            network::protocol::npc_update_packet packet{};
+            network::protocol::copy_string(packet.target_tag, target_tag);
+            packet.killed = npc.killed;
+            packet.killer_guid = npc.killer_guid;
+            packet.timestamp = timestamp;
+
+            clients.for_each_authenticated([&](const server::client_map::index i) {
+                const auto share = npc.get_remote_share(clients.get_player(i).guid);
+                if (share.hits == 0 && !npc.killed)
+                {
+                    return;
+                }
+
+                packet.damage_amount = share.damage;
+                packet.hit_count = share.hits;
+
+                buffer.reset();
+                buffer.write(game::PROTOCOL);
+                network::protocol::write(buffer, clients.get_identity(i).dictionary.outgoing, packet);
+
+                (void)manager.send(clients.get_address(i), "npc_update", buffer.get_view());
+            });
+        });
+    }
+
+    void send_state(const network::manager& manager, const server::client_map& clients)
+    {
+        // Same layout as write_vector, the count is patched in once the players are written
+        auto buffer = get_message_buffer();
+        buffer.reserve(sizeof(game::PROTOCOL) + sizeof(uint32_t) + clients.size() * sizeof(game::player));
+        buffer.write(game::PROTOCOL);
+
+        const auto count_offset = buffer.size();
+        buffer.write(uint32_t{});
+
+        uint32_t count = 0;
+        clients.for_each_authenticated([&](const server::client_map::index i) {
+            buffer.write(clients.get_player(i));
+            ++count;
+        });
+
+        buffer.write_at(count_offset, count);
+
+        clients.for_each_authenticated(
+            [&](const server::client_map::index i) { (void)manager.send(clients.get_address(i), "states", buffer.get_view()); });
     }
 }
 
-server::server(const uint16_t port)
+server::server(const uint16_t port, const std::filesystem::path& session_directory)
     : manager_(port)
 {
-    this->on("state", &handle_player_state);
+    this->manager_.set_session_timeout(SESSION_TIMEOUT);
+
+    try
+    {
+        this->world_state_.open_journal(session_directory);
+    }
+    catch (const std::exception& e)
+    {
+        console::error("Session journal disabled: %s", e.what());
+    }
+
+    this->on("state", [this](network::manager& manager, server::client_map& clients, const network::address& source,
+                             const std::string_view& data) { handle_player_state(manager, clients, this->session_keys_, source, data); });
     this->on("kill", &handle_player_kill);
     this->on("authResponse", &handle_authentication_response);
 
     // Register True Co-op broadcast handlers
-    this->on("fact", &handle_fact_broadcast);
-    this->on("attack", &handle_attack_broadcast);
+    this->on("fact", [this](const network::manager& manager, server::client_map& clients, const network::address& source,
+                            const std::string_view& data) { handle_fact_broadcast(manager, clients, this->world_state_, source, data); });
+    this->on("fact_batch", [this](const network::manager& manager, server::client_map& clients, const network::address& source,
+                                  const std::string_view& data) {
+        handle_fact_batch_broadcast(manager, clients, this->world_state_, source, data);
+    });
+    this->on("attack", [this](server::client_map& clients, const network::address& source, const std::string_view& data) {
+        handle_attack(this->damage_ledger_, clients, source, data);
+    });
     this->on("cutscene", &handle_cutscene_broadcast);
+    this->on("loot", &handle_loot_broadcast);
+
+    this->on("heartbeat", [this](const network::manager& manager, server::client_map& clients, const network::address& source,
+                                 const std::string_view& data) { handle_heartbeat(manager, clients, this->world_state_, source, data); });
+    this->on("world_state_nodes_request", [this](const network::manager& manager, server::client_map& clients,
+                                                 const network::address& source, const std::string_view& data) {
+        handle_world_state_nodes_request(manager, clients, this->world_state_, source, data);
+    });
+    this->on("world_state_bucket_request", [this](const network::manager& manager, server::client_map& clients,
+                                                  const network::address& source, const std::string_view& data) {
+        handle_world_state_bucket_request(manager, clients, this->world_state_, source, data);
+    });
+    this->manager_.on("snapshot_request", [this](const network::address& source, const std::string_view& data) {
+        this->clients_.access_with_lock([&](client_map& clients, std::unique_lock<std::mutex>& lock) {
+            check_session(this->manager_, clients, source);
+            handle_snapshot_request(this->manager_, clients, lock, this->world_state_, source, data);
+        });
+    });
+
+    this->on("dict_ack", &handle_dictionary_ack);
+    this->on("dict_reset", &handle_dictionary_reset);
 }
 
 uint16_t server::get_ipv4_port() const
@@ -289,6 +642,11 @@ uint16_t server::get_ipv6_port() const
     return this->manager_.get_ipv6_socket().get_port();
 }
 
+void server::set_session_timeout(const std::chrono::milliseconds timeout)
+{
+    this->manager_.set_session_timeout(timeout);
+}
+
 void server::run()
 {
     this->stop_ = false;
@@ -308,36 +666,35 @@ void server::stop()
 void server::run_frame()
 {
     this->clients_.access([this](client_map& clients) {
-        const auto now = std::chrono::high_resolution_clock::now();
+        const auto now = client_map::clock::now();
 
-        for (auto i = clients.begin(); i != clients.end();)
-        {
-            const auto last_packet_diff = now - i->second.last_packet;
+        clients.expire(now - 20s, [this](const network::address& address) {
+            console::log("Removing player: %s", address.to_string().data());
+            this->manager_.clear_session(address);
+        });
 
-            if (last_packet_diff > 20s)
-            {
-                console::log("Removing player: %s", i->first.to_string().data());
-                i = clients.erase(i);
-            }
-            else
-            {
-                ++i;
-            }
-        }
+        assert(clients.is_consistent());
 
+        send_npc_updates(this->manager_, clients, this->damage_ledger_);
+        send_dictionary_updates(this->manager_, clients);
         send_state(this->manager_, clients);
+
+        this->world_state_.flush_journal();
     });
 }
 
 void server::on(const std::string& command, callback callback)
 {
-    this->on(command, [c = std::move(callback)](const network::manager&, client_map& clients, const network::address& source,
+    this->on(command, [c = std::move(callback)](network::manager&, client_map& clients, const network::address& source,
                                                 const std::string_view& data) { c(clients, source, data); });
 }
 
 void server::on(const std::string& command, reply_callback callback)
 {
     this->manager_.on(command, [this, c = std::move(callback)](const network::address& source, const std::string_view& data) {
-        this->clients_.access([&](client_map& clients) { c(this->manager_, clients, source, data); });
+        this->clients_.access([&](client_map& clients) {
+            check_session(this->manager_, clients, source);
+            c(this->manager_, clients, source, data);
+        });
     });
 }
@@ -1,28 +1,38 @@
 #pragma once
 
-#include <unordered_map>
-
 #include <network/manager.hpp>
 #include <utils/concurrency.hpp>
 
-#include "client.hpp"
+#include "client_map.hpp"
+#include "damage_ledger.hpp"
+#include "session_key_pool.hpp"
+#include "world_state.hpp"
 
 class server
 {
   public:
-    using client_map = std::unordered_map<network::address, client>;
+    using client_map = ::client_map;
 
-    server(uint16_t port);
+    server(uint16_t port, const std::filesystem::path& session_directory);
 
     uint16_t get_ipv4_port() const;
     uint16_t get_ipv6_port() const;
 
+    // Quiet time after which a client's session lapses and it has to authenticate again
+    void set_session_timeout(std::chrono::milliseconds timeout);
+
     void run();
     void stop();
 
   private:
     utils::concurrency::container<client_map> clients_{};
 
+    // Only accessed under the clients_ lock
+    damage_ledger damage_ledger_{};
+    world_state world_state_{};
+
+    session_key_pool session_keys_{};
+
     std::atomic_bool stop_{false};
     network::manager manager_;
 
@@ -31,6 +41,6 @@ class server
     using callback = std::function<void(client_map&, const network::address&, const std::string_view&)>;
     void on(const std::string& command, callback callback);
 
-    using reply_callback = std::function<void(const network::manager&, client_map&, const network::address&, const std::string_view&)>;
+    using reply_callback = std::function<void(network::manager&, client_map&, const network::address&, const std::string_view&)>;
     void on(const std::string& command, reply_callback callback);
 };
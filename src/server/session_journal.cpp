@@ -0,0 +1,357 @@
+#include "std_include.hpp"
+#include "session_journal.hpp"
+
+#include <unordered_map>
+
+#include <network/protocol.hpp>
+#include <utils/byte_buffer.hpp>
+#include <utils/compression.hpp>
+#include <utils/hash.hpp>
+#include <utils/io.hpp>
+
+#include "console.hpp"
+
+namespace
+{
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x534D3357; // "W3MS"
+    constexpr uint32_t JOURNAL_MAGIC = 0x4A4D3357;  // "W3MJ"
+    constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Version 2 snapshots store the body as a compressed block container
+    constexpr uint32_t RAW_SNAPSHOT_VERSION = 1;
+    constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+    constexpr size_t JOURNAL_HEADER_SIZE = sizeof(JOURNAL_MAGIC) + sizeof(FORMAT_VERSION) + sizeof(uint64_t);
+
+    enum class record_type : uint8_t
+    {
+        fact = 1,
+        environment = 2,
+    };
+
+    uint32_t get_record_checksum(const uint8_t type, const std::string_view payload)
+    {
+        return static_cast<uint32_t>(utils::hash::compute(payload) ^ type);
+    }
+
+    // Replays journal records on top of a snapshot, keeping the snapshot's fact order
+    class state_builder
+    {
+      public:
+        explicit state_builder(network::world_snapshot& state)
+            : state_(state)
+        {
+            for (size_t i = 0; i < state.facts.size(); ++i)
+            {
+                this->indices_.emplace(state.facts[i].first, i);
+            }
+        }
+
+        void apply(const record_type type, const std::string_view payload)
+        {
+            utils::buffer_deserializer buffer(payload);
+
+            if (type == record_type::fact)
+            {
+                const auto length = buffer.read_varint();
+                if (length >= network::protocol::MAX_FACT_NAME_LENGTH)
+                {
+                    throw std::runtime_error("Fact name too long in session journal");
+                }
+
+                const auto name = buffer.read_view(static_cast<size_t>(length));
+                const auto value = buffer.read<int32_t>();
+
+                const auto [entry, inserted] = this->indices_.try_emplace(std::string(name), this->state_.facts.size());
+                if (inserted)
+                {
+                    this->state_.facts.emplace_back(entry->first, value);
+                }
+                else
+                {
+                    this->state_.facts[entry->second].second = value;
+                }
+            }
+            else if (type == record_type::environment)
+            {
+                this->state_.total_crowns = buffer.read<uint32_t>();
+                this->state_.game_time = buffer.read<uint32_t>();
+                this->state_.weather_id = buffer.read<uint16_t>();
+            }
+            else
+            {
+                throw std::runtime_error("Unknown session journal record");
+            }
+        }
+
+      private:
+        network::world_snapshot& state_;
+        std::unordered_map<std::string, size_t> indices_{};
+    };
+
+    bool read_snapshot_file(const std::filesystem::path& path, network::world_snapshot& snapshot, uint64_t& generation)
+    {
+        std::string data{};
+        if (!utils::io::read_file(path, &data))
+        {
+            return false;
+        }
+
+        utils::buffer_deserializer buffer(data);
+        if (buffer.read<uint32_t>() != SNAPSHOT_MAGIC)
+        {
+            throw std::runtime_error("Unsupported session snapshot");
+        }
+
+        const auto version = buffer.read<uint32_t>();
+        if (version != RAW_SNAPSHOT_VERSION && version != SNAPSHOT_VERSION)
+        {
+            throw std::runtime_error("Unsupported session snapshot");
+        }
+
+        generation = buffer.read<uint64_t>();
+        const auto checksum = buffer.read<uint64_t>();
+
+        std::string raw_body{};
+        auto body = buffer.get_remaining_view();
+
+        if (version == SNAPSHOT_VERSION)
+        {
+            if (!utils::compression::zlib::decompress_blocks(raw_body, body))
+            {
+                throw std::runtime_error("Failed to decompress session snapshot");
+            }
+
+            body = raw_body;
+        }
+
+        if (utils::hash::compute(body) != checksum)
+        {
+            throw std::runtime_error("Session snapshot checksum mismatch");
+        }
+
+        snapshot = network::deserialize_snapshot(body);
+        return true;
+    }
+
+    // Returns the size of the valid prefix, everything after it is a torn write
+    size_t replay_journal_file(const std::string& data, const uint64_t generation, state_builder& builder, size_t& record_count)
+    {
+        utils::buffer_deserializer buffer(data);
+
+        try
+        {
+            if (buffer.read<uint32_t>() != JOURNAL_MAGIC || buffer.read<uint32_t>() != FORMAT_VERSION ||
+                buffer.read<uint64_t>() != generation)
+            {
+                return 0;
+            }
+        }
+        catch (const std::exception&)
+        {
+            return 0;
+        }
+
+        size_t valid_size = buffer.get_offset();
+
+        while (buffer.get_remaining_size() > 0)
+        {
+            try
+            {
+                const auto type = buffer.read<uint8_t>();
+                const auto length = buffer.read_varint();
+                const auto payload = buffer.read_view(static_cast<size_t>(std::min<uint64_t>(length, buffer.get_remaining_size())));
+                if (payload.size() != length || buffer.read<uint32_t>() != get_record_checksum(type, payload))
+                {
+                    break;
+                }
+
+                builder.apply(static_cast<record_type>(type), payload);
+            }
+            catch (const std::exception&)
+            {
+                break;
+            }
+
+            valid_size = buffer.get_offset();
+            ++record_count;
+        }
+
+        return valid_size;
+    }
+}
+
+session_journal::session_journal(const std::filesystem::path& directory)
+    : snapshot_path_(directory / "session.snapshot"),
+      journal_path_(directory / "session.journal")
+{
+    if (!utils::io::directory_exists(directory) && !utils::io::create_directory(directory))
+    {
+        throw std::runtime_error("Failed to create session directory");
+    }
+
+    this->recover();
+}
+
+session_journal::~session_journal()
+{
+    this->flush();
+}
+
+void session_journal::recover()
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    if (!read_snapshot_file(this->snapshot_path_, this->recovered_, this->generation_))
+    {
+        this->generation_ = 0;
+    }
+
+    std::string journal{};
+    size_t record_count = 0;
+    size_t valid_size = 0;
+
+    if (utils::io::read_file(this->journal_path_, &journal))
+    {
+        state_builder builder(this->recovered_);
+        valid_size = replay_journal_file(journal, this->generation_, builder, record_count);
+    }
+
+    if (valid_size == 0)
+    {
+        this->start_journal();
+    }
+    else
+    {
+        // Cut off the torn tail so new records follow the last valid one
+        if (valid_size != journal.size())
+        {
+            std::filesystem::resize_file(this->journal_path_, valid_size);
+        }
+
+        this->stream_.open(this->journal_path_, std::ios::binary | std::ios::out | std::ios::app);
+        this->journal_size_ = valid_size;
+    }
+
+    if (!this->stream_.is_open())
+    {
+        throw std::runtime_error("Failed to open session journal");
+    }
+
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+    console::log("Recovered session: %zu facts, %zu journal records in %lld us", this->recovered_.facts.size(), record_count,
+                 static_cast<long long>(duration.count()));
+}
+
+void session_journal::start_journal()
+{
+    this->stream_.close();
+    this->stream_.open(this->journal_path_, std::ios::binary | std::ios::out | std::ios::trunc);
+
+    utils::buffer_serializer header{};
+    header.write(JOURNAL_MAGIC);
+    header.write(FORMAT_VERSION);
+    header.write(this->generation_);
+
+    this->pending_.clear();
+    this->stream_.write(header.get_buffer().data(), static_cast<std::streamsize>(header.size()));
+    this->stream_.flush();
+    this->journal_size_ = JOURNAL_HEADER_SIZE;
+}
+
+void session_journal::append_record(const uint8_t type, const std::string_view payload)
+{
+    // The serializer would clear pending_, so the framing goes through small fixed buffers
+    std::array<char, sizeof(type) + 10> header_storage{};
+    utils::buffer_serializer header(header_storage);
+    header.write(type);
+    header.write_varint(payload.size());
+
+    const auto checksum = get_record_checksum(type, payload);
+
+    this->pending_.append(header.get_view());
+    this->pending_.append(payload);
+    this->pending_.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+}
+
+void session_journal::append_fact(const std::string_view name, const int32_t value)
+{
+    std::array<char, network::protocol::MAX_FACT_NAME_LENGTH + 16> storage{};
+    utils::buffer_serializer payload(storage);
+    payload.write_varint(name.size());
+    payload.write(name.data(), name.size());
+    payload.write(value);
+
+    this->append_record(static_cast<uint8_t>(record_type::fact), payload.get_view());
+}
+
+void session_journal::append_environment(const uint32_t total_crowns, const uint32_t game_time, const uint16_t weather_id)
+{
+    std::array<char, sizeof(total_crowns) + sizeof(game_time) + sizeof(weather_id)> storage{};
+    utils::buffer_serializer payload(storage);
+    payload.write(total_crowns);
+    payload.write(game_time);
+    payload.write(weather_id);
+
+    this->append_record(static_cast<uint8_t>(record_type::environment), payload.get_view());
+}
+
+void session_journal::flush()
+{
+    if (this->pending_.empty())
+    {
+        return;
+    }
+
+    this->stream_.write(this->pending_.data(), static_cast<std::streamsize>(this->pending_.size()));
+    this->stream_.flush();
+
+    this->journal_size_ += this->pending_.size();
+    this->pending_.clear();
+}
+
+void session_journal::compact(const network::world_snapshot& snapshot)
+{
+    this->flush();
+
+    const auto body = network::serialize_snapshot(snapshot);
+    const auto generation = this->generation_ + 1;
+
+    // Compaction runs in the server frame, so favour speed over size
+    const auto compressed_body = utils::compression::zlib::compress_blocks(body, utils::compression::zlib::fastest_level);
+    if (compressed_body.empty())
+    {
+        console::error("Failed to compress session snapshot");
+        return;
+    }
+
+    utils::buffer_serializer buffer{};
+    buffer.reserve(compressed_body.size() + 24);
+    buffer.write(SNAPSHOT_MAGIC);
+    buffer.write(SNAPSHOT_VERSION);
+    buffer.write(generation);
+    buffer.write(utils::hash::compute(body));
+    buffer.write(compressed_body.data(), compressed_body.size());
+
+    // Replace the snapshot atomically, a crash before the rename leaves the old snapshot and journal intact
+    auto temporary_path = this->snapshot_path_;
+    temporary_path += ".tmp";
+
+    if (!utils::io::write_file(temporary_path, buffer.get_buffer()))
+    {
+        console::error("Failed to write session snapshot");
+        return;
+    }
+
+    std::error_code ec{};
+    std::filesystem::rename(temporary_path, this->snapshot_path_, ec);
+    if (ec)
+    {
+        console::error("Failed to replace session snapshot: %s", ec.message().data());
+        return;
+    }
+
+    // A crash before the new journal header lands leaves a journal of the old generation, which is ignored
+    this->generation_ = generation;
+    this->start_journal();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include <network/world_snapshot.hpp>
+
+// Append-only record of the session's world state, so a restarted server picks up where it died.
+// Changes are buffered and written once per server frame. Once the journal outgrows COMPACTION_THRESHOLD it is
+// folded into a flat snapshot file and started over.
+//
+// session.snapshot: magic, version, generation, checksum of the raw body, serialize_snapshot() body compressed
+//                   with zlib::compress_blocks
+// session.journal:  magic, version, generation, then records of type, varint length, payload, checksum
+//
+// A journal only extends the snapshot of the same generation. Records after the first torn or corrupt one are
+// dropped, they can only stem from a crash in the middle of a write.
+class session_journal
+{
+  public:
+    static constexpr size_t COMPACTION_THRESHOLD = 4 * 1024 * 1024;
+
+    // Throws if the journal can't be opened for writing
+    explicit session_journal(const std::filesystem::path& directory);
+
+    session_journal(session_journal&&) = delete;
+    session_journal(const session_journal&) = delete;
+    session_journal& operator=(session_journal&&) = delete;
+    session_journal& operator=(const session_journal&) = delete;
+
+    ~session_journal();
+
+    // State as of the last flushed record, read once at startup
+    const network::world_snapshot& get_recovered_state() const
+    {
+        return this->recovered_;
+    }
+
+    void append_fact(std::string_view name, int32_t value);
+    void append_environment(uint32_t total_crowns, uint32_t game_time, uint16_t weather_id);
+
+    void flush();
+
+    bool needs_compaction() const
+    {
+        return this->journal_size_ >= COMPACTION_THRESHOLD;
+    }
+
+    // The snapshot has to include every record appended so far
+    void compact(const network::world_snapshot& snapshot);
+
+  private:
+    std::filesystem::path snapshot_path_{};
+    std::filesystem::path journal_path_{};
+
+    std::ofstream stream_{};
+    std::string pending_{};
+    size_t journal_size_{};
+    uint64_t generation_{};
+
+    network::world_snapshot recovered_{};
+
+    void recover();
+    void start_journal();
+    void append_record(uint8_t type, std::string_view payload);
+};
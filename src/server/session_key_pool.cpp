@@ -0,0 +1,58 @@
+#include "std_include.hpp"
+#include "session_key_pool.hpp"
+
+#include <utils/thread.hpp>
+
+session_key_pool::session_key_pool()
+{
+    this->thread_ = utils::thread::create_named_jthread("Session Keys", [this](const std::stop_token& stop_token) { this->run(stop_token); });
+}
+
+session_key_pool::~session_key_pool()
+{
+    this->thread_.request_stop();
+    this->wake_.notify_all();
+}
+
+std::optional<utils::cryptography::ecc::key> session_key_pool::take()
+{
+    std::optional<utils::cryptography::ecc::key> key{};
+
+    {
+        std::lock_guard _{this->mutex_};
+        if (this->keys_.empty())
+        {
+            return std::nullopt;
+        }
+
+        key = std::move(this->keys_.front());
+        this->keys_.pop_front();
+    }
+
+    this->wake_.notify_one();
+    return key;
+}
+
+void session_key_pool::run(const std::stop_token& stop_token)
+{
+    while (true)
+    {
+        {
+            std::unique_lock lock{this->mutex_};
+            if (!this->wake_.wait(lock, stop_token, [this] { return this->keys_.size() < CAPACITY; }))
+            {
+                return;
+            }
+        }
+
+        // Same curve as the client identity keys. A generator of its own, seeded from the shared one, keeps the shared
+        // one free for the nonces the dispatcher draws meanwhile.
+        std::string entropy(64, '\0');
+        utils::cryptography::random::get_data(entropy.data(), entropy.size());
+
+        auto key = utils::cryptography::ecc::generate_key(512, entropy);
+
+        std::lock_guard _{this->mutex_};
+        this->keys_.push_back(std::move(key));
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <utils/cryptography.hpp>
+
+// Ephemeral keys for the session key exchange, generated ahead of time on a thread of their own.
+// A P-521 key takes milliseconds to generate, far too long for the network dispatcher while it holds the clients lock.
+// Handshakes take keys without waiting, so a flood of new source addresses only drains the pool and can't stall the
+// relays. Whoever finds it empty simply isn't answered yet and gets a key with one of its next packets.
+class session_key_pool
+{
+  public:
+    static constexpr size_t CAPACITY = 8;
+
+    session_key_pool();
+    ~session_key_pool();
+
+    session_key_pool(session_key_pool&&) = delete;
+    session_key_pool(const session_key_pool&) = delete;
+    session_key_pool& operator=(session_key_pool&&) = delete;
+    session_key_pool& operator=(const session_key_pool&) = delete;
+
+    // Nothing if the pool is drained, never blocks on key generation
+    std::optional<utils::cryptography::ecc::key> take();
+
+  private:
+    std::mutex mutex_{};
+    std::condition_variable_any wake_{};
+    std::deque<utils::cryptography::ecc::key> keys_{};
+
+    std::jthread thread_{};
+
+    void run(const std::stop_token& stop_token);
+};
@@ -0,0 +1,208 @@
+#include "std_include.hpp"
+#include "world_state.hpp"
+
+namespace
+{
+    // Saves can be loaded, so game time moves both ways
+    uint32_t get_distance(const uint32_t a, const uint32_t b)
+    {
+        return a > b ? a - b : b - a;
+    }
+}
+
+void world_state::set_fact(const std::string_view name, const int32_t value)
+{
+    auto entry = this->facts_.find(name);
+    if (entry == this->facts_.end())
+    {
+        if (this->facts_.size() >= network::MAX_SNAPSHOT_FACTS)
+        {
+            return;
+        }
+
+        this->add_fact(std::string(name), value);
+    }
+    else if (entry->second == value)
+    {
+        return;
+    }
+    else
+    {
+        this->fact_tree_.update(network::protocol::get_fact_hash(name), network::protocol::get_fact_state(entry->second),
+                                network::protocol::get_fact_state(value));
+        entry->second = value;
+    }
+
+    this->invalidate_snapshot();
+
+    if (this->journal_)
+    {
+        this->journal_->append_fact(name, value);
+    }
+}
+
+void world_state::apply_fact(const network::protocol::fact_packet& fact)
+{
+    const auto name = network::protocol::view_string(fact.fact_name);
+    const auto current = this->get_fact(name).value_or(0);
+
+    this->set_fact(name, network::protocol::apply_fact_update(current, fact.value, fact.update));
+}
+
+std::optional<int32_t> world_state::get_fact(const std::string_view name) const
+{
+    const auto entry = this->facts_.find(name);
+    if (entry == this->facts_.end())
+    {
+        return std::nullopt;
+    }
+
+    return entry->second;
+}
+
+void world_state::update_environment(const network::protocol::heartbeat_packet& heartbeat)
+{
+    this->game_time_ = heartbeat.game_time;
+
+    const auto game_time_moved = get_distance(this->game_time_, this->recorded_game_time_) >= GAME_TIME_RESOLUTION;
+
+    if (this->total_crowns_ == heartbeat.total_crowns && this->weather_id_ == heartbeat.weather_id && !game_time_moved)
+    {
+        return;
+    }
+
+    this->total_crowns_ = heartbeat.total_crowns;
+    this->recorded_game_time_ = this->game_time_;
+    this->weather_id_ = heartbeat.weather_id;
+    this->invalidate_snapshot();
+
+    if (this->journal_)
+    {
+        this->journal_->append_environment(this->total_crowns_, this->game_time_, this->weather_id_);
+    }
+}
+
+void world_state::open_journal(const std::filesystem::path& directory)
+{
+    this->journal_.reset();
+    this->journal_.emplace(directory);
+
+    const auto& state = this->journal_->get_recovered_state();
+    this->total_crowns_ = state.total_crowns;
+    this->game_time_ = state.game_time;
+    this->recorded_game_time_ = state.game_time;
+    this->weather_id_ = state.weather_id;
+
+    this->facts_.clear();
+    this->facts_.reserve(state.facts.size());
+    this->fact_hashes_.clear();
+    this->fact_tree_.clear();
+
+    for (const auto& [name, value] : state.facts)
+    {
+        if (!this->facts_.contains(name))
+        {
+            this->add_fact(name, value);
+        }
+    }
+
+    this->invalidate_snapshot();
+}
+
+network::protocol::world_state_bucket_packet world_state::get_bucket_page(const size_t bucket, const uint32_t offset) const
+{
+    network::protocol::world_state_bucket_packet page{};
+    page.bucket = static_cast<uint16_t>(bucket);
+    page.offset = offset;
+
+    const auto first_hash = static_cast<uint32_t>(bucket << 24);
+    const auto begin = this->fact_hashes_.lower_bound(first_hash);
+    const auto end = this->fact_hashes_.upper_bound(first_hash | 0xFFFFFF);
+
+    page.fact_count = static_cast<uint32_t>(std::distance(begin, end));
+
+    auto entry = begin;
+    for (uint32_t i = 0; i < offset && entry != end; ++i)
+    {
+        ++entry;
+    }
+
+    for (; entry != end && page.facts.size() < network::protocol::MAX_BUCKET_PAGE_SIZE; ++entry)
+    {
+        auto& fact = page.facts.emplace_back();
+        network::protocol::copy_string(fact.fact_name, entry->second);
+        fact.value = this->facts_.find(entry->second)->second;
+        fact.update = network::protocol::fact_update::set;
+    }
+
+    return page;
+}
+
+void world_state::flush_journal()
+{
+    if (!this->journal_)
+    {
+        return;
+    }
+
+    this->journal_->flush();
+
+    if (this->journal_->needs_compaction())
+    {
+        this->journal_->compact(this->create_snapshot());
+    }
+}
+
+std::shared_ptr<const network::snapshot_transfer> world_state::get_cached_snapshot() const
+{
+    return this->snapshot_;
+}
+
+world_state::pending_snapshot world_state::prepare_snapshot()
+{
+    pending_snapshot pending{};
+    pending.id = this->next_snapshot_id_++;
+    pending.version = this->version_;
+    pending.snapshot = this->create_snapshot();
+
+    return pending;
+}
+
+void world_state::cache_snapshot(const pending_snapshot& pending, std::shared_ptr<const network::snapshot_transfer> snapshot)
+{
+    if (pending.version == this->version_)
+    {
+        this->snapshot_ = std::move(snapshot);
+    }
+}
+
+network::world_snapshot world_state::create_snapshot() const
+{
+    network::world_snapshot snapshot{};
+    snapshot.total_crowns = this->total_crowns_;
+    snapshot.game_time = this->game_time_;
+    snapshot.weather_id = this->weather_id_;
+    snapshot.facts.reserve(this->facts_.size());
+
+    for (const auto& [name, value] : this->facts_)
+    {
+        snapshot.facts.emplace_back(name, value);
+    }
+
+    return snapshot;
+}
+
+void world_state::add_fact(std::string name, const int32_t value)
+{
+    const auto fact_hash = network::protocol::get_fact_hash(name);
+    const auto entry = this->facts_.emplace(std::move(name), value).first;
+
+    this->fact_hashes_.emplace(fact_hash, entry->first);
+    this->fact_tree_.insert(fact_hash, network::protocol::get_fact_state(value));
+}
+
+void world_state::invalidate_snapshot()
+{
+    ++this->version_;
+    this->snapshot_.reset();
+}
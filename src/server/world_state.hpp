@@ -0,0 +1,108 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <network/protocol.hpp>
+#include <network/world_snapshot.hpp>
+#include <utils/hash.hpp>
+#include <utils/merkle_tree.hpp>
+
+#include "session_journal.hpp"
+
+// The session's shared world as seen through the fact and heartbeat relays.
+// Late joiners receive it as one compressed snapshot instead of only the facts broadcast after they connected.
+// Facts are stored as the value every connected peer ends up with: a SetFact replaces it, an AddFact adds to it.
+// With a journal attached every change is persisted, so the state survives a server restart.
+// The facts are also kept in a merkle tree, so clients whose heartbeat root differs can find and resync the facts they
+// lack without a full snapshot.
+class world_state
+{
+  public:
+    // Restores the state recorded in the directory and journals all further changes there
+    void open_journal(const std::filesystem::path& directory);
+
+    // Writes the changes of this frame, compacts the journal once it grew too large
+    void flush_journal();
+
+    // New names beyond MAX_SNAPSHOT_FACTS are dropped, existing ones still update
+    void set_fact(std::string_view name, int32_t value);
+
+    // An add is a delta on the stored value, a fact that isn't stored yet starts at 0
+    void apply_fact(const network::protocol::fact_packet& fact);
+
+    std::optional<int32_t> get_fact(std::string_view name) const;
+    // Game time advances with every heartbeat, on its own it only invalidates the snapshot and gets journaled
+    // once it moved by GAME_TIME_RESOLUTION
+    void update_environment(const network::protocol::heartbeat_packet& heartbeat);
+
+    // The snapshot is compressed once per change, joiners share the result and keep streaming it even after the state
+    // moved on. Compressing a large world takes a while, so the state is copied with prepare_snapshot and compressed
+    // by the caller without holding its lock, then handed back to cache_snapshot.
+    struct pending_snapshot
+    {
+        uint64_t id{};
+        uint64_t version{};
+        network::world_snapshot snapshot{};
+    };
+
+    // Null if the state changed since the last snapshot was built
+    std::shared_ptr<const network::snapshot_transfer> get_cached_snapshot() const;
+    pending_snapshot prepare_snapshot();
+
+    // Dropped if the state changed since the snapshot was prepared
+    void cache_snapshot(const pending_snapshot& pending, std::shared_ptr<const network::snapshot_transfer> snapshot);
+
+    size_t get_fact_count() const
+    {
+        return this->facts_.size();
+    }
+
+    const utils::merkle_tree& get_fact_tree() const
+    {
+        return this->fact_tree_;
+    }
+
+    // Up to MAX_BUCKET_PAGE_SIZE facts of a bucket starting at offset, ordered by fact hash
+    network::protocol::world_state_bucket_packet get_bucket_page(size_t bucket, uint32_t offset) const;
+
+  private:
+    struct string_hash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const std::string_view text) const noexcept
+        {
+            return static_cast<size_t>(utils::hash::compute(text));
+        }
+    };
+
+    // One in-game hour
+    static constexpr uint32_t GAME_TIME_RESOLUTION = 60 * 60;
+
+    std::unordered_map<std::string, int32_t, string_hash, std::equal_to<>> facts_{};
+
+    // Names point into facts_, whose nodes never move
+    std::multimap<uint32_t, std::string_view> fact_hashes_{};
+    utils::merkle_tree fact_tree_{};
+    uint32_t total_crowns_{};
+    uint32_t game_time_{};
+    uint32_t recorded_game_time_{};
+    uint16_t weather_id_{};
+
+    // Bumped with every change that invalidates the snapshot
+    uint64_t version_{};
+    uint64_t next_snapshot_id_{1};
+    std::shared_ptr<const network::snapshot_transfer> snapshot_{};
+
+    std::optional<session_journal> journal_{};
+
+    network::world_snapshot create_snapshot() const;
+    void add_fact(std::string name, int32_t value);
+    void invalidate_snapshot();
+};
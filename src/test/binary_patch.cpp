@@ -0,0 +1,112 @@
+#include "test.hpp"
+
+#include <utils/binary_patch.hpp>
+#include <utils/compression.hpp>
+
+#include <random>
+#include <sstream>
+#include <string>
+
+// Block containers and patches whose operations span several container blocks, which apply_patch reads one at a time
+
+namespace
+{
+    std::string generate_random(std::mt19937_64& random, const size_t size)
+    {
+        std::string data(size, '\0');
+        for (auto& c : data)
+        {
+            c = static_cast<char>(random());
+        }
+
+        return data;
+    }
+
+    bool apply(const std::string& base, const std::string_view patch, std::string& target)
+    {
+        std::istringstream base_stream(base);
+        target.clear();
+
+        return utils::binary_patch::apply_patch(base_stream, patch, [&](const std::string_view data) {
+            target.append(data);
+            return true;
+        });
+    }
+}
+
+TEST_CASE(compression_blocks)
+{
+    using namespace utils::compression::zlib;
+
+    std::mt19937_64 random(0x5733);
+
+    // Compressible runs between incompressible ones, so some blocks are stored as they are
+    std::string data{};
+    while (data.size() < 5 * 64 * 1024 + 123)
+    {
+        data += generate_random(random, 20000);
+        data.append(30000, static_cast<char>(random()));
+    }
+
+    const auto container = compress_blocks(data, fastest_level, 64 * 1024);
+    CHECK(is_block_container(container));
+
+    for (const size_t thread_count : {size_t{0}, size_t{1}, size_t{4}})
+    {
+        std::string output{};
+        CHECK(decompress_blocks(output, container, SIZE_MAX, thread_count) && output == data);
+        CHECK(compress_blocks(data, fastest_level, 64 * 1024, thread_count) == container);
+    }
+
+    std::string output{};
+    CHECK(!decompress_blocks(output, container, data.size() - 1));
+    CHECK(!decompress_blocks(output, std::string_view(container).substr(0, container.size() - 1)));
+
+    std::string corrupt = container;
+    corrupt[corrupt.size() / 2] ^= 0x55;
+    CHECK(!decompress_blocks(output, corrupt) && output.empty());
+
+    block_reader reader(container);
+    std::string streamed{};
+    for (std::string block{}; reader.read_next(block);)
+    {
+        streamed += block;
+    }
+
+    CHECK(reader.is_complete() && streamed == data);
+
+    // Inflating into caller memory only succeeds at the exact size
+    const auto compressed = compress(data);
+    std::string exact(data.size(), '\0');
+    decompressor decompressor{};
+    CHECK(decompressor.decompress(std::span(exact), compressed) && exact == data);
+    CHECK(!decompressor.decompress(std::span(exact).first(data.size() - 1), compressed));
+    CHECK(!decompressor.decompress(std::span(exact.data(), exact.size()), std::string_view(compressed).substr(1)));
+}
+
+TEST_CASE(binary_patch_across_blocks)
+{
+    std::mt19937_64 random(0x5733);
+
+    const auto base = generate_random(random, 2 * 1024 * 1024);
+
+    // Inserts larger than a container block, copies between them and short operations straddling block ends
+    auto target = generate_random(random, 1536 * 1024);
+    target += base.substr(1000, 300000);
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        target += generate_random(random, 40);
+        target += base.substr(random() % (base.size() - 100), 64);
+    }
+
+    target += generate_random(random, 1024 * 1024);
+
+    const auto patch = utils::binary_patch::create_patch(base, target);
+    CHECK(utils::binary_patch::get_target_size(patch) == target.size());
+
+    std::string patched{};
+    CHECK(apply(base, patch, patched) && patched == target);
+
+    CHECK(!apply(base, std::string_view(patch).substr(0, patch.size() - 9), patched));
+    CHECK(!apply(base.substr(0, base.size() / 2), patch, patched));
+}
@@ -0,0 +1,147 @@
+#include "test.hpp"
+
+#include <server/client_map.hpp>
+
+#include <algorithm>
+#include <random>
+
+// Random churn against client_map, checked step by step against a plain model of who is connected and authenticated
+
+namespace
+{
+    using clock = client_map::clock;
+
+    constexpr size_t ADDRESS_COUNT = 24;
+    constexpr size_t GUID_COUNT = 8;
+    constexpr size_t STEP_COUNT = 20000;
+
+    struct model_client
+    {
+        network::address address{};
+        uint64_t guid{};
+        bool authenticated{};
+        clock::time_point last_packet{};
+    };
+
+    model_client* find_model_client(std::vector<model_client>& model, const network::address& address)
+    {
+        const auto entry = std::find_if(model.begin(), model.end(), [&](const model_client& client) { return client.address == address; });
+        return entry == model.end() ? nullptr : &*entry;
+    }
+
+    void check_model(const client_map& clients, const std::vector<model_client>& model)
+    {
+        CHECK(clients.is_consistent());
+        CHECK(clients.size() == model.size());
+
+        for (const auto& client : model)
+        {
+            const auto index = clients.find(client.address);
+            CHECK(index != client_map::npos);
+            CHECK(clients.get_address(index) == client.address);
+            CHECK(clients.get_player(index).guid == client.guid);
+            CHECK(clients.is_authenticated(index) == client.authenticated);
+        }
+
+        for (uint64_t guid = 1; guid <= GUID_COUNT; ++guid)
+        {
+            const auto owner = std::find_if(model.begin(), model.end(),
+                                            [&](const model_client& client) { return client.authenticated && client.guid == guid; });
+
+            const auto index = clients.find_by_guid(guid);
+            if (owner == model.end())
+            {
+                CHECK(index == client_map::npos);
+            }
+            else
+            {
+                CHECK(index != client_map::npos);
+                CHECK(clients.get_address(index) == owner->address);
+            }
+        }
+    }
+}
+
+TEST_CASE(client_map_churn)
+{
+    std::mt19937_64 random(0x5733);
+
+    std::vector<network::address> addresses{};
+    for (size_t i = 0; i < ADDRESS_COUNT; ++i)
+    {
+        addresses.emplace_back("127.0.0." + std::to_string(1 + i % 4) + ":" + std::to_string(28960 + i));
+    }
+
+    client_map clients{};
+    std::vector<model_client> model{};
+
+    for (size_t step = 0; step < STEP_COUNT; ++step)
+    {
+        const auto now = clock::time_point{} + std::chrono::milliseconds(10 * step);
+        const auto operation = random() % 10;
+
+        if (operation < 6)
+        {
+            // State update, creates the client or changes its guid now and then
+            const auto& address = addresses[random() % addresses.size()];
+
+            game::player player{};
+            player.guid = 1 + random() % GUID_COUNT;
+
+            auto* client = find_model_client(model, address);
+            if (!client)
+            {
+                client = &model.emplace_back();
+                client->address = address;
+            }
+            else if (client->guid != player.guid)
+            {
+                client->authenticated = false;
+            }
+
+            client->guid = player.guid;
+            client->last_packet = now;
+
+            clients.update_state(clients.get_or_create(address), player, now);
+        }
+        else if (operation < 9)
+        {
+            // Authentication or re-authentication, the latest one of a guid wins
+            if (model.empty())
+            {
+                continue;
+            }
+
+            auto& client = model[random() % model.size()];
+            for (auto& other : model)
+            {
+                if (other.authenticated && other.guid == client.guid)
+                {
+                    other.authenticated = false;
+                }
+            }
+
+            client.authenticated = true;
+            client.last_packet = now;
+
+            // client_map only tracks whether a key is present, an empty one skips the costly key generation
+            clients.authenticate(clients.find(client.address), {}, now);
+        }
+        else
+        {
+            const auto cutoff = now - std::chrono::milliseconds(random() % 500);
+
+            size_t expired = 0;
+            std::erase_if(model, [&](const model_client& client) { return client.last_packet < cutoff; });
+
+            const auto count = clients.expire(cutoff, [&](const network::address& address) {
+                CHECK(!find_model_client(model, address));
+                ++expired;
+            });
+
+            CHECK(count == expired);
+        }
+
+        check_model(clients, model);
+    }
+}
@@ -0,0 +1,109 @@
+#include "test.hpp"
+
+#include <server/std_include.hpp>
+#include <server/damage_ledger.hpp>
+
+#include <limits>
+
+// Attacks folded into one update per NPC and tick: each player only receives the hits of the others, a killing blow
+// settles the NPC for the rest of the tick and damage that can't come from the game is rejected
+
+namespace
+{
+    constexpr uint64_t GERALT = 1;
+    constexpr uint64_t CIRI = 2;
+    constexpr uint64_t LAMBERT = 3;
+
+    network::protocol::attack_packet make_attack(const std::string_view target_tag, const float damage, const bool force_kill = false)
+    {
+        network::protocol::attack_packet attack{};
+        network::protocol::copy_string(attack.target_tag, target_tag);
+        attack.damage_amount = damage;
+        attack.force_kill = force_kill;
+
+        return attack;
+    }
+
+    damage_ledger::entry_map flush(damage_ledger& ledger)
+    {
+        damage_ledger::entry_map entries{};
+        ledger.flush([&](const std::string& target_tag, const damage_ledger::entry& npc) { entries.emplace(target_tag, npc); });
+
+        return entries;
+    }
+}
+
+TEST_CASE(damage_ledger_remote_share)
+{
+    damage_ledger ledger{};
+    CHECK(ledger.record(GERALT, make_attack("drowner_001", 10.0f)));
+    CHECK(ledger.record(CIRI, make_attack("drowner_001", 25.0f)));
+    CHECK(ledger.record(GERALT, make_attack("drowner_001", 5.0f)));
+    CHECK(ledger.record(CIRI, make_attack("nekker_002", 7.0f)));
+
+    const auto entries = flush(ledger);
+    CHECK(ledger.empty());
+    CHECK(entries.size() == 2);
+
+    const auto& drowner = entries.at("drowner_001");
+    CHECK(drowner.total_damage == 40.0f);
+    CHECK(drowner.hit_count == 3);
+
+    const auto geralt_share = drowner.get_remote_share(GERALT);
+    CHECK(geralt_share.damage == 25.0f);
+    CHECK(geralt_share.hits == 1);
+
+    const auto ciri_share = drowner.get_remote_share(CIRI);
+    CHECK(ciri_share.damage == 15.0f);
+    CHECK(ciri_share.hits == 2);
+
+    // A player who didn't take part sees every hit
+    const auto lambert_share = drowner.get_remote_share(LAMBERT);
+    CHECK(lambert_share.damage == 40.0f);
+    CHECK(lambert_share.hits == 3);
+
+    // Nothing of the nekker is Ciri's to apply again
+    const auto own_share = entries.at("nekker_002").get_remote_share(CIRI);
+    CHECK(own_share.damage == 0.0f);
+    CHECK(own_share.hits == 0);
+}
+
+TEST_CASE(damage_ledger_force_kill)
+{
+    damage_ledger ledger{};
+    CHECK(ledger.record(GERALT, make_attack("drowner_001", 10.0f)));
+    CHECK(ledger.record(CIRI, make_attack("drowner_001", 30.0f, true)));
+
+    // Hits after the killing blow are accepted but change nothing
+    CHECK(ledger.record(GERALT, make_attack("drowner_001", 50.0f)));
+    CHECK(ledger.record(LAMBERT, make_attack("drowner_001", 20.0f, true)));
+
+    const auto entries = flush(ledger);
+    const auto& drowner = entries.at("drowner_001");
+
+    CHECK(drowner.killed);
+    CHECK(drowner.killer_guid == CIRI);
+    CHECK(drowner.total_damage == 40.0f);
+    CHECK(drowner.hit_count == 2);
+    CHECK(drowner.contributions.size() == 2);
+    CHECK(drowner.get_remote_share(GERALT).damage == 30.0f);
+
+    // The next tick starts over
+    CHECK(ledger.record(GERALT, make_attack("drowner_001", 5.0f)));
+    CHECK(!flush(ledger).at("drowner_001").killed);
+}
+
+TEST_CASE(damage_ledger_invalid_damage)
+{
+    damage_ledger ledger{};
+    CHECK(!ledger.record(GERALT, make_attack("drowner_001", std::numeric_limits<float>::quiet_NaN())));
+    CHECK(!ledger.record(GERALT, make_attack("drowner_001", std::numeric_limits<float>::infinity())));
+    CHECK(!ledger.record(GERALT, make_attack("drowner_001", -std::numeric_limits<float>::infinity())));
+    CHECK(!ledger.record(GERALT, make_attack("drowner_001", -1.0f)));
+    CHECK(!ledger.record(GERALT, make_attack("", 10.0f)));
+    CHECK(ledger.empty());
+
+    // Zero damage is a hit that missed, not an error
+    CHECK(ledger.record(GERALT, make_attack("drowner_001", 0.0f)));
+    CHECK(!ledger.empty());
+}
@@ -0,0 +1,196 @@
+#include "test.hpp"
+
+#include <client/module/fact_cache.hpp>
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// The flat LRU fact cache: eviction follows registration order, deleting from the middle of a probe chain keeps the
+// rest of the chain reachable without tombstones, and a full table keeps working through evictions and resizes
+
+namespace
+{
+    using quest_sync::fact_cache;
+    using quest_sync::quest_fact;
+
+    constexpr auto ignore_eviction = [](const quest_fact&) {};
+
+    std::vector<uint32_t> get_order(const fact_cache& cache)
+    {
+        std::vector<uint32_t> order{};
+        cache.for_each([&](const quest_fact& fact) { order.push_back(fact.fact_hash); });
+
+        return order;
+    }
+
+    void insert(fact_cache& cache, const uint32_t fact_hash, const int32_t value)
+    {
+        cache.emplace(fact_hash, ignore_eviction).first->value = value;
+    }
+
+    // Keys whose home slot in a table of slot_count slots is the same, so they form one probe chain
+    std::vector<uint32_t> find_colliding_keys(const size_t slot_count, const size_t count)
+    {
+        std::vector<uint32_t> keys{};
+        for (uint32_t key = 1; keys.size() < count; ++key)
+        {
+            if (((key * 0x9E3779B97F4A7C15ull) >> 32 & (slot_count - 1)) == 3)
+            {
+                keys.push_back(key);
+            }
+        }
+
+        return keys;
+    }
+}
+
+TEST_CASE(fact_cache_eviction_order)
+{
+    fact_cache cache(4);
+
+    for (uint32_t key = 1; key <= 4; ++key)
+    {
+        CHECK(cache.emplace(key, ignore_eviction).second);
+    }
+
+    CHECK((get_order(cache) == std::vector<uint32_t>{4, 3, 2, 1}));
+
+    // Registering a known fact again makes it the most recent one
+    CHECK(!cache.emplace(1, ignore_eviction).second);
+    CHECK((get_order(cache) == std::vector<uint32_t>{1, 4, 3, 2}));
+
+    std::vector<uint32_t> evicted{};
+    const auto on_evict = [&](const quest_fact& fact) { evicted.push_back(fact.fact_hash); };
+
+    cache.emplace(5, on_evict);
+    cache.emplace(6, on_evict);
+
+    CHECK((evicted == std::vector<uint32_t>{2, 3}));
+    CHECK((get_order(cache) == std::vector<uint32_t>{6, 5, 1, 4}));
+    CHECK(!cache.find(2) && !cache.find(3));
+    CHECK(cache.size() == 4);
+
+    // Lookups don't count as use
+    CHECK(cache.find(4));
+    cache.emplace(7, on_evict);
+    CHECK(evicted.back() == 4);
+}
+
+TEST_CASE(fact_cache_backward_shift)
+{
+    // A limit of 8 gives 16 slots
+    fact_cache cache(8);
+    const auto chain = find_colliding_keys(16, 6);
+
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        insert(cache, chain[i], static_cast<int32_t>(i));
+    }
+
+    // Removing from the middle and the head of the chain shifts the later members up
+    cache.erase(chain[2]);
+    cache.erase(chain[0]);
+
+    CHECK(!cache.find(chain[0]) && !cache.find(chain[2]));
+    for (const auto i : {1, 3, 4, 5})
+    {
+        CHECK(cache.find(chain[i]) && cache.find(chain[i])->value == i);
+    }
+
+    CHECK((get_order(cache) == std::vector<uint32_t>{chain[5], chain[4], chain[3], chain[1]}));
+
+    // A missing key of the same chain stops at its end
+    CHECK(!cache.find(find_colliding_keys(16, 7).back()));
+
+    // Erasing a missing key does nothing
+    cache.erase(chain[0]);
+    CHECK(cache.size() == 4);
+
+    // Freed slots are reused
+    insert(cache, chain[0], 10);
+    insert(cache, chain[2], 12);
+    CHECK(cache.find(chain[0])->value == 10 && cache.find(chain[2])->value == 12);
+    CHECK(cache.size() == 6);
+}
+
+TEST_CASE(fact_cache_full_table)
+{
+    fact_cache cache(16);
+    const auto chain = find_colliding_keys(32, 24);
+
+    // Every key probes the same chain, a full table wraps the eviction through it
+    std::vector<uint32_t> evicted{};
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        cache.emplace(chain[i], [&](const quest_fact& fact) { evicted.push_back(fact.fact_hash); }).first->value = static_cast<int32_t>(i);
+        CHECK(cache.size() == std::min<size_t>(i + 1, 16));
+    }
+
+    CHECK((evicted == std::vector<uint32_t>(chain.begin(), chain.begin() + 8)));
+    for (size_t i = 8; i < chain.size(); ++i)
+    {
+        CHECK(cache.find(chain[i]) && cache.find(chain[i])->value == static_cast<int32_t>(i));
+    }
+
+    // Shrinking evicts the least recent facts and keeps the order of the rest
+    evicted.clear();
+    cache.set_limit(4, [&](const quest_fact& fact) { evicted.push_back(fact.fact_hash); });
+
+    CHECK(evicted.size() == 12 && evicted.front() == chain[8] && evicted.back() == chain[19]);
+    CHECK((get_order(cache) == std::vector<uint32_t>{chain[23], chain[22], chain[21], chain[20]}));
+
+    cache.set_limit(64);
+    CHECK((get_order(cache) == std::vector<uint32_t>{chain[23], chain[22], chain[21], chain[20]}));
+    CHECK(cache.find(chain[20])->value == 20);
+
+    cache.clear();
+    CHECK(cache.size() == 0 && !cache.find(chain[23]));
+    CHECK(get_order(cache).empty());
+}
+
+TEST_CASE(fact_cache_random_operations)
+{
+    constexpr size_t limit = 64;
+
+    fact_cache cache(limit);
+    std::list<uint32_t> lru{};
+    std::unordered_map<uint32_t, int32_t> values{};
+
+    std::mt19937 random(0x5733);
+
+    for (int32_t i = 0; i < 100000; ++i)
+    {
+        // Few distinct keys, so erases and re-registrations hit live entries
+        const auto key = static_cast<uint32_t>(random() % 256) << (random() % 2 ? 24 : 0);
+
+        if (random() % 4 == 0)
+        {
+            cache.erase(key);
+            lru.remove(key);
+            values.erase(key);
+        }
+        else
+        {
+            cache.emplace(key, [&](const quest_fact& fact) {
+                CHECK(fact.fact_hash == lru.back());
+                values.erase(fact.fact_hash);
+                lru.pop_back();
+            }).first->value = i;
+
+            lru.remove(key);
+            lru.push_front(key);
+            values[key] = i;
+        }
+
+        CHECK(cache.size() == values.size());
+    }
+
+    CHECK((get_order(cache) == std::vector<uint32_t>(lru.begin(), lru.end())));
+    for (const auto& [key, value] : values)
+    {
+        CHECK(cache.find(key) && cache.find(key)->value == value);
+    }
+}
@@ -0,0 +1,126 @@
+#include "test.hpp"
+
+#include <server/world_state.hpp>
+
+#include <client/module/quest_sync.hpp>
+#include <network/packet_codec.hpp>
+
+#include <limits>
+
+// SetFact and AddFact through the coalescer, the wire and the server's world state: adds stay deltas until they
+// meet a stored value, so counters bumped by several players add up
+
+namespace
+{
+    using network::protocol::fact_update;
+
+    network::protocol::fact_packet make_fact(const char* name, const int32_t value, const fact_update update)
+    {
+        network::protocol::fact_packet fact{};
+        network::protocol::copy_string(fact.fact_name, name);
+        fact.value = value;
+        fact.update = update;
+
+        return fact;
+    }
+
+    const quest_sync::quest_fact* find_fact(const std::vector<quest_sync::quest_fact>& facts, const std::string_view name)
+    {
+        for (const auto& fact : facts)
+        {
+            if (network::protocol::view_string(fact.fact_name) == name)
+            {
+                return &fact;
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+TEST_CASE(fact_update_world_state)
+{
+    world_state world{};
+
+    world.apply_fact(make_fact("kills", 3, fact_update::add));
+    CHECK(world.get_fact("kills") == 3);
+
+    // Two players bumping the same counter
+    world.apply_fact(make_fact("kills", 1, fact_update::add));
+    world.apply_fact(make_fact("kills", 1, fact_update::add));
+    CHECK(world.get_fact("kills") == 5);
+
+    world.apply_fact(make_fact("kills", 10, fact_update::set));
+    CHECK(world.get_fact("kills") == 10);
+
+    world.apply_fact(make_fact("kills", -4, fact_update::add));
+    CHECK(world.get_fact("kills") == 6);
+
+    world.apply_fact(make_fact("wrapped", std::numeric_limits<int32_t>::max(), fact_update::set));
+    world.apply_fact(make_fact("wrapped", 1, fact_update::add));
+    CHECK(world.get_fact("wrapped") == std::numeric_limits<int32_t>::min());
+
+    CHECK(!world.get_fact("missing"));
+}
+
+TEST_CASE(fact_update_coalescer)
+{
+    quest_sync::fact_coalescer coalescer{};
+
+    coalescer.push("adds", 2, fact_update::add, 1);
+    coalescer.push("adds", 3, fact_update::add, 1);
+
+    coalescer.push("set_then_add", 7, fact_update::set, 1);
+    coalescer.push("set_then_add", 1, fact_update::add, 1);
+
+    coalescer.push("add_then_set", 4, fact_update::add, 1);
+    coalescer.push("add_then_set", 9, fact_update::set, 1);
+
+    const auto facts = coalescer.take();
+    CHECK(facts.size() == 3);
+
+    const auto* adds = find_fact(facts, "adds");
+    CHECK(adds && adds->value == 5 && adds->update == fact_update::add);
+
+    const auto* set_then_add = find_fact(facts, "set_then_add");
+    CHECK(set_then_add && set_then_add->value == 8 && set_then_add->update == fact_update::set);
+
+    const auto* add_then_set = find_fact(facts, "add_then_set");
+    CHECK(add_then_set && add_then_set->value == 9 && add_then_set->update == fact_update::set);
+}
+
+TEST_CASE(fact_update_wire)
+{
+    network::string_dictionary dictionary{};
+
+    network::protocol::fact_batch_packet batch{};
+    batch.facts.push_back(make_fact("kills", 2, fact_update::add));
+    batch.facts.push_back(make_fact("found_ciri", 1, fact_update::set));
+
+    utils::buffer_serializer buffer{};
+    network::protocol::write(buffer, dictionary.outgoing, batch);
+
+    utils::buffer_deserializer reader(buffer.get_buffer());
+    const auto decoded = network::protocol::read<network::protocol::fact_batch_packet>(reader, dictionary.incoming);
+
+    CHECK(decoded.facts.size() == 2);
+    CHECK(decoded.facts[0].update == fact_update::add && decoded.facts[0].value == 2);
+    CHECK(decoded.facts[1].update == fact_update::set && decoded.facts[1].value == 1);
+
+    // A sender from before the update field: version 1 and one byte shorter, which reads as a set
+    utils::buffer_serializer current{};
+    network::protocol::write(current, dictionary.outgoing, make_fact("kills", 2, fact_update::add));
+
+    auto legacy = current.get_buffer();
+    CHECK(static_cast<uint8_t>(legacy[0]) == 2);
+
+    legacy.pop_back();
+    legacy[0] = 1;
+    legacy[1] = static_cast<char>(static_cast<uint8_t>(legacy[1]) - 1);
+
+    utils::buffer_deserializer legacy_reader(legacy);
+    const auto legacy_fact = network::protocol::read<network::protocol::fact_packet>(legacy_reader, dictionary.incoming);
+
+    CHECK(network::protocol::view_string(legacy_fact.fact_name) == "kills");
+    CHECK(legacy_fact.value == 2 && legacy_fact.update == fact_update::set);
+}
@@ -0,0 +1,155 @@
+#include "test.hpp"
+
+#include <client/updater/file_state_cache.hpp>
+
+#include <utils/io.hpp>
+
+#include <vector>
+
+// Installed file hashes are served from the cache only while size and modification time are unchanged. A cache that
+// is corrupt or from another version is ignored, which costs one full rehash.
+
+namespace
+{
+    using namespace std::chrono_literals;
+
+    class install_directory
+    {
+      public:
+        install_directory()
+            : path_(std::filesystem::temp_directory_path() /
+                    ("w3m_file_state_cache_" + std::to_string(utils::cryptography::random::get_integer())))
+        {
+            std::filesystem::create_directories(this->path_);
+        }
+
+        ~install_directory()
+        {
+            std::error_code error{};
+            std::filesystem::remove_all(this->path_, error);
+        }
+
+        install_directory(install_directory&&) = delete;
+        install_directory(const install_directory&) = delete;
+        install_directory& operator=(install_directory&&) = delete;
+        install_directory& operator=(const install_directory&) = delete;
+
+        std::filesystem::path get_cache() const
+        {
+            return this->path_ / updater::file_state_cache::FILE_NAME;
+        }
+
+        // Written an hour ago, so the cache doesn't consider it racy
+        std::filesystem::path write(const std::string& name, const std::string& data,
+                                    const std::filesystem::file_time_type::duration age = 1h) const
+        {
+            const auto path = this->path_ / name;
+            CHECK(utils::io::write_file(path, data));
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - age);
+
+            return path;
+        }
+
+      private:
+        std::filesystem::path path_{};
+    };
+
+    utils::cryptography::sha1::digest hash(const std::string& data)
+    {
+        utils::cryptography::sha1::hasher hasher{};
+        hasher.update(data);
+        return hasher.finalize();
+    }
+
+    // A cache that knows w3m.dll and w3m.exe
+    void create_cache(const install_directory& directory, const std::filesystem::path& dll, const std::filesystem::path& exe)
+    {
+        updater::file_state_cache cache(directory.get_cache());
+        CHECK(cache.get_hash("w3m.dll", dll));
+        CHECK(cache.get_hash("w3m.exe", exe));
+        cache.save();
+    }
+}
+
+TEST_CASE(file_state_cache_invalidation)
+{
+    const install_directory directory{};
+    const auto dll = directory.write("w3m.dll", "dll version 1");
+    const auto exe = directory.write("w3m.exe", "exe version 1");
+    create_cache(directory, dll, exe);
+
+    {
+        const updater::file_state_cache cache(directory.get_cache());
+        CHECK(cache.find("w3m.dll", dll) == hash("dll version 1"));
+        CHECK(cache.find("w3m.exe", exe) == hash("exe version 1"));
+        CHECK(!cache.find("w3m.pdb", exe));
+    }
+
+    // A different size, and the same size written at another time
+    directory.write("w3m.dll", "dll version 10");
+    directory.write("w3m.exe", "exe version 2", 2h);
+
+    updater::file_state_cache cache(directory.get_cache());
+    CHECK(!cache.find("w3m.dll", dll));
+    CHECK(!cache.find("w3m.exe", exe));
+
+    CHECK(cache.get_hash("w3m.dll", dll) == hash("dll version 10"));
+    CHECK(cache.get_hash("w3m.exe", exe) == hash("exe version 2"));
+    cache.save();
+
+    const updater::file_state_cache reloaded(directory.get_cache());
+    CHECK(reloaded.find("w3m.dll", dll) == hash("dll version 10"));
+    CHECK(reloaded.find("w3m.exe", exe) == hash("exe version 2"));
+}
+
+TEST_CASE(file_state_cache_racy_file)
+{
+    const install_directory directory{};
+    const auto dll = directory.write("w3m.dll", "dll version 1", 0s);
+
+    updater::file_state_cache cache(directory.get_cache());
+    CHECK(cache.get_hash("w3m.dll", dll) == hash("dll version 1"));
+
+    // Written too recently, another write within the same timestamp would go unnoticed
+    CHECK(!cache.find("w3m.dll", dll));
+}
+
+TEST_CASE(file_state_cache_corrupt)
+{
+    const install_directory directory{};
+    const auto dll = directory.write("w3m.dll", "dll version 1");
+    const auto exe = directory.write("w3m.exe", "exe version 1");
+    create_cache(directory, dll, exe);
+
+    const auto valid = utils::io::read_file(directory.get_cache());
+
+    auto corrupt = valid;
+    corrupt.back() = static_cast<char>(corrupt.back() ^ 1);
+
+    const auto truncated = valid.substr(0, valid.size() - 5);
+
+    // Same layout with another version number
+    auto old_version = valid;
+    old_version[4] = 0;
+
+    // The valid cache last, the others have to be rehashed
+    const std::vector<std::string> caches{corrupt, truncated, old_version, valid};
+    for (size_t i = 0; i < caches.size(); ++i)
+    {
+        CHECK(utils::io::write_file(directory.get_cache(), caches[i]));
+
+        updater::file_state_cache cache(directory.get_cache());
+        const auto rehash = i + 1 < caches.size();
+
+        CHECK(cache.find("w3m.dll", dll).has_value() != rehash);
+        CHECK(cache.find("w3m.exe", exe).has_value() != rehash);
+
+        // Either way the hashes are right
+        CHECK(cache.get_hash("w3m.dll", dll) == hash("dll version 1"));
+        CHECK(cache.get_hash("w3m.exe", exe) == hash("exe version 1"));
+
+        // And the rehash repairs the cache
+        cache.save();
+        CHECK(updater::file_state_cache(directory.get_cache()).find("w3m.dll", dll) == hash("dll version 1"));
+    }
+}
@@ -0,0 +1,106 @@
+#include "test.hpp"
+
+#include <utils/hash.hpp>
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// The runtime block loops: every one the CPU supports matches XXH3_64bits over whole blocks, partial blocks and
+// tails that don't fill a stripe, from aligned and unaligned addresses
+
+namespace
+{
+    using utils::hash::instruction_set;
+
+    // Same pseudo-random input as the constexpr checks in hash.cpp, extended past a megabyte
+    std::string make_test_input(const size_t length)
+    {
+        std::string input(length, '\0');
+        uint64_t generator = utils::hash::detail::PRIME32_1;
+
+        for (auto& c : input)
+        {
+            c = static_cast<char>(static_cast<uint8_t>(generator >> 56));
+            generator *= utils::hash::detail::PRIME64_1;
+        }
+
+        return input;
+    }
+
+    struct reference_value
+    {
+        size_t offset{};
+        size_t length{};
+        uint64_t expected{};
+    };
+
+    // From XXH3_64bits
+    constexpr reference_value reference_values[] = {
+        {0, 241, 0x281410FD53152172},              // First length that takes the block loop
+        {0, 1024, 0x95C63C696323768E},
+        {0, 2048, 0x8C9A8E3F25D392D6},             // Scrambles after the first block
+        {0, 1024 * 1024, 0xC52DB6D82C29B354},
+        {0, 1024 * 1024 - 13, 0xDAEBC407BF3DB897}, // Tail shorter than a stripe
+        {0, 1000003, 0x0ECADB1E2D224E53},
+        {3, 1024, 0x3240B26336F40A35},             // Unaligned input
+        {5, 1000003, 0xBE7C343C1139569C},
+    };
+}
+
+TEST_CASE(hash_block_loops)
+{
+    const auto input = make_test_input(1024 * 1024 + 64);
+
+    // Generic always works, the others depend on the CPU running the tests
+    CHECK(utils::hash::is_supported(instruction_set::generic));
+
+    size_t tested = 0;
+    for (const auto instructions : {instruction_set::generic, instruction_set::sse2, instruction_set::avx2})
+    {
+        if (!utils::hash::is_supported(instructions))
+        {
+            printf("Skipping unsupported block loop: %s\n", std::string(utils::hash::get_name(instructions)).c_str());
+            continue;
+        }
+
+        for (const auto& value : reference_values)
+        {
+            const auto data = std::string_view(input).substr(value.offset, value.length);
+            CHECK(utils::hash::compute(data, instructions) == value.expected);
+        }
+
+        ++tested;
+    }
+
+    // Whatever compute() picked
+    for (const auto& value : reference_values)
+    {
+        CHECK(utils::hash::compute(std::string_view(input).substr(value.offset, value.length)) == value.expected);
+    }
+
+    CHECK(tested >= 1);
+}
+
+TEST_CASE(hash_block_loop_lengths)
+{
+    const auto input = make_test_input(4096 + 64);
+
+    // Every length and alignment around the block and stripe boundaries agrees with the generic loop
+    for (const auto instructions : {instruction_set::sse2, instruction_set::avx2})
+    {
+        if (!utils::hash::is_supported(instructions))
+        {
+            continue;
+        }
+
+        for (size_t offset = 0; offset < 8; ++offset)
+        {
+            for (size_t length = 230; length <= 2200; ++length)
+            {
+                const auto data = std::string_view(input).substr(offset, length);
+                CHECK(utils::hash::compute(data, instructions) == utils::hash::compute(data, instruction_set::generic));
+            }
+        }
+    }
+}
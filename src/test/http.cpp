@@ -0,0 +1,373 @@
+#include "test.hpp"
+
+#include <client/utils/http.hpp>
+
+#include <network/socket.hpp>
+#include <utils/cryptography.hpp>
+#include <utils/io.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define poll WSAPoll
+#endif
+
+// The updater's HTTP client against a loopback stand-in for the update server: ranged downloads, a range that breaks
+// off and resumes, a server that ignores Range, and plain requests
+
+namespace
+{
+    constexpr size_t FILE_SIZE = 1024 * 1024 + 123;
+    constexpr uint64_t CHUNK_SIZE = 64 * 1024;
+
+    void close_socket(const SOCKET s)
+    {
+#ifdef _WIN32
+        closesocket(s);
+#else
+        close(s);
+#endif
+    }
+
+    bool send_all(const SOCKET s, std::string_view data)
+    {
+#ifdef _WIN32
+        constexpr int flags = 0;
+#else
+        constexpr int flags = MSG_NOSIGNAL;
+#endif
+
+        while (!data.empty())
+        {
+            const auto sent = ::send(s, data.data(), static_cast<int>(std::min<size_t>(data.size(), 64 * 1024)), flags);
+            if (sent <= 0)
+            {
+                return false;
+            }
+
+            data.remove_prefix(static_cast<size_t>(sent));
+        }
+
+        return true;
+    }
+
+    // Serves one file at /file over HTTP/1.1, one request per connection
+    class http_responder
+    {
+      public:
+        struct options
+        {
+            bool ignore_range{};
+
+            // The first partial response covering this offset breaks off right before it
+            std::optional<uint64_t> disconnect_at{};
+        };
+
+        struct request
+        {
+            std::string path{};
+            std::optional<std::pair<uint64_t, uint64_t>> range{};
+        };
+
+        http_responder(std::string body, const options& options)
+            : body_(std::move(body)),
+              options_(options)
+        {
+            network::initialize_wsa();
+
+            this->socket_ = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            CHECK(this->socket_ != INVALID_SOCKET);
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+            socklen_t length = sizeof(address);
+            CHECK(bind(this->socket_, reinterpret_cast<sockaddr*>(&address), length) == 0);
+            CHECK(listen(this->socket_, 16) == 0);
+            CHECK(getsockname(this->socket_, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+
+            this->port_ = ntohs(address.sin_port);
+            this->thread_ = std::thread([this] { this->run(); });
+        }
+
+        ~http_responder()
+        {
+            this->stop_ = true;
+            this->thread_.join();
+            close_socket(this->socket_);
+        }
+
+        http_responder(http_responder&&) = delete;
+        http_responder(const http_responder&) = delete;
+        http_responder& operator=(http_responder&&) = delete;
+        http_responder& operator=(const http_responder&) = delete;
+
+        std::string get_url(const std::string_view path = "/file") const
+        {
+            return "http://127.0.0.1:" + std::to_string(this->port_) + std::string(path);
+        }
+
+        std::vector<request> get_requests() const
+        {
+            std::lock_guard _{this->mutex_};
+            return this->requests_;
+        }
+
+      private:
+        std::string body_{};
+        options options_{};
+
+        SOCKET socket_{INVALID_SOCKET};
+        uint16_t port_{};
+
+        mutable std::mutex mutex_{};
+        std::vector<request> requests_{};
+
+        std::atomic_bool stop_{false};
+        std::thread thread_{};
+
+        void run()
+        {
+            while (!this->stop_)
+            {
+                pollfd descriptor{};
+                descriptor.fd = this->socket_;
+                descriptor.events = POLLIN;
+
+                if (poll(&descriptor, 1, 20) <= 0)
+                {
+                    continue;
+                }
+
+                const auto connection = accept(this->socket_, nullptr, nullptr);
+                if (connection != INVALID_SOCKET)
+                {
+                    this->serve(connection);
+                    close_socket(connection);
+                }
+            }
+        }
+
+        static std::optional<request> read_request(const SOCKET connection)
+        {
+            std::string data{};
+            char buffer[4096];
+
+            while (data.find("\r\n\r\n") == std::string::npos)
+            {
+                const auto received = recv(connection, buffer, static_cast<int>(sizeof(buffer)), 0);
+                if (received <= 0)
+                {
+                    return std::nullopt;
+                }
+
+                data.append(buffer, static_cast<size_t>(received));
+            }
+
+            request result{};
+
+            const auto path_start = data.find(' ') + 1;
+            result.path = data.substr(path_start, data.find(' ', path_start) - path_start);
+
+            const auto range = data.find("\r\nRange: bytes=");
+            if (range != std::string::npos)
+            {
+                const auto start = range + 15;
+                const auto dash = data.find('-', start);
+                const auto end = data.find("\r\n", dash);
+
+                result.range.emplace(std::stoull(data.substr(start, dash - start)), std::stoull(data.substr(dash + 1, end - dash - 1)));
+            }
+
+            return result;
+        }
+
+        void serve(const SOCKET connection)
+        {
+            const auto request = read_request(connection);
+            if (!request)
+            {
+                return;
+            }
+
+            {
+                std::lock_guard _{this->mutex_};
+                this->requests_.push_back(*request);
+            }
+
+            if (request->path != "/file")
+            {
+                (void)send_all(connection, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+                return;
+            }
+
+            if (!request->range || this->options_.ignore_range)
+            {
+                (void)send_all(connection, "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(this->body_.size()) +
+                                               "\r\nConnection: close\r\n\r\n");
+                (void)send_all(connection, this->body_);
+                return;
+            }
+
+            const auto [first, last] = *request->range;
+            auto end = last + 1;
+
+            (void)send_all(connection, "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + std::to_string(first) + "-" +
+                                           std::to_string(last) + "/" + std::to_string(this->body_.size()) +
+                                           "\r\nContent-Length: " + std::to_string(end - first) + "\r\nConnection: close\r\n\r\n");
+
+            const auto disconnect_at = this->options_.disconnect_at;
+            if (disconnect_at && *disconnect_at > first && *disconnect_at < end)
+            {
+                this->options_.disconnect_at.reset();
+                end = *disconnect_at;
+            }
+
+            (void)send_all(connection, std::string_view(this->body_).substr(first, end - first));
+        }
+    };
+
+    std::string generate_body()
+    {
+        std::mt19937_64 random(0x5733);
+
+        std::string body(FILE_SIZE, '\0');
+        for (auto& c : body)
+        {
+            c = static_cast<char>(random());
+        }
+
+        return body;
+    }
+
+    class temporary_file
+    {
+      public:
+        temporary_file()
+            : path_(std::filesystem::temp_directory_path() / ("w3m_http_" + std::to_string(utils::cryptography::random::get_integer())))
+        {
+        }
+
+        ~temporary_file()
+        {
+            std::error_code error{};
+            std::filesystem::remove(this->path_, error);
+        }
+
+        temporary_file(temporary_file&&) = delete;
+        temporary_file(const temporary_file&) = delete;
+        temporary_file& operator=(temporary_file&&) = delete;
+        temporary_file& operator=(const temporary_file&) = delete;
+
+        const std::filesystem::path& get() const
+        {
+            return this->path_;
+        }
+
+      private:
+        std::filesystem::path path_{};
+    };
+
+    utils::http::range_options get_range_options()
+    {
+        utils::http::range_options options{};
+        options.chunk_size = CHUNK_SIZE;
+        options.connections = 4;
+
+        return options;
+    }
+
+    size_t count_ranged(const std::vector<http_responder::request>& requests)
+    {
+        return static_cast<size_t>(std::ranges::count_if(requests, [](const auto& request) { return request.range.has_value(); }));
+    }
+}
+
+TEST_CASE(http_ranged_download)
+{
+    const auto body = generate_body();
+    const http_responder server(body, {});
+    const temporary_file file{};
+
+    size_t progress = 0;
+    CHECK(utils::http::download_file(server.get_url(), file.get(), body.size(), [&](const size_t received) { progress = received; },
+                                     get_range_options()));
+
+    CHECK(utils::io::read_file(file.get()) == body);
+    CHECK(progress == body.size());
+
+    // Every chunk once, the last one short
+    const auto requests = server.get_requests();
+    CHECK(requests.size() == (body.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    CHECK(count_ranged(requests) == requests.size());
+}
+
+TEST_CASE(http_resumed_range)
+{
+    const auto body = generate_body();
+    constexpr uint64_t disconnect_at = CHUNK_SIZE * 5 + 1000;
+
+    http_responder::options options{};
+    options.disconnect_at = disconnect_at;
+
+    const http_responder server(body, options);
+    const temporary_file file{};
+
+    CHECK(utils::http::download_file(server.get_url(), file.get(), body.size(), {}, get_range_options()));
+    CHECK(utils::io::read_file(file.get()) == body);
+
+    // The broken range is requested again from the first byte that didn't arrive
+    const auto requests = server.get_requests();
+    CHECK(requests.size() == (body.size() + CHUNK_SIZE - 1) / CHUNK_SIZE + 1);
+    CHECK(std::ranges::any_of(requests, [](const auto& request) {
+        return request.range && request.range->first == disconnect_at && request.range->second == CHUNK_SIZE * 6 - 1;
+    }));
+}
+
+TEST_CASE(http_ignored_range)
+{
+    const auto body = generate_body();
+
+    http_responder::options options{};
+    options.ignore_range = true;
+
+    const http_responder server(body, options);
+    const temporary_file file{};
+
+    CHECK(utils::http::download_file(server.get_url(), file.get(), body.size(), {}, get_range_options()));
+    CHECK(utils::io::read_file(file.get()) == body);
+
+    // The full response to a range gives up on ranges, one plain request follows
+    const auto requests = server.get_requests();
+    CHECK(count_ranged(requests) >= 1);
+    CHECK(!requests.back().range);
+    CHECK(requests.size() - count_ranged(requests) == 1);
+}
+
+TEST_CASE(http_get_data)
+{
+    const auto body = generate_body();
+    const http_responder server(body, {});
+
+    CHECK(utils::http::get_data(server.get_url()) == body);
+
+    // Error responses are not retried
+    CHECK(!utils::http::get_data(server.get_url("/missing")));
+    CHECK(server.get_requests().size() == 2);
+
+    // A short file arrives in one plain request
+    const temporary_file file{};
+    CHECK(utils::http::download_file(server.get_url(), file.get(), body.size()));
+    CHECK(utils::io::read_file(file.get()) == body);
+    CHECK(count_ranged(server.get_requests()) == 0);
+
+    // A size that doesn't match fails
+    CHECK(!utils::http::download_file(server.get_url(), file.get(), body.size() - 1));
+}
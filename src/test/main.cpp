@@ -0,0 +1,97 @@
+#include "test.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern "C"
+{
+    int s_read_arc4random(void*, size_t)
+    {
+        return -1;
+    }
+
+    int s_read_getrandom(void*, size_t)
+    {
+        return -1;
+    }
+
+    int s_read_urandom(void*, size_t)
+    {
+        return -1;
+    }
+
+    int s_read_ltm_rng(void*, size_t)
+    {
+        return -1;
+    }
+}
+
+namespace test
+{
+    namespace
+    {
+        struct test_case
+        {
+            const char* name{};
+            function run{};
+        };
+
+        std::vector<test_case>& get_test_cases()
+        {
+            static std::vector<test_case> test_cases{};
+            return test_cases;
+        }
+    }
+
+    registration::registration(const char* name, const function run)
+    {
+        get_test_cases().push_back({name, run});
+    }
+
+    void fail(const char* expression, const char* file, const int line)
+    {
+        throw std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": CHECK(" + expression + ") failed");
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    const std::vector<std::string_view> filters(argv + 1, argv + argc);
+
+    size_t failed = 0;
+    size_t run = 0;
+
+    for (const auto& test_case : test::get_test_cases())
+    {
+        if (!filters.empty() && std::find(filters.begin(), filters.end(), test_case.name) == filters.end())
+        {
+            continue;
+        }
+
+        ++run;
+        const auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+            test_case.run();
+
+            const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printf("[PASS] %s (%.2f s)\n", test_case.name, seconds);
+        }
+        catch (const std::exception& e)
+        {
+            ++failed;
+            printf("[FAIL] %s: %s\n", test_case.name, e.what());
+        }
+
+        (void)fflush(stdout);
+    }
+
+    printf("%zu of %zu test cases passed\n", run - failed, run);
+    return failed ? 1 : 0;
+}
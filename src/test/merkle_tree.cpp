@@ -0,0 +1,217 @@
+#include "test.hpp"
+
+#include <utils/merkle_tree.hpp>
+
+#include <client/module/quest_sync.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The world state tree: changes that cancel out restore the root, digests don't depend on insertion order, and a
+// drill-down between two diverged peers ends at the one bucket that differs
+
+namespace
+{
+    using entry_list = std::vector<std::pair<uint32_t, uint64_t>>;
+
+    entry_list generate_entries(const size_t count)
+    {
+        std::mt19937 random(0x5733);
+
+        entry_list entries{};
+        entries.reserve(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            entries.emplace_back(static_cast<uint32_t>(random()), random() % 16);
+        }
+
+        return entries;
+    }
+
+    utils::merkle_tree build_tree(const entry_list& entries)
+    {
+        utils::merkle_tree tree{};
+        for (const auto& [key, value] : entries)
+        {
+            tree.insert(key, value);
+        }
+
+        return tree;
+    }
+
+    bool has_same_nodes(const utils::merkle_tree& a, const utils::merkle_tree& b)
+    {
+        for (size_t node = 0; node < utils::merkle_tree::FIRST_BUCKET_NODE; ++node)
+        {
+            if (!std::ranges::equal(a.get_children(node), b.get_children(node)))
+            {
+                return false;
+            }
+        }
+
+        return a.get_root() == b.get_root();
+    }
+
+    // Walks the levels like the client does against the server's answers
+    std::vector<size_t> drill_down(const utils::merkle_tree& local, const utils::merkle_tree& remote)
+    {
+        std::vector<size_t> nodes{0};
+        std::vector<size_t> buckets{};
+
+        while (!nodes.empty())
+        {
+            const auto node = nodes.back();
+            nodes.pop_back();
+
+            for (const auto child : local.find_divergent_children(node, remote.get_children(node)))
+            {
+                if (utils::merkle_tree::is_bucket_node(child))
+                {
+                    buckets.push_back(utils::merkle_tree::get_bucket_of_node(child));
+                }
+                else
+                {
+                    nodes.push_back(child);
+                }
+            }
+        }
+
+        return buckets;
+    }
+
+    network::protocol::fact_packet to_packet(const quest_sync::quest_fact& fact)
+    {
+        network::protocol::fact_packet packet{};
+        packet.fact_name = fact.fact_name;
+        packet.value = fact.value;
+
+        return packet;
+    }
+}
+
+TEST_CASE(merkle_tree_round_trip)
+{
+    const utils::merkle_tree empty{};
+    const auto entries = generate_entries(1000);
+
+    auto tree = build_tree(entries);
+    CHECK(tree.get_root() != empty.get_root());
+
+    const auto root = tree.get_root();
+    const auto [key, value] = entries[123];
+
+    tree.update(key, value, value + 1);
+    CHECK(tree.get_root() != root);
+
+    tree.update(key, value + 1, value);
+    CHECK(tree.get_root() == root);
+
+    // An update is the same as erasing the old entry and inserting the new one
+    auto replaced = build_tree(entries);
+    replaced.erase(key, value);
+    replaced.insert(key, value + 7);
+    tree.update(key, value, value + 7);
+    CHECK(has_same_nodes(tree, replaced));
+
+    tree.update(key, value + 7, value);
+    for (const auto& [k, v] : entries)
+    {
+        tree.erase(k, v);
+    }
+
+    CHECK(has_same_nodes(tree, empty));
+
+    tree = build_tree(entries);
+    tree.clear();
+    CHECK(has_same_nodes(tree, empty));
+}
+
+TEST_CASE(merkle_tree_order_independence)
+{
+    auto entries = generate_entries(1000);
+    const auto tree = build_tree(entries);
+
+    std::ranges::shuffle(entries, std::mt19937(42));
+    CHECK(has_same_nodes(build_tree(entries), tree));
+
+    // Reaching the same values through updates
+    utils::merkle_tree updated{};
+    for (const auto& [key, value] : entries)
+    {
+        updated.insert(key, value + 3);
+    }
+
+    std::ranges::reverse(entries);
+    for (const auto& [key, value] : entries)
+    {
+        updated.update(key, value + 3, value);
+    }
+
+    CHECK(has_same_nodes(updated, tree));
+}
+
+TEST_CASE(merkle_tree_drill_down)
+{
+    auto entries = generate_entries(5000);
+    const auto remote = build_tree(entries);
+
+    auto& [key, value] = entries[4321];
+    value += 1;
+
+    const auto local = build_tree(entries);
+    CHECK(local.get_root() != remote.get_root());
+
+    // One differing node per level
+    CHECK(local.find_divergent_children(0, remote.get_children(0)).size() == 1);
+
+    const auto buckets = drill_down(local, remote);
+    CHECK(buckets.size() == 1);
+    CHECK(buckets[0] == utils::merkle_tree::get_bucket(key));
+
+    CHECK(drill_down(remote, remote).empty());
+}
+
+TEST_CASE(merkle_tree_fact_managers)
+{
+    quest_sync::quest_fact_manager local{};
+    quest_sync::quest_fact_manager remote{};
+
+    std::vector<std::pair<std::string, int32_t>> facts{};
+    for (int32_t i = 0; i < 500; ++i)
+    {
+        facts.emplace_back("q" + std::to_string(i) + "_objective", i);
+    }
+
+    local.apply_snapshot_facts(facts, 1);
+    remote.apply_snapshot_facts(facts, 2);
+
+    CHECK(local.get_world_state_hash() == remote.get_world_state_hash());
+
+    remote.register_fact("q123_objective", 7, 2, network::protocol::fact_update::add);
+    CHECK(local.get_world_state_hash() != remote.get_world_state_hash());
+
+    const auto root_children = remote.get_world_state_children(0);
+    const auto nodes = local.find_divergent_world_state_nodes(0, root_children);
+    CHECK(nodes.size() == 1);
+
+    const auto buckets = local.find_divergent_world_state_nodes(nodes[0], remote.get_world_state_children(nodes[0]));
+    CHECK(buckets.size() == 1);
+
+    const auto bucket = utils::merkle_tree::get_bucket_of_node(buckets[0]);
+    CHECK(bucket == utils::merkle_tree::get_bucket(quest_sync::quest_fact_manager::compute_fact_hash("q123_objective")));
+
+    // Copying the remote bucket's facts converges, only the changed one is applied
+    std::vector<network::protocol::fact_packet> packets{};
+    for (const auto& fact : remote.get_bucket_facts(bucket))
+    {
+        packets.push_back(to_packet(fact));
+    }
+
+    CHECK(local.apply_resynced_facts(packets, 2, [](uint32_t) { return false; }) == 1);
+    CHECK(local.get_fact("q123_objective")->value == 130);
+    CHECK(local.get_world_state_hash() == remote.get_world_state_hash());
+}
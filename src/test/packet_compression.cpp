@@ -0,0 +1,215 @@
+#include "test.hpp"
+
+#include <network/manager.hpp>
+#include <network/packet_dictionary.hpp>
+#include <utils/compression.hpp>
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Compressed framing between managers: what goes on the wire is deflated against the packet dictionary and arrives
+// unchanged, tiny packets stay plain, and datagrams compressed with another dictionary or cut short are dropped without
+// disturbing the packets that follow
+
+namespace
+{
+    constexpr uint16_t RECEIVER_PORT = 29360;
+    constexpr uint16_t RELAY_PORT = 29460;
+    constexpr std::chrono::seconds WAIT_LIMIT{10};
+
+    constexpr int32_t PLAIN_MAGIC = -1;
+    constexpr int32_t COMPRESSED_MAGIC = -2;
+
+    int32_t get_magic(const std::string_view datagram)
+    {
+        int32_t magic{};
+        CHECK(datagram.size() >= sizeof(magic));
+        std::memcpy(&magic, datagram.data(), sizeof(magic));
+
+        return magic;
+    }
+
+    std::string make_frame(const int32_t magic, const std::string_view data)
+    {
+        std::string frame(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        frame.append(data);
+
+        return frame;
+    }
+
+    // Stands between sender and receiver, so the datagrams can be inspected and tampered with
+    class datagram_relay
+    {
+      public:
+        datagram_relay()
+            : socket_(AF_INET)
+        {
+            network::address local("127.0.0.1:" + std::to_string(RELAY_PORT));
+            CHECK(this->socket_.bind_port(local));
+            CHECK(this->socket_.set_blocking(false));
+        }
+
+        network::address get_address() const
+        {
+            return network::address("127.0.0.1:" + std::to_string(RELAY_PORT));
+        }
+
+        std::string receive() const
+        {
+            const auto deadline = std::chrono::steady_clock::now() + WAIT_LIMIT;
+
+            network::address source{};
+            std::string data{};
+
+            while (!this->socket_.receive(source, data))
+            {
+                CHECK(std::chrono::steady_clock::now() < deadline);
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+
+            return data;
+        }
+
+        void forward(const network::address& target, const std::string& data) const
+        {
+            CHECK(this->socket_.send(target, data));
+        }
+
+      private:
+        network::socket socket_;
+    };
+
+    class packet_log
+    {
+      public:
+        void add(const std::string_view data)
+        {
+            std::lock_guard _{this->mutex_};
+            this->packets_.emplace_back(data);
+        }
+
+        // Waits for count packets in total
+        std::vector<std::string> wait_for(const size_t count) const
+        {
+            const auto deadline = std::chrono::steady_clock::now() + WAIT_LIMIT;
+
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+                {
+                    std::lock_guard _{this->mutex_};
+                    if (this->packets_.size() >= count)
+                    {
+                        return this->packets_;
+                    }
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+
+            test::fail("packets arrived", __FILE__, __LINE__);
+        }
+
+      private:
+        mutable std::mutex mutex_{};
+        std::vector<std::string> packets_{};
+    };
+
+    std::string make_payload()
+    {
+        std::string payload{};
+        for (int i = 0; i < 20; ++i)
+        {
+            payload += "q104_found_ciri " + std::to_string(i) + "\n";
+        }
+
+        return payload;
+    }
+}
+
+TEST_CASE(packet_compression_round_trip)
+{
+    packet_log log{};
+
+    network::manager receiver(RECEIVER_PORT);
+    receiver.on("compressionTest", [&](const network::address&, const std::string_view& data) { log.add(data); });
+
+    const network::address receiver_address("127.0.0.1:" + std::to_string(receiver.get_ipv4_socket().get_port()));
+
+    const datagram_relay relay{};
+    network::manager sender{};
+    sender.set_compression(true);
+
+    const auto payload = make_payload();
+    CHECK(sender.send(relay.get_address(), "compressionTest", payload));
+
+    // Deflated against the packet dictionary
+    const auto compressed = relay.receive();
+    CHECK(get_magic(compressed) == COMPRESSED_MAGIC);
+    CHECK(compressed.size() < sizeof(int32_t) + sizeof("compressionTest") + payload.size());
+
+    utils::compression::zlib::decompressor decompressor(network::get_packet_dictionary());
+    std::string decompressed{};
+    CHECK(decompressor.decompress(decompressed, std::string_view(compressed).substr(sizeof(int32_t))));
+    CHECK(decompressed == "compressionTest " + payload);
+
+    // Tiny packets would grow
+    CHECK(sender.send(relay.get_address(), "compressionTest"));
+    const auto tiny = relay.receive();
+    CHECK(get_magic(tiny) == PLAIN_MAGIC);
+    CHECK(tiny == make_frame(PLAIN_MAGIC, "compressionTest "));
+
+    // Both arrive as they were sent
+    relay.forward(receiver_address, compressed);
+    relay.forward(receiver_address, tiny);
+
+    const auto packets = log.wait_for(2);
+    CHECK(packets.size() == 2);
+    CHECK(packets[0] == payload);
+    CHECK(packets[1].empty());
+
+    // Without compression the same packet goes out plain
+    sender.set_compression(false);
+    CHECK(sender.send(relay.get_address(), "compressionTest", payload));
+    CHECK(relay.receive() == make_frame(PLAIN_MAGIC, "compressionTest " + payload));
+}
+
+TEST_CASE(packet_compression_rejection)
+{
+    packet_log log{};
+
+    network::manager receiver(RECEIVER_PORT);
+    receiver.on("compressionTest", [&](const network::address&, const std::string_view& data) { log.add(data); });
+
+    const network::address receiver_address("127.0.0.1:" + std::to_string(receiver.get_ipv4_socket().get_port()));
+
+    const datagram_relay relay{};
+    const auto payload = "compressionTest " + make_payload();
+
+    // A peer with another dictionary: its back references resolve to the wrong bytes or past the start of ours
+    const utils::compression::zlib::dictionary wrong_dictionary(payload);
+    CHECK(wrong_dictionary.get_id() != network::get_packet_dictionary().get_id());
+
+    utils::compression::zlib::compressor compressor(wrong_dictionary);
+    std::string compressed{};
+    CHECK(compressor.compress(compressed, payload));
+    relay.forward(receiver_address, make_frame(COMPRESSED_MAGIC, compressed));
+
+    // A datagram cut short
+    network::manager sender{};
+    sender.set_compression(true);
+    CHECK(sender.send(relay.get_address(), "compressionTest", make_payload()));
+
+    const auto valid = relay.receive();
+    CHECK(get_magic(valid) == COMPRESSED_MAGIC);
+    relay.forward(receiver_address, valid.substr(0, valid.size() / 2));
+
+    // Neither reached the handler, the receiver still accepts the next one
+    relay.forward(receiver_address, valid);
+
+    const auto packets = log.wait_for(1);
+    CHECK(packets.size() == 1);
+    CHECK(packets[0] == make_payload());
+}
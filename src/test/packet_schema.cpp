@@ -0,0 +1,231 @@
+#include "test.hpp"
+
+#include <network/packet_codec.hpp>
+
+#include <string>
+
+// Generated packet serializers: round trips for string, fixed and list schemas, the version byte and length prefix,
+// and rejection of truncated or inconsistent input. Older senders leave newer fields at their default, fields of
+// newer senders are skipped.
+
+namespace
+{
+    using namespace network::protocol;
+
+    constexpr size_t HEADER_SIZE = 3;
+
+    fact_packet make_fact(const std::string_view name, const int32_t value)
+    {
+        fact_packet packet{};
+        copy_string(packet.fact_name, name);
+        packet.value = value;
+        packet.timestamp = 0x0123456789ABCDEF;
+        packet.update = fact_update::add;
+
+        return packet;
+    }
+
+    heartbeat_packet make_heartbeat()
+    {
+        heartbeat_packet packet{};
+        packet.player_guid = 0x1122334455667788;
+        packet.total_crowns = 4000;
+        packet.world_fact_hash = 0xDEADBEEFCAFEBABE;
+        packet.script_version = 3;
+        packet.game_time = 36000;
+        packet.weather_id = 7;
+        packet.timestamp = 99;
+
+        return packet;
+    }
+
+    bool operator==(const fact_packet& a, const fact_packet& b)
+    {
+        return a.fact_name == b.fact_name && a.value == b.value && a.timestamp == b.timestamp && a.update == b.update;
+    }
+
+    bool operator==(const heartbeat_packet& a, const heartbeat_packet& b)
+    {
+        return a.player_guid == b.player_guid && a.total_crowns == b.total_crowns && a.world_fact_hash == b.world_fact_hash &&
+               a.script_version == b.script_version && a.game_time == b.game_time && a.weather_id == b.weather_id &&
+               a.timestamp == b.timestamp;
+    }
+
+    template <typename T>
+    std::string encode(network::string_encoder& strings, const T& packet)
+    {
+        utils::buffer_serializer buffer{};
+        write(buffer, strings, packet);
+        return buffer.move_buffer();
+    }
+
+    template <typename T>
+    T decode(network::string_decoder& strings, const std::string_view data)
+    {
+        utils::buffer_deserializer buffer(data);
+        auto packet = read<T>(buffer, strings);
+        CHECK(buffer.get_remaining_size() == 0);
+
+        return packet;
+    }
+
+    uint16_t get_length(const std::string_view data)
+    {
+        return static_cast<uint16_t>(static_cast<uint8_t>(data[1]) | static_cast<uint8_t>(data[2]) << 8);
+    }
+
+    void set_length(std::string& data, const size_t length)
+    {
+        data[1] = static_cast<char>(length & 0xFF);
+        data[2] = static_cast<char>(length >> 8);
+    }
+}
+
+TEST_CASE(packet_schema_round_trip)
+{
+    network::string_dictionary link{};
+
+    const auto fact = make_fact("q104_found_ciri", -5);
+    const auto fact_data = encode(link.outgoing, fact);
+
+    CHECK(static_cast<uint8_t>(fact_data[0]) == schema_version<fact_packet>);
+    CHECK(get_length(fact_data) == fact_data.size() - HEADER_SIZE);
+    CHECK(fact_data.size() <= max_packet_size<fact_packet>);
+    CHECK(decode<fact_packet>(link.incoming, fact_data) == fact);
+
+    // Fixed layout, read at compile-time offsets
+    const auto heartbeat = make_heartbeat();
+    const auto heartbeat_data = encode(link.outgoing, heartbeat);
+    CHECK(heartbeat_data.size() == max_packet_size<heartbeat_packet>);
+    CHECK(decode<heartbeat_packet>(link.incoming, heartbeat_data) == heartbeat);
+
+    world_state_nodes_packet nodes{};
+    nodes.node = 12;
+    for (size_t i = 0; i < nodes.children.size(); ++i)
+    {
+        nodes.children[i] = i * 0x9E3779B97F4A7C15;
+    }
+
+    const auto decoded_nodes = decode<world_state_nodes_packet>(link.incoming, encode(link.outgoing, nodes));
+    CHECK(decoded_nodes.node == nodes.node && decoded_nodes.children == nodes.children);
+
+    // Lists of nested packets, each with its own header
+    fact_batch_packet batch{};
+    for (int32_t i = 0; i < static_cast<int32_t>(MAX_FACT_BATCH_SIZE); ++i)
+    {
+        batch.facts.push_back(make_fact("fact_" + std::to_string(i % 5), i));
+    }
+
+    const auto decoded_batch = decode<fact_batch_packet>(link.incoming, encode(link.outgoing, batch));
+    CHECK(decoded_batch.facts.size() == batch.facts.size());
+    for (size_t i = 0; i < batch.facts.size(); ++i)
+    {
+        CHECK(decoded_batch.facts[i] == batch.facts[i]);
+    }
+
+    batch.facts.push_back(make_fact("one_too_many", 0));
+    CHECK_THROWS(encode(link.outgoing, batch));
+
+    // Packets follow each other in one buffer
+    utils::buffer_serializer buffer{};
+    write(buffer, link.outgoing, fact);
+    write(buffer, link.outgoing, heartbeat);
+
+    utils::buffer_deserializer reader(buffer.get_view());
+    CHECK(read<fact_packet>(reader, link.incoming) == fact);
+    CHECK(read<heartbeat_packet>(reader, link.incoming) == heartbeat);
+    CHECK(reader.get_remaining_size() == 0);
+}
+
+TEST_CASE(packet_schema_truncated)
+{
+    network::string_dictionary link{};
+
+    const auto fact_data = encode(link.outgoing, make_fact("q104_found_ciri", 1));
+    const auto heartbeat_data = encode(link.outgoing, make_heartbeat());
+
+    // Every cut is caught by the length prefix or the header read
+    for (size_t length = 0; length < fact_data.size(); ++length)
+    {
+        network::string_decoder strings{};
+        CHECK_THROWS(decode<fact_packet>(strings, std::string_view(fact_data).substr(0, length)));
+    }
+
+    for (size_t length = 0; length < heartbeat_data.size(); ++length)
+    {
+        CHECK_THROWS(decode<heartbeat_packet>(link.incoming, std::string_view(heartbeat_data).substr(0, length)));
+    }
+
+    // A length prefix past the end of the datagram
+    auto overlong = heartbeat_data;
+    set_length(overlong, get_length(overlong) + 1);
+    CHECK_THROWS(decode<heartbeat_packet>(link.incoming, overlong));
+
+    // A length prefix shorter than the fields it claims to hold
+    const auto shorten = [](const std::string& data) {
+        auto short_length = data + '\0';
+        set_length(short_length, get_length(data) - 1);
+        return short_length;
+    };
+
+    const auto short_fact = shorten(fact_data);
+    utils::buffer_deserializer fact_reader(short_fact);
+    CHECK_THROWS(read<fact_packet>(fact_reader, link.incoming));
+
+    const auto short_heartbeat = shorten(heartbeat_data);
+    utils::buffer_deserializer heartbeat_reader(short_heartbeat);
+    CHECK_THROWS(read<heartbeat_packet>(heartbeat_reader, link.incoming));
+
+    // A list count past its maximum
+    utils::buffer_serializer batch{};
+    batch.write(static_cast<uint8_t>(schema_version<fact_batch_packet>));
+    batch.write(uint16_t{1});
+    batch.write_varint(MAX_FACT_BATCH_SIZE + 1);
+    CHECK_THROWS(decode<fact_batch_packet>(link.incoming, batch.get_view()));
+}
+
+TEST_CASE(packet_schema_versions)
+{
+    network::string_dictionary link{};
+
+    const auto fact = make_fact("q104_found_ciri", 3);
+    const auto fact_data = encode(link.outgoing, fact);
+
+    // There is no version 0
+    auto unversioned = fact_data;
+    unversioned[0] = 0;
+    CHECK_THROWS(decode<fact_packet>(link.incoming, unversioned));
+
+    // A version 1 sender doesn't know about the update field, it stays at its default
+    static_assert(schema_version<fact_packet> == 2);
+
+    auto old_data = fact_data.substr(0, fact_data.size() - sizeof(fact_update));
+    old_data[0] = 1;
+    set_length(old_data, old_data.size() - HEADER_SIZE);
+
+    const auto old_fact = decode<fact_packet>(link.incoming, old_data);
+    CHECK(old_fact.value == fact.value && old_fact.timestamp == fact.timestamp);
+    CHECK(old_fact.update == fact_update::set);
+
+    // Fields of a newer sender are skipped, the next packet still lines up
+    const auto add_newer_field = [](std::string data) {
+        data[0] = static_cast<char>(data[0] + 1);
+        data += "\x01\x02\x03\x04";
+        set_length(data, data.size() - HEADER_SIZE);
+
+        return data;
+    };
+
+    const auto newer_fact = add_newer_field(fact_data) + fact_data;
+    utils::buffer_deserializer fact_reader(newer_fact);
+    CHECK(read<fact_packet>(fact_reader, link.incoming) == fact);
+    CHECK(read<fact_packet>(fact_reader, link.incoming) == fact);
+    CHECK(fact_reader.get_remaining_size() == 0);
+
+    // A fixed layout of another version is read field by field
+    const auto newer_heartbeat = add_newer_field(encode(link.outgoing, make_heartbeat())) + fact_data;
+    utils::buffer_deserializer heartbeat_reader(newer_heartbeat);
+    CHECK(read<heartbeat_packet>(heartbeat_reader, link.incoming) == make_heartbeat());
+    CHECK(read<fact_packet>(heartbeat_reader, link.incoming) == fact);
+    CHECK(heartbeat_reader.get_remaining_size() == 0);
+}
@@ -0,0 +1,128 @@
+#include "test.hpp"
+
+#include <security/session_cipher.hpp>
+
+#include <string>
+#include <vector>
+
+// Sealed packets only open once, within the replay window and with their header, ciphertext and tag intact
+
+namespace
+{
+    constexpr size_t HEADER_SIZE = sizeof(int32_t);
+
+    security::session_keys make_keys(const uint8_t send, const uint8_t receive)
+    {
+        security::session_keys keys{};
+        keys.send.fill(send);
+        keys.receive.fill(receive);
+
+        return keys;
+    }
+
+    std::string seal(security::session_cipher& cipher, const std::string_view plaintext)
+    {
+        std::string packet(HEADER_SIZE, 'h');
+        packet.append(security::SEQUENCE_SIZE, '\0');
+        packet.append(plaintext);
+
+        CHECK(cipher.seal(packet, HEADER_SIZE));
+        return packet;
+    }
+
+    bool open(security::session_cipher& cipher, std::string packet, const std::string_view plaintext = "state")
+    {
+        return cipher.open(packet, HEADER_SIZE) && packet.substr(HEADER_SIZE + security::SEQUENCE_SIZE) == plaintext;
+    }
+}
+
+TEST_CASE(replay_window)
+{
+    security::replay_window window{};
+    CHECK(!window.is_fresh(0));
+
+    window.mark(5);
+    CHECK(!window.is_fresh(5));
+    CHECK(window.is_fresh(4));
+    CHECK(window.is_fresh(6));
+
+    // Reordered within the window
+    window.mark(100);
+    CHECK(window.is_fresh(50));
+    window.mark(50);
+    CHECK(!window.is_fresh(50));
+    CHECK(!window.is_fresh(100));
+
+    // Sliding forward forgets everything that fell out, old sequences stay rejected
+    const auto highest = 100 + security::replay_window::SIZE;
+    window.mark(highest);
+    CHECK(!window.is_fresh(100));
+    CHECK(!window.is_fresh(50));
+    CHECK(window.is_fresh(highest - 1));
+    CHECK(window.is_fresh(highest - security::replay_window::SIZE + 1));
+
+    // A jump past the whole bitmap clears it
+    window.mark(highest + 10 * security::replay_window::SIZE);
+    CHECK(window.is_fresh(highest + 10 * security::replay_window::SIZE - 1));
+    CHECK(!window.is_fresh(highest));
+}
+
+TEST_CASE(session_cipher_replayed)
+{
+    security::session_cipher sender(make_keys(1, 2));
+    security::session_cipher receiver(make_keys(2, 1));
+
+    const auto first = seal(sender, "state");
+    const auto second = seal(sender, "state");
+
+    CHECK(open(receiver, second));
+    CHECK(open(receiver, first));
+
+    CHECK(!open(receiver, first));
+    CHECK(!open(receiver, second));
+}
+
+TEST_CASE(session_cipher_out_of_window)
+{
+    security::session_cipher sender(make_keys(1, 2));
+    security::session_cipher receiver(make_keys(2, 1));
+
+    std::vector<std::string> packets{};
+    for (size_t i = 0; i < security::replay_window::SIZE + 2; ++i)
+    {
+        packets.emplace_back(seal(sender, "state"));
+    }
+
+    CHECK(open(receiver, packets.back()));
+
+    // Sequence 1 is SIZE + 1 behind, sequence 3 is still inside
+    CHECK(!open(receiver, packets[0]));
+    CHECK(!open(receiver, packets[1]));
+    CHECK(open(receiver, packets[2]));
+}
+
+TEST_CASE(session_cipher_forged)
+{
+    security::session_cipher sender(make_keys(1, 2));
+    security::session_cipher receiver(make_keys(2, 1));
+    security::session_cipher stranger(make_keys(3, 4));
+
+    const auto packet = seal(sender, "state");
+
+    for (const auto offset : {size_t{0}, HEADER_SIZE, HEADER_SIZE + security::SEQUENCE_SIZE, packet.size() - 1})
+    {
+        auto forged = packet;
+        forged[offset] = static_cast<char>(forged[offset] ^ 0x20);
+        CHECK(!open(receiver, forged));
+    }
+
+    CHECK(!open(receiver, packet.substr(0, packet.size() - 1)));
+    CHECK(!open(receiver, seal(stranger, "state")));
+
+    // A forged far-ahead sequence must not slide the window past the genuine packets
+    auto ahead = packet;
+    ahead[HEADER_SIZE + security::SEQUENCE_SIZE - 1] = 0x40;
+    CHECK(!open(receiver, ahead));
+
+    CHECK(open(receiver, packet));
+}
@@ -0,0 +1,243 @@
+#include "test.hpp"
+
+#include <server/std_include.hpp>
+#include <server/session_journal.hpp>
+
+#include <utils/byte_buffer.hpp>
+#include <utils/cryptography.hpp>
+#include <utils/hash.hpp>
+#include <utils/io.hpp>
+
+// Crash recovery of the server's session journal: clean restarts, torn and corrupt tails, stale journals after a
+// compaction and snapshots written by older servers
+
+namespace
+{
+    class session_directory
+    {
+      public:
+        session_directory()
+            : path_(std::filesystem::temp_directory_path() /
+                    ("w3m_session_journal_" + std::to_string(utils::cryptography::random::get_integer())))
+        {
+            std::filesystem::create_directories(this->path_);
+        }
+
+        ~session_directory()
+        {
+            std::error_code error{};
+            std::filesystem::remove_all(this->path_, error);
+        }
+
+        session_directory(session_directory&&) = delete;
+        session_directory(const session_directory&) = delete;
+        session_directory& operator=(session_directory&&) = delete;
+        session_directory& operator=(const session_directory&) = delete;
+
+        const std::filesystem::path& get_path() const
+        {
+            return this->path_;
+        }
+
+        std::filesystem::path get_journal() const
+        {
+            return this->path_ / "session.journal";
+        }
+
+        std::filesystem::path get_snapshot() const
+        {
+            return this->path_ / "session.snapshot";
+        }
+
+      private:
+        std::filesystem::path path_{};
+    };
+
+    const int32_t* find_fact(const network::world_snapshot& state, const std::string_view name)
+    {
+        for (const auto& [fact_name, value] : state.facts)
+        {
+            if (fact_name == name)
+            {
+                return &value;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool has_fact(const network::world_snapshot& state, const std::string_view name, const int32_t value)
+    {
+        const auto* fact = find_fact(state, name);
+        return fact && *fact == value;
+    }
+
+    size_t get_journal_size(const session_directory& directory)
+    {
+        return static_cast<size_t>(std::filesystem::file_size(directory.get_journal()));
+    }
+}
+
+TEST_CASE(session_journal_reopen)
+{
+    const session_directory directory{};
+
+    {
+        session_journal journal(directory.get_path());
+        CHECK(journal.get_recovered_state().facts.empty());
+
+        journal.append_fact("found_ciri", 1);
+        journal.append_fact("q002_yen_arrives", 2);
+        journal.append_environment(1500, 36000, 3);
+        journal.append_fact("found_ciri", 4);
+    }
+
+    const session_journal journal(directory.get_path());
+    const auto& state = journal.get_recovered_state();
+
+    CHECK(state.facts.size() == 2);
+    CHECK(state.facts[0].first == "found_ciri");
+    CHECK(has_fact(state, "found_ciri", 4));
+    CHECK(has_fact(state, "q002_yen_arrives", 2));
+    CHECK(state.total_crowns == 1500);
+    CHECK(state.game_time == 36000);
+    CHECK(state.weather_id == 3);
+}
+
+TEST_CASE(session_journal_torn_record)
+{
+    const session_directory directory{};
+    size_t valid_size = 0;
+
+    {
+        session_journal journal(directory.get_path());
+        journal.append_fact("found_ciri", 1);
+        journal.flush();
+        valid_size = get_journal_size(directory);
+
+        journal.append_fact("q002_yen_arrives", 2);
+    }
+
+    // The crash hit in the middle of the second record
+    const auto full_size = get_journal_size(directory);
+    std::filesystem::resize_file(directory.get_journal(), valid_size + (full_size - valid_size) / 2);
+
+    {
+        session_journal journal(directory.get_path());
+        const auto& state = journal.get_recovered_state();
+
+        CHECK(state.facts.size() == 1);
+        CHECK(has_fact(state, "found_ciri", 1));
+        CHECK(get_journal_size(directory) == valid_size);
+
+        // New records follow the last valid one
+        journal.append_fact("q002_yen_arrives", 3);
+    }
+
+    const session_journal journal(directory.get_path());
+    CHECK(journal.get_recovered_state().facts.size() == 2);
+    CHECK(has_fact(journal.get_recovered_state(), "q002_yen_arrives", 3));
+}
+
+TEST_CASE(session_journal_corrupt_checksum)
+{
+    const session_directory directory{};
+    size_t first_size = 0;
+    size_t second_size = 0;
+
+    {
+        session_journal journal(directory.get_path());
+        journal.append_fact("found_ciri", 1);
+        journal.flush();
+        first_size = get_journal_size(directory);
+
+        journal.append_fact("q002_yen_arrives", 2);
+        journal.flush();
+        second_size = get_journal_size(directory);
+
+        journal.append_fact("q003_lambert", 3);
+    }
+
+    // Flip a bit of the second record's checksum, the record itself stays intact
+    auto data = utils::io::read_file(directory.get_journal());
+    data[second_size - 1] = static_cast<char>(data[second_size - 1] ^ 1);
+    CHECK(utils::io::write_file(directory.get_journal(), data));
+
+    const session_journal journal(directory.get_path());
+    const auto& state = journal.get_recovered_state();
+
+    CHECK(state.facts.size() == 1);
+    CHECK(has_fact(state, "found_ciri", 1));
+    CHECK(!find_fact(state, "q003_lambert"));
+    CHECK(get_journal_size(directory) == first_size);
+}
+
+TEST_CASE(session_journal_stale_generation)
+{
+    const session_directory directory{};
+    std::string old_journal{};
+
+    {
+        session_journal journal(directory.get_path());
+        journal.append_fact("found_ciri", 1);
+        journal.flush();
+        old_journal = utils::io::read_file(directory.get_journal());
+
+        journal.append_fact("found_ciri", 2);
+
+        network::world_snapshot snapshot{};
+        snapshot.facts.emplace_back("found_ciri", 2);
+        journal.compact(snapshot);
+    }
+
+    // A crash after the snapshot was replaced but before the new journal header landed
+    CHECK(utils::io::write_file(directory.get_journal(), old_journal));
+
+    {
+        session_journal journal(directory.get_path());
+        const auto& state = journal.get_recovered_state();
+
+        CHECK(state.facts.size() == 1);
+        CHECK(has_fact(state, "found_ciri", 2));
+        CHECK(get_journal_size(directory) < old_journal.size());
+
+        journal.append_fact("q002_yen_arrives", 5);
+    }
+
+    const session_journal journal(directory.get_path());
+    CHECK(has_fact(journal.get_recovered_state(), "found_ciri", 2));
+    CHECK(has_fact(journal.get_recovered_state(), "q002_yen_arrives", 5));
+}
+
+TEST_CASE(session_journal_raw_snapshot)
+{
+    const session_directory directory{};
+
+    network::world_snapshot snapshot{};
+    snapshot.total_crowns = 250;
+    snapshot.game_time = 7200;
+    snapshot.weather_id = 2;
+    snapshot.facts.emplace_back("found_ciri", 1);
+    snapshot.facts.emplace_back("q002_yen_arrives", 2);
+
+    // Version 1 layout: the serialized body without compression
+    const auto body = network::serialize_snapshot(snapshot);
+
+    utils::buffer_serializer buffer{};
+    buffer.write(uint32_t{0x534D3357});
+    buffer.write(uint32_t{1});
+    buffer.write(uint64_t{7});
+    buffer.write(utils::hash::compute(body));
+    buffer.write(body.data(), body.size());
+
+    CHECK(utils::io::write_file(directory.get_snapshot(), buffer.get_buffer()));
+
+    const session_journal journal(directory.get_path());
+    const auto& state = journal.get_recovered_state();
+
+    CHECK(state.total_crowns == 250);
+    CHECK(state.game_time == 7200);
+    CHECK(state.weather_id == 2);
+    CHECK(state.facts.size() == 2);
+    CHECK(has_fact(state, "q002_yen_arrives", 2));
+}
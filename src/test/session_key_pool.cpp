@@ -0,0 +1,50 @@
+#include "test.hpp"
+
+#include <server/std_include.hpp>
+#include <server/session_key_pool.hpp>
+
+#include <thread>
+
+// Handshakes never wait for key generation: a drained pool answers with nothing right away and refills in the
+// background
+
+namespace
+{
+    constexpr auto WAIT_LIMIT = std::chrono::seconds(30);
+
+    utils::cryptography::ecc::key wait_for_key(session_key_pool& pool)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + WAIT_LIMIT;
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            if (auto key = pool.take())
+            {
+                return std::move(*key);
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        return {};
+    }
+}
+
+TEST_CASE(session_key_pool)
+{
+    session_key_pool pool{};
+
+    const auto first = wait_for_key(pool);
+    const auto second = wait_for_key(pool);
+    CHECK(first.is_valid() && second.is_valid());
+    CHECK(first.get_public_key() != second.get_public_key());
+
+    // Taking is never slower than a lock, even with every key gone
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < session_key_pool::CAPACITY * 4; ++i)
+    {
+        (void)pool.take();
+    }
+
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(250));
+    CHECK(wait_for_key(pool).is_valid());
+}
@@ -0,0 +1,222 @@
+#include "test.hpp"
+
+#include <server/std_include.hpp>
+#include <server/server.hpp>
+
+#include <game/structs.hpp>
+#include <security/session_cipher.hpp>
+#include <utils/byte_buffer.hpp>
+#include <utils/cryptography.hpp>
+
+// A client with a confirmed session against a server that restarts and loses its keys: the client's session times out,
+// the new server's handshake gets through and sealed states flow again. The same for a client that restarts on the
+// same address: the server's session times out and it authenticates the new client.
+
+namespace
+{
+    constexpr auto SESSION_TIMEOUT = 300ms;
+    constexpr auto STATE_INTERVAL = 30ms;
+    constexpr auto WAIT_LIMIT = 10s;
+
+    class running_server
+    {
+      public:
+        running_server(const uint16_t port, const std::filesystem::path& session_directory)
+            : server_(port, session_directory),
+              thread_([this] { this->server_.run(); })
+        {
+        }
+
+        ~running_server()
+        {
+            this->server_.stop();
+            this->thread_.join();
+        }
+
+        running_server(running_server&&) = delete;
+        running_server(const running_server&) = delete;
+        running_server& operator=(running_server&&) = delete;
+        running_server& operator=(const running_server&) = delete;
+
+        uint16_t get_port() const
+        {
+            return this->server_.get_ipv4_port();
+        }
+
+        void set_session_timeout(const std::chrono::milliseconds timeout)
+        {
+            this->server_.set_session_timeout(timeout);
+        }
+
+      private:
+        server server_;
+        std::thread thread_;
+    };
+
+    // What the client's network module does, on a manager of its own
+    class test_client
+    {
+      public:
+        test_client(const network::address& server_address, const utils::cryptography::ecc::key& key,
+                    const std::optional<uint16_t>& port = std::nullopt)
+            : server_address_(server_address),
+              key_(key),
+              manager_(port)
+        {
+            this->manager_.set_session_timeout(SESSION_TIMEOUT);
+
+            this->manager_.on("authRequest", [this](const network::address& source, const std::string_view& data) {
+                if (source == this->server_address_)
+                {
+                    this->handle_authentication_request(source, data);
+                }
+            });
+
+            this->manager_.on("states", [this](const network::address& source, const std::string_view&) {
+                if (source == this->server_address_)
+                {
+                    ++this->states_;
+                }
+            });
+        }
+
+        void send_state()
+        {
+            game::player player{};
+            player.guid = this->key_.get_hash();
+
+            utils::buffer_serializer buffer{};
+            buffer.write(game::PROTOCOL);
+            buffer.write(player);
+
+            (void)this->manager_.send(this->server_address_, "state", buffer.get_view());
+        }
+
+        // Keeps sending states until the server answers with some
+        bool wait_for_states()
+        {
+            const auto start_count = this->states_.load();
+            const auto deadline = std::chrono::steady_clock::now() + WAIT_LIMIT;
+
+            while (std::chrono::steady_clock::now() < deadline)
+            {
+                this->send_state();
+                std::this_thread::sleep_for(STATE_INTERVAL);
+
+                if (this->states_ >= start_count + 5)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Authentication requests answered, the server repeats them until the response arrives
+        size_t get_handshake_count() const
+        {
+            return this->handshakes_;
+        }
+
+        uint16_t get_port() const
+        {
+            return this->manager_.get_ipv4_socket().get_port();
+        }
+
+      private:
+        network::address server_address_{};
+        utils::cryptography::ecc::key key_{};
+        network::manager manager_{};
+
+        std::atomic_size_t states_{0};
+        std::atomic_size_t handshakes_{0};
+
+        void handle_authentication_request(const network::address& source, const std::string_view& data)
+        {
+            utils::buffer_deserializer buffer(data);
+            if (buffer.read<uint32_t>() != game::PROTOCOL)
+            {
+                return;
+            }
+
+            const auto nonce = buffer.read_string();
+
+            utils::cryptography::ecc::key server_key{};
+            server_key.deserialize(buffer.read_string_view());
+
+            const auto keys = security::derive_session_keys(this->key_, server_key, nonce, security::session_role::client);
+
+            utils::buffer_serializer response{};
+            response.write(game::PROTOCOL);
+            response.write_string(this->key_.serialize(PK_PUBLIC));
+            response.write_string(utils::cryptography::ecc::sign_message(this->key_, nonce));
+
+            this->manager_.set_session(source, std::make_shared<security::session_cipher>(keys), false);
+            (void)this->manager_.send(source, "authResponse", response.get_buffer());
+
+            ++this->handshakes_;
+        }
+    };
+
+    std::filesystem::path create_session_directory()
+    {
+        auto directory = std::filesystem::temp_directory_path() /
+                         ("w3m_session_recovery_" + std::to_string(utils::cryptography::random::get_integer()));
+        std::filesystem::create_directories(directory);
+
+        return directory;
+    }
+}
+
+TEST_CASE(session_recovery)
+{
+    const auto session_directory = create_session_directory();
+
+    auto first_server = std::make_unique<running_server>(28960, session_directory);
+    const auto port = first_server->get_port();
+
+    test_client client(network::address("127.0.0.1:" + std::to_string(port)), utils::cryptography::ecc::generate_key(512));
+    CHECK(client.wait_for_states());
+
+    const auto handshake_count = client.get_handshake_count();
+    CHECK(handshake_count > 0);
+
+    // The new server binds the same port, without the keys of the first one
+    first_server.reset();
+    const running_server second_server(port, session_directory);
+    CHECK(second_server.get_port() == port);
+
+    CHECK(client.wait_for_states());
+    CHECK(client.get_handshake_count() > handshake_count);
+
+    std::error_code error{};
+    std::filesystem::remove_all(session_directory, error);
+}
+
+TEST_CASE(session_recovery_client_restart)
+{
+    const auto session_directory = create_session_directory();
+
+    running_server server(28960, session_directory);
+    server.set_session_timeout(SESSION_TIMEOUT);
+
+    const network::address server_address("127.0.0.1:" + std::to_string(server.get_port()));
+    const auto key = utils::cryptography::ecc::generate_key(512);
+
+    auto first_client = std::make_unique<test_client>(server_address, key, uint16_t{29160});
+    CHECK(first_client->wait_for_states());
+
+    // The restarted client binds the same port, without the keys of the first one
+    const auto client_port = first_client->get_port();
+    first_client.reset();
+
+    test_client second_client(server_address, key, client_port);
+    CHECK(second_client.get_port() == client_port);
+    CHECK(second_client.get_handshake_count() == 0);
+
+    CHECK(second_client.wait_for_states());
+    CHECK(second_client.get_handshake_count() > 0);
+
+    std::error_code error{};
+    std::filesystem::remove_all(session_directory, error);
+}
@@ -0,0 +1,204 @@
+#include "test.hpp"
+
+#include <game/structs.hpp>
+#include <network/string_dictionary.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+// The per-link string dictionary: definitions repeat until acknowledged, then only the id travels. A receiver that lost
+// its dictionary rejects unknown ids and asks for a reset, after which every definition is sent again under its old id.
+
+namespace
+{
+    using name = std::array<char, 64>;
+
+    name make_name(const std::string_view text)
+    {
+        name value{};
+        std::copy(text.begin(), text.end(), value.begin());
+        return value;
+    }
+
+    std::string encode(network::string_encoder& encoder, const std::string_view text)
+    {
+        utils::buffer_serializer buffer{};
+        encoder.write(buffer, text);
+        return buffer.move_buffer();
+    }
+
+    std::string decode(network::string_decoder& decoder, const std::string_view data)
+    {
+        utils::buffer_deserializer buffer(data);
+
+        name value{};
+        decoder.read(buffer, value);
+        CHECK(buffer.get_remaining_size() == 0);
+
+        return value.data();
+    }
+
+    // What the receiving end sends back in its "dict_ack" packets
+    void acknowledge(network::string_dictionary& sender, network::string_dictionary& receiver)
+    {
+        for (const auto& payload : network::serialize_acknowledgements(receiver.incoming.take_acknowledgements()))
+        {
+            network::apply_acknowledgements(sender.outgoing, payload);
+        }
+    }
+}
+
+TEST_CASE(string_dictionary_round_trip)
+{
+    network::string_dictionary sender{};
+    network::string_dictionary receiver{};
+
+    const auto first = encode(sender.outgoing, "q104_found_ciri");
+    CHECK(decode(receiver.incoming, first) == "q104_found_ciri");
+
+    // Lost definitions are repeated, so the receiver can always resolve the id
+    const auto repeated = encode(sender.outgoing, "q104_found_ciri");
+    CHECK(repeated == first);
+
+    acknowledge(sender, receiver);
+    CHECK(receiver.incoming.take_acknowledgements().empty());
+
+    const auto compact = encode(sender.outgoing, "q104_found_ciri");
+    CHECK(compact.size() == 1);
+    CHECK(decode(receiver.incoming, compact) == "q104_found_ciri");
+
+    // A late copy of the definition still decodes
+    CHECK(decode(receiver.incoming, first) == "q104_found_ciri");
+
+    // The empty string and fixed arrays go through the same path
+    utils::buffer_serializer buffer{};
+    sender.outgoing.write(buffer, make_name("witcher_sword"));
+    sender.outgoing.write(buffer, "");
+
+    utils::buffer_deserializer reader(buffer.get_view());
+    name sword{};
+    name empty = make_name("stale");
+    receiver.incoming.read(reader, sword);
+    receiver.incoming.read(reader, empty);
+
+    CHECK(std::string(sword.data()) == "witcher_sword");
+    CHECK(std::string(empty.data()).empty());
+    CHECK(sender.outgoing.size() == 3);
+}
+
+TEST_CASE(string_dictionary_reset)
+{
+    network::string_dictionary sender{};
+    network::string_dictionary receiver{};
+
+    const auto definition = encode(sender.outgoing, "nml_bandit_01");
+    CHECK(decode(receiver.incoming, definition) == "nml_bandit_01");
+    acknowledge(sender, receiver);
+
+    const auto compact = encode(sender.outgoing, "nml_bandit_01");
+
+    // The receiver reconnected and lost its dictionary, the id alone means nothing to it
+    receiver.incoming.reset();
+    CHECK(!receiver.incoming.take_reset_request());
+    CHECK_THROWS(decode(receiver.incoming, compact));
+    CHECK(receiver.incoming.take_reset_request());
+    CHECK(!receiver.incoming.take_reset_request());
+
+    // Its "dict_reset" makes the sender define everything again under the same ids
+    sender.outgoing.reset();
+    CHECK(sender.outgoing.size() == 1);
+
+    const auto redefinition = encode(sender.outgoing, "nml_bandit_01");
+    CHECK(redefinition == definition);
+    CHECK(decode(receiver.incoming, redefinition) == "nml_bandit_01");
+
+    acknowledge(sender, receiver);
+    CHECK(decode(receiver.incoming, encode(sender.outgoing, "nml_bandit_01")) == "nml_bandit_01");
+}
+
+TEST_CASE(string_dictionary_limits)
+{
+    network::string_dictionary sender{};
+    network::string_dictionary receiver{};
+
+    // Ids are only valid once defined
+    utils::buffer_serializer undefined{};
+    undefined.write_varint(uint64_t{7} << 1);
+    CHECK_THROWS(decode(receiver.incoming, undefined.get_view()));
+
+    utils::buffer_serializer out_of_range{};
+    out_of_range.write_varint((uint64_t{network::MAX_DICTIONARY_SIZE} + 1) << 1 | 1);
+    out_of_range.write_varint(1);
+    out_of_range.write("x", 1);
+    CHECK_THROWS(decode(receiver.incoming, out_of_range.get_view()));
+
+    CHECK_THROWS(encode(sender.outgoing, std::string(network::MAX_INTERNED_LENGTH + 1, 'x')));
+
+    // Truncated definitions
+    const auto definition = encode(sender.outgoing, "q001_mutagen");
+    CHECK_THROWS(decode(receiver.incoming, std::string_view(definition).substr(0, definition.size() - 1)));
+
+    // Texts longer than the destination are cut, the result stays null terminated
+    std::array<char, 4> small{};
+    utils::buffer_deserializer reader(definition);
+    receiver.incoming.read(reader, small);
+    CHECK(std::string(small.data()) == "q00");
+
+    // A full dictionary sends the remaining strings as literals
+    for (uint32_t i = 1; i < network::MAX_DICTIONARY_SIZE; ++i)
+    {
+        (void)encode(sender.outgoing, "fact_" + std::to_string(i));
+    }
+
+    CHECK(sender.outgoing.size() == network::MAX_DICTIONARY_SIZE);
+
+    const auto literal = encode(sender.outgoing, "one_too_many");
+    CHECK(decode(receiver.incoming, literal) == "one_too_many");
+
+    // Literals aren't acknowledged, only the definition read above is
+    CHECK(receiver.incoming.take_acknowledgements().size() == 1);
+    CHECK(sender.outgoing.size() == network::MAX_DICTIONARY_SIZE);
+}
+
+TEST_CASE(string_dictionary_acknowledgements)
+{
+    std::vector<uint32_t> ids{};
+    for (uint32_t id = 1; id <= network::MAX_ACKNOWLEDGEMENTS_PER_PACKET * 2 + 3; ++id)
+    {
+        ids.push_back(id);
+    }
+
+    const auto payloads = network::serialize_acknowledgements(ids);
+    CHECK(payloads.size() == 3);
+
+    // Ids that were never sent are ignored
+    network::string_encoder encoder{};
+    for (const auto& payload : payloads)
+    {
+        network::apply_acknowledgements(encoder, payload);
+    }
+
+    const auto definition = encode(encoder, "first");
+    CHECK(definition.size() > 1);
+
+    network::string_decoder decoder{};
+    CHECK(decode(decoder, definition) == "first");
+    CHECK(decoder.take_acknowledgements() == std::vector<uint32_t>{1});
+
+    // Acknowledgements from another protocol version are ignored, oversized ones are rejected
+    utils::buffer_serializer old_protocol{};
+    old_protocol.write(game::PROTOCOL - 1);
+    old_protocol.write_varint(1);
+    old_protocol.write_varint(1);
+    network::apply_acknowledgements(encoder, old_protocol.get_view());
+    CHECK(encode(encoder, "first") == definition);
+
+    utils::buffer_serializer oversized{};
+    oversized.write(game::PROTOCOL);
+    oversized.write_varint(network::MAX_ACKNOWLEDGEMENTS_PER_PACKET + 1);
+    CHECK_THROWS(network::apply_acknowledgements(encoder, oversized.get_view()));
+
+    network::apply_acknowledgements(encoder, network::serialize_acknowledgements({1})[0]);
+    CHECK(encode(encoder, "first").size() == 1);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <exception>
+
+// Minimal self-registering test cases. A failed CHECK throws, which ends the case and fails the run.
+// Usage: tests [case name...]
+
+namespace test
+{
+    using function = void (*)();
+
+    class registration
+    {
+      public:
+        registration(const char* name, function run);
+    };
+
+    [[noreturn]] void fail(const char* expression, const char* file, int line);
+
+    template <typename F>
+    bool throws(F&& function)
+    {
+        try
+        {
+            function();
+        }
+        catch (const std::exception&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+}
+
+#define TEST_CASE(name)                                                            \
+    static void test_##name();                                                     \
+    static const test::registration test_registration_##name(#name, &test_##name); \
+    static void test_##name()
+
+#define CHECK(expression) ((expression) ? static_cast<void>(0) : test::fail(#expression, __FILE__, __LINE__))
+
+// Passes if evaluating expression throws a std::exception
+#define CHECK_THROWS(expression) \
+    ((test::throws([&] { (void)(expression); })) ? static_cast<void>(0) : test::fail("throws " #expression, __FILE__, __LINE__))
@@ -0,0 +1,120 @@
+#include "test.hpp"
+
+#include <client/updater/verified_file_sink.hpp>
+
+#include <utils/cryptography.hpp>
+#include <utils/io.hpp>
+
+// Downloads are hashed as they are written: only the expected size with the expected hash is accepted, and a retry
+// starts the file over
+
+namespace
+{
+    class temporary_path
+    {
+      public:
+        temporary_path()
+            : path_(std::filesystem::temp_directory_path() /
+                    ("w3m_verified_file_sink_" + std::to_string(utils::cryptography::random::get_integer())))
+        {
+        }
+
+        ~temporary_path()
+        {
+            std::error_code error{};
+            std::filesystem::remove(this->path_, error);
+        }
+
+        temporary_path(temporary_path&&) = delete;
+        temporary_path(const temporary_path&) = delete;
+        temporary_path& operator=(temporary_path&&) = delete;
+        temporary_path& operator=(const temporary_path&) = delete;
+
+        const std::filesystem::path& get() const
+        {
+            return this->path_;
+        }
+
+      private:
+        std::filesystem::path path_{};
+    };
+
+    updater::file_info make_file_info(const std::string& data)
+    {
+        updater::file_info file{};
+        file.name = "w3m.dll";
+        file.size = data.size();
+        file.hash = utils::cryptography::sha1::compute(data, true);
+
+        return file;
+    }
+
+    std::string make_data()
+    {
+        std::string data(100000, '\0');
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<char>(i * 7 + i / 255);
+        }
+
+        return data;
+    }
+}
+
+TEST_CASE(verified_file_sink)
+{
+    const temporary_path path{};
+    const auto data = make_data();
+    const auto file = make_file_info(data);
+
+    updater::verified_file_sink sink(path.get(), file);
+    sink.begin();
+
+    // A first attempt that broke off, the retry starts over
+    CHECK(sink.write(std::string_view(data).substr(0, 1000)));
+    sink.begin();
+
+    for (size_t offset = 0; offset < data.size(); offset += 4096)
+    {
+        CHECK(sink.write(std::string_view(data).substr(offset, 4096)));
+    }
+
+    CHECK(sink.finish());
+    CHECK(utils::cryptography::matches_hex(sink.get_digest(), file.hash));
+    CHECK(utils::io::read_file(path.get()) == data);
+}
+
+TEST_CASE(verified_file_sink_oversize)
+{
+    const temporary_path path{};
+    const auto data = make_data();
+    const auto file = make_file_info(data);
+
+    updater::verified_file_sink sink(path.get(), file);
+    sink.begin();
+
+    CHECK(sink.write(data));
+    CHECK(!sink.write("x"));
+    CHECK(!sink.finish());
+
+    // Too short is just as wrong
+    sink.begin();
+    CHECK(sink.write(std::string_view(data).substr(0, data.size() - 1)));
+    CHECK(!sink.finish());
+}
+
+TEST_CASE(verified_file_sink_bad_hash)
+{
+    const temporary_path path{};
+    auto data = make_data();
+    const auto file = make_file_info(data);
+
+    data[data.size() / 2] = static_cast<char>(data[data.size() / 2] ^ 1);
+
+    updater::verified_file_sink sink(path.get(), file);
+    sink.begin();
+
+    CHECK(sink.write(data));
+    CHECK(!sink.finish());
+    CHECK(!utils::cryptography::matches_hex(sink.get_digest(), file.hash));
+}
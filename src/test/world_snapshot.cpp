@@ -0,0 +1,191 @@
+#include "test.hpp"
+
+#include <network/world_snapshot.hpp>
+
+#include <client/module/quest_sync.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Late-join transfer: chunks are reassembled in any order and across request windows, a lost chunk is resumed at the
+// gap, a new snapshot id restarts the transfer, corruption is rejected, and the result seeds the client's facts
+
+namespace
+{
+    network::world_snapshot generate_snapshot(const size_t fact_count, const uint32_t seed)
+    {
+        std::mt19937 random(seed);
+
+        network::world_snapshot snapshot{};
+        snapshot.total_crowns = 1234;
+        snapshot.game_time = 36000;
+        snapshot.weather_id = 3;
+
+        for (size_t i = 0; i < fact_count; ++i)
+        {
+            snapshot.facts.emplace_back("fact_" + std::to_string(random()), static_cast<int32_t>(random() % 1000));
+        }
+
+        return snapshot;
+    }
+
+    // Goes through the wire format like a received datagram
+    void deliver(network::snapshot_receiver& receiver, const network::snapshot_transfer& transfer, const uint32_t index)
+    {
+        utils::buffer_serializer message{};
+        transfer.write_chunk(message, index);
+
+        utils::buffer_deserializer buffer(message.get_view());
+        receiver.add_chunk(network::read_snapshot_chunk(buffer));
+    }
+
+    // Answers requests with up to a window of chunks like the server, skipping the dropped ones
+    void answer_request(network::snapshot_receiver& receiver, const network::snapshot_transfer& transfer, const uint32_t first_chunk,
+                        std::vector<uint32_t>& dropped)
+    {
+        const auto end = std::min(transfer.get_chunk_count(), first_chunk + static_cast<uint32_t>(network::SNAPSHOT_WINDOW));
+        for (auto i = first_chunk; i < end; ++i)
+        {
+            const auto drop = std::ranges::find(dropped, i);
+            if (drop != dropped.end())
+            {
+                dropped.erase(drop);
+                continue;
+            }
+
+            deliver(receiver, transfer, i);
+        }
+    }
+}
+
+TEST_CASE(world_snapshot_windows)
+{
+    const auto snapshot = generate_snapshot(8000, 0x5733);
+    const network::snapshot_transfer transfer(17, snapshot);
+    CHECK(transfer.get_chunk_count() > network::SNAPSHOT_WINDOW * 2);
+
+    network::snapshot_receiver receiver{};
+    std::vector<uint32_t> dropped{3, network::SNAPSHOT_WINDOW + 1};
+
+    size_t requests = 0;
+    while (!receiver.is_complete())
+    {
+        CHECK(++requests < 16);
+        answer_request(receiver, transfer, receiver.get_next_chunk(), dropped);
+    }
+
+    // Each dropped chunk costs at most one extra request that resumes at the gap
+    CHECK(requests <= (transfer.get_chunk_count() + network::SNAPSHOT_WINDOW - 1) / network::SNAPSHOT_WINDOW + 2);
+    CHECK(receiver.get_snapshot_id() == 17);
+    CHECK(receiver.get_next_chunk() == transfer.get_chunk_count());
+
+    const auto received = receiver.get_snapshot();
+    CHECK(received.total_crowns == snapshot.total_crowns);
+    CHECK(received.game_time == snapshot.game_time);
+    CHECK(received.weather_id == snapshot.weather_id);
+    CHECK(received.facts == snapshot.facts);
+
+    quest_sync::quest_fact_manager facts{};
+    facts.set_fact_limit(network::MAX_SNAPSHOT_FACTS);
+    CHECK(facts.apply_snapshot_facts(received.facts, 0) == snapshot.facts.size());
+
+    const auto& [name, value] = snapshot.facts[1234];
+    CHECK(facts.get_fact(name) && facts.get_fact(name)->value == value);
+}
+
+TEST_CASE(world_snapshot_out_of_order)
+{
+    const auto snapshot = generate_snapshot(1000, 42);
+    const network::snapshot_transfer transfer(5, snapshot);
+
+    std::vector<uint32_t> order(transfer.get_chunk_count());
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+
+    std::ranges::shuffle(order, std::mt19937(7));
+
+    network::snapshot_receiver receiver{};
+    for (const auto index : order)
+    {
+        CHECK(!receiver.is_complete());
+        deliver(receiver, transfer, index);
+
+        // Duplicates from a resent window are ignored
+        deliver(receiver, transfer, index);
+    }
+
+    CHECK(receiver.is_complete());
+    CHECK(receiver.get_snapshot().facts == snapshot.facts);
+}
+
+TEST_CASE(world_snapshot_restart)
+{
+    const network::snapshot_transfer stale(1, generate_snapshot(1000, 1));
+    const network::snapshot_transfer current(2, generate_snapshot(1200, 2));
+
+    network::snapshot_receiver receiver{};
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        deliver(receiver, stale, i);
+    }
+
+    CHECK(receiver.get_next_chunk() == 4);
+
+    // The server rebuilt its snapshot in the meantime, e.g. after a restart
+    deliver(receiver, current, 1);
+    CHECK(receiver.get_snapshot_id() == 2);
+    CHECK(receiver.get_next_chunk() == 0);
+    CHECK(receiver.get_chunk_count() == current.get_chunk_count());
+
+    for (uint32_t i = 0; i < current.get_chunk_count(); ++i)
+    {
+        deliver(receiver, current, i);
+    }
+
+    CHECK(receiver.get_snapshot().facts.size() == 1200);
+
+    receiver.reset();
+    CHECK(receiver.get_snapshot_id() == 0);
+    CHECK(!receiver.is_complete());
+    CHECK_THROWS(receiver.get_snapshot());
+}
+
+TEST_CASE(world_snapshot_corruption)
+{
+    const network::snapshot_transfer transfer(9, generate_snapshot(1000, 9));
+
+    network::snapshot_receiver receiver{};
+    for (uint32_t i = 0; i < transfer.get_chunk_count(); ++i)
+    {
+        utils::buffer_serializer message{};
+        transfer.write_chunk(message, i);
+
+        auto data = message.get_buffer();
+        if (i == 2)
+        {
+            data.back() ^= 1;
+        }
+
+        utils::buffer_deserializer buffer(data);
+        receiver.add_chunk(network::read_snapshot_chunk(buffer));
+    }
+
+    CHECK(receiver.is_complete());
+    CHECK_THROWS(receiver.get_snapshot());
+
+    // A chunk past the announced size never reaches the receiver
+    utils::buffer_serializer message{};
+    transfer.write_chunk(message, 0);
+
+    auto data = message.get_buffer();
+    const uint32_t index = transfer.get_chunk_count();
+    std::memcpy(data.data() + sizeof(uint64_t) * 2 + sizeof(uint32_t), &index, sizeof(index));
+
+    utils::buffer_deserializer buffer(data);
+    CHECK_THROWS(network::read_snapshot_chunk(buffer));
+}
@@ -0,0 +1,158 @@
+#include "test.hpp"
+
+#include <server/world_state.hpp>
+
+#include <client/module/quest_sync.hpp>
+
+// The cached late-join snapshot: game time alone only invalidates it once it moved by an hour, and a snapshot
+// compressed while the state changed is handed out but not cached. The fact tree matches a client's for the same
+// facts, and a client repairs a divergent bucket from the server's pages.
+
+namespace
+{
+    network::protocol::heartbeat_packet make_heartbeat(const uint32_t game_time, const uint16_t weather_id = 1)
+    {
+        network::protocol::heartbeat_packet heartbeat{};
+        heartbeat.total_crowns = 100;
+        heartbeat.game_time = game_time;
+        heartbeat.weather_id = weather_id;
+
+        return heartbeat;
+    }
+
+    std::shared_ptr<const network::snapshot_transfer> build_snapshot(world_state& world)
+    {
+        const auto pending = world.prepare_snapshot();
+        auto snapshot = std::make_shared<const network::snapshot_transfer>(pending.id, pending.snapshot);
+        world.cache_snapshot(pending, snapshot);
+
+        return snapshot;
+    }
+}
+
+TEST_CASE(world_state_game_time)
+{
+    world_state world{};
+    world.update_environment(make_heartbeat(36000));
+
+    const auto snapshot = build_snapshot(world);
+    CHECK(world.get_cached_snapshot() == snapshot);
+
+    // A heartbeat every second moves game time a little each time
+    for (uint32_t game_time = 36000; game_time < 36000 + 3000; game_time += 15)
+    {
+        world.update_environment(make_heartbeat(game_time));
+    }
+
+    CHECK(world.get_cached_snapshot() == snapshot);
+
+    world.update_environment(make_heartbeat(36000 + 3600));
+    CHECK(!world.get_cached_snapshot());
+
+    const auto later = build_snapshot(world);
+    CHECK(later->id != snapshot->id);
+
+    // Loading an earlier save
+    world.update_environment(make_heartbeat(1000));
+    CHECK(!world.get_cached_snapshot());
+
+    build_snapshot(world);
+    world.update_environment(make_heartbeat(1000, 2));
+    CHECK(!world.get_cached_snapshot());
+}
+
+TEST_CASE(world_state_stale_snapshot)
+{
+    world_state world{};
+    world.set_fact("found_ciri", 1);
+
+    const auto pending = world.prepare_snapshot();
+
+    // Changes while the snapshot is being compressed
+    world.set_fact("found_ciri", 2);
+
+    world.cache_snapshot(pending, std::make_shared<const network::snapshot_transfer>(pending.id, pending.snapshot));
+    CHECK(!world.get_cached_snapshot());
+
+    const auto snapshot = build_snapshot(world);
+    CHECK(world.get_cached_snapshot() == snapshot);
+
+    const auto facts = network::decompress_snapshot(snapshot->data).facts;
+    CHECK(facts.size() == 1 && facts[0].second == 2);
+}
+
+TEST_CASE(world_state_bucket_resync)
+{
+    world_state world{};
+    quest_sync::quest_fact_manager client{};
+    client.set_fact_limit(network::MAX_SNAPSHOT_FACTS);
+
+    std::vector<std::pair<std::string, int32_t>> client_facts{};
+
+    // Enough facts in one bucket for several pages
+    constexpr size_t bucket = 7;
+    constexpr size_t bucket_facts = network::protocol::MAX_BUCKET_PAGE_SIZE * 2 + 5;
+
+    size_t in_bucket = 0;
+    for (int32_t i = 0; in_bucket < bucket_facts; ++i)
+    {
+        const auto name = "fact_" + std::to_string(i);
+        world.set_fact(name, i);
+
+        if (utils::merkle_tree::get_bucket(network::protocol::get_fact_hash(name)) == bucket)
+        {
+            ++in_bucket;
+
+            // The client missed every third fact of the bucket and holds an old value of another one
+            if (in_bucket % 3 == 0)
+            {
+                continue;
+            }
+
+            client_facts.emplace_back(name, in_bucket == 1 ? i + 1 : i);
+            continue;
+        }
+
+        client_facts.emplace_back(name, i);
+    }
+
+    client.apply_snapshot_facts(client_facts, 1);
+
+    CHECK(world.get_fact_tree().get_root() != client.get_world_state_hash());
+
+    const auto nodes = client.find_divergent_world_state_nodes(0, world.get_fact_tree().get_children(0));
+    CHECK(nodes.size() == 1);
+
+    const auto buckets = client.find_divergent_world_state_nodes(nodes[0], world.get_fact_tree().get_children(nodes[0]));
+    CHECK(buckets.size() == 1);
+    CHECK(utils::merkle_tree::get_bucket_of_node(buckets[0]) == bucket);
+
+    uint32_t offset = 0;
+    size_t pages = 0;
+    size_t applied = 0;
+
+    while (true)
+    {
+        const auto page = world.get_bucket_page(bucket, offset);
+        CHECK(page.bucket == bucket);
+        CHECK(page.offset == offset);
+        CHECK(page.fact_count == bucket_facts);
+        CHECK(page.facts.size() <= network::protocol::MAX_BUCKET_PAGE_SIZE);
+
+        applied += client.apply_resynced_facts(page.facts, 0, [](uint32_t) { return false; });
+        offset += static_cast<uint32_t>(page.facts.size());
+        ++pages;
+
+        if (page.facts.empty() || offset >= page.fact_count)
+        {
+            break;
+        }
+    }
+
+    CHECK(pages == 3);
+    CHECK(applied == bucket_facts / 3 + 1);
+    CHECK(world.get_fact_tree().get_root() == client.get_world_state_hash());
+
+    // Past the end
+    CHECK(world.get_bucket_page(bucket, offset).facts.empty());
+}